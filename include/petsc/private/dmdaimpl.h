@@ -8,6 +8,8 @@
 #include <petscdmda.h>
 #include <petsc/private/dmimpl.h>
 
+typedef struct _n_DMDAHalo *DMDAHalo;
+
 typedef struct {
   PetscInt              M,N,P;                 /* array dimensions */
   PetscInt              m,n,p;                 /* processor layout */
@@ -70,6 +72,10 @@ typedef struct {
   /* used by DMDASetMatPreallocateOnly() */
   PetscBool             prealloc_only;
   PetscInt              preallocCenterDim; /* Dimension of the points which connect adjacent points for preallocation */
+
+  /* used by DMDASetStructuredHalo() */
+  PetscBool             usehalo;
+  DMDAHalo              halo;                /* subarray datatypes replacing gtol for DMGlobalToLocal(), built on first use */
 } DM_DA;
 
 /*
@@ -95,6 +101,9 @@ PETSC_INTERN PetscErrorCode DMView_DA_VTK(DM,PetscViewer);
 PETSC_INTERN PetscErrorCode DMView_DA_GLVis(DM,PetscViewer);
 PETSC_EXTERN PetscErrorCode DMDAVTKWriteAll(PetscObject,PetscViewer);
 PETSC_EXTERN PetscErrorCode DMDASelectFields(DM,PetscInt*,PetscInt**);
+PETSC_INTERN PetscErrorCode DMDAHaloBegin_Private(DM,Vec,Vec);
+PETSC_INTERN PetscErrorCode DMDAHaloEnd_Private(DM,Vec,Vec);
+PETSC_INTERN PetscErrorCode DMDAHaloDestroy_Private(DM);
 
 PETSC_EXTERN PetscLogEvent DMDA_LocalADFunction;
 
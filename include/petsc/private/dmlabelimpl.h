@@ -11,7 +11,17 @@
      - Low storage is the most important design point
      - We want flexible insertion and deletion
      - We can live with O(log) query, but we need O(1) iteration over strata
+   A sorted stratum whose points are contiguous is stored as a stride, otherwise a lookup
+   (run ranges when there are few runs, or a bitmap when the stratum is dense) may be attached to it.
 */
+typedef struct {
+  PetscBool  setup;         /* The lookup matches the sorted points of the stratum */
+  PetscInt   numRuns;       /* Number of runs of consecutive points, or 0 if they are not stored */
+  PetscInt  *runs;          /* Run r is [runs[2r], runs[2r+1]) */
+  PetscInt   bStart, bEnd;  /* Bounds of the bitmap */
+  PetscBT    bt;            /* Membership bitmap, or NULL */
+} DMLabelLookup;
+
 struct _n_DMLabel {
   PetscInt         refct;
   PetscObjectState state;
@@ -23,6 +33,7 @@ struct _n_DMLabel {
   PetscBool  *validIS;        /* The IS is valid (no additions need to be merged in) */
   PetscInt   *stratumSizes;   /* Size of each stratum */
   IS         *points;         /* Points for each stratum, always sorted */
+  DMLabelLookup *lookup;      /* Accelerated membership test for each stratum */
   /* Hashtable for fast insertion */
   PetscHashI *ht;             /* Hash table for fast insertion */
   /* Index for fast search */
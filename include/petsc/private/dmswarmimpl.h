@@ -18,6 +18,7 @@ PETSC_EXTERN PetscLogEvent DMSWARM_Migrate,
 typedef struct _p_DataField* DataField;
 typedef struct _p_DataBucket* DataBucket;
 typedef struct _p_DMSwarmSort* DMSwarmSort;
+typedef struct _p_DataEx* DataEx;
 
 typedef struct {
   DataBucket db;
@@ -45,6 +46,9 @@ typedef struct {
   PetscBool collect_view_active;
   PetscInt  collect_view_reset_nlocal;
   DMSwarmSort sort_context;
+  PetscBool   cell_sorted_layout;
+  DataEx      migrate_de; /* persistent neighbour exchanger used by DMSWARM_MIGRATE_DMCELLINCREMENTAL */
+  PetscReal   *migrate_bbox; /* bounding boxes (min and max of each coordinate) of the cells of the neighbours of migrate_de */
 } DM_Swarm;
 
 typedef struct {
@@ -63,5 +67,6 @@ struct _p_DMSwarmSort {
 PETSC_INTERN PetscErrorCode DMSwarmMigrate_Push_Basic(DM, PetscBool);
 PETSC_INTERN PetscErrorCode DMSwarmMigrate_CellDMScatter(DM,PetscBool);
 PETSC_INTERN PetscErrorCode DMSwarmMigrate_CellDMExact(DM,PetscBool);
+PETSC_INTERN PetscErrorCode DMSwarmMigrate_CellDMIncremental(DM,PetscBool);
 
 #endif /* _SWARMIMPL_H */
@@ -4,6 +4,7 @@
 
 #include <petscmat.h>
 #include <petscmatcoarsen.h>
+#include <petscbt.h>
 #include <petsc/private/petscimpl.h>
 
 PETSC_EXTERN PetscBool MatRegisterAllCalled;
@@ -545,6 +546,10 @@ struct  _p_MatFDColoring{
   PetscInt       brows,bcols;      /* number of block rows or columns for speedup inserting the dense matrix into sparse Jacobian */
   PetscBool      setupcalled;      /* true if setup has been called */
   PetscBool      viewed;           /* true if the -mat_fd_coloring_view has been triggered already */
+  PetscBT        rowmask;          /* local rows recomputed by MatFDColoringApply(), all rows if NULL */
+  PetscInt       *coloractive;     /* with rowmask, whether each color perturbs an active row on some process */
+  PetscInt       *nactivecolumns;  /* with rowmask and ghosted differencing, the number of columns of each color perturbed */
+  PetscInt       **activecolumns;  /* and those columns, only the ones in an active row */
   void           (*ftn_func_pointer)(void),*ftn_func_cntx; /* serve the same purpose as *fortran_func_pointers in PETSc objects */
 };
 
@@ -1250,7 +1255,6 @@ PETSC_STATIC_INLINE PetscErrorCode MatPivotCheck(Mat fact,Mat mat,const MatFacto
 #define PetscIncompleteLLDestroy(lnk,bt) (PetscFree(lnk) || PetscBTDestroy(&(bt)))
 
 /* -------------------------------------------------------------------------------------------------------*/
-#include <petscbt.h>
 /*
   Create and initialize a condensed linked list -
     same as PetscLLCreate(), but uses a scalable array 'lnk' with size of max number of entries, not O(N).
@@ -60,6 +60,7 @@ struct _p_SNES {
   MatStructure matstruct;        /* Used by Picard solver */
 
   Vec  vec_sol_update;           /* pointer to solution update */
+  Vec  vec_jacrefresh;           /* residual each Jacobian row was last computed with, for SNESSetLagJacobianPartial() */
 
   Vec  scaling;                  /* scaling vector */
   void *scaP;                    /* scaling context */
@@ -91,6 +92,9 @@ struct _p_SNES {
   PetscInt    iter;               /* global iteration number */
   PetscInt    linear_its;         /* total number of linear solver iterations */
   PetscReal   norm;               /* residual norm of current iterate */
+  PetscReal   fnormlocal;         /* local square of the residual norm returned by the function set with SNESSetFunctionAndNorm() */
+  PetscObjectId    fnormlocalid;    /* id of the residual it belongs to */
+  PetscObjectState fnormlocalstate; /* and state of that residual when the norm was computed */
   PetscReal   rtol;               /* relative tolerance */
   PetscReal   divtol;             /* relative divergence tolerance */
   PetscReal   abstol;             /* absolute tolerance */
@@ -103,6 +107,7 @@ struct _p_SNES {
   PetscBool   lagjac_persist;     /* The jac_iter persists until reset */
   PetscInt    pre_iter;           /* The present iteration of the Preconditioner lagging */
   PetscBool   lagpre_persist;     /* The pre_iter persists until reset */
+  PetscReal   lagjacpartial;      /* SNESSetLagJacobianPartial() */
   PetscInt    gridsequence;       /* number of grid sequence steps to take; defaults to zero */
 
   PetscBool   tolerancesset;      /* SNESSetTolerances() called and tolerances should persist through SNESCreate_XXX()*/
@@ -168,6 +173,7 @@ typedef struct _p_DMSNES *DMSNES;
 typedef struct _DMSNESOps *DMSNESOps;
 struct _DMSNESOps {
   PetscErrorCode (*computefunction)(SNES,Vec,Vec,void*);
+  PetscErrorCode (*computefunctionnorm)(SNES,Vec,Vec,PetscReal*,void*); /* also returns the local square of the norm */
   PetscErrorCode (*computejacobian)(SNES,Vec,Mat,Mat,void*);
 
   /* objective */
@@ -187,6 +193,7 @@ struct _DMSNESOps {
 struct _p_DMSNES {
   PETSCHEADER(struct _DMSNESOps);
   void *functionctx;
+  void *functionnormctx;
   void *gsctx;
   void *pctx;
   void *jacobianctx;
@@ -252,6 +259,7 @@ PETSC_INTERN PetscErrorCode SNESVISetVariableBounds_VI(SNES,Vec,Vec);
 PETSC_INTERN PetscErrorCode SNESConvergedDefault_VI(SNES,PetscInt,PetscReal,PetscReal,PetscReal,SNESConvergedReason*,void*);
 
 PetscErrorCode SNESScaleStep_Private(SNES,Vec,PetscReal*,PetscReal*,PetscReal*,PetscReal*);
+PETSC_INTERN PetscErrorCode SNESFDColoringSetActiveRows_Private(SNES,Vec,MatFDColoring);
 PETSC_EXTERN PetscErrorCode DMSNESCheckFromOptions_Internal(SNES,DM,Vec,Vec,PetscErrorCode (**)(PetscInt,PetscReal,const PetscReal[],PetscInt,PetscScalar*,void*),void**);
 
 PETSC_EXTERN PetscLogEvent SNES_Solve, SNES_LineSearch, SNES_FunctionEval, SNES_JacobianEval, SNES_NGSEval, SNES_NGSFuncEval, SNES_NPCSolve, SNES_ObjectiveEval;
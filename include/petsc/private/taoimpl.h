@@ -25,6 +25,9 @@ struct _TaoOps {
     PetscErrorCode (*computejacobianinequality)(Tao, Vec, Mat, Mat,  void*);
     PetscErrorCode (*computejacobianequality)(Tao, Vec, Mat, Mat,  void*);
     PetscErrorCode (*computebounds)(Tao, Vec, Vec, void*);
+    PetscErrorCode (*computeobjectivemultiple)(Tao, PetscInt, Vec*, PetscReal*, void*);
+    PetscErrorCode (*computeseparableobjectivemultiple)(Tao, PetscInt, Vec*, Vec*, void*);
+    PetscErrorCode (*computebatchobjectiveandgradient)(Tao, Vec, PetscInt, const PetscInt*, PetscReal*, Vec, void*);
 
     PetscErrorCode (*convergencetest)(Tao,void*);
     PetscErrorCode (*convergencedestroy)(void*);
@@ -57,6 +60,9 @@ struct _p_Tao {
     void *user_jac_stateP;
     void *user_jac_designP;
     void *user_boundsP;
+    void *user_objmultP;
+    void *user_sepobjmultP;
+    void *user_batchobjgradP;
 
     PetscErrorCode (*monitor[MAXTAOMONITORS])(Tao,void*);
     PetscErrorCode (*monitordestroy[MAXTAOMONITORS])(void**);
@@ -132,6 +138,13 @@ struct _p_Tao {
     PetscInt  ksp_its; /* KSP iterations for this solver iteration */
     PetscInt  ksp_tot_its; /* Total (cumulative) KSP iterations */
 
+    PetscInt     objgroups;  /* number of groups of processes evaluating disjoint sets of points concurrently */
+    PetscSubcomm objsubcomm;
+
+    PetscInt     nsamples_local; /* objective that is a sum over samples, owned by process in contiguous ranges */
+    PetscInt     nsamples;
+    PetscInt     sample_start;
+
 
     TaoLineSearch linesearch;
     PetscBool lsflag; /* goes up when line search fails */
@@ -26,6 +26,9 @@ PETSC_EXTERN PetscErrorCode TSARKIMEXRegisterAll(void);
 PETSC_EXTERN PetscErrorCode TSRosWRegisterAll(void);
 PETSC_EXTERN PetscErrorCode TSGLLERegisterAll(void);
 PETSC_EXTERN PetscErrorCode TSGLLEAdaptRegisterAll(void);
+PETSC_INTERN PetscErrorCode TSRHSSplitDestroy_Private(TS);
+PETSC_INTERN PetscErrorCode TSJacobianReuseCheck_Private(TS,SNES,PetscReal,Mat,Mat,PetscBool*);
+PETSC_INTERN PetscErrorCode TSJacobianReuseUpdate_Private(TS,PetscReal,Mat);
 
 typedef struct _TSOps *TSOps;
 
@@ -64,6 +67,15 @@ struct _TSOps {
 */
 typedef struct _n_TSEvent *TSEvent;
 
+typedef struct _n_TS_RHSSplitLink *TS_RHSSplitLink;
+struct _n_TS_RHSSplitLink {
+  char            *splitname;
+  IS              is;
+  TSRHSFunction   rhsfunction;   /* right hand side restricted to the split, optional */
+  void            *ctx;
+  TS_RHSSplitLink next;
+};
+
 typedef struct _TSTrajectoryOps *TSTrajectoryOps;
 
 struct _TSTrajectoryOps {
@@ -99,6 +111,7 @@ struct _p_TS {
   TSAdapt        adapt;
   TSAdaptType    default_adapt_type;
   TSEvent        event;
+  TS_RHSSplitLink tsrhssplit;     /* named subsets of the components of the solution, see TSRHSSplitSetIS() */
 
   /* ---------------- User (or PETSc) Provided stuff ---------------------*/
   PetscErrorCode (*monitor[MAXTSMONITORS])(TS,PetscInt,PetscReal,Vec,void*);
@@ -176,6 +189,19 @@ struct _p_TS {
     PetscReal shift;            /* The derivative of the lhs wrt to Xdot */
   } ijacobian;
 
+  /* Reuse of the shifted Jacobian and of its preconditioner across the implicit stages and steps, see TSSetJacobianReuse() */
+  struct {
+    PetscBool        use;
+    PetscReal        shiftratio;    /* rebuild when the shift changes by more than this factor */
+    PetscReal        rate;          /* rebuild when the Newton iteration contracts the residual less than this */
+    PetscReal        shift;         /* shift of the current matrices, 0 when there are none */
+    PetscObjectState state;         /* state of the preconditioning matrix after it was last computed */
+    PetscReal        fnorm;         /* residual norm when the Jacobian was last requested */
+    PetscBool        rateok;        /* the last observed contraction was below the rate */
+    PetscInt         reject;        /* number of rejected steps when the Jacobian was computed */
+    PetscInt         computed,reused;
+  } jacreuse;
+
   /* --------------------Nonlinear Iteration------------------------------*/
   SNES     snes;
   PetscBool usessnes;   /* Flag set by each TSType to indicate if the type actually uses a SNES;
@@ -393,6 +419,6 @@ PETSC_STATIC_INLINE PetscErrorCode TSCheckImplicitTerm(TS ts)
   PetscFunctionReturn(0);
 }
 
-PETSC_EXTERN PetscLogEvent TSTrajectory_Set, TSTrajectory_Get, TSTrajectory_DiskWrite, TSTrajectory_DiskRead;
+PETSC_EXTERN PetscLogEvent TSTrajectory_Set, TSTrajectory_Get, TSTrajectory_DiskWrite, TSTrajectory_DiskRead, TSTrajectory_IOWait;
 
 #endif
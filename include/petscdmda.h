@@ -65,6 +65,8 @@ PETSC_EXTERN PetscErrorCode DMDAGlobalToNaturalAllCreate(DM,VecScatter*);
 PETSC_EXTERN PetscErrorCode DMDANaturalAllToGlobalCreate(DM,VecScatter*);
 
 PETSC_EXTERN PetscErrorCode DMDAGetScatter(DM,VecScatter*,VecScatter*);
+PETSC_EXTERN PetscErrorCode DMDASetStructuredHalo(DM,PetscBool);
+PETSC_EXTERN PetscErrorCode DMDAGetStructuredHalo(DM,PetscBool*);
 PETSC_EXTERN PetscErrorCode DMDAGetNeighbors(DM,const PetscMPIInt**);
 
 PETSC_EXTERN PetscErrorCode DMDASetAOType(DM,AOType);
@@ -185,6 +187,13 @@ PETSC_EXTERN PetscErrorCode MatRegisterDAAD(void);
 PETSC_EXTERN PetscErrorCode MatCreateDAAD(DM,Mat*);
 PETSC_EXTERN PetscErrorCode MatCreateSeqUSFFT(Vec,DM,Mat*);
 
+PETSC_EXTERN PetscErrorCode DMDACreateStencilMatrix(DM,Mat*);
+PETSC_EXTERN PetscErrorCode DMDAStencilMatrixSetConstantCoefficients(Mat,const PetscScalar[]);
+PETSC_EXTERN PetscErrorCode DMDAStencilMatrixSetCoefficients(Mat,Vec);
+PETSC_EXTERN PetscErrorCode DMDAStencilMatrixGetCoefficientDM(Mat,DM*);
+PETSC_EXTERN PetscErrorCode DMDAStencilMatrixGetStencil(Mat,PetscInt*,const MatStencil*[]);
+PETSC_EXTERN PetscErrorCode DMDAStencilMatrixSetTileSize(Mat,PetscInt,PetscInt);
+
 PETSC_EXTERN PetscErrorCode DMDASetGetMatrix(DM,PetscErrorCode (*)(DM, Mat *));
 PETSC_EXTERN PetscErrorCode DMDASetBlockFills(DM,const PetscInt*,const PetscInt*);
 PETSC_EXTERN PetscErrorCode DMDASetRefinementFactor(DM,PetscInt,PetscInt,PetscInt);
@@ -12,6 +12,7 @@ typedef enum {
   DMSWARM_MIGRATE_BASIC=0,
   DMSWARM_MIGRATE_DMCELLNSCATTER,
   DMSWARM_MIGRATE_DMCELLEXACT,
+  DMSWARM_MIGRATE_DMCELLINCREMENTAL,
   DMSWARM_MIGRATE_USER
 } DMSwarmMigrateType;
 
@@ -78,6 +79,8 @@ PETSC_EXTERN PetscErrorCode DMSwarmCopyPoint(DM dm,PetscInt,PetscInt);
 PETSC_EXTERN PetscErrorCode DMSwarmGetLocalSize(DM,PetscInt*);
 PETSC_EXTERN PetscErrorCode DMSwarmGetSize(DM,PetscInt*);
 PETSC_EXTERN PetscErrorCode DMSwarmMigrate(DM,PetscBool);
+PETSC_EXTERN PetscErrorCode DMSwarmSetMigrateType(DM,DMSwarmMigrateType);
+PETSC_EXTERN PetscErrorCode DMSwarmSetFieldMigrate(DM,const char[],PetscBool);
 
 PETSC_EXTERN PetscErrorCode DMSwarmCollectViewCreate(DM);
 PETSC_EXTERN PetscErrorCode DMSwarmCollectViewDestroy(DM);
@@ -98,6 +101,9 @@ PETSC_EXTERN PetscErrorCode DMSwarmSortGetPointsPerCell(DM,PetscInt,PetscInt*,Pe
 PETSC_EXTERN PetscErrorCode DMSwarmSortGetNumberOfPointsPerCell(DM,PetscInt,PetscInt*);
 PETSC_EXTERN PetscErrorCode DMSwarmSortGetIsValid(DM,PetscBool*);
 PETSC_EXTERN PetscErrorCode DMSwarmSortGetSizes(DM,PetscInt*,PetscInt*);
+PETSC_EXTERN PetscErrorCode DMSwarmSortFields(DM);
+PETSC_EXTERN PetscErrorCode DMSwarmSetCellSortedLayout(DM,PetscBool);
+PETSC_EXTERN PetscErrorCode DMSwarmGetCellSortedLayout(DM,PetscBool*);
 
 PETSC_EXTERN PetscErrorCode DMSwarmProjectFields(DM,PetscInt,const char**,Vec**,PetscBool);
 
@@ -185,6 +185,7 @@ PETSC_EXTERN PetscErrorCode ISColoringGetIS(ISColoring,PetscInt*,IS*[]);
 PETSC_EXTERN PetscErrorCode ISColoringRestoreIS(ISColoring,IS*[]);
 PETSC_EXTERN PetscErrorCode ISColoringReference(ISColoring);
 PETSC_EXTERN PetscErrorCode ISColoringSetType(ISColoring,ISColoringType);
+PETSC_EXTERN PetscErrorCode ISColoringGetType(ISColoring,ISColoringType*);
 
 
 /* --------------------------------------------------------------------------*/
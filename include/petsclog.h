@@ -226,6 +226,7 @@ PETSC_EXTERN PetscErrorCode PetscLogDefaultBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogAllBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogNestedBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogTraceBegin(FILE *);
+PETSC_EXTERN PetscErrorCode PetscLogTimelineBegin(PetscInt);
 PETSC_EXTERN PetscErrorCode PetscLogActions(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogObjects(PetscBool);
 /* General functions */
@@ -237,6 +238,7 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject, const char[], ...);
 PETSC_EXTERN PetscErrorCode PetscLogView(PetscViewer);
 PETSC_EXTERN PetscErrorCode PetscLogViewFromOptions(void);
 PETSC_EXTERN PetscErrorCode PetscLogDump(const char[]);
+PETSC_EXTERN PetscErrorCode PetscLogTimelineDump(const char[]);
 
 PETSC_EXTERN PetscErrorCode PetscGetFlops(PetscLogDouble *);
 
@@ -449,10 +451,12 @@ PETSC_STATIC_INLINE int PetscMPIParallelComm(MPI_Comm comm)
 #define PetscLogViewFromOptions()           0
 #define PetscLogDefaultBegin()                     0
 #define PetscLogTraceBegin(file)            0
+#define PetscLogTimelineBegin(size)         0
 #define PetscLogSet(lb,le)                  0
 #define PetscLogAllBegin()                  0
 #define PetscLogNestedBegin()               0
 #define PetscLogDump(c)                     0
+#define PetscLogTimelineDump(c)             0
 #define PetscLogEventRegister(a,b,c)        0
 #define PetscLogObjects(a)                  0
 #define PetscLogActions(a)                  0
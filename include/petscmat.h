@@ -1257,6 +1257,7 @@ PETSC_EXTERN PetscErrorCode MatFDColoringSetF(MatFDColoring,Vec);
 PETSC_EXTERN PetscErrorCode MatFDColoringGetPerturbedColumns(MatFDColoring,PetscInt*,const PetscInt*[]);
 PETSC_EXTERN PetscErrorCode MatFDColoringSetUp(Mat,ISColoring,MatFDColoring);
 PETSC_EXTERN PetscErrorCode MatFDColoringSetBlockSize(MatFDColoring,PetscInt,PetscInt);
+PETSC_EXTERN PetscErrorCode MatFDColoringSetActiveRows(MatFDColoring,IS);
 
 
 /*S
@@ -1601,6 +1602,8 @@ PETSC_EXTERN PetscErrorCode MatDiagonalScaleLocal(Mat,Vec);
 PETSC_EXTERN PetscErrorCode MatCreateMFFD(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt,Mat*);
 PETSC_EXTERN PetscErrorCode MatMFFDSetBase(Mat,Vec,Vec);
 PETSC_EXTERN PetscErrorCode MatMFFDSetFunction(Mat,PetscErrorCode(*)(void*,Vec,Vec),void*);
+PETSC_EXTERN PetscErrorCode MatMFFDSetFunctionMultiple(Mat,PetscErrorCode(*)(void*,PetscInt,Vec[],Vec[]),void*);
+PETSC_EXTERN PetscErrorCode MatMFFDMultMultiple(Mat,PetscInt,Vec[],Vec[]);
 PETSC_EXTERN PetscErrorCode MatMFFDSetFunctioni(Mat,PetscErrorCode (*)(void*,PetscInt,Vec,PetscScalar*));
 PETSC_EXTERN PetscErrorCode MatMFFDSetFunctioniBase(Mat,PetscErrorCode (*)(void*,Vec));
 PETSC_EXTERN PetscErrorCode MatMFFDSetHHistory(Mat,PetscScalar[],PetscInt);
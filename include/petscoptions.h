@@ -36,6 +36,7 @@ PETSC_EXTERN PetscErrorCode PetscOptionsLeft(PetscOptions);
 PETSC_EXTERN PetscErrorCode PetscOptionsLeftGet(PetscOptions,PetscInt*,char***,char***);
 PETSC_EXTERN PetscErrorCode PetscOptionsLeftRestore(PetscOptions,PetscInt*,char***,char***);
 PETSC_EXTERN PetscErrorCode PetscOptionsView(PetscOptions,PetscViewer);
+PETSC_EXTERN PetscErrorCode PetscOptionsGetLookupCounts(PetscOptions,PetscInt64*,PetscInt64*,PetscLogDouble*);
 
 PETSC_EXTERN PetscErrorCode PetscOptionsCreateDefault(void);
 PETSC_EXTERN PetscErrorCode PetscOptionsInsert(PetscOptions,int*,char ***,const char[]);
@@ -144,6 +144,8 @@ PETSC_EXTERN PetscErrorCode SNESSetLagJacobian(SNES,PetscInt);
 PETSC_EXTERN PetscErrorCode SNESGetLagJacobian(SNES,PetscInt*);
 PETSC_EXTERN PetscErrorCode SNESSetLagPreconditionerPersists(SNES,PetscBool);
 PETSC_EXTERN PetscErrorCode SNESSetLagJacobianPersists(SNES,PetscBool);
+PETSC_EXTERN PetscErrorCode SNESSetLagJacobianPartial(SNES,PetscReal);
+PETSC_EXTERN PetscErrorCode SNESGetLagJacobianPartial(SNES,PetscReal*);
 PETSC_EXTERN PetscErrorCode SNESSetGridSequence(SNES,PetscInt);
 PETSC_EXTERN PetscErrorCode SNESGetGridSequence(SNES,PetscInt*);
 
@@ -365,6 +367,10 @@ PETSC_EXTERN PetscErrorCode SNESSetInitialFunction(SNES,Vec);
 PETSC_EXTERN PetscErrorCode SNESSetObjective(SNES,PetscErrorCode (*)(SNES,Vec,PetscReal *,void*),void*);
 PETSC_EXTERN PetscErrorCode SNESGetObjective(SNES,PetscErrorCode (**)(SNES,Vec,PetscReal *,void*),void**);
 PETSC_EXTERN PetscErrorCode SNESComputeObjective(SNES,Vec,PetscReal *);
+PETSC_EXTERN PetscErrorCode SNESSetFunctionAndNorm(SNES,PetscErrorCode (*)(SNES,Vec,Vec,PetscReal*,void*),void*);
+PETSC_EXTERN PetscErrorCode SNESGetFunctionAndNorm(SNES,PetscErrorCode (**)(SNES,Vec,Vec,PetscReal*,void*),void**);
+PETSC_EXTERN PetscErrorCode SNESFunctionNormBegin(SNES,Vec,PetscReal*);
+PETSC_EXTERN PetscErrorCode SNESFunctionNormEnd(SNES,Vec,PetscReal*);
 
 /*E
     SNESNormSchedule - Frequency with which the norm is computed
@@ -678,6 +684,8 @@ PETSC_EXTERN PetscErrorCode DMSNESSetPicard(DM,PetscErrorCode(*)(SNES,Vec,Vec,vo
 PETSC_EXTERN PetscErrorCode DMSNESGetPicard(DM,PetscErrorCode(**)(SNES,Vec,Vec,void*),PetscErrorCode(**)(SNES,Vec,Mat,Mat,void*),void**);
 PETSC_EXTERN PetscErrorCode DMSNESSetObjective(DM,PetscErrorCode (*)(SNES,Vec,PetscReal *,void*),void*);
 PETSC_EXTERN PetscErrorCode DMSNESGetObjective(DM,PetscErrorCode (**)(SNES,Vec,PetscReal *,void*),void**);
+PETSC_EXTERN PetscErrorCode DMSNESSetFunctionAndNorm(DM,PetscErrorCode (*)(SNES,Vec,Vec,PetscReal*,void*),void*);
+PETSC_EXTERN PetscErrorCode DMSNESGetFunctionAndNorm(DM,PetscErrorCode (**)(SNES,Vec,Vec,PetscReal*,void*),void**);
 PETSC_EXTERN PetscErrorCode DMCopyDMSNES(DM,DM);
 
 PETSC_EXTERN_TYPEDEF typedef PetscErrorCode (*DMDASNESFunction)(DMDALocalInfo*,void*,void*,void*);
@@ -685,6 +693,7 @@ PETSC_EXTERN_TYPEDEF typedef PetscErrorCode (*DMDASNESJacobian)(DMDALocalInfo*,v
 PETSC_EXTERN_TYPEDEF typedef PetscErrorCode (*DMDASNESObjective)(DMDALocalInfo*,void*,PetscReal*,void*);
 
 PETSC_EXTERN PetscErrorCode DMDASNESSetFunctionLocal(DM,InsertMode,DMDASNESFunction,void*);
+PETSC_EXTERN PetscErrorCode DMDASNESSetFunctionLocalSubBoxes(DM,PetscBool);
 PETSC_EXTERN PetscErrorCode DMDASNESSetJacobianLocal(DM,DMDASNESJacobian,void*);
 PETSC_EXTERN PetscErrorCode DMDASNESSetObjectiveLocal(DM,DMDASNESObjective,void*);
 PETSC_EXTERN PetscErrorCode DMDASNESSetPicardLocal(DM,InsertMode,PetscErrorCode (*)(DMDALocalInfo*,void*,void*,void*),PetscErrorCode (*)(DMDALocalInfo*,void*,Mat,Mat,void*),void*);
@@ -795,6 +804,7 @@ PETSC_EXTERN PetscErrorCode SNESNASMSetComputeFinalJacobian(SNES,PetscBool);
 PETSC_EXTERN PetscErrorCode SNESNASMGetSNES(SNES,PetscInt,SNES *);
 PETSC_EXTERN PetscErrorCode SNESNASMGetNumber(SNES,PetscInt*);
 PETSC_EXTERN PetscErrorCode SNESNASMSetWeight(SNES,Vec);
+PETSC_EXTERN PetscErrorCode SNESNASMSetJacobianLag(SNES,PetscInt);
 
 typedef enum {SNES_COMPOSITE_ADDITIVE,SNES_COMPOSITE_MULTIPLICATIVE,SNES_COMPOSITE_ADDITIVEOPTIMAL} SNESCompositeType;
 PETSC_EXTERN const char *const SNESCompositeTypes[];
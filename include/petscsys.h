@@ -2126,6 +2126,31 @@ M*/
     for ( ; _p < _end; _p += PETSC_LEVEL1_DCACHE_LINESIZE) PETSC_Prefetch(_p,(rw),(t)); \
   } while (0)
 
+/*MC
+   PetscPragmaSIMD - Asks the compiler to vectorize the loop that immediately follows
+
+   Synopsis:
+    #include <petscsys.h>
+    PetscPragmaSIMD
+    for (i=0; i<n; i++) y[i] += a[i]*x[i];
+
+   Level: developer
+
+   Notes:
+   The loop must not carry dependencies between iterations. Expands to nothing when the compiler offers no suitable pragma.
+
+   Concepts: vectorization
+M*/
+#if defined(__INTEL_COMPILER)
+#  define PetscPragmaSIMD _Pragma("vector")
+#elif defined(_OPENMP) && _OPENMP >= 201307
+#  define PetscPragmaSIMD _Pragma("omp simd")
+#elif defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) && !defined(__clang__)
+#  define PetscPragmaSIMD _Pragma("GCC ivdep")
+#else
+#  define PetscPragmaSIMD
+#endif
+
 /*
       Determine if some of the kernel computation routines use
    Fortran (rather than C) for the numerical calculations. On some machines
@@ -61,6 +61,7 @@ J*/
 #define TAOASILS    "asils"
 #define TAOASFLS    "asfls"
 #define TAOIPM      "ipm"
+#define TAOSGD      "sgd"
 #define TAOTEST     "test"
 
 PETSC_EXTERN PetscClassId TAO_CLASSID;
@@ -139,6 +140,12 @@ PETSC_EXTERN PetscErrorCode TaoSetObjectiveAndGradientRoutine(Tao, PetscErrorCod
 PETSC_EXTERN PetscErrorCode TaoSetHessianRoutine(Tao,Mat,Mat,PetscErrorCode(*)(Tao,Vec, Mat, Mat, void*), void*);
 PETSC_EXTERN PetscErrorCode TaoSetSeparableObjectiveRoutine(Tao, Vec, PetscErrorCode(*)(Tao, Vec, Vec, void*), void*);
 PETSC_EXTERN PetscErrorCode TaoSetSeparableObjectiveWeights(Tao, Vec, PetscInt, PetscInt*, PetscInt*, PetscReal*);
+PETSC_EXTERN PetscErrorCode TaoSetObjectiveMultipleRoutine(Tao, PetscErrorCode(*)(Tao, PetscInt, Vec[], PetscReal[], void*), void*);
+PETSC_EXTERN PetscErrorCode TaoSetSeparableObjectiveMultipleRoutine(Tao, PetscErrorCode(*)(Tao, PetscInt, Vec[], Vec[], void*), void*);
+PETSC_EXTERN PetscErrorCode TaoSetBatchObjectiveAndGradientRoutine(Tao, PetscInt, PetscInt, PetscErrorCode(*)(Tao, Vec, PetscInt, const PetscInt[], PetscReal*, Vec, void*), void*);
+PETSC_EXTERN PetscErrorCode TaoGetBatchSamples(Tao, PetscInt*, PetscInt*, PetscInt*);
+PETSC_EXTERN PetscErrorCode TaoSetObjectiveGroups(Tao, PetscInt);
+PETSC_EXTERN PetscErrorCode TaoGetObjectiveGroups(Tao, PetscInt*);
 PETSC_EXTERN PetscErrorCode TaoSetConstraintsRoutine(Tao, Vec, PetscErrorCode(*)(Tao, Vec, Vec, void*), void*);
 PETSC_EXTERN PetscErrorCode TaoSetInequalityConstraintsRoutine(Tao, Vec, PetscErrorCode(*)(Tao, Vec, Vec, void*), void*);
 PETSC_EXTERN PetscErrorCode TaoSetEqualityConstraintsRoutine(Tao, Vec, PetscErrorCode(*)(Tao, Vec, Vec, void*), void*);
@@ -152,6 +159,9 @@ PETSC_EXTERN PetscErrorCode TaoSetStateDesignIS(Tao, IS, IS);
 
 PETSC_EXTERN PetscErrorCode TaoComputeObjective(Tao, Vec, PetscReal*);
 PETSC_EXTERN PetscErrorCode TaoComputeSeparableObjective(Tao, Vec, Vec);
+PETSC_EXTERN PetscErrorCode TaoComputeObjectiveMultiple(Tao, PetscInt, Vec[], PetscReal[]);
+PETSC_EXTERN PetscErrorCode TaoComputeSeparableObjectiveMultiple(Tao, PetscInt, Vec[], Vec[]);
+PETSC_EXTERN PetscErrorCode TaoComputeBatchObjectiveAndGradient(Tao, Vec, PetscInt, const PetscInt[], PetscReal*, Vec);
 PETSC_EXTERN PetscErrorCode TaoComputeGradient(Tao, Vec, Vec);
 PETSC_EXTERN PetscErrorCode TaoComputeObjectiveAndGradient(Tao, Vec, PetscReal*, Vec);
 PETSC_EXTERN PetscErrorCode TaoComputeConstraints(Tao, Vec, Vec);
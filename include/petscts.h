@@ -43,6 +43,10 @@ typedef const char* TSType;
 #define TSEIMEX           "eimex"
 #define TSMIMEX           "mimex"
 #define TSBDF             "bdf"
+#define TSPARAREAL        "parareal"
+#define TSENSEMBLE        "ensemble"
+#define TSEXPRB           "exprb"
+#define TSMPRK            "mprk"
 
 /*E
     TSProblemType - Determines the type of problem this TS object is to be used to solve
@@ -386,6 +390,13 @@ PETSC_EXTERN PetscErrorCode TSGetRHSFunction(TS,Vec*,TSRHSFunction*,void**);
 PETSC_EXTERN PetscErrorCode TSSetRHSJacobian(TS,Mat,Mat,TSRHSJacobian,void*);
 PETSC_EXTERN PetscErrorCode TSGetRHSJacobian(TS,Mat*,Mat*,TSRHSJacobian*,void**);
 PETSC_EXTERN PetscErrorCode TSRHSJacobianSetReuse(TS,PetscBool);
+PETSC_EXTERN PetscErrorCode TSSetJacobianReuse(TS,PetscBool);
+PETSC_EXTERN PetscErrorCode TSSetJacobianReuseTolerances(TS,PetscReal,PetscReal);
+PETSC_EXTERN PetscErrorCode TSGetJacobianReuseCounts(TS,PetscInt*,PetscInt*);
+PETSC_EXTERN PetscErrorCode TSRHSSplitSetIS(TS,const char[],IS);
+PETSC_EXTERN PetscErrorCode TSRHSSplitGetIS(TS,const char[],IS*);
+PETSC_EXTERN PetscErrorCode TSRHSSplitSetRHSFunction(TS,const char[],TSRHSFunction,void*);
+PETSC_EXTERN PetscErrorCode TSRHSSplitGetRHSFunction(TS,const char[],TSRHSFunction*,void**);
 
 PETSC_EXTERN_TYPEDEF typedef PetscErrorCode (*TSSolutionFunction)(TS,PetscReal,Vec,void*);
 PETSC_EXTERN PetscErrorCode TSSetSolutionFunction(TS,TSSolutionFunction,void*);
@@ -728,11 +739,17 @@ typedef const char* TSRKType;
 #define TSRK5F    "5f"
 #define TSRK5DP   "5dp"
 #define TSRK5BS   "5bs"
+#define TSRK3W    "3w"
+#define TSRK4CK   "4ck"
+#define TSRK3SSP  "3ssp"
+#define TSRK4SSP  "4ssp"
 
 PETSC_EXTERN PetscErrorCode TSRKGetType(TS ts,TSRKType*);
 PETSC_EXTERN PetscErrorCode TSRKSetType(TS ts,TSRKType);
 PETSC_EXTERN PetscErrorCode TSRKSetFullyImplicit(TS,PetscBool);
 PETSC_EXTERN PetscErrorCode TSRKRegister(TSRKType,PetscInt,PetscInt,const PetscReal[],const PetscReal[],const PetscReal[],const PetscReal[],PetscInt,const PetscReal[]);
+PETSC_EXTERN PetscErrorCode TSRKRegister2N(TSRKType,PetscInt,PetscInt,const PetscReal[],const PetscReal[],const PetscReal[]);
+PETSC_EXTERN PetscErrorCode TSRKRegister3Sstar(TSRKType,PetscInt,PetscInt,const PetscReal[],const PetscReal[],const PetscReal[],const PetscReal[]);
 PETSC_EXTERN PetscErrorCode TSRKInitializePackage(void);
 PETSC_EXTERN PetscErrorCode TSRKFinalizePackage(void);
 PETSC_EXTERN PetscErrorCode TSRKRegisterDestroy(void);
@@ -833,6 +850,30 @@ PETSC_EXTERN PetscErrorCode TSRosWRegisterDestroy(void);
 PETSC_EXTERN PetscErrorCode TSBDFSetOrder(TS,PetscInt);
 PETSC_EXTERN PetscErrorCode TSBDFGetOrder(TS,PetscInt*);
 
+PETSC_EXTERN PetscErrorCode TSPararealSetTimeComm(TS,MPI_Comm);
+PETSC_EXTERN PetscErrorCode TSPararealGetFineTS(TS,TS*);
+PETSC_EXTERN PetscErrorCode TSPararealGetCoarseTS(TS,TS*);
+PETSC_EXTERN PetscErrorCode TSPararealGetIterationNumber(TS,PetscInt*);
+
+PETSC_EXTERN PetscErrorCode TSEnsembleGetStageTimes(TS,const PetscReal*[]);
+
+/*J
+    TSExpRBType - String with the name of an exponential Rosenbrock method.
+
+   Level: beginner
+
+.seealso: TSExpRBSetType(), TS, TSEXPRB
+J*/
+typedef const char* TSExpRBType;
+#define TSEXPRB2          "2"
+#define TSEXPRB32         "32"
+
+PETSC_EXTERN PetscErrorCode TSExpRBSetType(TS,TSExpRBType);
+PETSC_EXTERN PetscErrorCode TSExpRBGetType(TS,TSExpRBType*);
+
+PETSC_EXTERN PetscErrorCode TSMPRKSetRatio(TS,PetscInt);
+PETSC_EXTERN PetscErrorCode TSMPRKGetRatio(TS,PetscInt*);
+
 /*
        PETSc interface to Sundials
 */
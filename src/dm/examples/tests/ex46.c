@@ -0,0 +1,133 @@
+
+static char help[] = "Tests DMDACreateStencilMatrix() against the assembled matrix from DMCreateMatrix().\n\n\
+  -dim <d>        : dimension of the grid\n\
+  -dof <dof>      : number of components per grid point\n\
+  -box            : use a box instead of a star stencil\n\
+  -periodic       : use periodic boundaries\n\
+  -variable       : use coefficients that vary between grid points\n\n";
+
+#include <petscdm.h>
+#include <petscdmda.h>
+
+/* deterministic coefficients so that every parallel decomposition sees the same operator */
+static PetscScalar Coefficient(PetscInt s,PetscInt center,PetscInt npts,PetscInt c,PetscInt i,PetscInt j,PetscInt k,PetscBool variable)
+{
+  if (s == center) return 2.0*npts + (variable ? (i+j+k+c)%3 : 0);
+  return -1.0 - (variable ? 0.1*((i+2*j+3*k+s+c)%5) : 0.0);
+}
+
+int main(int argc,char **argv)
+{
+  DM               da,cda;
+  Mat              A,B;
+  Vec              x,y,z,b,C;
+  PetscInt         dim = 3,dof = 1,M = 9,npts,center = 0,s,c,i,j,k,xs,ys,zs,xm,ym,zm,Mg,Ng,Pg;
+  const MatStencil *st;
+  PetscScalar      *coef,*xa,*ca;
+  PetscReal        nrm,nrm0;
+  PetscBool        box = PETSC_FALSE,periodic = PETSC_FALSE,variable = PETSC_FALSE;
+  DMBoundaryType   bt;
+  PetscErrorCode   ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-M",&M,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-box",&box,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-periodic",&periodic,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-variable",&variable,NULL);CHKERRQ(ierr);
+  bt   = periodic ? DM_BOUNDARY_PERIODIC : DM_BOUNDARY_NONE;
+
+  if (dim == 1) {
+    ierr = DMDACreate1d(PETSC_COMM_WORLD,bt,M,dof,1,NULL,&da);CHKERRQ(ierr);
+  } else if (dim == 2) {
+    ierr = DMDACreate2d(PETSC_COMM_WORLD,bt,bt,box ? DMDA_STENCIL_BOX : DMDA_STENCIL_STAR,M,M+1,PETSC_DECIDE,PETSC_DECIDE,dof,1,NULL,NULL,&da);CHKERRQ(ierr);
+  } else {
+    ierr = DMDACreate3d(PETSC_COMM_WORLD,bt,bt,bt,box ? DMDA_STENCIL_BOX : DMDA_STENCIL_STAR,M,M+1,M+2,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,dof,1,NULL,NULL,NULL,&da);CHKERRQ(ierr);
+  }
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMDAGetInfo(da,0,&Mg,&Ng,&Pg,0,0,0,0,0,0,0,0,0);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(da,&xs,&ys,&zs,&xm,&ym,&zm);CHKERRQ(ierr);
+
+  ierr = DMDACreateStencilMatrix(da,&A);CHKERRQ(ierr);
+  ierr = DMDAStencilMatrixGetStencil(A,&npts,&st);CHKERRQ(ierr);
+  for (s=0; s<npts; s++) if (!st[s].i && !st[s].j && !st[s].k) center = s;
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Stencil with %D points, diagonal is point %D\n",npts,center);CHKERRQ(ierr);
+  if (variable) {
+    ierr = DMDAStencilMatrixGetCoefficientDM(A,&cda);CHKERRQ(ierr);
+    ierr = DMCreateGlobalVector(cda,&C);CHKERRQ(ierr);
+    ierr = VecGetArray(C,&ca);CHKERRQ(ierr);
+    for (k=zs; k<zs+zm; k++) for (j=ys; j<ys+ym; j++) for (i=xs; i<xs+xm; i++) {
+      PetscInt q = ((k-zs)*ym + j-ys)*xm + i-xs;
+      for (s=0; s<npts; s++) for (c=0; c<dof; c++) ca[(q*npts+s)*dof+c] = Coefficient(s,center,npts,c,i,j,k,variable);
+    }
+    ierr = VecRestoreArray(C,&ca);CHKERRQ(ierr);
+    ierr = DMDAStencilMatrixSetCoefficients(A,C);CHKERRQ(ierr);
+    ierr = VecDestroy(&C);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMalloc1(npts*dof,&coef);CHKERRQ(ierr);
+    for (s=0; s<npts; s++) for (c=0; c<dof; c++) coef[s*dof+c] = Coefficient(s,center,npts,c,0,0,0,variable);
+    ierr = DMDAStencilMatrixSetConstantCoefficients(A,coef);CHKERRQ(ierr);
+    ierr = PetscFree(coef);CHKERRQ(ierr);
+  }
+
+  /* assemble the same operator */
+  ierr = DMCreateMatrix(da,&B);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  for (k=zs; k<zs+zm; k++) for (j=ys; j<ys+ym; j++) for (i=xs; i<xs+xm; i++) for (c=0; c<dof; c++) {
+    MatStencil row,col;
+    PetscScalar v;
+
+    row.i = i; row.j = j; row.k = k; row.c = c;
+    for (s=0; s<npts; s++) {
+      col.i = i+st[s].i; col.j = j+st[s].j; col.k = k+st[s].k; col.c = c;
+      if (!periodic && (col.i < 0 || col.i >= Mg || col.j < 0 || col.j >= Ng || col.k < 0 || col.k >= Pg)) continue;
+      v = Coefficient(s,center,npts,c,i,j,k,variable);
+      ierr = MatSetValuesStencil(B,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = DMCreateGlobalVector(da,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(x,&xa);CHKERRQ(ierr);
+  for (k=zs; k<zs+zm; k++) for (j=ys; j<ys+ym; j++) for (i=xs; i<xs+xm; i++) for (c=0; c<dof; c++) {
+    xa[(((k-zs)*ym + j-ys)*xm + i-xs)*dof+c] = PetscSinReal(1.0+i+3.0*j+7.0*k+c);
+  }
+  ierr = VecRestoreArray(x,&xa);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,z);CHKERRQ(ierr);
+  ierr = VecAXPY(z,-1.0,y);CHKERRQ(ierr);
+  ierr = VecNorm(z,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult %s\n",nrm < 1.e-12 ? "agrees" : "differs");CHKERRQ(ierr);
+
+  ierr = MatGetDiagonal(A,y);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(B,z);CHKERRQ(ierr);
+  ierr = VecAXPY(z,-1.0,y);CHKERRQ(ierr);
+  ierr = VecNorm(z,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatGetDiagonal %s\n",nrm < 1.e-12 ? "agrees" : "differs");CHKERRQ(ierr);
+
+  /* red-black relaxation on A x = b */
+  ierr = VecCopy(x,b);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&nrm0);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,1.0,(MatSORType)(SOR_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,5,1,y);CHKERRQ(ierr);
+  ierr = MatMult(B,y,z);CHKERRQ(ierr);
+  ierr = VecAYPX(z,-1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(z,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSOR %s the residual\n",nrm < 1.e-3*nrm0 ? "reduced" : "did not reduce");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,67 @@
+
+static char help[] = "Tests the structured ghost exchange of DMDA against the vector scatter.\n\n\
+  -dim <d>        : dimension of the grid\n\
+  -dof <dof>      : number of components per grid point\n\
+  -s <s>          : stencil width\n\
+  -box            : use a box instead of a star stencil\n\
+  -periodic       : use periodic boundaries\n\n";
+
+#include <petscdm.h>
+#include <petscdmda.h>
+
+int main(int argc,char **argv)
+{
+  DM             da;
+  Vec            g,l1,l2;
+  PetscInt       dim = 3,dof = 1,s = 1,M = 8,it;
+  PetscReal      nrm;
+  PetscBool      box = PETSC_FALSE,periodic = PETSC_FALSE;
+  DMBoundaryType bt;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-s",&s,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-M",&M,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-box",&box,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-periodic",&periodic,NULL);CHKERRQ(ierr);
+  bt   = periodic ? DM_BOUNDARY_PERIODIC : DM_BOUNDARY_GHOSTED;
+
+  if (dim == 1) {
+    ierr = DMDACreate1d(PETSC_COMM_WORLD,bt,M,dof,s,NULL,&da);CHKERRQ(ierr);
+  } else if (dim == 2) {
+    ierr = DMDACreate2d(PETSC_COMM_WORLD,bt,DM_BOUNDARY_NONE,box ? DMDA_STENCIL_BOX : DMDA_STENCIL_STAR,M,M+1,PETSC_DECIDE,PETSC_DECIDE,dof,s,NULL,NULL,&da);CHKERRQ(ierr);
+  } else {
+    ierr = DMDACreate3d(PETSC_COMM_WORLD,bt,DM_BOUNDARY_NONE,bt,box ? DMDA_STENCIL_BOX : DMDA_STENCIL_STAR,M,M+1,M+2,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,dof,s,NULL,NULL,NULL,&da);CHKERRQ(ierr);
+  }
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+
+  ierr = DMCreateGlobalVector(da,&g);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(da,&l1);CHKERRQ(ierr);
+  ierr = VecDuplicate(l1,&l2);CHKERRQ(ierr);
+  for (it=0; it<2; it++) {
+    ierr = VecSetRandom(g,NULL);CHKERRQ(ierr);
+    /* ghost values that are never filled keep this value in both vectors */
+    ierr = VecSet(l1,-1.0);CHKERRQ(ierr);
+    ierr = VecSet(l2,-1.0);CHKERRQ(ierr);
+    ierr = DMDASetStructuredHalo(da,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(da,g,INSERT_VALUES,l1);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da,g,INSERT_VALUES,l1);CHKERRQ(ierr);
+    ierr = DMDASetStructuredHalo(da,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(da,g,INSERT_VALUES,l2);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da,g,INSERT_VALUES,l2);CHKERRQ(ierr);
+    ierr = VecAXPY(l2,-1.0,l1);CHKERRQ(ierr);
+    ierr = VecNorm(l2,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nrm,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Local vectors %s\n",nrm == 0.0 ? "agree" : "differ");CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&g);CHKERRQ(ierr);
+  ierr = VecDestroy(&l1);CHKERRQ(ierr);
+  ierr = VecDestroy(&l2);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,108 @@
+
+static char help[] = "Tests the migration of DMSwarm points between cells.\n\n\
+  -shift <s>      : distance the points are moved in x before migrating (less than the width of a subdomain)\n\
+  -steps <n>      : number of migrations, the direction of the motion alternates\n\n";
+
+#include <petscdm.h>
+#include <petscdmda.h>
+#include <petscdmswarm.h>
+
+int main(int argc,char **argv)
+{
+  DM             celldm,swarm;
+  PetscInt       p,e,k,npoints,ncells,npc,nglobal0,nglobal,bs,*cellid,*owner,*list,step,steps = 2,nlost = 0,nbad = 0,nunsorted = 0;
+  PetscReal      *coor,*w,*scratch,shift = 0.13,dx;
+  PetscMPIInt    rank;
+  PetscBool      sorted;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-shift",&shift,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-steps",&steps,NULL);CHKERRQ(ierr);
+
+  ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DMDA_STENCIL_BOX,9,7,PETSC_DECIDE,PETSC_DECIDE,1,1,NULL,NULL,&celldm);CHKERRQ(ierr);
+  ierr = DMDASetElementType(celldm,DMDA_ELEMENT_Q1);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(celldm);CHKERRQ(ierr);
+  ierr = DMSetUp(celldm);CHKERRQ(ierr);
+  ierr = DMDASetUniformCoordinates(celldm,0.0,1.0,0.0,1.0,0.0,0.0);CHKERRQ(ierr);
+
+  ierr = DMCreate(PETSC_COMM_WORLD,&swarm);CHKERRQ(ierr);
+  ierr = DMSetType(swarm,DMSWARM);CHKERRQ(ierr);
+  ierr = DMSetDimension(swarm,2);CHKERRQ(ierr);
+  ierr = DMSwarmSetType(swarm,DMSWARM_PIC);CHKERRQ(ierr);
+  ierr = DMSwarmSetCellDM(swarm,celldm);CHKERRQ(ierr);
+  ierr = DMSwarmRegisterPetscDatatypeField(swarm,"w",1,PETSC_REAL);CHKERRQ(ierr);
+  ierr = DMSwarmRegisterPetscDatatypeField(swarm,"owner",1,PETSC_INT);CHKERRQ(ierr);
+  ierr = DMSwarmRegisterPetscDatatypeField(swarm,"scratch",1,PETSC_REAL);CHKERRQ(ierr);
+  ierr = DMSwarmFinalizeFieldRegister(swarm);CHKERRQ(ierr);
+  ierr = DMSwarmSetFieldMigrate(swarm,"scratch",PETSC_FALSE);CHKERRQ(ierr);
+  ierr = DMSwarmSetLocalSizes(swarm,4,0);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(swarm);CHKERRQ(ierr);
+  ierr = DMSwarmInsertPointsUsingCellDM(swarm,DMSWARMPIC_LAYOUT_REGULAR,2);CHKERRQ(ierr);
+
+  for (step=0; step<steps; step++) {
+    /* move every point to another cell, possibly owned by a neighboring rank, and tag it with a function of its new position */
+    dx   = (step % 2) ? -shift : shift;
+    ierr = DMSwarmGetLocalSize(swarm,&npoints);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,DMSwarmPICField_coor,&bs,NULL,(void**)&coor);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,"w",NULL,NULL,(void**)&w);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,"owner",NULL,NULL,(void**)&owner);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,"scratch",NULL,NULL,(void**)&scratch);CHKERRQ(ierr);
+    for (p=0; p<npoints; p++) {
+      coor[bs*p] += (coor[bs*p] + dx < 1.0 && coor[bs*p] + dx > 0.0) ? dx : -dx;
+      w[p]        = coor[bs*p] + 10.0*coor[bs*p+1];
+      owner[p]    = rank;
+      scratch[p]  = 1.0;
+    }
+    ierr = DMSwarmRestoreField(swarm,"scratch",NULL,NULL,(void**)&scratch);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,"owner",NULL,NULL,(void**)&owner);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,"w",NULL,NULL,(void**)&w);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,DMSwarmPICField_coor,&bs,NULL,(void**)&coor);CHKERRQ(ierr);
+
+    ierr = DMSwarmGetSize(swarm,&nglobal0);CHKERRQ(ierr);
+    ierr = DMSwarmMigrate(swarm,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = DMSwarmGetSize(swarm,&nglobal);CHKERRQ(ierr);
+    if (nglobal != nglobal0) nlost++;
+
+    /* the fields must still describe the same points, only the points which stayed keep the field which is not migrated */
+    ierr = DMSwarmSortGetAccess(swarm);CHKERRQ(ierr);
+    ierr = DMSwarmSortGetSizes(swarm,&ncells,NULL);CHKERRQ(ierr);
+    ierr = DMSwarmGetLocalSize(swarm,&npoints);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,DMSwarmPICField_cellid,NULL,NULL,(void**)&cellid);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,DMSwarmPICField_coor,&bs,NULL,(void**)&coor);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,"w",NULL,NULL,(void**)&w);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,"owner",NULL,NULL,(void**)&owner);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(swarm,"scratch",NULL,NULL,(void**)&scratch);CHKERRQ(ierr);
+    for (p=0; p<npoints; p++) {
+      if (p && cellid[p] < cellid[p-1]) nunsorted++;
+      if (cellid[p] < 0 || cellid[p] >= ncells) nbad++;
+      if (PetscAbsReal(w[p] - (coor[bs*p] + 10.0*coor[bs*p+1])) > 1.0e-12) nbad++;
+      if (scratch[p] != (owner[p] == rank ? 1.0 : 0.0)) nbad++;
+    }
+    ierr = DMSwarmRestoreField(swarm,"scratch",NULL,NULL,(void**)&scratch);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,"owner",NULL,NULL,(void**)&owner);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,"w",NULL,NULL,(void**)&w);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,DMSwarmPICField_coor,&bs,NULL,(void**)&coor);CHKERRQ(ierr);
+    ierr = DMSwarmRestoreField(swarm,DMSwarmPICField_cellid,NULL,NULL,(void**)&cellid);CHKERRQ(ierr);
+
+    /* with a cell sorted layout the points of each cell are consecutive */
+    for (e=0,p=0; e<ncells; e++) {
+      ierr = DMSwarmSortGetPointsPerCell(swarm,e,&npc,&list);CHKERRQ(ierr);
+      for (k=0; k<npc; k++,p++) if (list[k] != p) nunsorted++;
+      ierr = PetscFree(list);CHKERRQ(ierr);
+    }
+    ierr = DMSwarmSortRestoreAccess(swarm);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Number of points %s\n",nlost ? "changed" : "conserved");CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nbad,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Fields %s consistent\n",nbad ? "are not" : "are");CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nunsorted,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  sorted = nunsorted ? PETSC_FALSE : PETSC_TRUE;
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Fields %s stored by cell\n",sorted ? "are" : "are not");CHKERRQ(ierr);
+
+  ierr = DMDestroy(&swarm);CHKERRQ(ierr);
+  ierr = DMDestroy(&celldm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
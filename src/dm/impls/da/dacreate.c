@@ -76,6 +76,7 @@ PetscErrorCode  DMSetFromOptions_DA(PetscOptionItems *PetscOptionsObject,DM da)
   }
 
   ierr = PetscOptionsInt("-da_refine","Uniformly refine DA one or more times","None",refine,&refine,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-da_structured_halo","Use a ghost exchange built from the box geometry in DMGlobalToLocal()","DMDASetStructuredHalo",dd->usehalo,&dd->usehalo,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
 
   while (refine--) {
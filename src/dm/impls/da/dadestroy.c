@@ -65,6 +65,7 @@ PetscErrorCode  DMDestroy_DA(DM da)
 
   ierr = VecScatterDestroy(&dd->gtol);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&dd->ltol);CHKERRQ(ierr);
+  ierr = DMDAHaloDestroy_Private(da);CHKERRQ(ierr);
   ierr = VecDestroy(&dd->natural);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&dd->gton);CHKERRQ(ierr);
   ierr = AODestroy(&dd->ao);CHKERRQ(ierr);
@@ -5,6 +5,16 @@
 
 #include <petsc/private/dmdaimpl.h>    /*I   "petscdmda.h"   I*/
 
+/* whether this global-to-local update goes through the structured ghost exchange of dahalo.c */
+PETSC_STATIC_INLINE PetscBool DMDAUseHalo_Private(DM_DA *dd,InsertMode mode)
+{
+  if (!dd->usehalo || mode != INSERT_VALUES) return PETSC_FALSE;
+  if (dd->bx == DM_BOUNDARY_MIRROR || dd->by == DM_BOUNDARY_MIRROR || dd->bz == DM_BOUNDARY_MIRROR) return PETSC_FALSE;
+  if (dd->bx == DM_BOUNDARY_TWIST || dd->by == DM_BOUNDARY_TWIST || dd->bz == DM_BOUNDARY_TWIST) return PETSC_FALSE;
+  if (dd->xol || dd->yol || dd->zol) return PETSC_FALSE;
+  return PETSC_TRUE;
+}
+
 PetscErrorCode  DMGlobalToLocalBegin_DA(DM da,Vec g,InsertMode mode,Vec l)
 {
   PetscErrorCode ierr;
@@ -14,7 +24,11 @@ PetscErrorCode  DMGlobalToLocalBegin_DA(DM da,Vec g,InsertMode mode,Vec l)
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
   PetscValidHeaderSpecific(g,VEC_CLASSID,2);
   PetscValidHeaderSpecific(l,VEC_CLASSID,4);
-  ierr = VecScatterBegin(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  if (DMDAUseHalo_Private(dd,mode)) {
+    ierr = DMDAHaloBegin_Private(da,g,l);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterBegin(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -28,7 +42,11 @@ PetscErrorCode  DMGlobalToLocalEnd_DA(DM da,Vec g,InsertMode mode,Vec l)
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
   PetscValidHeaderSpecific(g,VEC_CLASSID,2);
   PetscValidHeaderSpecific(l,VEC_CLASSID,4);
-  ierr = VecScatterEnd(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  if (DMDAUseHalo_Private(dd,mode)) {
+    ierr = DMDAHaloEnd_Private(da,g,l);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterEnd(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
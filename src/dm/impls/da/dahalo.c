@@ -0,0 +1,248 @@
+/*
+    Structured ghost point exchange for DMGlobalToLocalBegin/End() on a DMDA.
+
+    Instead of the general VecScatter, whose index arrays grow with the ghost region, each face, edge and corner
+  of the ghost region is described by an MPI subarray datatype built from the box geometry alone. Values are sent
+  straight out of the global array and received straight into the local array, the owned values are copied row by
+  row. With DMDA_STENCIL_STAR only the faces are exchanged.
+*/
+#include <petsc/private/dmdaimpl.h>    /*I   "petscdmda.h"   I*/
+
+struct _n_DMDAHalo {
+  PetscInt          n;              /* number of messages in each direction */
+  PetscMPIInt       *rank,*stag,*rtag;
+  MPI_Datatype      *send,*recv;    /* regions of the global and of the local array */
+  MPI_Request       *req;           /* receives followed by sends */
+  const PetscScalar *garray;        /* arrays held between DMDAHaloBegin_Private() and DMDAHaloEnd_Private() */
+  PetscScalar       *larray;
+  Vec               g,l;
+};
+
+/* start and width along one axis of the region of an owned box [s,e) lying in direction d; w is the ghost width */
+PETSC_STATIC_INLINE void DMDAHaloRange_Private(PetscInt d,PetscInt s,PetscInt e,PetscInt w,PetscInt *start,PetscInt *width)
+{
+  if (d < 0)       {*start = s;   *width = w;}
+  else if (d == 0) {*start = s;   *width = e-s;}
+  else             {*start = e-w; *width = w;}
+}
+
+/* rank of the process offset by (dx,dy,dz) in the process grid, or -1 if there is none */
+static PetscMPIInt DMDAHaloNeighbor_Private(DM_DA *dd,PetscMPIInt rank,PetscInt dx,PetscInt dy,PetscInt dz)
+{
+  PetscInt pi = rank % dd->m + dx,pj = (rank/dd->m) % dd->n + dy,pk = rank/(dd->m*dd->n) + dz;
+
+  if (pi < 0 || pi >= dd->m) {
+    if (dd->bx != DM_BOUNDARY_PERIODIC) return -1;
+    pi = (pi + dd->m) % dd->m;
+  }
+  if (pj < 0 || pj >= dd->n) {
+    if (dd->by != DM_BOUNDARY_PERIODIC) return -1;
+    pj = (pj + dd->n) % dd->n;
+  }
+  if (pk < 0 || pk >= dd->p) {
+    if (dd->bz != DM_BOUNDARY_PERIODIC) return -1;
+    pk = (pk + dd->p) % dd->p;
+  }
+  return (PetscMPIInt)(pi + dd->m*(pj + dd->n*pk));
+}
+
+static PetscErrorCode DMDAHaloSetUp_Private(DM da)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAHalo       halo;
+  MPI_Comm       comm;
+  PetscMPIInt    rank,nb,gsizes[3],lsizes[3],sub[3],gstarts[3],lstarts[3],tags[27];
+  PetscInt       dim = da->dim,dof = dd->w,s = dd->s,xs,ys,zs,xm,ym,zm,gxs,gys,gzs,gxm,gym,gzm;
+  PetscInt       dx,dy,dz,st,w,n = 0,t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)da,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(da,&xs,&ys,&zs,&xm,&ym,&zm);CHKERRQ(ierr);
+  ierr = DMDAGetGhostCorners(da,&gxs,&gys,&gzs,&gxm,&gym,&gzm);CHKERRQ(ierr);
+  /* every process asks for the same tags, one per direction of travel */
+  for (t=0; t<27; t++) {ierr = PetscObjectGetNewTag((PetscObject)da,&tags[t]);CHKERRQ(ierr);}
+
+  ierr = PetscNew(&halo);CHKERRQ(ierr);
+  ierr = PetscMalloc5(26,&halo->rank,26,&halo->stag,26,&halo->rtag,26,&halo->send,26,&halo->recv);CHKERRQ(ierr);
+  ierr = PetscMalloc1(52,&halo->req);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(zm,&gsizes[0]);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(ym,&gsizes[1]);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(xm*dof,&gsizes[2]);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(gzm,&lsizes[0]);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(gym,&lsizes[1]);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(gxm*dof,&lsizes[2]);CHKERRQ(ierr);
+  for (dz=(dim > 2 ? -1 : 0); dz<=(dim > 2 ? 1 : 0); dz++) {
+    for (dy=(dim > 1 ? -1 : 0); dy<=(dim > 1 ? 1 : 0); dy++) {
+      for (dx=-1; dx<=1; dx++) {
+        if (!dx && !dy && !dz) continue;
+        if (dd->stencil_type == DMDA_STENCIL_STAR && (dx != 0) + (dy != 0) + (dz != 0) > 1) continue;
+        nb = DMDAHaloNeighbor_Private(dd,rank,dx,dy,dz);
+        if (nb < 0) continue;
+        halo->rank[n] = nb;
+        /* the message travelling in direction (dx,dy,dz) is tagged by that direction on both ends */
+        halo->stag[n] = tags[(dz+1)*9 + (dy+1)*3 + dx+1];
+        halo->rtag[n] = tags[(1-dz)*9 + (1-dy)*3 + 1-dx];
+
+        /* the owned values lying in the neighbour's ghost region */
+        DMDAHaloRange_Private(dx,0,xm,s,&st,&w);
+        gstarts[2] = (PetscMPIInt)(st*dof); sub[2] = (PetscMPIInt)(w*dof);
+        DMDAHaloRange_Private(dy,0,ym,s,&st,&w);
+        gstarts[1] = (PetscMPIInt)st; sub[1] = (PetscMPIInt)w;
+        DMDAHaloRange_Private(dz,0,zm,s,&st,&w);
+        gstarts[0] = (PetscMPIInt)st; sub[0] = (PetscMPIInt)w;
+        ierr = MPI_Type_create_subarray(3,gsizes,sub,gstarts,MPI_ORDER_C,MPIU_SCALAR,&halo->send[n]);CHKERRQ(ierr);
+        ierr = MPI_Type_commit(&halo->send[n]);CHKERRQ(ierr);
+
+        /* our ghost region on the side of the neighbour, the ghost region starts one stencil width before the owned box */
+        DMDAHaloRange_Private(dx,xs-gxs,xs-gxs+xm,s,&st,&w);
+        if (dx < 0) st -= s; else if (dx > 0) st += s;
+        lstarts[2] = (PetscMPIInt)(st*dof); sub[2] = (PetscMPIInt)(w*dof);
+        DMDAHaloRange_Private(dy,ys-gys,ys-gys+ym,s,&st,&w);
+        if (dy < 0) st -= s; else if (dy > 0) st += s;
+        lstarts[1] = (PetscMPIInt)st; sub[1] = (PetscMPIInt)w;
+        DMDAHaloRange_Private(dz,zs-gzs,zs-gzs+zm,s,&st,&w);
+        if (dz < 0) st -= s; else if (dz > 0) st += s;
+        lstarts[0] = (PetscMPIInt)st; sub[0] = (PetscMPIInt)w;
+        ierr = MPI_Type_create_subarray(3,lsizes,sub,lstarts,MPI_ORDER_C,MPIU_SCALAR,&halo->recv[n]);CHKERRQ(ierr);
+        ierr = MPI_Type_commit(&halo->recv[n]);CHKERRQ(ierr);
+        n++;
+      }
+    }
+  }
+  halo->n  = n;
+  dd->halo = halo;
+  ierr = PetscInfo2(da,"Structured ghost exchange with %D messages each way for %D ghost values\n",n,dd->nlocal-dd->Nlocal);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAHaloDestroy_Private(DM da)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAHalo       halo = dd->halo;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!halo) PetscFunctionReturn(0);
+  for (i=0; i<halo->n; i++) {
+    ierr = MPI_Type_free(&halo->send[i]);CHKERRQ(ierr);
+    ierr = MPI_Type_free(&halo->recv[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree5(halo->rank,halo->stag,halo->rtag,halo->send,halo->recv);CHKERRQ(ierr);
+  ierr = PetscFree(halo->req);CHKERRQ(ierr);
+  ierr = PetscFree(dd->halo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAHaloBegin_Private(DM da,Vec g,Vec l)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAHalo       halo;
+  MPI_Comm       comm;
+  PetscInt       i,j,k,xs,ys,zs,xm,ym,zm,gxs,gys,gzs,gxm,gym,gzm,dof = dd->w;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!dd->halo) {ierr = DMDAHaloSetUp_Private(da);CHKERRQ(ierr);}
+  halo = dd->halo;
+  if (halo->g) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONGSTATE,"DMGlobalToLocalEnd() must be called before starting another ghost exchange on this DMDA");
+  ierr = PetscObjectGetComm((PetscObject)da,&comm);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(g,&halo->garray);CHKERRQ(ierr);
+  ierr = VecGetArray(l,&halo->larray);CHKERRQ(ierr);
+  halo->g = g;
+  halo->l = l;
+  for (i=0; i<halo->n; i++) {
+    ierr = MPI_Irecv(halo->larray,1,halo->recv[i],halo->rank[i],halo->rtag[i],comm,&halo->req[i]);CHKERRQ(ierr);
+  }
+  for (i=0; i<halo->n; i++) {
+    ierr = MPI_Isend((void*)halo->garray,1,halo->send[i],halo->rank[i],halo->stag[i],comm,&halo->req[halo->n+i]);CHKERRQ(ierr);
+  }
+  /* owned values, one contiguous row at a time, while the messages are in flight */
+  ierr = DMDAGetCorners(da,&xs,&ys,&zs,&xm,&ym,&zm);CHKERRQ(ierr);
+  ierr = DMDAGetGhostCorners(da,&gxs,&gys,&gzs,&gxm,&gym,&gzm);CHKERRQ(ierr);
+  for (k=0; k<zm; k++) {
+    for (j=0; j<ym; j++) {
+      ierr = PetscMemcpy(halo->larray + (((k+zs-gzs)*gym + j+ys-gys)*gxm + xs-gxs)*dof,halo->garray + ((k*ym + j)*xm)*dof,xm*dof*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAHaloEnd_Private(DM da,Vec g,Vec l)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAHalo       halo = dd->halo;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!halo || halo->g != g || halo->l != l) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONGSTATE,"DMGlobalToLocalEnd() must match the preceding DMGlobalToLocalBegin()");
+  if (halo->n) {ierr = MPI_Waitall(2*(PetscMPIInt)halo->n,halo->req,MPI_STATUSES_IGNORE);CHKERRQ(ierr);}
+  ierr = VecRestoreArrayRead(g,&halo->garray);CHKERRQ(ierr);
+  ierr = VecRestoreArray(l,&halo->larray);CHKERRQ(ierr);
+  halo->g = NULL;
+  halo->l = NULL;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDASetStructuredHalo - Sets whether DMGlobalToLocalBegin() and DMGlobalToLocalEnd() use a ghost exchange built from the
+   box geometry instead of the general vector scatter
+
+   Logically Collective on DMDA
+
+   Input Parameters:
++  da - the distributed array
+-  flg - PETSC_TRUE to use the structured exchange
+
+   Options Database Key:
+.  -da_structured_halo - use the structured exchange
+
+   Level: intermediate
+
+   Notes:
+   The structured exchange sends each face (and, for DMDA_STENCIL_BOX, each edge and corner) of the ghost region with an
+   MPI subarray datatype, so it needs no index arrays and packs nothing by hand. It is used for INSERT_VALUES; other insert
+   modes, DMLocalToGlobalBegin(), mirror and twist boundaries and DMDAs with overlapping subdomains keep using the vector scatter.
+
+.keywords: distributed array, ghost points, communication
+
+.seealso: DMDAGetStructuredHalo(), DMGlobalToLocalBegin(), DMGlobalToLocalEnd(), DMDAGetScatter()
+@*/
+PetscErrorCode DMDASetStructuredHalo(DM da,PetscBool flg)
+{
+  DM_DA *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(da,DM_CLASSID,1);
+  PetscValidLogicalCollectiveBool(da,flg,2);
+  dd->usehalo = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAGetStructuredHalo - Gets whether the structured ghost exchange is used by DMGlobalToLocalBegin() and DMGlobalToLocalEnd()
+
+   Not Collective
+
+   Input Parameter:
+.  da - the distributed array
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the structured exchange is used
+
+   Level: intermediate
+
+.seealso: DMDASetStructuredHalo()
+@*/
+PetscErrorCode DMDAGetStructuredHalo(DM da,PetscBool *flg)
+{
+  DM_DA *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(da,DM_CLASSID,1);
+  PetscValidPointer(flg,2);
+  *flg = dd->usehalo;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,567 @@
+/*
+    Matrix-free application of constant or variable coefficient stencils on a DMDA.
+
+    The operator is stored as one coefficient per stencil point (and component) instead of an assembled AIJ
+  matrix. The interior of each process's box is swept directly out of the global vector, tile by tile, while
+  the ghost values are in flight; the remaining shell of points is swept from the ghosted vector afterwards.
+*/
+#include <petsc/private/dmdaimpl.h>     /*I  "petscdmda.h"   I*/
+
+typedef struct {
+  DM             da;                      /* grid the operator lives on */
+  DM             cda;                     /* DMDA with npts*dof fields holding per-point coefficients */
+  PetscInt       dim,dof,M,N,P;
+  DMBoundaryType bx,by,bz;
+  PetscInt       xs,ys,zs,xm,ym,zm;       /* owned box */
+  PetscInt       gxs,gys,gzs,gxm,gym,gzm; /* ghosted box */
+  PetscInt       npts,center;             /* number of stencil points and index of the diagonal one */
+  MatStencil     *stencil;                /* offsets of the stencil points, the c entry is unused */
+  PetscInt       *goff,*loff;             /* offset of each stencil point in the global and in the ghosted array */
+  PetscInt       *all,*act;               /* list of all stencil points and work space for the active ones */
+  PetscBool      constant;
+  PetscScalar    *crow;                   /* constant coefficients replicated along an x row, [npts][xm*dof] */
+  PetscScalar    *vcoef;                  /* coefficients of the owned points, [npts][xm*ym*zm*dof] */
+  PetscInt       tj,tk;                   /* tile sizes in y and z used for the interior sweep */
+  Vec            xl;                      /* ghosted work vector */
+} Mat_DAStencil;
+
+#define DAStencilGlobalIndex(st,i,j,k) (((((k)-(st)->zs)*(st)->ym + (j)-(st)->ys)*(st)->xm + (i)-(st)->xs)*(st)->dof)
+#define DAStencilLocalIndex(st,i,j,k)  (((((k)-(st)->gzs)*(st)->gym + (j)-(st)->gys)*(st)->gxm + (i)-(st)->gxs)*(st)->dof)
+
+PETSC_STATIC_INLINE PetscBool DAStencilInDomain(PetscInt i,PetscInt M,DMBoundaryType b)
+{
+  return (b == DM_BOUNDARY_PERIODIC || (i >= 0 && i < M)) ? PETSC_TRUE : PETSC_FALSE;
+}
+
+/* coefficients of stencil point s for the owned point (i,j,k), consecutive entries belong to consecutive points of the x row */
+PETSC_STATIC_INLINE const PetscScalar *DAStencilCoefficients(Mat_DAStencil *st,PetscInt s,PetscInt i,PetscInt j,PetscInt k)
+{
+  if (st->constant) return st->crow + (s*st->xm + i - st->xs)*st->dof;
+  return st->vcoef + s*st->xm*st->ym*st->zm*st->dof + DAStencilGlobalIndex(st,i,j,k);
+}
+
+/*
+   y[0:n] = sum over the active stencil points s of coef_s[0:n]*x[xoff[s]:xoff[s]+n]
+
+   x and y point at the first entry of a contiguous piece of an x row; every access has unit stride so the
+   inner loop vectorizes.
+*/
+static void DAStencilApply_Kernel(Mat_DAStencil *st,PetscInt n,PetscInt nact,const PetscInt act[],const PetscInt xoff[],PetscInt i,PetscInt j,PetscInt k,const PetscScalar *x,PetscScalar *PETSC_RESTRICT y)
+{
+  PetscInt a,e;
+
+  for (e=0; e<n; e++) y[e] = 0.0;
+  for (a=0; a<nact; a++) {
+    const PetscScalar *PETSC_RESTRICT c  = DAStencilCoefficients(st,act[a],i,j,k);
+    const PetscScalar *PETSC_RESTRICT xa = x + xoff[act[a]];
+
+    PetscPragmaSIMD
+    for (e=0; e<n; e++) y[e] += c[e]*xa[e];
+  }
+}
+
+/* applies the stencil to the owned points [ia,ib) of the row (j,k), reading the ghosted array and dropping neighbours outside the grid */
+static void DAStencilApplyLocalRow_Private(Mat_DAStencil *st,PetscInt ia,PetscInt ib,PetscInt j,PetscInt k,const PetscScalar *xl,PetscScalar *y)
+{
+  PetscInt *act = st->act,*pact = st->act + st->npts,nact = 0,npact,mlo = ia,mhi = ib,s,a,i;
+
+  for (s=0; s<st->npts; s++) {
+    if (DAStencilInDomain(j+st->stencil[s].j,st->N,st->by) && DAStencilInDomain(k+st->stencil[s].k,st->P,st->bz)) act[nact++] = s;
+  }
+  if (st->bx != DM_BOUNDARY_PERIODIC) {
+    mlo = PetscMax(ia,1);
+    mhi = PetscMin(ib,st->M-1);
+  }
+  for (i=ia; i<ib; i++) {
+    if (i >= mlo && i < mhi) continue;
+    for (a=0,npact=0; a<nact; a++) {
+      if (DAStencilInDomain(i+st->stencil[act[a]].i,st->M,st->bx)) pact[npact++] = act[a];
+    }
+    DAStencilApply_Kernel(st,st->dof,npact,pact,st->loff,i,j,k,xl+DAStencilLocalIndex(st,i,j,k),y+DAStencilGlobalIndex(st,i,j,k));
+  }
+  if (mhi > mlo) DAStencilApply_Kernel(st,(mhi-mlo)*st->dof,nact,act,st->loff,mlo,j,k,xl+DAStencilLocalIndex(st,mlo,j,k),y+DAStencilGlobalIndex(st,mlo,j,k));
+}
+
+/* the owned points whose entire stencil is owned by this process */
+static void DAStencilGetInterior_Private(Mat_DAStencil *st,PetscInt *ilo,PetscInt *ihi,PetscInt *jlo,PetscInt *jhi,PetscInt *klo,PetscInt *khi)
+{
+  *ilo = st->xs+1; *ihi = st->xs+st->xm-1;
+  *jlo = st->ys;   *jhi = st->ys+st->ym;
+  *klo = st->zs;   *khi = st->zs+st->zm;
+  if (st->dim > 1) {(*jlo)++; (*jhi)--;}
+  if (st->dim > 2) {(*klo)++; (*khi)--;}
+  if (*jhi <= *jlo || *khi <= *klo) *ihi = *ilo;
+}
+
+static PetscErrorCode MatMult_DAStencil(Mat A,Vec x,Vec y)
+{
+  Mat_DAStencil     *st;
+  const PetscScalar *xa;
+  PetscScalar       *ya;
+  PetscInt          ilo,ihi,jlo,jhi,klo,khi,jt,kt,j,k;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  if (!st->crow && !st->vcoef) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONGSTATE,"Must call DMDAStencilMatrixSetConstantCoefficients() or DMDAStencilMatrixSetCoefficients() first");
+  ierr = DMGlobalToLocalBegin(st->da,x,INSERT_VALUES,st->xl);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&ya);CHKERRQ(ierr);
+
+  /* overlap the ghost exchange with the points that need no ghost values */
+  DAStencilGetInterior_Private(st,&ilo,&ihi,&jlo,&jhi,&klo,&khi);
+  if (ihi > ilo) {
+    ierr = VecGetArrayRead(x,&xa);CHKERRQ(ierr);
+    for (kt=klo; kt<khi; kt+=st->tk) {
+      for (jt=jlo; jt<jhi; jt+=st->tj) {
+        for (k=kt; k<PetscMin(kt+st->tk,khi); k++) {
+          for (j=jt; j<PetscMin(jt+st->tj,jhi); j++) {
+            const PetscInt g = DAStencilGlobalIndex(st,ilo,j,k);
+
+            DAStencilApply_Kernel(st,(ihi-ilo)*st->dof,st->npts,st->all,st->goff,ilo,j,k,xa+g,ya+g);
+          }
+        }
+      }
+    }
+    ierr = VecRestoreArrayRead(x,&xa);CHKERRQ(ierr);
+  }
+  ierr = DMGlobalToLocalEnd(st->da,x,INSERT_VALUES,st->xl);CHKERRQ(ierr);
+
+  ierr = VecGetArrayRead(st->xl,&xa);CHKERRQ(ierr);
+  for (k=st->zs; k<st->zs+st->zm; k++) {
+    for (j=st->ys; j<st->ys+st->ym; j++) {
+      if (ihi > ilo && j >= jlo && j < jhi && k >= klo && k < khi) {
+        DAStencilApplyLocalRow_Private(st,st->xs,ilo,j,k,xa,ya);
+        DAStencilApplyLocalRow_Private(st,ihi,st->xs+st->xm,j,k,xa,ya);
+      } else {
+        DAStencilApplyLocalRow_Private(st,st->xs,st->xs+st->xm,j,k,xa,ya);
+      }
+    }
+  }
+  ierr = VecRestoreArrayRead(st->xl,&xa);CHKERRQ(ierr);
+  ierr = VecRestoreArray(y,&ya);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*st->npts*st->dof*st->xm*st->ym*st->zm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetDiagonal_DAStencil(Mat A,Vec d)
+{
+  Mat_DAStencil  *st;
+  PetscScalar    *da;
+  PetscInt       j,k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  if (!st->crow && !st->vcoef) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONGSTATE,"Must call DMDAStencilMatrixSetConstantCoefficients() or DMDAStencilMatrixSetCoefficients() first");
+  ierr = VecGetArray(d,&da);CHKERRQ(ierr);
+  for (k=st->zs; k<st->zs+st->zm; k++) {
+    for (j=st->ys; j<st->ys+st->ym; j++) {
+      ierr = PetscMemcpy(da+DAStencilGlobalIndex(st,st->xs,j,k),DAStencilCoefficients(st,st->center,st->xs,j,k),st->xm*st->dof*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
+  }
+  ierr = VecRestoreArray(d,&da);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Red-black relaxation: the points are colored by the parity of i+j+k and each half sweep updates one color from
+   freshly exchanged ghost values. For star stencils this is exactly Gauss-Seidel in red-black ordering; for box
+   stencils points of the same color are coupled and are relaxed Jacobi style. Either way the result does not
+   depend on the parallel decomposition.
+*/
+static PetscErrorCode MatSOR_DAStencil(Mat A,Vec b,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec x)
+{
+  Mat_DAStencil     *st;
+  const PetscScalar *ba,*xl;
+  PetscScalar       *xa;
+  PetscInt          colors[4],ncolors,it,n,i,j,k,s,c;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  if (!st->crow && !st->vcoef) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONGSTATE,"Must call DMDAStencilMatrixSetConstantCoefficients() or DMDAStencilMatrixSetCoefficients() first");
+  if (flag & (SOR_EISENSTAT | SOR_APPLY_UPPER | SOR_APPLY_LOWER)) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"Only forward, backward and symmetric red-black sweeps are supported");
+  if ((flag & SOR_SYMMETRIC_SWEEP) == SOR_SYMMETRIC_SWEEP || (flag & SOR_LOCAL_SYMMETRIC_SWEEP) == SOR_LOCAL_SYMMETRIC_SWEEP) {
+    colors[0] = 0; colors[1] = 1; colors[2] = 1; colors[3] = 0; ncolors = 4;
+  } else if (flag & (SOR_FORWARD_SWEEP | SOR_LOCAL_FORWARD_SWEEP)) {
+    colors[0] = 0; colors[1] = 1; ncolors = 2;
+  } else if (flag & (SOR_BACKWARD_SWEEP | SOR_LOCAL_BACKWARD_SWEEP)) {
+    colors[0] = 1; colors[1] = 0; ncolors = 2;
+  } else SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONG,"Unknown SOR type %D",(PetscInt)flag);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = VecSet(x,0.0);CHKERRQ(ierr);}
+
+  for (it=0; it<its*lits; it++) {
+    for (n=0; n<ncolors; n++) {
+      ierr = DMGlobalToLocalBegin(st->da,x,INSERT_VALUES,st->xl);CHKERRQ(ierr);
+      ierr = DMGlobalToLocalEnd(st->da,x,INSERT_VALUES,st->xl);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(st->xl,&xl);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(b,&ba);CHKERRQ(ierr);
+      ierr = VecGetArray(x,&xa);CHKERRQ(ierr);
+      for (k=st->zs; k<st->zs+st->zm; k++) {
+        for (j=st->ys; j<st->ys+st->ym; j++) {
+          for (i=st->xs+(st->xs+j+k+colors[n])%2; i<st->xs+st->xm; i+=2) {
+            const PetscInt    g = DAStencilGlobalIndex(st,i,j,k),l = DAStencilLocalIndex(st,i,j,k);
+            const PetscScalar *diag = DAStencilCoefficients(st,st->center,i,j,k);
+
+            for (c=0; c<st->dof; c++) {
+              PetscScalar sum = ba[g+c];
+
+              for (s=0; s<st->npts; s++) {
+                const MatStencil *o = &st->stencil[s];
+
+                if (s == st->center) continue;
+                if (!DAStencilInDomain(i+o->i,st->M,st->bx) || !DAStencilInDomain(j+o->j,st->N,st->by) || !DAStencilInDomain(k+o->k,st->P,st->bz)) continue;
+                sum -= DAStencilCoefficients(st,s,i,j,k)[c]*xl[l+st->loff[s]+c];
+              }
+              xa[g+c] = (1.0-omega)*xa[g+c] + omega*sum/(diag[c]+fshift);
+            }
+          }
+        }
+      }
+      ierr = VecRestoreArray(x,&xa);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(b,&ba);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(st->xl,&xl);CHKERRQ(ierr);
+    }
+    ierr = PetscLogFlops((2.0*st->npts+4.0)*st->dof*st->xm*st->ym*st->zm*ncolors/2);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMDAStencilMatrixSetConstantCoefficients_DAStencil(Mat A,const PetscScalar coef[])
+{
+  Mat_DAStencil  *st;
+  PetscInt       s,i,c;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  ierr = PetscFree(st->vcoef);CHKERRQ(ierr);
+  if (!st->crow) {ierr = PetscMalloc1(st->npts*st->xm*st->dof,&st->crow);CHKERRQ(ierr);}
+  for (s=0; s<st->npts; s++) {
+    for (i=0; i<st->xm; i++) {
+      for (c=0; c<st->dof; c++) st->crow[(s*st->xm+i)*st->dof+c] = coef[s*st->dof+c];
+    }
+  }
+  st->constant = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMDAStencilMatrixSetCoefficients_DAStencil(Mat A,Vec C)
+{
+  Mat_DAStencil     *st;
+  const PetscScalar *ca;
+  PetscInt          nown,n,q,s,c;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  nown = st->xm*st->ym*st->zm;
+  ierr = VecGetLocalSize(C,&n);CHKERRQ(ierr);
+  if (n != nown*st->npts*st->dof) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Coefficient vector has local size %D, expected %D; create it from DMDAStencilMatrixGetCoefficientDM()",n,nown*st->npts*st->dof);
+  ierr = PetscFree(st->crow);CHKERRQ(ierr);
+  if (!st->vcoef) {ierr = PetscMalloc1(st->npts*nown*st->dof,&st->vcoef);CHKERRQ(ierr);}
+  /* transpose to one contiguous array per stencil point so the kernels stream with unit stride */
+  ierr = VecGetArrayRead(C,&ca);CHKERRQ(ierr);
+  for (q=0; q<nown; q++) {
+    for (s=0; s<st->npts; s++) {
+      for (c=0; c<st->dof; c++) st->vcoef[(s*nown+q)*st->dof+c] = ca[(q*st->npts+s)*st->dof+c];
+    }
+  }
+  ierr = VecRestoreArrayRead(C,&ca);CHKERRQ(ierr);
+  st->constant = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMDAStencilMatrixGetCoefficientDM_DAStencil(Mat A,DM *cdm)
+{
+  Mat_DAStencil  *st;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  *cdm = st->cda;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMDAStencilMatrixGetStencil_DAStencil(Mat A,PetscInt *npts,const MatStencil *stencil[])
+{
+  Mat_DAStencil  *st;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  if (npts)    *npts    = st->npts;
+  if (stencil) *stencil = st->stencil;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMDAStencilMatrixSetTileSize_DAStencil(Mat A,PetscInt tj,PetscInt tk)
+{
+  Mat_DAStencil  *st;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  if (tj == PETSC_DECIDE) {
+    /* keep the three x-y planes of a tile touched by a 3d stencil within a typical L2 cache */
+    tj = (256*1024)/(3*PetscMax(st->xm*st->dof,1)*(PetscInt)sizeof(PetscScalar));
+  }
+  if (tk == PETSC_DECIDE) tk = st->zm;
+  st->tj = PetscMax(tj,1);
+  st->tk = PetscMax(tk,1);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_DAStencil(Mat A)
+{
+  Mat_DAStencil  *st;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(A,(void**)&st);CHKERRQ(ierr);
+  ierr = VecDestroy(&st->xl);CHKERRQ(ierr);
+  ierr = DMDestroy(&st->cda);CHKERRQ(ierr);
+  ierr = DMDestroy(&st->da);CHKERRQ(ierr);
+  ierr = PetscFree5(st->stencil,st->goff,st->loff,st->all,st->act);CHKERRQ(ierr);
+  ierr = PetscFree(st->crow);CHKERRQ(ierr);
+  ierr = PetscFree(st->vcoef);CHKERRQ(ierr);
+  ierr = PetscFree(st);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"DMDAStencilMatrixSetConstantCoefficients_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"DMDAStencilMatrixSetCoefficients_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"DMDAStencilMatrixGetCoefficientDM_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"DMDAStencilMatrixGetStencil_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"DMDAStencilMatrixSetTileSize_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDACreateStencilMatrix - Creates a matrix-free operator that applies a 3, 5, 7, 9 or 27 point stencil on a DMDA
+
+   Collective on DMDA
+
+   Input Parameter:
+.  da - the distributed array, with a stencil width of at least one
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
++  -dm_da_stencil_tile_y <n> - number of rows in y per tile of the interior sweep, by default chosen to fit a 256 KB cache
+-  -dm_da_stencil_tile_z <n> - number of planes in z per tile of the interior sweep, by default all of them
+
+   Level: intermediate
+
+   Notes:
+   The stencil couples each grid point with its nearest neighbours: all of them for DMDA_STENCIL_BOX and only those along
+   the coordinate axes for DMDA_STENCIL_STAR. The coupling is diagonal in the components, that is component c of a point
+   only couples with component c of its neighbours. Use DMDAStencilMatrixGetStencil() to obtain the ordering of the stencil
+   points and provide the coefficients with DMDAStencilMatrixSetConstantCoefficients() or DMDAStencilMatrixSetCoefficients().
+
+   Neighbours outside a non-periodic grid are dropped, so the operator agrees with the matrix obtained by
+   assembling the same coefficients into the matrix from DMCreateMatrix().
+
+   The matrix supports MatMult(), MatGetDiagonal() and MatSOR(); the latter performs red-black relaxation, which is a
+   parallel Gauss-Seidel method for star stencils.
+
+.keywords: distributed array, matrix-free, stencil
+
+.seealso: DMDAStencilMatrixSetConstantCoefficients(), DMDAStencilMatrixSetCoefficients(), DMDAStencilMatrixGetStencil(), DMDAStencilMatrixSetTileSize(), DMCreateMatrix()
+@*/
+PetscErrorCode DMDACreateStencilMatrix(DM da,Mat *A)
+{
+  Mat_DAStencil   *st;
+  DMDAStencilType stype;
+  PetscInt        sw,di,dj,dk,nz,s;
+  PetscInt        tj = PETSC_DECIDE,tk = PETSC_DECIDE;
+  PetscBool       isda;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(da,DM_CLASSID,1);
+  PetscValidPointer(A,2);
+  ierr = PetscObjectTypeCompare((PetscObject)da,DMDA,&isda);CHKERRQ(ierr);
+  if (!isda) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONG,"Requires a DMDA");
+  if (!da->setupcalled) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ORDER,"You should call DMSetUp() first");
+
+  ierr = PetscNew(&st);CHKERRQ(ierr);
+  ierr = DMDAGetInfo(da,&st->dim,&st->M,&st->N,&st->P,0,0,0,&st->dof,&sw,&st->bx,&st->by,&st->bz,&stype);CHKERRQ(ierr);
+  if (sw < 1) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONG,"Requires a DMDA with stencil width of at least one");
+  ierr = DMDAGetCorners(da,&st->xs,&st->ys,&st->zs,&st->xm,&st->ym,&st->zm);CHKERRQ(ierr);
+  ierr = DMDAGetGhostCorners(da,&st->gxs,&st->gys,&st->gzs,&st->gxm,&st->gym,&st->gzm);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject)da);CHKERRQ(ierr);
+  st->da = da;
+
+  /* stencil points in lexicographic order of (k,j,i) offsets, i fastest */
+  ierr = PetscMalloc5(27,&st->stencil,27,&st->goff,27,&st->loff,27,&st->all,54,&st->act);CHKERRQ(ierr);
+  for (dk=(st->dim > 2 ? -1 : 0); dk<=(st->dim > 2 ? 1 : 0); dk++) {
+    for (dj=(st->dim > 1 ? -1 : 0); dj<=(st->dim > 1 ? 1 : 0); dj++) {
+      for (di=-1; di<=1; di++) {
+        nz = (di != 0) + (dj != 0) + (dk != 0);
+        if (stype == DMDA_STENCIL_STAR && nz > 1) continue;
+        s = st->npts++;
+        if (!nz) st->center = s;
+        st->stencil[s].i = di; st->stencil[s].j = dj; st->stencil[s].k = dk; st->stencil[s].c = 0;
+        st->goff[s] = ((dk*st->ym + dj)*st->xm + di)*st->dof;
+        st->loff[s] = ((dk*st->gym + dj)*st->gxm + di)*st->dof;
+        st->all[s]  = s;
+      }
+    }
+  }
+  ierr = DMCreateLocalVector(da,&st->xl);CHKERRQ(ierr);
+  ierr = DMDAGetReducedDMDA(da,st->npts*st->dof,&st->cda);CHKERRQ(ierr);
+
+  ierr = MatCreateShell(PetscObjectComm((PetscObject)da),st->xm*st->ym*st->zm*st->dof,st->xm*st->ym*st->zm*st->dof,PETSC_DETERMINE,PETSC_DETERMINE,st,A);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*A,MATOP_MULT,(void (*)(void))MatMult_DAStencil);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*A,MATOP_GET_DIAGONAL,(void (*)(void))MatGetDiagonal_DAStencil);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*A,MATOP_SOR,(void (*)(void))MatSOR_DAStencil);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*A,MATOP_DESTROY,(void (*)(void))MatDestroy_DAStencil);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)*A,"DMDAStencilMatrixSetConstantCoefficients_C",DMDAStencilMatrixSetConstantCoefficients_DAStencil);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)*A,"DMDAStencilMatrixSetCoefficients_C",DMDAStencilMatrixSetCoefficients_DAStencil);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)*A,"DMDAStencilMatrixGetCoefficientDM_C",DMDAStencilMatrixGetCoefficientDM_DAStencil);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)*A,"DMDAStencilMatrixGetStencil_C",DMDAStencilMatrixGetStencil_DAStencil);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)*A,"DMDAStencilMatrixSetTileSize_C",DMDAStencilMatrixSetTileSize_DAStencil);CHKERRQ(ierr);
+  ierr = MatSetDM(*A,da);CHKERRQ(ierr);
+
+  ierr = PetscObjectOptionsBegin((PetscObject)da);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-dm_da_stencil_tile_y","Rows in y per tile of the interior sweep","DMDAStencilMatrixSetTileSize",tj,&tj,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-dm_da_stencil_tile_z","Planes in z per tile of the interior sweep","DMDAStencilMatrixSetTileSize",tk,&tk,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  ierr = DMDAStencilMatrixSetTileSize_DAStencil(*A,tj,tk);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAStencilMatrixSetConstantCoefficients - Sets the same stencil coefficients at every grid point
+
+   Logically Collective on Mat
+
+   Input Parameters:
++  A - the matrix obtained with DMDACreateStencilMatrix()
+-  coef - the coefficients, coef[s*dof+c] multiplies component c of stencil point s
+
+   Level: intermediate
+
+.seealso: DMDACreateStencilMatrix(), DMDAStencilMatrixGetStencil(), DMDAStencilMatrixSetCoefficients()
+@*/
+PetscErrorCode DMDAStencilMatrixSetConstantCoefficients(Mat A,const PetscScalar coef[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidScalarPointer(coef,2);
+  ierr = PetscUseMethod(A,"DMDAStencilMatrixSetConstantCoefficients_C",(Mat,const PetscScalar[]),(A,coef));CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAStencilMatrixSetCoefficients - Sets stencil coefficients that vary from grid point to grid point
+
+   Collective on Mat
+
+   Input Parameters:
++  A - the matrix obtained with DMDACreateStencilMatrix()
+-  C - global vector of the DMDA returned by DMDAStencilMatrixGetCoefficientDM(); field s*dof+c at a grid point
+       multiplies component c of stencil point s
+
+   Level: intermediate
+
+   Notes:
+   The values are copied, call this routine again after changing C.
+
+.seealso: DMDACreateStencilMatrix(), DMDAStencilMatrixGetStencil(), DMDAStencilMatrixGetCoefficientDM(), DMDAStencilMatrixSetConstantCoefficients()
+@*/
+PetscErrorCode DMDAStencilMatrixSetCoefficients(Mat A,Vec C)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidHeaderSpecific(C,VEC_CLASSID,2);
+  ierr = PetscUseMethod(A,"DMDAStencilMatrixSetCoefficients_C",(Mat,Vec),(A,C));CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAStencilMatrixGetCoefficientDM - Gets the DMDA whose global vectors hold per-point stencil coefficients
+
+   Not Collective
+
+   Input Parameter:
+.  A - the matrix obtained with DMDACreateStencilMatrix()
+
+   Output Parameter:
+.  cdm - a DMDA with the layout of the grid and npts*dof fields, owned by the matrix
+
+   Level: intermediate
+
+.seealso: DMDACreateStencilMatrix(), DMDAStencilMatrixSetCoefficients()
+@*/
+PetscErrorCode DMDAStencilMatrixGetCoefficientDM(Mat A,DM *cdm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidPointer(cdm,2);
+  ierr = PetscUseMethod(A,"DMDAStencilMatrixGetCoefficientDM_C",(Mat,DM*),(A,cdm));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMDAStencilMatrixGetStencil - Gets the offsets of the stencil points applied by the matrix
+
+   Not Collective
+
+   Input Parameter:
+.  A - the matrix obtained with DMDACreateStencilMatrix()
+
+   Output Parameters:
++  npts - the number of stencil points
+-  stencil - the offsets of the stencil points (the c entries are unused), ordered lexicographically with i varying fastest
+
+   Level: intermediate
+
+.seealso: DMDACreateStencilMatrix(), DMDAStencilMatrixSetConstantCoefficients(), DMDAStencilMatrixSetCoefficients()
+@*/
+PetscErrorCode DMDAStencilMatrixGetStencil(Mat A,PetscInt *npts,const MatStencil *stencil[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  ierr = PetscUseMethod(A,"DMDAStencilMatrixGetStencil_C",(Mat,PetscInt*,const MatStencil*[]),(A,npts,stencil));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   DMDAStencilMatrixSetTileSize - Sets the tile sizes used to block the interior sweep of MatMult() for cache reuse
+
+   Logically Collective on Mat
+
+   Input Parameters:
++  A - the matrix obtained with DMDACreateStencilMatrix()
+.  tj - number of rows in y per tile, or PETSC_DECIDE
+-  tk - number of planes in z per tile, or PETSC_DECIDE
+
+   Options Database Keys:
++  -dm_da_stencil_tile_y <tj> - rows in y per tile
+-  -dm_da_stencil_tile_z <tk> - planes in z per tile
+
+   Level: advanced
+
+.seealso: DMDACreateStencilMatrix()
+@*/
+PetscErrorCode DMDAStencilMatrixSetTileSize(Mat A,PetscInt tj,PetscInt tk)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveInt(A,tj,2);
+  PetscValidLogicalCollectiveInt(A,tk,3);
+  ierr = PetscUseMethod(A,"DMDAStencilMatrixSetTileSize_C",(Mat,PetscInt,PetscInt),(A,tj,tk));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -7,6 +7,7 @@ typedef struct {
   PetscInt  pStart, pEnd; /* The label chart */
   PetscInt  numStrata;    /* The number of label strata */
   PetscReal fill;         /* Percentage of label to fill */
+  PetscBool structured;   /* Label made of runs, a dense stratum and a contiguous stratum instead of random points */
   PetscInt  size;         /* The number of set values */
 } AppCtx;
 
@@ -20,12 +21,14 @@ PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   options->pEnd      = 1000;
   options->numStrata = 5;
   options->fill      = 0.10;
+  options->structured = PETSC_FALSE;
 
   ierr = PetscOptionsBegin(comm, "", "Meshing Problem Options", "DMPLEX");CHKERRQ(ierr);
   ierr = PetscOptionsInt("-debug", "The debugging level", "ex6.c", options->debug, &options->debug, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-num_strata", "The number of label values", "ex6.c", options->numStrata, &options->numStrata, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pend", "The label point limit", "ex6.c", options->pEnd, &options->pEnd, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsReal("-fill", "The percentage of label chart to set", "ex6.c", options->fill, &options->fill, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-structured", "Set runs of points instead of random points", "ex6.c", options->structured, &options->structured, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();
   PetscFunctionReturn(0);
 }
@@ -60,6 +63,23 @@ PetscErrorCode TestSetup(DMLabel label, AppCtx *user)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode TestSetupStructured(DMLabel label, AppCtx *user)
+{
+  const PetscInt half = (user->pEnd - user->pStart)/2, quarter = half/2;
+  PetscInt       p;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  user->size = 0;
+  /* short runs of each value, a dense stratum, and a contiguous stratum */
+  for (p = user->pStart; p < user->pStart+half; ++p, ++user->size) {ierr = DMLabelSetValue(label, p, ((p - user->pStart)/8) % user->numStrata);CHKERRQ(ierr);}
+  for (p = user->pStart+half; p < user->pStart+half+quarter; p += 2, ++user->size) {ierr = DMLabelSetValue(label, p, user->numStrata);CHKERRQ(ierr);}
+  for (p = user->pStart+half+quarter; p < user->pEnd; ++p, ++user->size) {ierr = DMLabelSetValue(label, p, user->numStrata+1);CHKERRQ(ierr);}
+  ierr = DMLabelCreateIndex(label, user->pStart, user->pEnd);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF, "Created structured label with chart [%D, %D) and set %D values\n", user->pStart, user->pEnd, user->size);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode TestLookup(DMLabel label, AppCtx *user)
 {
   const PetscInt pStart = user->pStart;
@@ -82,6 +102,54 @@ PetscErrorCode TestLookup(DMLabel label, AppCtx *user)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode TestBatch(DMLabel label, AppCtx *user)
+{
+  const PetscInt pStart = user->pStart;
+  const PetscInt pEnd   = user->pEnd;
+  const PetscInt n      = pEnd - pStart;
+  PetscInt       *points, *values, numValues, p, v;
+  PetscBool      *has;
+  IS             valueIS;
+  const PetscInt *vals;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(n, &points, n, &values, n, &has);CHKERRQ(ierr);
+  /* sorted and reversed chunks */
+  for (p = 0; p < n; ++p) points[p] = pStart + p;
+  ierr = DMLabelGetValues(label, n, points, values);CHKERRQ(ierr);
+  for (p = 0; p < n; ++p) {
+    PetscInt val;
+
+    ierr = DMLabelGetValue(label, points[p], &val);CHKERRQ(ierr);
+    if (val != values[p]) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Batched value %D does not match value %D for point %D", values[p], val, points[p]);
+  }
+  for (p = 0; p < n; ++p) points[p] = pEnd - 1 - p;
+  ierr = DMLabelGetValues(label, n, points, values);CHKERRQ(ierr);
+  for (p = 0; p < n; ++p) {
+    PetscInt val;
+
+    ierr = DMLabelGetValue(label, points[p], &val);CHKERRQ(ierr);
+    if (val != values[p]) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Batched value %D does not match value %D for point %D", values[p], val, points[p]);
+  }
+  ierr = DMLabelGetNumValues(label, &numValues);CHKERRQ(ierr);
+  ierr = DMLabelGetValueIS(label, &valueIS);CHKERRQ(ierr);
+  ierr = ISGetIndices(valueIS, &vals);CHKERRQ(ierr);
+  for (v = 0; v < numValues; ++v) {
+    ierr = DMLabelStratumHasPoints(label, vals[v], n, points, has);CHKERRQ(ierr);
+    for (p = 0; p < n; ++p) {
+      PetscBool contains;
+
+      ierr = DMLabelStratumHasPoint(label, vals[v], points[p], &contains);CHKERRQ(ierr);
+      if (contains != has[p]) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Batched contains check %D does not match for point %D in stratum %D", (PetscInt) has[p], points[p], vals[v]);
+    }
+  }
+  ierr = ISRestoreIndices(valueIS, &vals);CHKERRQ(ierr);
+  ierr = ISDestroy(&valueIS);CHKERRQ(ierr);
+  ierr = PetscFree3(points, values, has);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode TestClear(DMLabel label, AppCtx *user)
 {
   PetscInt       pStart = user->pStart, pEnd = user->pEnd, p;
@@ -115,8 +183,10 @@ int main(int argc, char **argv)
   ierr = PetscInitialize(&argc, &argv, NULL,help);if (ierr) return ierr;
   ierr = ProcessOptions(PETSC_COMM_WORLD, &user);CHKERRQ(ierr);
   ierr = DMLabelCreate("Test Label", &label);CHKERRQ(ierr);
-  ierr = TestSetup(label, &user);CHKERRQ(ierr);
+  if (user.structured) {ierr = TestSetupStructured(label, &user);CHKERRQ(ierr);}
+  else                 {ierr = TestSetup(label, &user);CHKERRQ(ierr);}
   ierr = TestLookup(label, &user);CHKERRQ(ierr);
+  ierr = TestBatch(label, &user);CHKERRQ(ierr);
   ierr = TestClear(label,&user);CHKERRQ(ierr);
   ierr = DMLabelDestroy(&label);CHKERRQ(ierr);
   ierr = PetscFinalize();
@@ -137,5 +207,8 @@ int main(int argc, char **argv)
   test:
     suffix: 3
     args: -malloc_dump -pend 10000 -fill 0.25
+  test:
+    suffix: 4
+    args: -malloc_dump -pend 10000 -structured
 
 TEST*/
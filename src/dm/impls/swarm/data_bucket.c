@@ -50,6 +50,7 @@ PetscErrorCode DataFieldCreate(const char registeration_function[],const char na
   df->atomic_size = size;
   df->L  = L;
   df->bs = 1;
+  df->migrate = PETSC_TRUE;
   /* allocate something so we don't have to reallocate */
   ierr = PetscMalloc(size * L, &df->data);CHKERRQ(ierr);
   ierr = PetscMemzero(df->data, size * L);CHKERRQ(ierr);
@@ -519,6 +520,77 @@ PetscErrorCode DataBucketRemovePointAtIndex(const DataBucket db,const PetscInt i
   PetscFunctionReturn(0);
 }
 
+/*
+ Removes a list of points in one pass, preserving the relative order of the points which remain.
+ The list must be sorted in increasing order and may not contain duplicates.
+ Each field is compacted by moving the contiguous segments between consecutive removed points,
+ which avoids the repeated swap-and-resize incurred by calling DataBucketRemovePointAtIndex() per point.
+*/
+PetscErrorCode DataBucketRemovePoints(const DataBucket db,const PetscInt n,const PetscInt list[])
+{
+  PetscInt       f,k,start,end,nkeep;
+  PetscBool      any_active_fields;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = DataBucketQueryForActiveFields(db,&any_active_fields);CHKERRQ(ierr);
+  if (any_active_fields) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_USER,"Cannot safely remove points as at least one DataField is currently being accessed");
+#ifdef DATAFIELD_POINT_ACCESS_GUARD
+  for (k=0; k<n; k++) {
+    if (list[k] < 0 || list[k] >= db->L) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_USER,"Index %D of point to remove must be in [0,%D)",list[k],db->L);
+    if (k && list[k] <= list[k-1]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_USER,"List of points to remove must be sorted and may not contain duplicates");
+  }
+#endif
+  for (f=0; f<db->nfields; f++) {
+    DataField field = db->field[f];
+    char      *data = (char*)field->data;
+    size_t    asize = field->atomic_size;
+
+    nkeep = list[0];
+    for (k=0; k<n; k++) {
+      start = list[k] + 1;
+      end   = (k == n-1) ? db->L : list[k+1];
+      if (end > start) {
+        ierr = PetscMemmove(data + nkeep*asize,data + start*asize,(end-start)*asize);CHKERRQ(ierr);
+        nkeep += end - start;
+      }
+    }
+  }
+  ierr = DataBucketSetSizes(db,db->L-n,DATA_BUCKET_BUFFER_DEFAULT);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+ Reorders every field such that point p of the re-ordered bucket is point perm[p] of the original bucket.
+ perm[] must be a permutation of 0,...,L-1.
+*/
+PetscErrorCode DataBucketPermute(const DataBucket db,const PetscInt perm[])
+{
+  PetscInt       f,p;
+  PetscBool      any_active_fields;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DataBucketQueryForActiveFields(db,&any_active_fields);CHKERRQ(ierr);
+  if (any_active_fields) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_USER,"Cannot safely permute points as at least one DataField is currently being accessed");
+  for (f=0; f<db->nfields; f++) {
+    DataField field = db->field[f];
+    size_t    asize = field->atomic_size;
+    char      *data = (char*)field->data,*pdata;
+
+    /* gather into a new array of the same length and swap; the unused buffer at the end is carried over */
+    ierr = PetscMalloc(asize*(field->L+1),&pdata);CHKERRQ(ierr);
+    for (p=0; p<db->L; p++) {
+      ierr = PetscMemcpy(pdata + p*asize,data + perm[p]*asize,asize);CHKERRQ(ierr);
+    }
+    ierr = PetscMemcpy(pdata + db->L*asize,data + db->L*asize,(field->L-db->L)*asize);CHKERRQ(ierr);
+    ierr = PetscFree(field->data);CHKERRQ(ierr);
+    field->data = (void*)pdata;
+  }
+  PetscFunctionReturn(0);
+}
+
 /* copy x into y */
 PetscErrorCode DataFieldCopyPoint(const PetscInt pid_x,const DataField field_x,
                         const PetscInt pid_y,const DataField field_y )
@@ -735,7 +807,7 @@ PetscErrorCode DataBucketInsertValues(DataBucket db1,DataBucket db2)
   PetscFunctionReturn(0);
 }
 
-/* helpers for parallel send/recv */
+/* helpers for parallel send/recv, only the fields marked for migration are packed */
 PetscErrorCode DataBucketCreatePackedArray(DataBucket db,size_t *bytes,void **buf)
 {
   PetscInt       f;
@@ -747,6 +819,8 @@ PetscErrorCode DataBucketCreatePackedArray(DataBucket db,size_t *bytes,void **bu
   sizeof_marker_contents = 0;
   for (f = 0; f < db->nfields; ++f) {
     DataField df = db->field[f];
+
+    if (!df->migrate) continue;
     sizeof_marker_contents += df->atomic_size;
   }
   ierr = PetscMalloc(sizeof_marker_contents, &buffer);CHKERRQ(ierr);
@@ -780,6 +854,7 @@ PetscErrorCode DataBucketFillPackedArray(DataBucket db,const PetscInt index,void
   for (f = 0; f < db->nfields; ++f) {
     DataField df = db->field[f];
 
+    if (!df->migrate) continue;
     asize = df->atomic_size;
     data = (void*)( df->data );
     data_p = (void*)( (char*)data + index*asize );
@@ -801,6 +876,7 @@ PetscErrorCode DataBucketInsertPackedArray(DataBucket db,const PetscInt idx,void
   for (f = 0; f < db->nfields; ++f) {
     DataField df = db->field[f];
 
+    if (!df->migrate) continue;
     data_p = (void*)( (char*)data + offset );
     ierr = DataFieldInsertPoint(df, idx, (void*)data_p);CHKERRQ(ierr);
     offset = offset + df->atomic_size;
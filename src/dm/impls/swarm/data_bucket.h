@@ -22,6 +22,7 @@ struct _p_DataField {
 	char          *name; /* what are they called */
 	void          *data; /* the data - an array of structs */
   PetscDataType petsc_type;
+  PetscBool     migrate; /* is the field communicated by the packed array helpers */
 };
 
 struct _p_DataBucket {
@@ -89,6 +90,8 @@ PetscErrorCode DataBucketView(MPI_Comm comm,DataBucket db,const char filename[],
 PetscErrorCode DataBucketAddPoint(DataBucket db);
 PetscErrorCode DataBucketRemovePoint(DataBucket db);
 PetscErrorCode DataBucketRemovePointAtIndex(const DataBucket db,const PetscInt index);
+PetscErrorCode DataBucketRemovePoints(const DataBucket db,const PetscInt n,const PetscInt list[]);
+PetscErrorCode DataBucketPermute(const DataBucket db,const PetscInt perm[]);
 
 PetscErrorCode DataBucketDuplicateFields(DataBucket dbA,DataBucket *dbB);
 PetscErrorCode DataBucketInsertValues(DataBucket db1,DataBucket db2);
@@ -3,10 +3,10 @@
 
 #include <petscvec.h>
 #include <petscmat.h>
+#include <petsc/private/dmswarmimpl.h>
 
 typedef enum { DEOBJECT_INITIALIZED=0, DEOBJECT_FINALIZED, DEOBJECT_STATE_UNKNOWN } DEObjectState;
 
-typedef struct _p_DataEx* DataEx;
 struct  _p_DataEx {
 	PetscInt    instance;
 	MPI_Comm    comm;
@@ -3,13 +3,14 @@
 #include <petscviewer.h>
 #include <petscdraw.h>
 #include "data_bucket.h"
+#include "data_ex.h"
 
 PetscLogEvent DMSWARM_Migrate, DMSWARM_SetSizes, DMSWARM_AddPoints, DMSWARM_RemovePoints, DMSWARM_Sort;
 PetscLogEvent DMSWARM_DataExchangerTopologySetup, DMSWARM_DataExchangerBegin, DMSWARM_DataExchangerEnd;
 PetscLogEvent DMSWARM_DataExchangerSendCount, DMSWARM_DataExchangerPack;
 
 const char* DMSwarmTypeNames[] = { "basic", "pic", 0 };
-const char* DMSwarmMigrateTypeNames[] = { "basic", "dmcellnscatter", "dmcellexact", "user", 0 };
+const char* DMSwarmMigrateTypeNames[] = { "basic", "dmcellnscatter", "dmcellexact", "dmcellincremental", "user", 0 };
 const char* DMSwarmCollectTypeNames[] = { "basic", "boundingbox", "general", "user", 0 };
 const char* DMSwarmPICLayoutTypeNames[] = { "regular", "gauss", "subdivision", 0 };
 
@@ -385,9 +386,16 @@ PETSC_EXTERN PetscErrorCode DMSwarmSetLocalSizes(DM dm,PetscInt nlocal,PetscInt
 PETSC_EXTERN PetscErrorCode DMSwarmSetCellDM(DM dm,DM dmcell)
 {
   DM_Swarm *swarm = (DM_Swarm*)dm->data;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
   swarm->dmcell = dmcell;
+  /* the neighbour pattern was derived from the previous cell DM */
+  if (swarm->migrate_de) {
+    ierr = DataExDestroy(swarm->migrate_de);CHKERRQ(ierr);
+    swarm->migrate_de = NULL;
+  }
+  ierr = PetscFree(swarm->migrate_bbox);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -785,6 +793,86 @@ PETSC_EXTERN PetscErrorCode DMSwarmCopyPoint(DM dm,PetscInt pi,PetscInt pj)
   PetscFunctionReturn(0);
 }
 
+/*@C
+   DMSwarmSetMigrateType - Set the method used to migrate points between MPI-ranks
+
+   Logically collective on DM
+
+   Input parameters:
++  dm - the DMSwarm
+-  mtype - the migration type
+
+   Options Database Key:
+.  -dm_swarm_migrate_type <basic,dmcellnscatter,dmcellexact,dmcellincremental,user> - the migration type
+
+   Notes:
+   DMSWARM_MIGRATE_DMCELLINCREMENTAL is a variant of DMSWARM_MIGRATE_DMCELLNSCATTER intended for swarms in which
+   most points remain within the sub-domain of the cell DM owned by the MPI-rank. Only the points which are no
+   longer located within a local cell are packed and sent, each to the neighbour ranks of the cell DM (see
+   DMGetNeighbors()) whose local cells have a bounding box containing the point. The communication pattern and the
+   bounding boxes are constructed once and reused by all subsequent migrations until a new cell DM is attached. Combine it with DMSwarmSetFieldMigrate() to avoid
+   communicating fields which are re-computed after migration.
+
+   For swarms of type DMSWARM_PIC the migration type is otherwise chosen by DMSetUp() based on the cell DM.
+
+   Level: advanced
+
+.seealso: DMSwarmMigrate(), DMSwarmSetFieldMigrate(), DMSwarmSetCellDM()
+@*/
+PETSC_EXTERN PetscErrorCode DMSwarmSetMigrateType(DM dm,DMSwarmMigrateType mtype)
+{
+  DM_Swarm *swarm = (DM_Swarm*)dm->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(dm,mtype,2);
+  if (mtype == DMSWARM_MIGRATE_DMCELLINCREMENTAL && swarm->swarm_type != DMSWARM_PIC) SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"DMSWARM_MIGRATE_DMCELLINCREMENTAL requires a DMSwarm of type DMSWARM_PIC");
+  swarm->migrate_type = mtype;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMSwarmSetFieldMigrate - Indicates whether the values of a field are communicated when points are migrated
+
+   Not collective
+
+   Input parameters:
++  dm - the DMSwarm
+.  fieldname - the textual name given to a registered field
+-  flg - PETSC_FALSE if the field should not be communicated
+
+   Notes:
+   By default all fields are communicated. The values of a field which is not communicated are zero for every
+   point received during DMSwarmMigrate() (or a collect operation); this is useful for work arrays and for
+   quantities which are re-computed once points have been relocated. The fields defined by DMSwarm itself
+   (the point identifier, rank, coordinates and cell index) are always communicated.
+
+   Level: advanced
+
+.seealso: DMSwarmMigrate(), DMSwarmSetMigrateType()
+@*/
+PETSC_EXTERN PetscErrorCode DMSwarmSetFieldMigrate(DM dm,const char fieldname[],PetscBool flg)
+{
+  DM_Swarm       *swarm = (DM_Swarm*)dm->data;
+  DataField      gfield;
+  PetscBool      builtin;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidCharPointer(fieldname,2);
+  if (!flg) {
+    ierr = PetscStrcmp(fieldname,DMSwarmField_pid,&builtin);CHKERRQ(ierr);
+    if (!builtin) {ierr = PetscStrcmp(fieldname,DMSwarmField_rank,&builtin);CHKERRQ(ierr);}
+    if (!builtin) {ierr = PetscStrcmp(fieldname,DMSwarmPICField_coor,&builtin);CHKERRQ(ierr);}
+    if (!builtin) {ierr = PetscStrcmp(fieldname,DMSwarmPICField_cellid,&builtin);CHKERRQ(ierr);}
+    if (builtin) SETERRQ1(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Field \"%s\" is required by DMSwarm and must be communicated",fieldname);
+  }
+  ierr = DataBucketGetDataFieldByName(swarm->db,fieldname,&gfield);CHKERRQ(ierr);
+  gfield->migrate = flg;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMSwarmMigrate_Basic(DM dm,PetscBool remove_sent_points)
 {
   PetscErrorCode ierr;
@@ -830,6 +918,9 @@ PETSC_EXTERN PetscErrorCode DMSwarmMigrate(DM dm,PetscBool remove_sent_points)
       SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_SUP,"DMSWARM_MIGRATE_DMCELLEXACT not implemented");
       /*ierr = DMSwarmMigrate_CellDMExact(dm,remove_sent_points);CHKERRQ(ierr);*/
       break;
+    case DMSWARM_MIGRATE_DMCELLINCREMENTAL:
+      ierr = DMSwarmMigrate_CellDMIncremental(dm,remove_sent_points);CHKERRQ(ierr);
+      break;
     case DMSWARM_MIGRATE_USER:
       SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_SUP,"DMSWARM_MIGRATE_USER not implemented");
       /*ierr = swarm->migrate(dm,remove_sent_points);CHKERRQ(ierr);*/
@@ -838,6 +929,9 @@ PETSC_EXTERN PetscErrorCode DMSwarmMigrate(DM dm,PetscBool remove_sent_points)
       SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_SUP,"DMSWARM_MIGRATE type unknown");
       break;
   }
+  if (swarm->cell_sorted_layout && (swarm->migrate_type == DMSWARM_MIGRATE_DMCELLNSCATTER || swarm->migrate_type == DMSWARM_MIGRATE_DMCELLINCREMENTAL)) {
+    ierr = DMSwarmSortFields(dm);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(DMSWARM_Migrate,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1000,7 +1094,7 @@ PetscErrorCode DMSetup_Swarm(DM dm)
         ierr = PetscPrintf(PetscObjectComm((PetscObject)dm),"  DMSWARM_PIC: Using method CellDM->GetNeigbors\n");CHKERRQ(ierr);
       } else SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_USER,"DMSWARM_PIC requires the method CellDM->ops->getneighbors be defined");
 
-      swarm->migrate_type = DMSWARM_MIGRATE_DMCELLNSCATTER;
+      if (swarm->migrate_type != DMSWARM_MIGRATE_DMCELLINCREMENTAL) swarm->migrate_type = DMSWARM_MIGRATE_DMCELLNSCATTER;
     }
   }
 
@@ -1024,6 +1118,22 @@ PetscErrorCode DMSetup_Swarm(DM dm)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode DMSetFromOptions_Swarm(PetscOptionItems *PetscOptionsObject,DM dm)
+{
+  DM_Swarm       *swarm = (DM_Swarm*)dm->data;
+  PetscErrorCode ierr;
+  PetscInt       mtype = (PetscInt)swarm->migrate_type;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"DMSwarm Options");CHKERRQ(ierr);
+  ierr = PetscOptionsEList("-dm_swarm_migrate_type","Method used to migrate points","DMSwarmSetMigrateType",DMSwarmMigrateTypeNames,DMSWARM_MIGRATE_USER+1,DMSwarmMigrateTypeNames[mtype],&mtype,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = DMSwarmSetMigrateType(dm,(DMSwarmMigrateType)mtype);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-dm_swarm_cell_sorted_layout","Re-order all fields by cell after each migration","DMSwarmSetCellSortedLayout",swarm->cell_sorted_layout,&swarm->cell_sorted_layout,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 extern PetscErrorCode DMSwarmSortDestroy(DMSwarmSort *_ctx);
 
 PetscErrorCode DMDestroy_Swarm(DM dm)
@@ -1036,6 +1146,10 @@ PetscErrorCode DMDestroy_Swarm(DM dm)
   if (swarm->sort_context) {
     ierr = DMSwarmSortDestroy(&swarm->sort_context);CHKERRQ(ierr);
   }
+  if (swarm->migrate_de) {
+    ierr = DataExDestroy(swarm->migrate_de);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(swarm->migrate_bbox);CHKERRQ(ierr);
   ierr = PetscFree(swarm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1176,11 +1290,12 @@ PETSC_EXTERN PetscErrorCode DMCreate_Swarm(DM dm)
   swarm->dmcell = NULL;
   swarm->collect_view_active = PETSC_FALSE;
   swarm->collect_view_reset_nlocal = -1;
+  swarm->cell_sorted_layout = PETSC_FALSE;
 
   dm->dim  = 0;
   dm->ops->view                            = DMView_Swarm;
   dm->ops->load                            = NULL;
-  dm->ops->setfromoptions                  = NULL;
+  dm->ops->setfromoptions                  = DMSetFromOptions_Swarm;
   dm->ops->clone                           = NULL;
   dm->ops->setup                           = DMSetup_Swarm;
   dm->ops->createdefaultsection            = NULL;
@@ -5,6 +5,30 @@
 #include "data_bucket.h"
 #include "data_ex.h"
 
+/*
+ Removes, in a single pass over the fields, all points p >= pstart whose DMSwarm_rank value is equal to
+ (remove_if_equal = PETSC_TRUE) or differs from (remove_if_equal = PETSC_FALSE) the value mark.
+ The relative order of the remaining points is preserved.
+*/
+static PetscErrorCode DMSwarmRemoveMarkedPoints_Private(DM dm,PetscInt pstart,PetscInt mark,PetscBool remove_if_equal)
+{
+  DM_Swarm       *swarm = (DM_Swarm*)dm->data;
+  PetscErrorCode ierr;
+  PetscInt       p,npoints,nremove = 0,*rankval,*list;
+
+  PetscFunctionBegin;
+  ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc1(npoints-pstart+1,&list);CHKERRQ(ierr);
+  ierr = DMSwarmGetField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  for (p=pstart; p<npoints; p++) {
+    if ((rankval[p] == mark) == remove_if_equal) list[nremove++] = p;
+  }
+  ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  ierr = DataBucketRemovePoints(swarm->db,nremove,list);CHKERRQ(ierr);
+  ierr = PetscFree(list);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
  User loads desired location (MPI rank) into field DMSwarm_rank
 */
@@ -55,30 +79,8 @@ PetscErrorCode DMSwarmMigrate_Push_Basic(DM dm,PetscBool remove_sent_points)
   ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
 
   if (remove_sent_points) {
-    DataField gfield;
-
-    ierr = DataBucketGetDataFieldByName(swarm->db,DMSwarmField_rank,&gfield);CHKERRQ(ierr);
-    ierr = DataFieldGetAccess(gfield);CHKERRQ(ierr);
-    ierr = DataFieldGetEntries(gfield,(void**)&rankval);CHKERRQ(ierr);
-
     /* remove points which left processor */
-    ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr);
-    for (p=0; p<npoints; p++) {
-      nrank = rankval[p];
-      if (nrank != rank) {
-        /* kill point */
-        ierr = DataFieldRestoreAccess(gfield);CHKERRQ(ierr);
-        
-        ierr = DataBucketRemovePointAtIndex(swarm->db,p);CHKERRQ(ierr);
-
-        ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr); /* you need to update npoints as the list size decreases! */
-        ierr = DataFieldGetAccess(gfield);CHKERRQ(ierr);
-        ierr = DataFieldGetEntries(gfield,(void**)&rankval);CHKERRQ(ierr);
-        p--; /* check replacement point */
-      }
-    }
-    ierr = DataFieldRestoreEntries(gfield,(void**)&rankval);CHKERRQ(ierr);
-    ierr = DataFieldRestoreAccess(gfield);CHKERRQ(ierr);
+    ierr = DMSwarmRemoveMarkedPoints_Private(dm,0,(PetscInt)rank,PETSC_FALSE);CHKERRQ(ierr);
   }
   ierr = DataExBegin(de);CHKERRQ(ierr);
   ierr = DataExEnd(de);CHKERRQ(ierr);
@@ -150,21 +152,8 @@ PetscErrorCode DMSwarmMigrate_DMNeighborScatter(DM dm,DM dmcell,PetscBool remove
   ierr = DataExPackFinalize(de);CHKERRQ(ierr);
   ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
   if (remove_sent_points) {
-    DataField PField;
-
-    ierr = DataBucketGetDataFieldByName(swarm->db,DMSwarmField_rank,&PField);CHKERRQ(ierr);
-    ierr = DataFieldGetEntries(PField,(void**)&rankval);CHKERRQ(ierr);
     /* remove points which left processor */
-    ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr);
-    for (p=0; p<npoints; p++) {
-      if (rankval[p] == DMLOCATEPOINT_POINT_NOT_FOUND) {
-        /* kill point */
-        ierr = DataBucketRemovePointAtIndex(swarm->db,p);CHKERRQ(ierr);
-        ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr); /* you need to update npoints as the list size decreases! */
-        ierr = DataFieldGetEntries(PField,(void**)&rankval);CHKERRQ(ierr); /* update date point increase realloc performed */
-        p--; /* check replacement point */
-      }
-    }
+    ierr = DMSwarmRemoveMarkedPoints_Private(dm,0,DMLOCATEPOINT_POINT_NOT_FOUND,PETSC_TRUE);CHKERRQ(ierr);
   }
   ierr = DataBucketGetSizes(swarm->db,npoints_prior_migration,NULL,NULL);CHKERRQ(ierr);
   ierr = DataExBegin(de);CHKERRQ(ierr);
@@ -249,23 +238,8 @@ PetscErrorCode DMSwarmMigrate_CellDMScatter(DM dm,PetscBool remove_sent_points)
   if (commsize > 1) {
     ierr = DMSwarmMigrate_DMNeighborScatter(dm,dmcell,remove_sent_points,&npoints_prior_migration);CHKERRQ(ierr);
   } else {
-    DataField PField;
-    PetscInt npoints_curr;
-    
-    /* remove points which the domain */
-    ierr = DataBucketGetDataFieldByName(swarm->db,DMSwarmField_rank,&PField);CHKERRQ(ierr);
-    ierr = DataFieldGetEntries(PField,(void**)&rankval);CHKERRQ(ierr);
-    
-    ierr = DataBucketGetSizes(swarm->db,&npoints_curr,NULL,NULL);CHKERRQ(ierr);
-    for (p=0; p<npoints_curr; p++) {
-      if (rankval[p] == DMLOCATEPOINT_POINT_NOT_FOUND) {
-        /* kill point */
-        ierr = DataBucketRemovePointAtIndex(swarm->db,p);CHKERRQ(ierr);
-        ierr = DataBucketGetSizes(swarm->db,&npoints_curr,NULL,NULL);CHKERRQ(ierr); /* you need to update npoints as the list size decreases! */
-        ierr = DataFieldGetEntries(PField,(void**)&rankval);CHKERRQ(ierr); /* update date point increase realloc performed */
-        p--; /* check replacement point */
-      }
-    }
+    /* remove points which left the domain */
+    ierr = DMSwarmRemoveMarkedPoints_Private(dm,0,DMLOCATEPOINT_POINT_NOT_FOUND,PETSC_TRUE);CHKERRQ(ierr);
     ierr = DMSwarmGetSize(dm,&npoints_prior_migration);CHKERRQ(ierr);
     
   }
@@ -314,7 +288,6 @@ PetscErrorCode DMSwarmMigrate_CellDMScatter(DM dm,PetscBool remove_sent_points)
   { /* this performs two point locations: (i) on the intial points set prior to communication; and (ii) on the new (recieved) points */
     PetscScalar *LA_coor;
     PetscInt npoints_from_neighbours,bs;
-    DataField PField;
     
     npoints_from_neighbours = npoints2 - npoints_prior_migration;
     
@@ -334,20 +307,8 @@ PetscErrorCode DMSwarmMigrate_CellDMScatter(DM dm,PetscBool remove_sent_points)
     ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
     ierr = PetscSFDestroy(&sfcell);CHKERRQ(ierr);
     
-    /* remove points which left processor */
-    ierr = DataBucketGetDataFieldByName(swarm->db,DMSwarmField_rank,&PField);CHKERRQ(ierr);
-    ierr = DataFieldGetEntries(PField,(void**)&rankval);CHKERRQ(ierr);
-    
-    ierr = DataBucketGetSizes(swarm->db,&npoints2,NULL,NULL);CHKERRQ(ierr);
-    for (p=npoints_prior_migration; p<npoints2; p++) {
-      if (rankval[p] == DMLOCATEPOINT_POINT_NOT_FOUND) {
-        /* kill point */
-        ierr = DataBucketRemovePointAtIndex(swarm->db,p);CHKERRQ(ierr);
-        ierr = DataBucketGetSizes(swarm->db,&npoints2,NULL,NULL);CHKERRQ(ierr); /* you need to update npoints as the list size decreases! */
-        ierr = DataFieldGetEntries(PField,(void**)&rankval);CHKERRQ(ierr); /* update date point increase realloc performed */
-        p--; /* check replacement point */
-      }
-    }
+    /* remove received points which are not located within the local domain */
+    ierr = DMSwarmRemoveMarkedPoints_Private(dm,npoints_prior_migration,DMLOCATEPOINT_POINT_NOT_FOUND,PETSC_TRUE);CHKERRQ(ierr);
   }
   
   {
@@ -371,6 +332,259 @@ PetscErrorCode DMSwarmMigrate_CellDMScatter(DM dm,PetscBool remove_sent_points)
   PetscFunctionReturn(0);
 }
 
+typedef struct {
+  PetscMPIInt owner_rank;
+  PetscReal min[3],max[3];
+} CollectBBox;
+
+/*
+ Returns the neighbour exchanger of the swarm, creating it on first use from the neighbour ranks of the cell DM.
+ The neighbours also exchange the bounding boxes of the coordinates of their local cells, so that a point is only sent
+ to the neighbours whose box contains it. The (symmetrized) topology and the boxes are retained until the cell DM is changed.
+*/
+static PetscErrorCode DMSwarmMigrateGetNeighborExchanger_Private(DM dm,DM dmcell,DataEx *de)
+{
+  DM_Swarm          *swarm = (DM_Swarm*)dm->data;
+  PetscErrorCode    ierr;
+  PetscInt          r,d,k,cdim,n,nneighbors,n_bbox_recv;
+  const PetscMPIInt *neighbourranks;
+  PetscMPIInt       rank,mynneigh,*myneigh;
+  CollectBBox       bbox,*recv_bbox;
+  Vec               coor;
+  const PetscScalar *LA_coor;
+
+  PetscFunctionBegin;
+  if (!swarm->migrate_de) {
+    ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)dm),&rank);CHKERRQ(ierr);
+    ierr = DataExCreate(PetscObjectComm((PetscObject)dm),0,&swarm->migrate_de);CHKERRQ(ierr);
+    ierr = DMGetNeighbors(dmcell,&nneighbors,&neighbourranks);CHKERRQ(ierr);
+    ierr = DataExTopologyInitialize(swarm->migrate_de);CHKERRQ(ierr);
+    for (r=0; r<nneighbors; r++) {
+      if (neighbourranks[r] >= 0 && neighbourranks[r] != rank) {
+        ierr = DataExTopologyAddNeighbour(swarm->migrate_de,neighbourranks[r]);CHKERRQ(ierr);
+      }
+    }
+    ierr = DataExTopologyFinalize(swarm->migrate_de);CHKERRQ(ierr);
+
+    bbox.owner_rank = rank;
+    for (d=0; d<3; d++) {
+      bbox.min[d] = PETSC_MAX_REAL;
+      bbox.max[d] = PETSC_MIN_REAL;
+    }
+    ierr = DMGetCoordinateDim(dmcell,&cdim);CHKERRQ(ierr);
+    ierr = DMGetCoordinatesLocal(dmcell,&coor);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(coor,&n);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(coor,&LA_coor);CHKERRQ(ierr);
+    for (k=0; k<n/cdim; k++) {
+      for (d=0; d<cdim; d++) {
+        bbox.min[d] = PetscMin(bbox.min[d],PetscRealPart(LA_coor[k*cdim+d]));
+        bbox.max[d] = PetscMax(bbox.max[d],PetscRealPart(LA_coor[k*cdim+d]));
+      }
+    }
+    ierr = VecRestoreArrayRead(coor,&LA_coor);CHKERRQ(ierr);
+    for (d=cdim; d<3; d++) {
+      bbox.min[d] = PETSC_MIN_REAL;
+      bbox.max[d] = PETSC_MAX_REAL;
+    }
+
+    ierr = DataExTopologyGetNeighbours(swarm->migrate_de,&mynneigh,&myneigh);CHKERRQ(ierr);
+    ierr = DataExInitializeSendCount(swarm->migrate_de);CHKERRQ(ierr);
+    for (r=0; r<mynneigh; r++) {
+      ierr = DataExAddToSendCount(swarm->migrate_de,myneigh[r],1);CHKERRQ(ierr);
+    }
+    ierr = DataExFinalizeSendCount(swarm->migrate_de);CHKERRQ(ierr);
+    ierr = DataExPackInitialize(swarm->migrate_de,sizeof(CollectBBox));CHKERRQ(ierr);
+    for (r=0; r<mynneigh; r++) {
+      ierr = DataExPackData(swarm->migrate_de,myneigh[r],1,&bbox);CHKERRQ(ierr);
+    }
+    ierr = DataExPackFinalize(swarm->migrate_de);CHKERRQ(ierr);
+    ierr = DataExBegin(swarm->migrate_de);CHKERRQ(ierr);
+    ierr = DataExEnd(swarm->migrate_de);CHKERRQ(ierr);
+    ierr = DataExGetRecvData(swarm->migrate_de,&n_bbox_recv,(void**)&recv_bbox);CHKERRQ(ierr);
+    ierr = PetscMalloc1(6*mynneigh+1,&swarm->migrate_bbox);CHKERRQ(ierr);
+    for (r=0; r<mynneigh; r++) {
+      for (k=0; k<n_bbox_recv; k++) {
+        if (recv_bbox[k].owner_rank != myneigh[r]) continue;
+        for (d=0; d<3; d++) {
+          swarm->migrate_bbox[6*r+d]   = recv_bbox[k].min[d];
+          swarm->migrate_bbox[6*r+3+d] = recv_bbox[k].max[d];
+        }
+      }
+    }
+  }
+  *de = swarm->migrate_de;
+  PetscFunctionReturn(0);
+}
+
+/*
+ Locates the points [pstart,pend) within the cell DM, using the current cell index of each point as the initial guess,
+ and stores the result (a local cell index or DMLOCATEPOINT_POINT_NOT_FOUND) in DMSwarm_rank
+*/
+static PetscErrorCode DMSwarmMigrateLocatePoints_Private(DM dm,DM dmcell,PetscInt pstart,PetscInt pend,PetscBool use_guess)
+{
+  PetscErrorCode    ierr;
+  PetscInt          p,bs,*rankval,*p_cellid;
+  PetscScalar       *LA_coor;
+  PetscSF           sfcell = NULL;
+  PetscSFNode       *sf_cells;
+  const PetscSFNode *LA_sfcell;
+  Vec               pos;
+
+  PetscFunctionBegin;
+  if (use_guess) {
+    PetscInt range = 0;
+
+    ierr = PetscMalloc1(pend-pstart,&sf_cells);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&p_cellid);CHKERRQ(ierr);
+    for (p=pstart; p<pend; p++) {
+      sf_cells[p-pstart].rank  = 0;
+      sf_cells[p-pstart].index = p_cellid[p];
+      range = PetscMax(range,p_cellid[p]+1);
+    }
+    ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&p_cellid);CHKERRQ(ierr);
+    ierr = PetscSFCreate(PETSC_COMM_SELF,&sfcell);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(sfcell,range,pend-pstart,NULL,PETSC_OWN_POINTER,sf_cells,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  }
+  ierr = DMSwarmGetField(dm,DMSwarmPICField_coor,&bs,NULL,(void**)&LA_coor);CHKERRQ(ierr);
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF,bs,bs*(pend-pstart),(const PetscScalar*)&LA_coor[bs*pstart],&pos);CHKERRQ(ierr);
+  ierr = DMLocatePoints(dmcell,pos,DM_POINTLOCATION_NONE,&sfcell);CHKERRQ(ierr);
+  ierr = VecDestroy(&pos);CHKERRQ(ierr);
+  ierr = DMSwarmRestoreField(dm,DMSwarmPICField_coor,&bs,NULL,(void**)&LA_coor);CHKERRQ(ierr);
+
+  ierr = PetscSFGetGraph(sfcell,NULL,NULL,NULL,&LA_sfcell);CHKERRQ(ierr);
+  ierr = DMSwarmGetField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  for (p=pstart; p<pend; p++) {
+    rankval[p] = LA_sfcell[p-pstart].index;
+  }
+  ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfcell);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* whether the point x lies within the bounding box of the cells of the r-th neighbour of the exchanger */
+PETSC_STATIC_INLINE PetscBool DMSwarmMigrateInNeighborBox_Private(DM_Swarm *swarm,PetscInt r,PetscInt bs,const PetscReal x[])
+{
+  const PetscReal *box = &swarm->migrate_bbox[6*r];
+  PetscInt        d;
+
+  for (d=0; d<bs; d++) {
+    if (x[d] < box[d] || x[d] > box[3+d]) return PETSC_FALSE;
+  }
+  return PETSC_TRUE;
+}
+
+/*
+ Migration in which only the points which left the local cells are communicated.
+ Each mover is sent to the neighbour ranks of the cell DM whose cells' bounding box contains it, usually a single one,
+ using an exchanger whose topology is built once, thus the cost (excluding the location of the local points) scales
+ with the number of points which moved.
+*/
+PetscErrorCode DMSwarmMigrate_CellDMIncremental(DM dm,PetscBool remove_sent_points)
+{
+  DM_Swarm       *swarm = (DM_Swarm*)dm->data;
+  PetscErrorCode ierr;
+  DataEx         de = NULL;
+  DM             dmcell;
+  PetscInt       p,r,bs,npoints,npointsg = 0,npoints2g,nmovers = 0,*movers,*rankval,*p_cellid,n_points_recv,n_points_sent;
+  PetscReal      *LA_coor;
+  PetscMPIInt    commsize,mynneigh,*myneigh;
+  void           *point_buffer,*recv_points,*send_points;
+  size_t         sizeof_dmswarm_point;
+  PetscBool      error_check = swarm->migrate_error_on_missing_point;
+
+  PetscFunctionBegin;
+  ierr = DMSwarmGetCellDM(dm,&dmcell);CHKERRQ(ierr);
+  if (!dmcell) SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Only valid if cell DM provided");
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)dm),&commsize);CHKERRQ(ierr);
+  if (error_check) {
+    ierr = DMSwarmGetSize(dm,&npointsg);CHKERRQ(ierr);
+  }
+
+  /* identify the points which left the local cells */
+  ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMSwarmMigrateLocatePoints_Private(dm,dmcell,0,npoints,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = PetscMalloc1(npoints+1,&movers);CHKERRQ(ierr);
+  ierr = DMSwarmGetField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  for (p=0; p<npoints; p++) {
+    if (rankval[p] == DMLOCATEPOINT_POINT_NOT_FOUND) movers[nmovers++] = p;
+  }
+  ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  ierr = PetscInfo2(dm,"%D of %D local points left the local cells\n",nmovers,npoints);CHKERRQ(ierr);
+
+  if (commsize > 1) {
+    ierr = DMSwarmMigrateGetNeighborExchanger_Private(dm,dmcell,&de);CHKERRQ(ierr);
+    ierr = DataExTopologyGetNeighbours(de,&mynneigh,&myneigh);CHKERRQ(ierr);
+    ierr = DMSwarmGetField(dm,DMSwarmPICField_coor,&bs,NULL,(void**)&LA_coor);CHKERRQ(ierr);
+    ierr = DataExInitializeSendCount(de);CHKERRQ(ierr);
+    for (p=0; p<nmovers; p++) {
+      for (r=0; r<mynneigh; r++) {
+        if (DMSwarmMigrateInNeighborBox_Private(swarm,r,bs,&LA_coor[bs*movers[p]])) {
+          ierr = DataExAddToSendCount(de,myneigh[r],1);CHKERRQ(ierr);
+        }
+      }
+    }
+    ierr = DataExFinalizeSendCount(de);CHKERRQ(ierr);
+    ierr = DataBucketCreatePackedArray(swarm->db,&sizeof_dmswarm_point,&point_buffer);CHKERRQ(ierr);
+    ierr = DataExPackInitialize(de,sizeof_dmswarm_point);CHKERRQ(ierr);
+    for (p=0; p<nmovers; p++) {
+      PetscBool filled = PETSC_FALSE;
+
+      for (r=0; r<mynneigh; r++) {
+        if (!DMSwarmMigrateInNeighborBox_Private(swarm,r,bs,&LA_coor[bs*movers[p]])) continue;
+        if (!filled) {
+          ierr = DataBucketFillPackedArray(swarm->db,movers[p],point_buffer);CHKERRQ(ierr);
+          filled = PETSC_TRUE;
+        }
+        ierr = DataExPackData(de,myneigh[r],1,point_buffer);CHKERRQ(ierr);
+      }
+    }
+    ierr = DMSwarmRestoreField(dm,DMSwarmPICField_coor,&bs,NULL,(void**)&LA_coor);CHKERRQ(ierr);
+    ierr = DataExPackFinalize(de);CHKERRQ(ierr);
+    ierr = DataExGetSendData(de,&n_points_sent,&send_points);CHKERRQ(ierr);
+    ierr = PetscInfo1(dm,"%D copies of the points sent to the neighbours\n",n_points_sent);CHKERRQ(ierr);
+    ierr = DataExBegin(de);CHKERRQ(ierr);
+    /* compact the local points while the messages are in flight */
+    if (remove_sent_points) {
+      ierr = DataBucketRemovePoints(swarm->db,nmovers,movers);CHKERRQ(ierr);
+    }
+    ierr = DataExEnd(de);CHKERRQ(ierr);
+    ierr = DataExGetRecvData(de,&n_points_recv,(void**)&recv_points);CHKERRQ(ierr);
+    ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr);
+    ierr = DataBucketSetSizes(swarm->db,npoints + n_points_recv,DATA_BUCKET_BUFFER_DEFAULT);CHKERRQ(ierr);
+    for (p=0; p<n_points_recv; p++) {
+      void *data_p = (void*)( (char*)recv_points + p*sizeof_dmswarm_point );
+
+      ierr = DataBucketInsertPackedArray(swarm->db,npoints+p,data_p);CHKERRQ(ierr);
+    }
+    ierr = DataBucketDestroyPackedArray(swarm->db,&point_buffer);CHKERRQ(ierr);
+
+    /* keep only the received points which lie within a local cell */
+    if (n_points_recv) {
+      ierr = DMSwarmMigrateLocatePoints_Private(dm,dmcell,npoints,npoints+n_points_recv,PETSC_FALSE);CHKERRQ(ierr);
+      ierr = DMSwarmRemoveMarkedPoints_Private(dm,npoints,DMLOCATEPOINT_POINT_NOT_FOUND,PETSC_TRUE);CHKERRQ(ierr);
+    }
+  } else {
+    /* remove points which left the domain */
+    ierr = DataBucketRemovePoints(swarm->db,nmovers,movers);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(movers);CHKERRQ(ierr);
+
+  ierr = DataBucketGetSizes(swarm->db,&npoints,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMSwarmGetField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+  ierr = DMSwarmGetField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&p_cellid);CHKERRQ(ierr);
+  for (p=0; p<npoints; p++) {
+    p_cellid[p] = rankval[p];
+  }
+  ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&p_cellid);CHKERRQ(ierr);
+  ierr = DMSwarmRestoreField(dm,DMSwarmField_rank,NULL,NULL,(void**)&rankval);CHKERRQ(ierr);
+
+  if (error_check) {
+    ierr = DMSwarmGetSize(dm,&npoints2g);CHKERRQ(ierr);
+    if (npointsg != npoints2g) SETERRQ2(PetscObjectComm((PetscObject)dm),PETSC_ERR_USER,"Points from the DMSwarm must remain constant during migration (initial %D - final %D)",npointsg,npoints2g);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMSwarmMigrate_CellDMExact(DM dm,PetscBool remove_sent_points)
 {
   PetscFunctionBegin;
@@ -446,11 +660,6 @@ PetscErrorCode DMSwarmMigrate_GlobalToLocal_Basic(DM dm,PetscInt *globalsize)
   PetscFunctionReturn(0);
 }
 
-typedef struct {
-  PetscMPIInt owner_rank;
-  PetscReal min[3],max[3];
-} CollectBBox;
-
 PETSC_EXTERN PetscErrorCode DMSwarmCollect_DMDABoundingBox(DM dm,PetscInt *globalsize)
 {
   DM_Swarm *swarm = (DM_Swarm*)dm->data;
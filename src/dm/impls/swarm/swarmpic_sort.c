@@ -3,30 +3,7 @@
 #include <petscdmplex.h>
 #include <petscdmswarm.h>
 #include <petsc/private/dmswarmimpl.h>
-
-int sort_CompareSwarmPoint(const void *dataA,const void *dataB)
-{
-  SwarmPoint *pointA;
-  SwarmPoint *pointB;
-  
-  pointA = (SwarmPoint*)dataA;
-  pointB = (SwarmPoint*)dataB;
-  
-  if (pointA->cell_index < pointB->cell_index) {
-    return -1;
-  } else if (pointA->cell_index > pointB->cell_index) {
-    return 1;
-  } else {
-    return 0;
-  }
-}
-
-PetscErrorCode DMSwarmSortApplyCellIndexSort(DMSwarmSort ctx)
-{
-  PetscFunctionBegin;
-  qsort(ctx->list,ctx->npoints,sizeof(SwarmPoint),sort_CompareSwarmPoint);
-  PetscFunctionReturn(0);
-}
+#include "data_bucket.h"
 
 PetscErrorCode DMSwarmSortCreate(DMSwarmSort *_ctx)
 {
@@ -45,6 +22,43 @@ PetscErrorCode DMSwarmSortCreate(DMSwarmSort *_ctx)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode DMSwarmSortGetNumberOfCells_Private(DM dm,PetscInt *_ncells)
+{
+  PetscErrorCode  ierr;
+  PetscInt        ncells;
+  DM              celldm;
+  PetscBool       isda,isplex,isshell;
+
+  PetscFunctionBegin;
+  ierr = DMSwarmGetCellDM(dm,&celldm);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)celldm,DMDA,&isda);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)celldm,DMPLEX,&isplex);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)celldm,DMSHELL,&isshell);CHKERRQ(ierr);
+  ncells = 0;
+  if (isda) {
+    PetscInt nel,npe;
+    const PetscInt *element;
+    
+    ierr = DMDAGetElements(celldm,&nel,&npe,&element);CHKERRQ(ierr);
+    ncells = nel;
+    ierr = DMDARestoreElements(celldm,&nel,&npe,&element);CHKERRQ(ierr);
+  } else if (isplex) {
+    PetscInt ps,pe;
+    
+    ierr = DMPlexGetHeightStratum(celldm,0,&ps,&pe);CHKERRQ(ierr);
+    ncells = pe - ps;
+  } else if (isshell) {
+    PetscErrorCode (*method_DMShellGetNumberOfCells)(DM,PetscInt*);
+    
+    ierr = PetscObjectQueryFunction((PetscObject)celldm,"DMGetNumberOfCells_C",&method_DMShellGetNumberOfCells);CHKERRQ(ierr);
+    if (method_DMShellGetNumberOfCells) {
+      ierr = method_DMShellGetNumberOfCells(celldm,&ncells);CHKERRQ(ierr);
+    } else SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Cannot determine the number of cells for the DMSHELL object. User must provide a method via PetscObjectComposeFunction( (PetscObject)shelldm, \"DMGetNumberOfCells_C\", your_function_to_compute_number_of_cells );");
+  } else SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Cannot determine the number of cells for a DM not of type DA, PLEX or SHELL");
+  *_ncells = ncells;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode DMSwarmSortSetup(DMSwarmSort ctx,DM dm,PetscInt ncells)
 {
   PetscInt        *swarm_cellid;
@@ -70,23 +84,19 @@ PetscErrorCode DMSwarmSortSetup(DMSwarmSort ctx,DM dm,PetscInt ncells)
     ierr = PetscRealloc(sizeof(SwarmPoint)*npoints,&ctx->list);CHKERRQ(ierr);
     ctx->npoints = npoints;
   }
-  ierr = PetscMemzero(ctx->list,sizeof(SwarmPoint)*npoints);CHKERRQ(ierr);
   
+  /* counting sort: sum points per cell, create offset list, then scatter (stable) */
   ierr = DMSwarmGetField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
   for (p=0; p<ctx->npoints; p++) {
-    ctx->list[p].point_index = p;
-    ctx->list[p].cell_index  = swarm_cellid[p];
+    c = swarm_cellid[p];
+    if (c < 0 || c >= ctx->ncells) {
+      /* give the field back so that the swarm remains usable after the error */
+      ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(DMSWARM_Sort,0,0,0,0);CHKERRQ(ierr);
+      SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_USER,"Point %D has cell index %D outside of the local cell range [0,%D)",p,c,ctx->ncells);
+    }
+    ctx->pcell_offsets[c]++;
   }
-  ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
-  
-  ierr = DMSwarmSortApplyCellIndexSort(ctx);CHKERRQ(ierr);
-  
-  /* sum points per cell */
-  for (p=0; p<ctx->npoints; p++) {
-    ctx->pcell_offsets[ ctx->list[p].cell_index ]++;
-  }
-  
-  /* create offset list */
   count = 0;
   for (c=0; c<ctx->ncells; c++) {
     tmp = ctx->pcell_offsets[c];
@@ -94,6 +104,16 @@ PetscErrorCode DMSwarmSortSetup(DMSwarmSort ctx,DM dm,PetscInt ncells)
     count = count + tmp;
   }
   ctx->pcell_offsets[c] = count;
+  for (p=0; p<ctx->npoints; p++) {
+    c = swarm_cellid[p];
+    ctx->list[ ctx->pcell_offsets[c] ].point_index = p;
+    ctx->list[ ctx->pcell_offsets[c] ].cell_index  = c;
+    ctx->pcell_offsets[c]++;
+  }
+  ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
+  /* the scatter advanced each offset to the start of the next cell */
+  for (c=ctx->ncells; c>0; c--) ctx->pcell_offsets[c] = ctx->pcell_offsets[c-1];
+  ctx->pcell_offsets[0] = 0;
   
   ctx->isvalid = PETSC_TRUE;
   ierr = PetscLogEventEnd(DMSWARM_Sort,0,0,0,0);CHKERRQ(ierr);
@@ -240,41 +260,14 @@ PETSC_EXTERN PetscErrorCode DMSwarmSortGetAccess(DM dm)
   DM_Swarm        *swarm = (DM_Swarm*)dm->data;
   PetscErrorCode  ierr;
   PetscInt        ncells;
-  DM              celldm;
-  PetscBool       isda,isplex,isshell;
   
   PetscFunctionBegin;
   if (!swarm->sort_context) {
     ierr = DMSwarmSortCreate(&swarm->sort_context);CHKERRQ(ierr);
   }
   
-  /* get the number of cells */
-  ierr = DMSwarmGetCellDM(dm,&celldm);CHKERRQ(ierr);
-  ierr = PetscObjectTypeCompare((PetscObject)celldm,DMDA,&isda);CHKERRQ(ierr);
-  ierr = PetscObjectTypeCompare((PetscObject)celldm,DMPLEX,&isplex);CHKERRQ(ierr);
-  ierr = PetscObjectTypeCompare((PetscObject)celldm,DMSHELL,&isshell);CHKERRQ(ierr);
-  ncells = 0;
-  if (isda) {
-    PetscInt nel,npe;
-    const PetscInt *element;
-    
-    ierr = DMDAGetElements(celldm,&nel,&npe,&element);CHKERRQ(ierr);
-    ncells = nel;
-    ierr = DMDARestoreElements(celldm,&nel,&npe,&element);CHKERRQ(ierr);
-  } else if (isplex) {
-    PetscInt ps,pe;
-    
-    ierr = DMPlexGetHeightStratum(celldm,0,&ps,&pe);CHKERRQ(ierr);
-    ncells = pe - ps;
-  } else if (isshell) {
-    PetscErrorCode (*method_DMShellGetNumberOfCells)(DM,PetscInt*);
-    
-    ierr = PetscObjectQueryFunction((PetscObject)celldm,"DMGetNumberOfCells_C",&method_DMShellGetNumberOfCells);CHKERRQ(ierr);
-    if (method_DMShellGetNumberOfCells) {
-      ierr = method_DMShellGetNumberOfCells(celldm,&ncells);CHKERRQ(ierr);
-    } else SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Cannot determine the number of cells for the DMSHELL object. User must provide a method via PetscObjectComposeFunction( (PetscObject)shelldm, \"DMGetNumberOfCells_C\", your_function_to_compute_number_of_cells );");
-  } else SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Cannot determine the number of cells for a DM not of type DA, PLEX or SHELL");
-  
+  ierr = DMSwarmSortGetNumberOfCells_Private(dm,&ncells);CHKERRQ(ierr);
+
   /* setup */
   ierr = DMSwarmSortSetup(swarm->sort_context,dm,ncells);CHKERRQ(ierr);
   
@@ -365,3 +358,130 @@ PETSC_EXTERN PetscErrorCode DMSwarmSortGetSizes(DM dm,PetscInt *ncells,PetscInt
   if (npoints) { *npoints = swarm->sort_context->npoints; }
   PetscFunctionReturn(0);
 }
+
+/*@C
+   DMSwarmSortFields - Physically re-orders the points of a DMSwarm such that all fields are stored by cell
+ 
+   Collective on DM
+ 
+   Input parameter:
+.  dm - a DMSwarm object of type DMSWARM_PIC
+ 
+   Notes:
+   The points are re-ordered with a stable counting sort on the cell index, thus points within the same cell
+   retain their relative order. After the re-ordering, all the points contained in cell e are stored contiguously
+   in every field, so that loops over cells (e.g. projection and interpolation) traverse memory with unit stride.
+   If the sort context is valid when DMSwarmSortFields() is called, it is updated to describe the new layout,
+   in which case the point indices returned by DMSwarmSortGetPointsPerCell() are consecutive.
+ 
+   Every point must have been located within a local cell of the cell DM, e.g. via DMSwarmMigrate().
+   No field may be accessed (via DMSwarmGetField()) when DMSwarmSortFields() is called.
+ 
+   Level: advanced
+ 
+.seealso: DMSwarmSetCellSortedLayout(), DMSwarmSortGetAccess(), DMSwarmMigrate()
+@*/
+PETSC_EXTERN PetscErrorCode DMSwarmSortFields(DM dm)
+{
+  DM_Swarm       *swarm = (DM_Swarm*)dm->data;
+  PetscErrorCode ierr;
+  PetscInt       ncells,npoints,p,c,*swarm_cellid,*offsets,*perm = NULL;
+  PetscBool      sorted = PETSC_TRUE;
+  
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (swarm->swarm_type != DMSWARM_PIC) SETERRQ(PetscObjectComm((PetscObject)dm),PETSC_ERR_SUP,"Sorting the fields by cell is only valid for DMSWARM_PIC");
+  ierr = DMSwarmSortGetNumberOfCells_Private(dm,&ncells);CHKERRQ(ierr);
+  
+  ierr = PetscLogEventBegin(DMSWARM_Sort,0,0,0,0);CHKERRQ(ierr);
+  ierr = DMSwarmGetLocalSize(dm,&npoints);CHKERRQ(ierr);
+  ierr = DMSwarmGetField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
+  /* check the cell indices before anything is allocated, so that the swarm remains usable after the error */
+  for (p=0; p<npoints; p++) {
+    c = swarm_cellid[p];
+    if (c < 0 || c >= ncells) {
+      ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(DMSWARM_Sort,0,0,0,0);CHKERRQ(ierr);
+      SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_USER,"Point %D has cell index %D outside of the local cell range [0,%D)",p,c,ncells);
+    }
+    if (p && c < swarm_cellid[p-1]) sorted = PETSC_FALSE;
+  }
+  if (!sorted) {
+    ierr = PetscCalloc1(ncells+1,&offsets);CHKERRQ(ierr);
+    ierr = PetscMalloc1(npoints,&perm);CHKERRQ(ierr);
+    for (p=0; p<npoints; p++) offsets[swarm_cellid[p]+1]++;
+    for (c=0; c<ncells; c++) offsets[c+1] += offsets[c];
+    for (p=0; p<npoints; p++) perm[ offsets[swarm_cellid[p]]++ ] = p;
+    ierr = PetscFree(offsets);CHKERRQ(ierr);
+  }
+  ierr = DMSwarmRestoreField(dm,DMSwarmPICField_cellid,NULL,NULL,(void**)&swarm_cellid);CHKERRQ(ierr);
+  if (!sorted) {
+    ierr = DataBucketPermute(swarm->db,perm);CHKERRQ(ierr);
+    ierr = PetscFree(perm);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(DMSWARM_Sort,0,0,0,0);CHKERRQ(ierr);
+  
+  /* a valid sort context refers to the old ordering; rebuild it for the new one */
+  if (!sorted && swarm->sort_context && swarm->sort_context->isvalid) {
+    swarm->sort_context->isvalid = PETSC_FALSE;
+    ierr = DMSwarmSortSetup(swarm->sort_context,dm,ncells);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMSwarmSetCellSortedLayout - Requests that the fields of a DMSwarm are stored in cell order after each migration
+ 
+   Logically collective on DM
+ 
+   Input parameters:
++  dm - a DMSwarm object of type DMSWARM_PIC
+-  flg - PETSC_TRUE to re-order all fields by cell after each call to DMSwarmMigrate()
+ 
+   Options Database Key:
+.  -dm_swarm_cell_sorted_layout - re-order the fields by cell after each migration
+ 
+   Notes:
+   The re-ordering is performed with DMSwarmSortFields() and is only applied when the migration type
+   locates the points within the cell DM (i.e. DMSWARM_MIGRATE_DMCELLNSCATTER).
+ 
+   Level: advanced
+ 
+.seealso: DMSwarmSortFields(), DMSwarmGetCellSortedLayout(), DMSwarmMigrate()
+@*/
+PETSC_EXTERN PetscErrorCode DMSwarmSetCellSortedLayout(DM dm,PetscBool flg)
+{
+  DM_Swarm *swarm = (DM_Swarm*)dm->data;
+  
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidLogicalCollectiveBool(dm,flg,2);
+  swarm->cell_sorted_layout = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMSwarmGetCellSortedLayout - Indicates whether the fields of a DMSwarm are re-ordered by cell after each migration
+ 
+   Not collective
+ 
+   Input parameter:
+.  dm - a DMSwarm object
+ 
+   Output parameter:
+.  flg - PETSC_TRUE if the fields are re-ordered by cell
+ 
+   Level: advanced
+ 
+.seealso: DMSwarmSetCellSortedLayout(), DMSwarmSortFields()
+@*/
+PETSC_EXTERN PetscErrorCode DMSwarmGetCellSortedLayout(DM dm,PetscBool *flg)
+{
+  DM_Swarm *swarm = (DM_Swarm*)dm->data;
+  
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidPointer(flg,2);
+  *flg = swarm->cell_sorted_layout;
+  PetscFunctionReturn(0);
+}
@@ -32,6 +32,7 @@ PetscErrorCode DMLabelCreate(const char name[], DMLabel *label)
   (*label)->validIS        = NULL;
   (*label)->stratumSizes   = NULL;
   (*label)->points         = NULL;
+  (*label)->lookup         = NULL;
   (*label)->ht             = NULL;
   (*label)->pStart         = -1;
   (*label)->pEnd           = -1;
@@ -39,6 +40,215 @@ PetscErrorCode DMLabelCreate(const char name[], DMLabel *label)
   PetscFunctionReturn(0);
 }
 
+/*
+  DMLabelCreateStratumIS_Private - Create the IS for a stratum from its sorted points, a contiguous stratum is stored as a stride
+
+  Input parameters:
++ n - The number of points
+- points - The sorted points, which are taken over by the IS
+
+  Output parameter:
+. is - The stratum IS
+
+  Level: developer
+
+.seealso: DMLabelMakeValid_Private()
+*/
+static PetscErrorCode DMLabelCreateStratumIS_Private(PetscInt n, PetscInt points[], IS *is)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (n > 1 && points[n-1] - points[0] == n-1) {
+    ierr = ISCreateStride(PETSC_COMM_SELF, n, points[0], 1, is);CHKERRQ(ierr);
+    ierr = PetscFree(points);CHKERRQ(ierr);
+  } else {
+    ierr = ISCreateGeneral(PETSC_COMM_SELF, n, points, PETSC_OWN_POINTER, is);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectSetName((PetscObject) *is, "indices");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMLabelResetLookup_Private - Discard the lookup of a stratum whose points have changed
+
+  Input parameter:
++ label - The DMLabel
+- v - The stratum index
+
+  Level: developer
+
+.seealso: DMLabelSetUpLookup_Private()
+*/
+static PetscErrorCode DMLabelResetLookup_Private(DMLabel label, PetscInt v)
+{
+  DMLabelLookup  *lookup = &label->lookup[v];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(lookup->runs);CHKERRQ(ierr);
+  ierr = PetscBTDestroy(&lookup->bt);CHKERRQ(ierr);
+  lookup->numRuns = 0;
+  lookup->bStart  = lookup->bEnd = 0;
+  lookup->setup   = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMLabelSetUpLookup_Private - Choose a compact representation for the membership test of a sorted stratum
+
+  Input parameter:
++ label - The DMLabel
+- v - The stratum index
+
+  Notes:
+  Contiguous strata are strides, which ISLocate() handles in O(1). Strata made of few runs store the run bounds,
+  and dense strata a bitmap over their bounds, provided this costs at most a quarter of the point storage.
+  Otherwise the points are bisected.
+
+  Level: developer
+
+.seealso: DMLabelResetLookup_Private()
+*/
+static PetscErrorCode DMLabelSetUpLookup_Private(DMLabel label, PetscInt v)
+{
+  DMLabelLookup  *lookup = &label->lookup[v];
+  const PetscInt  n      = label->stratumSizes[v];
+  const PetscInt *points;
+  PetscInt        p, r, numRuns;
+  PetscBool       isstride;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (lookup->setup) PetscFunctionReturn(0);
+  lookup->setup = PETSC_TRUE;
+  ierr = PetscObjectTypeCompare((PetscObject) label->points[v], ISSTRIDE, &isstride);CHKERRQ(ierr);
+  if (isstride || n < 64) PetscFunctionReturn(0);
+  ierr = ISGetIndices(label->points[v], &points);CHKERRQ(ierr);
+  for (p = 1, numRuns = 1; p < n; ++p) if (points[p] != points[p-1]+1) ++numRuns;
+  if (8*numRuns <= n) {
+    ierr = PetscMalloc1(2*numRuns, &lookup->runs);CHKERRQ(ierr);
+    lookup->runs[0] = points[0];
+    for (p = 1, r = 0; p < n; ++p) {
+      if (points[p] != points[p-1]+1) {
+        lookup->runs[2*r+1] = points[p-1]+1;
+        lookup->runs[2*(++r)] = points[p];
+      }
+    }
+    lookup->runs[2*r+1] = points[n-1]+1;
+    lookup->numRuns     = numRuns;
+  } else if (PetscBTLength(points[n-1]+1 - points[0]) <= (PetscInt) (n*sizeof(PetscInt))/4) {
+    lookup->bStart = points[0];
+    lookup->bEnd   = points[n-1]+1;
+    ierr = PetscBTCreate(lookup->bEnd - lookup->bStart, &lookup->bt);CHKERRQ(ierr);
+    for (p = 0; p < n; ++p) {ierr = PetscBTSet(lookup->bt, points[p] - lookup->bStart);CHKERRQ(ierr);}
+  }
+  ierr = ISRestoreIndices(label->points[v], &points);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMLabelStratumContains_Private - Test whether a stratum contains a point
+
+  Input parameter:
++ label - The DMLabel
+. v - The stratum index
+- point - The point
+
+  Output parameter:
+. contains - PETSC_TRUE if the point is in the stratum
+
+  Level: developer
+
+.seealso: DMLabelSetUpLookup_Private()
+*/
+PETSC_STATIC_INLINE PetscErrorCode DMLabelStratumContains_Private(DMLabel label, PetscInt v, PetscInt point, PetscBool *contains)
+{
+  DMLabelLookup  *lookup = &label->lookup[v];
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginHot;
+  if (!label->validIS[v]) {
+    PetscBool has;
+
+    PetscHashIHasKey(label->ht[v], point, has);
+    *contains = has;
+    PetscFunctionReturn(0);
+  }
+  if (!lookup->setup) {ierr = DMLabelSetUpLookup_Private(label, v);CHKERRQ(ierr);}
+  if (lookup->numRuns) {
+    PetscInt lo = 0, hi = lookup->numRuns;
+
+    /* find the last run starting at or before the point */
+    while (hi - lo > 1) {
+      const PetscInt mid = (lo + hi)/2;
+
+      if (lookup->runs[2*mid] <= point) lo = mid;
+      else                              hi = mid;
+    }
+    *contains = (point >= lookup->runs[2*lo] && point < lookup->runs[2*lo+1]) ? PETSC_TRUE : PETSC_FALSE;
+  } else if (lookup->bt) {
+    *contains = (point >= lookup->bStart && point < lookup->bEnd && PetscBTLookup(lookup->bt, point - lookup->bStart)) ? PETSC_TRUE : PETSC_FALSE;
+  } else {
+    PetscInt i;
+
+    ierr = ISLocate(label->points[v], point, &i);CHKERRQ(ierr);
+    *contains = i >= 0 ? PETSC_TRUE : PETSC_FALSE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMLabelStratumContainsPoints_Private - Test whether a stratum contains each point of a chunk
+
+  Input parameter:
++ label - The DMLabel
+. v - The stratum index
+. n - The number of points
+. points - The points
+- sorted - The points are sorted, so a stratum without lookup can be merged in a single pass
+
+  Output parameter:
+. contains - PETSC_TRUE for each point in the stratum
+
+  Level: developer
+
+.seealso: DMLabelStratumContains_Private()
+*/
+static PetscErrorCode DMLabelStratumContainsPoints_Private(DMLabel label, PetscInt v, PetscInt n, const PetscInt points[], PetscBool sorted, PetscBool contains[])
+{
+  DMLabelLookup  *lookup = &label->lookup[v];
+  const PetscInt *idx;
+  PetscInt        i, q, size;
+  PetscBool       isstride = PETSC_FALSE;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (label->validIS[v]) {
+    ierr = DMLabelSetUpLookup_Private(label, v);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject) label->points[v], ISSTRIDE, &isstride);CHKERRQ(ierr);
+  }
+  if (!label->validIS[v] || isstride || lookup->numRuns || lookup->bt) {
+    for (i = 0; i < n; ++i) {ierr = DMLabelStratumContains_Private(label, v, points[i], &contains[i]);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  size = label->stratumSizes[v];
+  ierr = ISGetIndices(label->points[v], &idx);CHKERRQ(ierr);
+  if (sorted) {
+    for (i = 0, q = 0; i < n; ++i) {
+      while (q < size && idx[q] < points[i]) ++q;
+      contains[i] = (q < size && idx[q] == points[i]) ? PETSC_TRUE : PETSC_FALSE;
+    }
+  } else {
+    for (i = 0; i < n; ++i) {
+      ierr = PetscFindInt(points[i], size, idx, &q);CHKERRQ(ierr);
+      contains[i] = q >= 0 ? PETSC_TRUE : PETSC_FALSE;
+    }
+  }
+  ierr = ISRestoreIndices(label->points[v], &idx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
   DMLabelMakeValid_Private - Transfer stratum data from the hash format to the sorted list format
 
@@ -80,8 +290,8 @@ static PetscErrorCode DMLabelMakeValid_Private(DMLabel label, PetscInt v)
       ierr = PetscBTSet(label->bt, point - label->pStart);CHKERRQ(ierr);
     }
   }
-  ierr = ISCreateGeneral(PETSC_COMM_SELF,label->stratumSizes[v],pointArray,PETSC_OWN_POINTER,&(label->points[v]));CHKERRQ(ierr);
-  ierr = PetscObjectSetName((PetscObject) (label->points[v]), "indices");CHKERRQ(ierr);
+  ierr = DMLabelCreateStratumIS_Private(label->stratumSizes[v], pointArray, &(label->points[v]));CHKERRQ(ierr);
+  ierr = DMLabelResetLookup_Private(label, v);CHKERRQ(ierr);
   label->validIS[v] = PETSC_TRUE;
   ++label->state;
   PetscFunctionReturn(0);
@@ -141,6 +351,7 @@ static PetscErrorCode DMLabelMakeInvalid_Private(DMLabel label, PetscInt v)
     ierr = ISRestoreIndices(label->points[v],&points);CHKERRQ(ierr);
     ierr = ISDestroy(&(label->points[v]));CHKERRQ(ierr);
   }
+  ierr = DMLabelResetLookup_Private(label, v);CHKERRQ(ierr);
   label->validIS[v] = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
@@ -159,6 +370,7 @@ PetscErrorCode DMLabelAddStratum(DMLabel label, PetscInt value)
   IS         *tmpP;
   PetscHashI *tmpH;
   PetscBool  *tmpB;
+  DMLabelLookup *tmpL;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -171,12 +383,14 @@ PetscErrorCode DMLabelAddStratum(DMLabel label, PetscInt value)
   ierr = PetscMalloc1((label->numStrata+1), &tmpH);CHKERRQ(ierr);
   ierr = PetscMalloc1((label->numStrata+1), &tmpP);CHKERRQ(ierr);
   ierr = PetscMalloc1((label->numStrata+1), &tmpB);CHKERRQ(ierr);
+  ierr = PetscCalloc1((label->numStrata+1), &tmpL);CHKERRQ(ierr);
   for (v = 0; v < label->numStrata; ++v) {
     tmpV[v] = label->stratumValues[v];
     tmpS[v] = label->stratumSizes[v];
     tmpH[v] = label->ht[v];
     tmpP[v] = label->points[v];
     tmpB[v] = label->validIS[v];
+    tmpL[v] = label->lookup[v];
   }
   tmpV[v] = value;
   tmpS[v] = 0;
@@ -189,11 +403,13 @@ PetscErrorCode DMLabelAddStratum(DMLabel label, PetscInt value)
   ierr = PetscFree(label->ht);CHKERRQ(ierr);
   ierr = PetscFree(label->points);CHKERRQ(ierr);
   ierr = PetscFree(label->validIS);CHKERRQ(ierr);
+  ierr = PetscFree(label->lookup);CHKERRQ(ierr);
   label->stratumValues = tmpV;
   label->stratumSizes  = tmpS;
   label->ht            = tmpH;
   label->points        = tmpP;
   label->validIS       = tmpB;
+  label->lookup        = tmpL;
 
   PetscFunctionReturn(0);
 }
@@ -298,6 +514,10 @@ PetscErrorCode DMLabelDestroy(DMLabel *label)
   for (v = 0; v < (*label)->numStrata; ++v) {ierr = ISDestroy(&((*label)->points[v]));CHKERRQ(ierr);}
   ierr = PetscFree((*label)->points);CHKERRQ(ierr);
   ierr = PetscFree((*label)->validIS);CHKERRQ(ierr);
+  if ((*label)->lookup) {
+    for (v = 0; v < (*label)->numStrata; ++v) {ierr = DMLabelResetLookup_Private(*label, v);CHKERRQ(ierr);}
+    ierr = PetscFree((*label)->lookup);CHKERRQ(ierr);
+  }
   if ((*label)->ht) {
     for (v = 0; v < (*label)->numStrata; ++v) {PetscHashIDestroy((*label)->ht[v]);}
     ierr = PetscFree((*label)->ht);CHKERRQ(ierr);
@@ -339,6 +559,7 @@ PetscErrorCode DMLabelDuplicate(DMLabel label, DMLabel *labelnew)
     ierr = PetscMalloc1(label->numStrata, &(*labelnew)->ht);CHKERRQ(ierr);
     ierr = PetscMalloc1(label->numStrata, &(*labelnew)->points);CHKERRQ(ierr);
     ierr = PetscMalloc1(label->numStrata, &(*labelnew)->validIS);CHKERRQ(ierr);
+    ierr = PetscCalloc1(label->numStrata, &(*labelnew)->lookup);CHKERRQ(ierr);
     /* Could eliminate unused space here */
     for (v = 0; v < label->numStrata; ++v) {
       PetscHashICreate((*labelnew)->ht[v]);
@@ -478,25 +699,49 @@ PetscErrorCode DMLabelStratumHasPoint(DMLabel label, PetscInt value, PetscInt po
   *contains = PETSC_FALSE;
   for (v = 0; v < label->numStrata; ++v) {
     if (label->stratumValues[v] == value) {
-      if (label->validIS[v]) {
-        PetscInt i;
+      ierr = DMLabelStratumContains_Private(label, v, point, contains);CHKERRQ(ierr);
+      break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
 
-        ierr = ISLocate(label->points[v],point,&i);CHKERRQ(ierr);
-        if (i >= 0) {
-          *contains = PETSC_TRUE;
-          break;
-        }
-      } else {
-        PetscBool has;
+/*@
+  DMLabelStratumHasPoints - Test whether the stratum contains each point of a chunk
 
-        PetscHashIHasKey(label->ht[v], point, has);
-        if (has) {
-          *contains = PETSC_TRUE;
-          break;
-        }
-      }
-    }
+  Input Parameters:
++ label  - the DMLabel
+. value  - the stratum value
+. n      - the number of points
+- points - the points
+
+  Output Parameter:
+. contains - PETSC_TRUE for each point in the stratum
+
+  Note: When the points are sorted, a stratum without a compact representation is traversed only once.
+
+  Level: intermediate
+
+.seealso: DMLabelStratumHasPoint(), DMLabelGetValues()
+@*/
+PetscErrorCode DMLabelStratumHasPoints(DMLabel label, PetscInt value, PetscInt n, const PetscInt points[], PetscBool contains[])
+{
+  PetscInt       i, v;
+  PetscBool      sorted = PETSC_TRUE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (n) {
+    PetscValidIntPointer(points, 4);
+    PetscValidPointer(contains, 5);
+  }
+  for (v = 0; v < label->numStrata; ++v) if (label->stratumValues[v] == value) break;
+  if (v >= label->numStrata) {
+    for (i = 0; i < n; ++i) contains[i] = PETSC_FALSE;
+    PetscFunctionReturn(0);
   }
+  for (i = 1; i < n; ++i) if (points[i] < points[i-1]) {sorted = PETSC_FALSE; break;}
+  ierr = DMLabelStratumContainsPoints_Private(label, v, n, points, sorted, contains);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -565,27 +810,59 @@ PetscErrorCode DMLabelGetValue(DMLabel label, PetscInt point, PetscInt *value)
   PetscValidPointer(value, 3);
   *value = label->defaultValue;
   for (v = 0; v < label->numStrata; ++v) {
-    if (label->validIS[v]) {
-      PetscInt i;
+    PetscBool has;
 
-      ierr = ISLocate(label->points[v],point,&i);CHKERRQ(ierr);
-      if (i >= 0) {
-        *value = label->stratumValues[v];
-        break;
-      }
-    } else {
-      PetscBool has;
-
-      PetscHashIHasKey(label->ht[v], point, has);
-      if (has) {
-        *value = label->stratumValues[v];
-        break;
-      }
+    ierr = DMLabelStratumContains_Private(label, v, point, &has);CHKERRQ(ierr);
+    if (has) {
+      *value = label->stratumValues[v];
+      break;
     }
   }
   PetscFunctionReturn(0);
 }
 
+/*@
+  DMLabelGetValues - Return the values a label assigns to each point of a chunk
+
+  Input Parameters:
++ label  - the DMLabel
+. n      - the number of points
+- points - the points
+
+  Output Parameter:
+. values - the value of each point, or the default value of the label
+
+  Note: The points are tested one stratum at a time, and when they are sorted a stratum without a compact
+  representation is traversed only once.
+
+  Level: intermediate
+
+.seealso: DMLabelGetValue(), DMLabelStratumHasPoints(), DMLabelGetDefaultValue()
+@*/
+PetscErrorCode DMLabelGetValues(DMLabel label, PetscInt n, const PetscInt points[], PetscInt values[])
+{
+  PetscInt       i, v;
+  PetscBool      sorted = PETSC_TRUE, *has;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (n) {
+    PetscValidIntPointer(points, 3);
+    PetscValidIntPointer(values, 4);
+  }
+  for (i = 0; i < n; ++i) values[i] = label->defaultValue;
+  if (!n || !label->numStrata) PetscFunctionReturn(0);
+  for (i = 1; i < n; ++i) if (points[i] < points[i-1]) {sorted = PETSC_FALSE; break;}
+  ierr = PetscMalloc1(n, &has);CHKERRQ(ierr);
+  /* the first stratum containing a point wins, as in DMLabelGetValue() */
+  for (v = label->numStrata-1; v >= 0; --v) {
+    ierr = DMLabelStratumContainsPoints_Private(label, v, n, points, sorted, has);CHKERRQ(ierr);
+    for (i = 0; i < n; ++i) if (has[i]) values[i] = label->stratumValues[v];
+  }
+  ierr = PetscFree(has);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   DMLabelSetValue - Set the value a label assigns to a point.  If the value is the same as the label's default value (which is initially -1, and can be changed with DMLabelSetDefaultValue() to somethingg different), then this function will do nothing.
 
@@ -887,6 +1164,7 @@ PetscErrorCode DMLabelSetStratumIS(DMLabel label, PetscInt value, IS is)
   label->validIS[v] = PETSC_TRUE;
   ierr = PetscObjectReference((PetscObject)is);CHKERRQ(ierr);
   ierr = ISDestroy(&(label->points[v]));CHKERRQ(ierr);
+  ierr = DMLabelResetLookup_Private(label, v);CHKERRQ(ierr);
   if (label->bt) {
     const PetscInt *points;
     PetscInt p;
@@ -939,6 +1217,7 @@ PetscErrorCode DMLabelClearStratum(DMLabel label, PetscInt value)
       ierr = ISRestoreIndices(label->points[v], &points);CHKERRQ(ierr);
     }
     ierr = ISDestroy(&(label->points[v]));CHKERRQ(ierr);
+    ierr = DMLabelResetLookup_Private(label, v);CHKERRQ(ierr);
     label->stratumSizes[v] = 0;
     ierr = ISCreateGeneral(PETSC_COMM_SELF,0,NULL,PETSC_OWN_POINTER,&(label->points[v]));CHKERRQ(ierr);
     ierr = PetscObjectSetName((PetscObject) (label->points[v]), "indices");CHKERRQ(ierr);
@@ -994,8 +1273,8 @@ PetscErrorCode DMLabelFilter(DMLabel label, PetscInt start, PetscInt end)
     ierr = ISRestoreIndices(label->points[v],&points);CHKERRQ(ierr);
     if (pointsNew) {
       ierr = ISDestroy(&(label->points[v]));CHKERRQ(ierr);
-      ierr = ISCreateGeneral(PETSC_COMM_SELF,off,pointsNew,PETSC_OWN_POINTER,&(label->points[v]));CHKERRQ(ierr);
-      ierr = PetscObjectSetName((PetscObject) (label->points[v]), "indices");CHKERRQ(ierr);
+      ierr = DMLabelCreateStratumIS_Private(off, pointsNew, &(label->points[v]));CHKERRQ(ierr);
+      ierr = DMLabelResetLookup_Private(label, v);CHKERRQ(ierr);
     }
     label->stratumSizes[v] = off;
   }
@@ -1045,8 +1324,8 @@ PetscErrorCode DMLabelPermute(DMLabel label, IS permutation, DMLabel *labelNew)
     ierr = ISRestoreIndices((*labelNew)->points[v],&points);CHKERRQ(ierr);
     ierr = PetscSortInt(size, pointsNew);CHKERRQ(ierr);
     ierr = ISDestroy(&((*labelNew)->points[v]));CHKERRQ(ierr);
-    ierr = ISCreateGeneral(PETSC_COMM_SELF,size,pointsNew,PETSC_OWN_POINTER,&((*labelNew)->points[v]));CHKERRQ(ierr);
-    ierr = PetscObjectSetName((PetscObject) ((*labelNew)->points[v]), "indices");CHKERRQ(ierr);
+    ierr = DMLabelCreateStratumIS_Private(size, pointsNew, &((*labelNew)->points[v]));CHKERRQ(ierr);
+    ierr = DMLabelResetLookup_Private(*labelNew, v);CHKERRQ(ierr);
   }
   ierr = ISRestoreIndices(permutation, &perm);CHKERRQ(ierr);
   if (label->bt) {
@@ -1197,6 +1476,7 @@ PetscErrorCode DMLabelDistribute(DMLabel label, PetscSF sf, DMLabel *labelNew)
   }
   ierr = PetscCalloc1((*labelNew)->numStrata,&(*labelNew)->ht);CHKERRQ(ierr);
   ierr = PetscMalloc1((*labelNew)->numStrata,&(*labelNew)->points);CHKERRQ(ierr);
+  ierr = PetscCalloc1((*labelNew)->numStrata,&(*labelNew)->lookup);CHKERRQ(ierr);
   ierr = PetscMalloc1((*labelNew)->numStrata,&points);CHKERRQ(ierr);
   for (s = 0; s < (*labelNew)->numStrata; ++s) {
     PetscHashICreate((*labelNew)->ht[s]);
@@ -1214,8 +1494,7 @@ PetscErrorCode DMLabelDistribute(DMLabel label, PetscSF sf, DMLabel *labelNew)
     }
   }
   for (s = 0; s < (*labelNew)->numStrata; s++) {
-    ierr = ISCreateGeneral(PETSC_COMM_SELF,(*labelNew)->stratumSizes[s],&(points[s][0]),PETSC_OWN_POINTER,&((*labelNew)->points[s]));CHKERRQ(ierr);
-    ierr = PetscObjectSetName((PetscObject)((*labelNew)->points[s]),"indices");CHKERRQ(ierr);
+    ierr = DMLabelCreateStratumIS_Private((*labelNew)->stratumSizes[s], points[s], &((*labelNew)->points[s]));CHKERRQ(ierr);
   }
   ierr = PetscFree(points);CHKERRQ(ierr);
   PetscHashIDestroy(stratumHash);
@@ -1704,17 +1983,10 @@ static PetscErrorCode PetscSectionSymGetPoints_Label(PetscSectionSym sym, PetscS
     PetscInt ornt  = points[2*i+1];
 
     for (j = 0; j < numStrata; j++) {
-      if (label->validIS[j]) {
-        PetscInt k;
-
-        ierr = ISLocate(label->points[j],point,&k);CHKERRQ(ierr);
-        if (k >= 0) break;
-      } else {
-        PetscBool has;
+      PetscBool has;
 
-        PetscHashIHasKey(label->ht[j], point, has);
-        if (has) break;
-      }
+      ierr = DMLabelStratumContains_Private(label, j, point, &has);CHKERRQ(ierr);
+      if (has) break;
     }
     if ((sl->minMaxOrients[j][1] > sl->minMaxOrients[j][0]) && (ornt < sl->minMaxOrients[j][0] || ornt >= sl->minMaxOrients[j][1])) SETERRQ5(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"point %D orientation %D not in range [%D, %D) for stratum %D",point,ornt,sl->minMaxOrients[j][0],sl->minMaxOrients[j][1],j < numStrata ? label->stratumValues[j] : label->defaultValue);
     if (perms) {perms[i] = sl->perms[j] ? sl->perms[j][ornt] : NULL;}
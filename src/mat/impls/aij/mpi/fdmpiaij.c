@@ -22,6 +22,7 @@ PetscErrorCode  MatFDColoringApply_BAIJ(Mat J,MatFDColoring coloring,Vec x1,void
   PetscInt          bs=J->rmap->bs;
 
   PetscFunctionBegin;
+  if (coloring->rowmask) SETERRQ(PetscObjectComm((PetscObject)J),PETSC_ERR_SUP,"Active rows are only supported for AIJ matrices");
   /* (1) Set w1 = F(x1) */
   if (!coloring->fset) {
     ierr = PetscLogEventBegin(MAT_FDColoringFunction,0,0,0,0);CHKERRQ(ierr);
@@ -155,6 +156,44 @@ PetscErrorCode  MatFDColoringApply_BAIJ(Mat J,MatFDColoring coloring,Vec x1,void
   PetscFunctionReturn(0);
 }
 
+/*
+   After a partial refresh only values of the assembled matrix changed, so instead of assembling it again do what
+   MatAssemblyEnd() does for unchanged nonzero structure. Derived AIJ types that keep their own copy of the values
+   are assembled as usual.
+*/
+static PetscErrorCode MatFDColoringValuesChanged_AIJ_Private(Mat J)
+{
+  PetscErrorCode ierr;
+  Mat            A[2];
+  PetscInt       i,n = 1;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  A[0] = J;
+  ierr = PetscObjectTypeCompare((PetscObject)J,MATMPIAIJ,&flg);CHKERRQ(ierr);
+  if (flg) {
+    Mat_MPIAIJ *aij = (Mat_MPIAIJ*)J->data;
+
+    A[0] = aij->A; A[1] = aij->B; n = 2;
+    ierr = VecDestroy(&aij->diag);CHKERRQ(ierr);
+  }
+  for (i=0; i<n; i++) {
+    ierr = PetscObjectTypeCompare((PetscObject)A[i],MATSEQAIJ,&flg);CHKERRQ(ierr);
+    if (!flg) break;
+  }
+  if (!flg || !J->assembled) {
+    ierr = MatAssemblyBegin(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (i=0; i<n; i++) {
+    ierr = MatSeqAIJInvalidateDiagonal(A[i]);CHKERRQ(ierr);
+    if (A[i] != J) {ierr = PetscObjectStateIncrease((PetscObject)A[i]);CHKERRQ(ierr);}
+  }
+  ierr = PetscObjectStateIncrease((PetscObject)J);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* this is declared PETSC_EXTERN because it is used by MatFDColoringUseDM() which is in the DM library */
 PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void *sctx)
 {
@@ -172,6 +211,9 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
   MatEntry          *Jentry=coloring->matentry;
   MatEntry2         *Jentry2=coloring->matentry2;
   const PetscInt    ncolors=coloring->ncolors,*ncolumns=coloring->ncolumns,*nrows=coloring->nrows;
+  PetscBT           rowmask=coloring->rowmask;
+  const PetscInt    *active=coloring->coloractive,*ncols=coloring->activecolumns ? coloring->nactivecolumns : ncolumns;
+  PetscInt          **columns=coloring->activecolumns ? coloring->activecolumns : coloring->columns;
 
   PetscFunctionBegin;
   if ((ctype == IS_COLORING_LOCAL) && (J->ops->fdcoloringapply == MatFDColoringApply_AIJ)) SETERRQ(PetscObjectComm((PetscObject)J),PETSC_ERR_SUP,"Must call MatColoringUseDM() with IS_COLORING_LOCAL");
@@ -239,22 +281,26 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
       if (k + bcols > ncolors) bcols = ncolors - k;
       for (i=0; i<bcols; i++) {
         coloring->currentcolor = k+i;
+        if (active && !active[k+i]) { /* no active row is perturbed by this color */
+          dy_k += m;
+          continue;
+        }
 
         ierr = VecCopy(x1,w3);CHKERRQ(ierr);
         ierr = VecGetArray(w3,&w3_array);CHKERRQ(ierr);
         if (ctype == IS_COLORING_GLOBAL) w3_array -= cstart; /* shift pointer so global index can be used */
         if (coloring->htype[0] == 'w') {
-          for (l=0; l<ncolumns[k+i]; l++) {
-            col = coloring->columns[k+i][l]; /* local column (in global index!) of the matrix we are probing for */
+          for (l=0; l<ncols[k+i]; l++) {
+            col = columns[k+i][l]; /* local column (in global index!) of the matrix we are probing for */
             w3_array[col] += 1.0/dx;
           }
         } else { /* htype == 'ds' */
-          vscale_array -= cstart; /* shift pointer so global index can be used */
-          for (l=0; l<ncolumns[k+i]; l++) {
-            col = coloring->columns[k+i][l]; /* local column (in global index!) of the matrix we are probing for */
+          if (ctype == IS_COLORING_GLOBAL) vscale_array -= cstart; /* shift pointer so global index can be used */
+          for (l=0; l<ncols[k+i]; l++) {
+            col = columns[k+i][l]; /* local column (in global index!) of the matrix we are probing for */
             w3_array[col] += 1.0/vscale_array[col];
           }
-          vscale_array += cstart;
+          if (ctype == IS_COLORING_GLOBAL) vscale_array += cstart;
         }
         if (ctype == IS_COLORING_GLOBAL) w3_array += cstart;
         ierr = VecRestoreArray(w3,&w3_array);CHKERRQ(ierr);
@@ -278,7 +324,14 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
       nrows_k = nrows[nbcols++];
       ierr = VecGetArray(w2,&y);CHKERRQ(ierr);
 
-      if (coloring->htype[0] == 'w') {
+      if (rowmask) {
+        for (l=0; l<nrows_k; l++,nz++) {
+          row = coloring->htype[0] == 'w' ? Jentry2[nz].row : Jentry[nz].row; /* index in dy-array */
+          if (!PetscBTLookup(rowmask,row%m)) continue;
+          if (coloring->htype[0] == 'w') *(Jentry2[nz].valaddr) = dy[row]*dx;
+          else *(Jentry[nz].valaddr) = dy[row]*vscale_array[Jentry[nz].col];
+        }
+      } else if (coloring->htype[0] == 'w') {
         for (l=0; l<nrows_k; l++) {
           row                      = Jentry2[nz].row;   /* local row index */
           *(Jentry2[nz++].valaddr) = dy[row]*dx;
@@ -295,6 +348,10 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
   } else { /* bcols == 1 */
     for (k=0; k<ncolors; k++) {
       coloring->currentcolor = k;
+      if (active && !active[k]) { /* no active row is perturbed by this color */
+        nz += nrows[k];
+        continue;
+      }
 
       /*
        (3-1) Loop over each column associated with color
@@ -304,17 +361,17 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
       ierr = VecGetArray(w3,&w3_array);CHKERRQ(ierr);
       if (ctype == IS_COLORING_GLOBAL) w3_array -= cstart; /* shift pointer so global index can be used */
       if (coloring->htype[0] == 'w') {
-        for (l=0; l<ncolumns[k]; l++) {
-          col = coloring->columns[k][l]; /* local column (in global index!) of the matrix we are probing for */
+        for (l=0; l<ncols[k]; l++) {
+          col = columns[k][l]; /* local column (in global index!) of the matrix we are probing for */
           w3_array[col] += 1.0/dx;
         }
       } else { /* htype == 'ds' */
-        vscale_array -= cstart; /* shift pointer so global index can be used */
-        for (l=0; l<ncolumns[k]; l++) {
-          col = coloring->columns[k][l]; /* local column (in global index!) of the matrix we are probing for */
+        if (ctype == IS_COLORING_GLOBAL) vscale_array -= cstart; /* shift pointer so global index can be used */
+        for (l=0; l<ncols[k]; l++) {
+          col = columns[k][l]; /* local column (in global index!) of the matrix we are probing for */
           w3_array[col] += 1.0/vscale_array[col];
         }
-        vscale_array += cstart;
+        if (ctype == IS_COLORING_GLOBAL) vscale_array += cstart;
       }
       if (ctype == IS_COLORING_GLOBAL) w3_array += cstart;
       ierr = VecRestoreArray(w3,&w3_array);CHKERRQ(ierr);
@@ -333,7 +390,14 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
        */
       nrows_k = nrows[k];
       ierr = VecGetArray(w2,&y);CHKERRQ(ierr);
-      if (coloring->htype[0] == 'w') {
+      if (rowmask) {
+        for (l=0; l<nrows_k; l++,nz++) {
+          row = coloring->htype[0] == 'w' ? Jentry2[nz].row : Jentry[nz].row; /* local row index */
+          if (!PetscBTLookup(rowmask,row)) continue;
+          if (coloring->htype[0] == 'w') *(Jentry2[nz].valaddr) = y[row]*dx;
+          else *(Jentry[nz].valaddr) = y[row]*vscale_array[Jentry[nz].col];
+        }
+      } else if (coloring->htype[0] == 'w') {
         for (l=0; l<nrows_k; l++) {
           row                      = Jentry2[nz].row;   /* local row index */
           *(Jentry2[nz++].valaddr) = y[row]*dx;
@@ -349,8 +413,12 @@ PetscErrorCode  MatFDColoringApply_AIJ(Mat J,MatFDColoring coloring,Vec x1,void
     }
   }
 
-  ierr = MatAssemblyBegin(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
-  ierr = MatAssemblyEnd(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  if (rowmask) {
+    ierr = MatFDColoringValuesChanged_AIJ_Private(J);CHKERRQ(ierr);
+  } else {
+    ierr = MatAssemblyBegin(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
   if (vscale) {
     ierr = VecRestoreArray(vscale,&vscale_array);CHKERRQ(ierr);
   }
@@ -431,6 +499,9 @@ PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat mat,ISColoring iscoloring,MatFDCol
 
     if (ctype == IS_COLORING_GLOBAL && c->htype[0] == 'd') { /* create vscale for storing dx */
       ierr = VecCreateGhost(PetscObjectComm((PetscObject)mat),mat->cmap->n,PETSC_DETERMINE,B->cmap->n,aij->garray,&c->vscale);CHKERRQ(ierr);
+    } else if (ctype == IS_COLORING_LOCAL && c->htype[0] == 'd') { /* dx is stored for the ghosted local columns */
+      ierr = ISLocalToGlobalMappingGetSize(map,&n);CHKERRQ(ierr);
+      ierr = VecCreateSeq(PETSC_COMM_SELF,n,&c->vscale);CHKERRQ(ierr);
     }
   }
 
@@ -517,7 +588,7 @@ PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat mat,ISColoring iscoloring,MatFDCol
           /* set valaddrhit for part A */
           spidx            = bs2*spidxA[A_ci[col-cstart] + k];
           valaddrhit[*row] = &A_val[spidx];
-          rowhit[*row++]   = col - cstart + 1; /* local column index */
+          rowhit[*row++]   = (ltog && !isBAIJ) ? cols[j] + 1 : col - cstart + 1; /* local column index, ghosted for IS_COLORING_LOCAL */
         }
       } else { /* column is in B, off-diagonal block of mat */
 #if defined(PETSC_USE_CTABLE)
@@ -539,7 +610,7 @@ PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat mat,ISColoring iscoloring,MatFDCol
           /* set valaddrhit for part B */
           spidx            = bs2*spidxB[B_ci[colb] + k];
           valaddrhit[*row] = &B_val[spidx];
-          rowhit[*row++]   = colb + 1 + cend - cstart; /* local column index */
+          rowhit[*row++]   = (ltog && !isBAIJ) ? cols[j] + 1 : colb + 1 + cend - cstart; /* local column index, ghosted for IS_COLORING_LOCAL */
         }
       }
     }
@@ -118,6 +118,7 @@ PetscErrorCode  MatMFFDSetType(Mat mat,MatMFFDType ftype)
   if (ctx->ops->destroy) {
     ierr = (*ctx->ops->destroy)(ctx);CHKERRQ(ierr);
   }
+  ctx->ops->computemultiple = NULL;
 
   ierr =  PetscFunctionListFind(MatMFFDList,ftype,&r);CHKERRQ(ierr);
   if (!r) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_UNKNOWN_TYPE,"Unknown MatMFFD type %s given",ftype);
@@ -216,6 +217,7 @@ static PetscErrorCode MatDestroy_MFFD(Mat mat)
   ierr = VecDestroy(&ctx->dlscale);CHKERRQ(ierr);
   ierr = VecDestroy(&ctx->dshift);CHKERRQ(ierr);
   ierr = VecDestroy(&ctx->dshiftw);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(ctx->nwk,&ctx->wk);CHKERRQ(ierr);
   ierr = VecDestroy(&ctx->current_u);CHKERRQ(ierr);
   if (ctx->current_f_allocated) {
     ierr = VecDestroy(&ctx->current_f);CHKERRQ(ierr);
@@ -232,6 +234,8 @@ static PetscErrorCode MatDestroy_MFFD(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMFFDSetCheckh_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMFFDSetPeriod_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMFFDResetHHistory_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMFFDSetFunctionMultiple_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMFFDMultMultiple_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -299,6 +303,37 @@ PETSC_EXTERN PetscErrorCode MatAssemblyEnd_MFFD(Mat J,MatAssemblyType mt)
   PetscFunctionReturn(0);
 }
 
+/*
+  MatMFFDFinishDifference_Private - Given y = F(u + ha), forms y = (F(u + ha) - F(u))/h and applies the
+  shifts and scalings accumulated on the matrix
+*/
+static PetscErrorCode MatMFFDFinishDifference_Private(Mat mat,PetscScalar h,Vec a,Vec y)
+{
+  MatMFFD        ctx = (MatMFFD)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecAXPY(y,-1.0,ctx->current_f);CHKERRQ(ierr);
+  ierr = VecScale(y,1.0/h);CHKERRQ(ierr);
+
+  if ((ctx->vshift != 0.0) || (ctx->vscale != 1.0)) {
+    ierr = VecAXPBY(y,ctx->vshift,ctx->vscale,a);CHKERRQ(ierr);
+  }
+  if (ctx->dlscale) {
+    ierr = VecPointwiseMult(y,ctx->dlscale,y);CHKERRQ(ierr);
+  }
+  if (ctx->dshift) {
+    if (!ctx->dshiftw) {
+      ierr = VecDuplicate(y,&ctx->dshiftw);CHKERRQ(ierr);
+    }
+    ierr = VecPointwiseMult(ctx->dshift,a,ctx->dshiftw);CHKERRQ(ierr);
+    ierr = VecAXPY(y,1.0,ctx->dshiftw);CHKERRQ(ierr);
+  }
+
+  if (mat->nullsp) {ierr = MatNullSpaceRemove(mat->nullsp,y);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 /*
   MatMult_MFFD - Default matrix-free form for Jacobian-vector product, y = F'(u)*a:
 
@@ -370,26 +405,95 @@ static PetscErrorCode MatMult_MFFD(Mat mat,Vec a,Vec y)
   }
   ierr = (*ctx->func)(ctx->funcctx,w,y);CHKERRQ(ierr);
 
-  ierr = VecAXPY(y,-1.0,F);CHKERRQ(ierr);
-  ierr = VecScale(y,1.0/h);CHKERRQ(ierr);
+  ierr = MatMFFDFinishDifference_Private(mat,h,a,y);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MATMFFD_Mult,a,y,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
-  if ((ctx->vshift != 0.0) || (ctx->vscale != 1.0)) {
-    ierr = VecAXPBY(y,ctx->vshift,ctx->vscale,a);CHKERRQ(ierr);
-  }
-  if (ctx->dlscale) {
-    ierr = VecPointwiseMult(y,ctx->dlscale,y);CHKERRQ(ierr);
+/*
+  MatMFFDMultMultiple_MFFD - Applies the matrix-free Jacobian to k directions at once: the differencing
+  parameters of all directions come from a single reduction and the k perturbed residuals may be
+  evaluated with one call of the function given with MatMFFDSetFunctionMultiple()
+*/
+static PetscErrorCode MatMFFDMultMultiple_MFFD(Mat mat,PetscInt k,Vec a[],Vec y[])
+{
+  MatMFFD        ctx = (MatMFFD)mat->data;
+  PetscScalar    *h;
+  PetscBool      *zeroa,basef;
+  Vec            U,F,*w,*yw;
+  PetscInt       i,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ctx->current_u) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"MatMFFDSetBase() has not been called, this is often caused by forgetting to call \n\t\tMatAssemblyBegin/End on the first Mat in the SNES compute function");
+  if (!k) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(MATMFFD_Mult,a[0],y[0],0,0);CHKERRQ(ierr);
+
+  U = ctx->current_u;
+  F = ctx->current_f;
+  if (!((PetscObject)ctx)->type_name) {
+    ierr = MatMFFDSetType(mat,MATMFFD_WP);CHKERRQ(ierr);
+    ierr = MatSetFromOptions(mat);CHKERRQ(ierr);
   }
-  if (ctx->dshift) {
-    if (!ctx->dshiftw) {
-      ierr = VecDuplicate(y,&ctx->dshiftw);CHKERRQ(ierr);
+  ierr = PetscMalloc4(k,&h,k,&zeroa,k,&w,k,&yw);CHKERRQ(ierr);
+  basef = (PetscBool)(!ctx->ncurrenth && ctx->current_f_allocated);
+  if (ctx->ops->computemultiple && ctx->recomputeperiod == 1) {
+    ierr = (*ctx->ops->computemultiple)(ctx,U,k,a,h,zeroa);CHKERRQ(ierr);
+  } else {
+    for (i=0; i<k; i++) {
+      ierr = (*ctx->ops->compute)(ctx,U,a[i],&h[i],&zeroa[i]);CHKERRQ(ierr);
     }
-    ierr = VecPointwiseMult(ctx->dshift,a,ctx->dshiftw);CHKERRQ(ierr);
-    ierr = VecAXPY(y,1.0,ctx->dshiftw);CHKERRQ(ierr);
   }
 
-  if (mat->nullsp) {ierr = MatNullSpaceRemove(mat->nullsp,y);CHKERRQ(ierr);}
+  if (ctx->nwk < k) {
+    ierr = VecDestroyVecs(ctx->nwk,&ctx->wk);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(U,k,&ctx->wk);CHKERRQ(ierr);
+    ctx->nwk = k;
+  }
+  for (i=0,n=0; i<k; i++) {
+    if (zeroa[i]) {
+      ierr = VecSet(y[i],0.0);CHKERRQ(ierr);
+      continue;
+    }
+    if (mat->erroriffailure && PetscIsInfOrNanScalar(h[i])) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Computed Nan differencing parameter h");
+    if (ctx->checkh) {
+      ierr = (*ctx->checkh)(ctx->checkhctx,U,a[i],&h[i]);CHKERRQ(ierr);
+    }
+    ctx->currenth = h[i];
+    if (ctx->historyh && ctx->ncurrenth < ctx->maxcurrenth) {
+      ctx->historyh[ctx->ncurrenth] = h[i];
+    }
+    ctx->ncurrenth++;
 
-  ierr = PetscLogEventEnd(MATMFFD_Mult,a,y,0,0);CHKERRQ(ierr);
+    /* w_i = u + h_i a_i */
+    if (ctx->drscale) {
+      ierr = VecPointwiseMult(ctx->wk[n],ctx->drscale,a[i]);CHKERRQ(ierr);
+      ierr = VecAYPX(ctx->wk[n],h[i],U);CHKERRQ(ierr);
+    } else {
+      ierr = VecWAXPY(ctx->wk[n],h[i],a[i],U);CHKERRQ(ierr);
+    }
+    w[n]  = ctx->wk[n];
+    yw[n] = y[i];
+    n++;
+  }
+  if (n) {
+    if (basef) {
+      ierr = (*ctx->func)(ctx->funcctx,U,F);CHKERRQ(ierr);
+    }
+    if (ctx->funcmultiple) {
+      ierr = (*ctx->funcmultiple)(ctx->funcmultiplectx,n,w,yw);CHKERRQ(ierr);
+    } else {
+      for (i=0; i<n; i++) {
+        ierr = (*ctx->func)(ctx->funcctx,w[i],yw[i]);CHKERRQ(ierr);
+      }
+    }
+    for (i=0; i<k; i++) {
+      if (zeroa[i]) continue;
+      ierr = MatMFFDFinishDifference_Private(mat,h[i],a[i],y[i]);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFree4(h,zeroa,w,yw);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MATMFFD_Mult,a[0],y[0],0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -626,6 +730,16 @@ static PetscErrorCode  MatMFFDSetFunction_MFFD(Mat mat,PetscErrorCode (*func)(vo
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode  MatMFFDSetFunctionMultiple_MFFD(Mat mat,PetscErrorCode (*func)(void*,PetscInt,Vec[],Vec[]),void *funcctx)
+{
+  MatMFFD ctx = (MatMFFD)mat->data;
+
+  PetscFunctionBegin;
+  ctx->funcmultiple    = func;
+  ctx->funcmultiplectx = funcctx;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  MatMFFDSetFunctionError_MFFD(Mat mat,PetscReal error)
 {
   MatMFFD ctx = (MatMFFD)mat->data;
@@ -650,7 +764,7 @@ static PetscErrorCode MatMissingDiagonal_MFFD(Mat A,PetscBool  *missing,PetscInt
 .seealso: MatCreateMFFD(), MatCreateSNESMF(), MatMFFDSetFunction(), MatMFFDSetType(),  
           MatMFFDSetFunctionError(), MatMFFDDSSetUmin(), MatMFFDSetFunction()
           MatMFFDSetHHistory(), MatMFFDResetHHistory(), MatCreateSNESMF(),
-          MatMFFDGetH(),
+          MatMFFDGetH(), MatMFFDMultMultiple(), MatMFFDSetFunctionMultiple()
 M*/
 PETSC_EXTERN PetscErrorCode MatCreate_MFFD(Mat A)
 {
@@ -712,6 +826,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_MFFD(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatMFFDSetPeriod_C",MatMFFDSetPeriod_MFFD);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatMFFDSetFunctionError_C",MatMFFDSetFunctionError_MFFD);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatMFFDResetHHistory_C",MatMFFDResetHHistory_MFFD);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatMFFDSetFunctionMultiple_C",MatMFFDSetFunctionMultiple_MFFD);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatMFFDMultMultiple_C",MatMFFDMultMultiple_MFFD);CHKERRQ(ierr);
 
   mfctx->mat = A;
 
@@ -870,6 +986,96 @@ PetscErrorCode  MatMFFDSetFunction(Mat mat,PetscErrorCode (*func)(void*,Vec,Vec)
   PetscFunctionReturn(0);
 }
 
+/*@C
+   MatMFFDSetFunctionMultiple - Sets a function that evaluates the nonlinear function at several points in
+   one call; it is used by MatMFFDMultMultiple()
+
+   Logically Collective on Mat
+
+   Input Parameters:
++  mat - the matrix free matrix created via MatCreateSNESMF() or MatCreateMFFD()
+.  func - the function to use
+-  funcctx - optional function context passed to function
+
+   Calling Sequence of func:
+$     func (void *funcctx, PetscInt n, Vec x[], Vec f[])
+
++  funcctx - user provided context
+.  n - number of points
+.  x - the points, work vectors owned by the matrix
+-  f - the computed function values, f[i] = F(x[i])
+
+   Level: advanced
+
+   Notes:
+    The function may share work between the points, for example by scattering the ghost values of all of them in a single
+    communication phase or by reading the geometry and coefficients once.
+
+    The function set with MatMFFDSetFunction() (or SNESSetFunction() if MatCreateSNESMF() was used) is still needed to evaluate
+    F(u) at the base point and is called once per point if this is not set.
+
+.keywords: SNES, matrix-free, function
+
+.seealso: MatMFFDMultMultiple(), MatMFFDSetFunction(), MatCreateSNESMF(), MatCreateMFFD(), MATMFFD
+@*/
+PetscErrorCode  MatMFFDSetFunctionMultiple(Mat mat,PetscErrorCode (*func)(void*,PetscInt,Vec[],Vec[]),void *funcctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  ierr = PetscTryMethod(mat,"MatMFFDSetFunctionMultiple_C",(Mat,PetscErrorCode (*)(void*,PetscInt,Vec[],Vec[]),void*),(mat,func,funcctx));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatMFFDMultMultiple - Computes the matrix-free Jacobian-vector products y[i] = F'(u) a[i] for a block of directions
+
+   Collective on Mat
+
+   Input Parameters:
++  mat - the matrix free matrix created via MatCreateSNESMF() or MatCreateMFFD()
+.  k - the number of directions
+-  a - the directions
+
+   Output Parameter:
+.  y - the products, which must differ from the directions
+
+   Level: advanced
+
+   Notes:
+    The result is the same as k calls of MatMult(), but the inner products and norms needed for the differencing
+    parameters of all the directions are computed in a single reduction, and the k perturbed function values are
+    obtained with one call of the function given with MatMFFDSetFunctionMultiple() when one has been provided.
+
+    This is useful, for example, when building a block Krylov basis, probing a Jacobian with several vectors, or
+    computing sensitivities with respect to several parameters.
+
+.keywords: SNES, matrix-free, multiply
+
+.seealso: MatMFFDSetFunctionMultiple(), MatMult(), MatCreateSNESMF(), MatCreateMFFD(), MATMFFD
+@*/
+PetscErrorCode  MatMFFDMultMultiple(Mat mat,PetscInt k,Vec a[],Vec y[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  if (k < 0) SETERRQ1(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_OUTOFRANGE,"Number of directions %D cannot be negative",k);
+  if (k) {
+    PetscValidPointer(a,3);
+    PetscValidPointer(y,4);
+  }
+  for (i=0; i<k; i++) {
+    PetscValidHeaderSpecific(a[i],VEC_CLASSID,3);
+    PetscValidHeaderSpecific(y[i],VEC_CLASSID,4);
+    if (a[i] == y[i]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_IDN,"a and y must be different vectors");
+  }
+  ierr = PetscUseMethod(mat,"MatMFFDMultMultiple_C",(Mat,PetscInt,Vec[],Vec[]),(mat,k,a,y));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    MatMFFDSetFunctioni - Sets the function for a single component
 
@@ -101,6 +101,46 @@ static PetscErrorCode MatMFFDCompute_DS(MatMFFD ctx,Vec U,Vec a,PetscScalar *h,P
   PetscFunctionReturn(0);
 }
 
+/*
+   MatMFFDComputeMultiple_DS - Computes h for several directions, with the inner products
+   and norms of all the directions gathered in a single reduction.
+*/
+static PetscErrorCode MatMFFDComputeMultiple_DS(MatMFFD ctx,Vec U,PetscInt k,Vec a[],PetscScalar h[],PetscBool zeroa[])
+{
+  MatMFFD_DS     *hctx = (MatMFFD_DS*)ctx->hctx;
+  PetscReal      *nrm,*sum,umin = hctx->umin;
+  PetscScalar    *dot;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(k,&dot,k,&sum,k,&nrm);CHKERRQ(ierr);
+  ierr = VecMDotBegin(U,k,a,dot);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = VecNormBegin(a[i],NORM_1,&sum[i]);CHKERRQ(ierr);
+    ierr = VecNormBegin(a[i],NORM_2,&nrm[i]);CHKERRQ(ierr);
+  }
+  ierr = VecMDotEnd(U,k,a,dot);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = VecNormEnd(a[i],NORM_1,&sum[i]);CHKERRQ(ierr);
+    ierr = VecNormEnd(a[i],NORM_2,&nrm[i]);CHKERRQ(ierr);
+  }
+  for (i=0; i<k; i++) {
+    if (nrm[i] == 0.0) {
+      zeroa[i] = PETSC_TRUE;
+      continue;
+    }
+    zeroa[i] = PETSC_FALSE;
+    if (PetscAbsScalar(dot[i]) < umin*sum[i] && PetscRealPart(dot[i]) >= 0.0) dot[i] = umin*sum[i];
+    else if (PetscAbsScalar(dot[i]) < 0.0 && PetscRealPart(dot[i]) > -umin*sum[i]) dot[i] = -umin*sum[i];
+    h[i] = ctx->error_rel*dot[i]/(nrm[i]*nrm[i]);
+    if (PetscIsInfOrNanScalar(h[i])) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Differencing parameter is not a number sum = %g dot = %g norm = %g",(double)sum[i],(double)PetscRealPart(dot[i]),(double)nrm[i]);
+  }
+  ierr = PetscFree3(dot,sum,nrm);CHKERRQ(ierr);
+  ctx->count += k;
+  PetscFunctionReturn(0);
+}
+
 /*
    MatMFFDView_DS - Prints information about this particular
    method for computing h. Note that this does not print the general
@@ -252,10 +292,11 @@ PETSC_EXTERN PetscErrorCode MatCreateMFFD_DS(MatMFFD ctx)
   hctx->umin = 1.e-6;
 
   /* set the functions I am providing */
-  ctx->ops->compute        = MatMFFDCompute_DS;
-  ctx->ops->destroy        = MatMFFDDestroy_DS;
-  ctx->ops->view           = MatMFFDView_DS;
-  ctx->ops->setfromoptions = MatMFFDSetFromOptions_DS;
+  ctx->ops->compute         = MatMFFDCompute_DS;
+  ctx->ops->computemultiple = MatMFFDComputeMultiple_DS;
+  ctx->ops->destroy         = MatMFFDDestroy_DS;
+  ctx->ops->view            = MatMFFDView_DS;
+  ctx->ops->setfromoptions  = MatMFFDSetFromOptions_DS;
 
   ierr = PetscObjectComposeFunction((PetscObject)ctx->mat,"MatMFFDDSSetUmin_C",MatMFFDDSSetUmin_DS);CHKERRQ(ierr);
   PetscFunctionReturn(0);
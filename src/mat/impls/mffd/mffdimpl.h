@@ -21,6 +21,7 @@
 */
 struct _MFOps {
   PetscErrorCode (*compute)(MatMFFD,Vec,Vec,PetscScalar*,PetscBool * zeroa);
+  PetscErrorCode (*computemultiple)(MatMFFD,Vec,PetscInt,Vec[],PetscScalar[],PetscBool zeroa[]); /* h for several directions in one reduction */
   PetscErrorCode (*view)(MatMFFD,PetscViewer);
   PetscErrorCode (*destroy)(MatMFFD);
   PetscErrorCode (*setfromoptions)(PetscOptionItems*,MatMFFD);
@@ -49,6 +50,11 @@ struct _p_MatMFFD {    /* context for default matrix-free SNES */
   PetscErrorCode (*funci)(void*,PetscInt,Vec,PetscScalar*); /* Evaluates func_[i]() */
   PetscErrorCode (*funcisetbase)(void*,Vec);                /* Sets base for future evaluations of func_[i]() */
 
+  PetscErrorCode (*funcmultiple)(void*,PetscInt,Vec[],Vec[]); /* evaluates func() at several points in one call */
+  void           *funcmultiplectx;
+  Vec            *wk;                                         /* work vectors used by MatMFFDMultMultiple() */
+  PetscInt       nwk;
+
   PetscScalar vscale,vshift;   /* diagonal scale and shift by scalars */
   Vec         dlscale,drscale; /* diagonal scale */
   Vec         dshift,dshiftw;  /* shift by vectors */
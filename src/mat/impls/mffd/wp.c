@@ -83,6 +83,35 @@ static PetscErrorCode MatMFFDCompute_WP(MatMFFD ctx,Vec U,Vec a,PetscScalar *h,P
   PetscFunctionReturn(0);
 }
 
+/*
+     MatMFFDComputeMultiple_WP - Computes h for several directions; the norms of all the
+   directions (and of U when needed) are gathered in a single reduction.
+*/
+static PetscErrorCode MatMFFDComputeMultiple_WP(MatMFFD ctx,Vec U,PetscInt k,Vec a[],PetscScalar h[],PetscBool zeroa[])
+{
+  MatMFFD_WP     *hctx = (MatMFFD_WP*)ctx->hctx;
+  PetscReal      normU,*norma;
+  PetscBool      normu = (PetscBool)(hctx->computenormU || !ctx->ncurrenth);
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(k,&norma);CHKERRQ(ierr);
+  if (normu) {ierr = VecNormBegin(U,NORM_2,&normU);CHKERRQ(ierr);}
+  for (i=0; i<k; i++) {ierr = VecNormBegin(a[i],NORM_2,&norma[i]);CHKERRQ(ierr);}
+  if (normu) {
+    ierr            = VecNormEnd(U,NORM_2,&normU);CHKERRQ(ierr);
+    hctx->normUfact = PetscSqrtReal(1.0+normU);
+  }
+  for (i=0; i<k; i++) {
+    ierr     = VecNormEnd(a[i],NORM_2,&norma[i]);CHKERRQ(ierr);
+    zeroa[i] = (PetscBool)(norma[i] == 0.0);
+    if (!zeroa[i]) h[i] = ctx->error_rel*hctx->normUfact/norma[i];
+  }
+  ierr = PetscFree(norma);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
    MatMFFDView_WP - Prints information about this particular
      method for computing h. Note that this does not print the general
@@ -213,10 +242,11 @@ PETSC_EXTERN PetscErrorCode MatCreateMFFD_WP(MatMFFD ctx)
   hctx->computenormU = PETSC_FALSE;
 
   /* set the functions I am providing */
-  ctx->ops->compute        = MatMFFDCompute_WP;
-  ctx->ops->destroy        = MatMFFDDestroy_WP;
-  ctx->ops->view           = MatMFFDView_WP;
-  ctx->ops->setfromoptions = MatMFFDSetFromOptions_WP;
+  ctx->ops->compute         = MatMFFDCompute_WP;
+  ctx->ops->computemultiple = MatMFFDComputeMultiple_WP;
+  ctx->ops->destroy         = MatMFFDDestroy_WP;
+  ctx->ops->view            = MatMFFDView_WP;
+  ctx->ops->setfromoptions  = MatMFFDSetFromOptions_WP;
 
   ierr = PetscObjectComposeFunction((PetscObject)ctx->mat,"MatMFFDWPSetComputeNormU_C",MatMFFDWPSetComputeNormU_P);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -492,6 +492,18 @@ PetscErrorCode  MatFDColoringCreate(Mat mat,ISColoring iscoloring,MatFDColoring
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatFDColoringResetActiveRows_Private(MatFDColoring coloring)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBTDestroy(&coloring->rowmask);CHKERRQ(ierr);
+  ierr = PetscFree(coloring->coloractive);CHKERRQ(ierr);
+  if (coloring->activecolumns) {ierr = PetscFree(coloring->activecolumns[0]);CHKERRQ(ierr);}
+  ierr = PetscFree2(coloring->nactivecolumns,coloring->activecolumns);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
     MatFDColoringDestroy - Destroys a matrix coloring context that was created
     via MatFDColoringCreate().
@@ -531,6 +543,7 @@ PetscErrorCode  MatFDColoringDestroy(MatFDColoring *c)
   ierr = VecDestroy(&color->w1);CHKERRQ(ierr);
   ierr = VecDestroy(&color->w2);CHKERRQ(ierr);
   ierr = VecDestroy(&color->w3);CHKERRQ(ierr);
+  ierr = MatFDColoringResetActiveRows_Private(color);CHKERRQ(ierr);
   ierr = PetscHeaderDestroy(c);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -567,7 +580,10 @@ $          call MatFDColoringRestorePerturbedColumnsF90(i,array,ierr)
 PetscErrorCode  MatFDColoringGetPerturbedColumns(MatFDColoring coloring,PetscInt *n,const PetscInt *cols[])
 {
   PetscFunctionBegin;
-  if (coloring->currentcolor >= 0) {
+  if (coloring->currentcolor >= 0 && coloring->activecolumns) {
+    *n    = coloring->nactivecolumns[coloring->currentcolor];
+    *cols = coloring->activecolumns[coloring->currentcolor];
+  } else if (coloring->currentcolor >= 0) {
     *n    = coloring->ncolumns[coloring->currentcolor];
     *cols = coloring->columns[coloring->currentcolor];
   } else {
@@ -576,6 +592,89 @@ PetscErrorCode  MatFDColoringGetPerturbedColumns(MatFDColoring coloring,PetscInt
   PetscFunctionReturn(0);
 }
 
+/*@
+    MatFDColoringSetActiveRows - Restricts the following calls of MatFDColoringApply() to a subset of the rows of the Jacobian
+
+    Collective on MatFDColoring
+
+    Input Parameters:
++   coloring - coloring context created with MatFDColoringCreate()
+-   rows - the locally owned rows to recompute, in global numbering, or NULL to recompute all rows again
+
+    Notes:
+    The entries of the other rows keep their current values, so the matrix must already hold a Jacobian computed
+    with this coloring. Colors that do not perturb an active row on any process are skipped without evaluating the
+    function. With ghosted differencing (IS_COLORING_LOCAL) and -mat_fd_type ds only the columns of the active rows are
+    perturbed, see MatFDColoringGetPerturbedColumns(). Since only the values of the assembled matrix change, MatFDColoringApply()
+    neither zeros the matrix nor assembles it again.
+
+    This is only supported for AIJ matrices.
+
+    Level: advanced
+
+.seealso: MatFDColoringApply(), SNESSetLagJacobianPartial()
+
+.keywords: coloring, Jacobian, finite differences
+@*/
+PetscErrorCode  MatFDColoringSetActiveRows(MatFDColoring coloring,IS rows)
+{
+  PetscErrorCode ierr;
+  const PetscInt *idx;
+  PetscInt       i,k,l,n,nz,nb,row,bcols,ncolors = coloring->ncolors,*lactive;
+  PetscBT        colmask = NULL;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(coloring,MAT_FDCOLORING_CLASSID,1);
+  if (rows) PetscValidHeaderSpecific(rows,IS_CLASSID,2);
+  if (!coloring->setupcalled) SETERRQ(PetscObjectComm((PetscObject)coloring),PETSC_ERR_ARG_WRONGSTATE,"Must call MatFDColoringSetUp()");
+  ierr = MatFDColoringResetActiveRows_Private(coloring);CHKERRQ(ierr);
+  if (!rows) PetscFunctionReturn(0);
+  ierr = PetscBTCreate(coloring->m,&coloring->rowmask);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(rows,&n);CHKERRQ(ierr);
+  ierr = ISGetIndices(rows,&idx);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    if (idx[i] < coloring->rstart || idx[i] >= coloring->rstart + coloring->m) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row %D is not in the local range [%D,%D)",idx[i],coloring->rstart,coloring->rstart+coloring->m);
+    ierr = PetscBTSet(coloring->rowmask,idx[i]-coloring->rstart);CHKERRQ(ierr);
+  }
+  ierr = ISRestoreIndices(rows,&idx);CHKERRQ(ierr);
+
+  /* with ghosted differencing each process perturbs all the columns of its rows, so it can leave out the others */
+  if (coloring->ctype == IS_COLORING_LOCAL && coloring->htype[0] == 'd' && coloring->vscale) {
+    ierr = VecGetLocalSize(coloring->vscale,&n);CHKERRQ(ierr);
+    ierr = PetscBTCreate(n,&colmask);CHKERRQ(ierr);
+  }
+
+  /* in the blocked layout the entries of a block of colors are interleaved and the row of an entry is offset by m times the position of its color in the block */
+  bcols = coloring->bcols > 1 ? coloring->bcols : 1;
+  ierr  = PetscCalloc1(ncolors,&lactive);CHKERRQ(ierr);
+  ierr  = PetscMalloc1(ncolors,&coloring->coloractive);CHKERRQ(ierr);
+  for (k=0,nz=0,nb=0; k<ncolors; k+=bcols,nb++) {
+    for (l=0; l<coloring->nrows[nb]; l++,nz++) {
+      row = coloring->htype[0] == 'w' ? coloring->matentry2[nz].row : coloring->matentry[nz].row;
+      if (!PetscBTLookup(coloring->rowmask,row%coloring->m)) continue;
+      lactive[k+row/coloring->m] = 1;
+      if (colmask) {ierr = PetscBTSet(colmask,coloring->matentry[nz].col);CHKERRQ(ierr);}
+    }
+  }
+  ierr = MPIU_Allreduce(lactive,coloring->coloractive,ncolors,MPIU_INT,MPI_MAX,PetscObjectComm((PetscObject)coloring));CHKERRQ(ierr);
+  ierr = PetscFree(lactive);CHKERRQ(ierr);
+
+  if (colmask && ncolors) {
+    for (k=0,n=0; k<ncolors; k++) n += coloring->ncolumns[k];
+    ierr = PetscMalloc2(ncolors,&coloring->nactivecolumns,ncolors,&coloring->activecolumns);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n,&coloring->activecolumns[0]);CHKERRQ(ierr);
+    for (k=0; k<ncolors; k++) {
+      if (k) coloring->activecolumns[k] = coloring->activecolumns[k-1] + coloring->ncolumns[k-1];
+      coloring->nactivecolumns[k] = 0;
+      for (l=0; l<coloring->ncolumns[k]; l++) {
+        if (PetscBTLookup(colmask,coloring->columns[k][l])) coloring->activecolumns[k][coloring->nactivecolumns[k]++] = coloring->columns[k][l];
+      }
+    }
+  }
+  ierr = PetscBTDestroy(&colmask);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
     MatFDColoringApply - Given a matrix for which a MatFDColoring context
     has been created, computes the Jacobian for a function via finite differences.
@@ -596,7 +695,7 @@ PetscErrorCode  MatFDColoringGetPerturbedColumns(MatFDColoring coloring,PetscInt
 
     Level: intermediate
 
-.seealso: MatFDColoringCreate(), MatFDColoringDestroy(), MatFDColoringView(), MatFDColoringSetFunction()
+.seealso: MatFDColoringCreate(), MatFDColoringDestroy(), MatFDColoringView(), MatFDColoringSetFunction(), MatFDColoringSetActiveRows()
 
 .keywords: coloring, Jacobian, finite differences
 @*/
@@ -615,7 +714,7 @@ PetscErrorCode  MatFDColoringApply(Mat J,MatFDColoring coloring,Vec x1,void *sct
 
   ierr = MatSetUnfactored(J);CHKERRQ(ierr);
   ierr = PetscOptionsGetBool(((PetscObject)coloring)->options,NULL,"-mat_fd_coloring_dont_rezero",&flg,NULL);CHKERRQ(ierr);
-  if (flg) {
+  if (flg || coloring->rowmask) {
     ierr = PetscInfo(coloring,"Not calling MatZeroEntries()\n");CHKERRQ(ierr);
   } else {
     PetscBool assembled;
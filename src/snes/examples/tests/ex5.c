@@ -0,0 +1,102 @@
+
+static char help[] = "Tests the partial refresh of a colored finite difference Jacobian with SNESSetLagJacobianPartial().\n\n\
+  -u_xx + u + lambda g(x) u^3 = 1 on (0,1) with u = 0 on the boundary, where g(x) is a narrow bump at x = 1/2,\n\
+  started from the solution for lambda = 0 so that the residual only changes near the bump.\n\
+  -lambda <lambda> : strength of the reaction\n\
+  -rtol_partial <r> : the tolerance passed to SNESSetLagJacobianPartial()\n\n";
+
+#include <petscsnes.h>
+#include <petscdmda.h>
+
+typedef struct {
+  PetscReal lambda;
+  PetscInt  npoints;   /* number of grid points the local residual was evaluated on */
+} AppCtx;
+
+static PetscErrorCode FormFunctionLocal(DMDALocalInfo *info,PetscScalar *u,PetscScalar *f,AppCtx *user)
+{
+  PetscReal hx = 1.0/(info->mx-1),x,g;
+  PetscInt  i;
+
+  PetscFunctionBeginUser;
+  user->npoints += info->xm;
+  for (i=info->xs; i<info->xs+info->xm; i++) {
+    if (i == 0 || i == info->mx-1) {
+      f[i] = u[i];
+      continue;
+    }
+    x    = i*hx;
+    g    = PetscExpReal(-PetscSqr((x - 0.5)/0.02));
+    f[i] = (2.0*u[i] - u[i-1] - u[i+1])/(hx*hx) + u[i] + user->lambda*g*u[i]*u[i]*u[i] - 1.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  DM             da;
+  SNES           snes;
+  Vec            U0,U,R;
+  AppCtx         user;
+  PetscReal      lambda,rtol = 1.e-3,err,nrm;
+  PetscInt       nfull,npartial,itsfull,itspartial;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  user.lambda = 1.e4;
+  ierr = PetscOptionsGetReal(NULL,NULL,"-lambda",&user.lambda,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-rtol_partial",&rtol,NULL);CHKERRQ(ierr);
+
+  ierr = DMDACreate1d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,257,1,1,NULL,&da);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMDASNESSetFunctionLocal(da,INSERT_VALUES,(DMDASNESFunction)FormFunctionLocal,&user);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(da,&U0);CHKERRQ(ierr);
+  ierr = VecDuplicate(U0,&U);CHKERRQ(ierr);
+  ierr = VecDuplicate(U0,&R);CHKERRQ(ierr);
+
+  ierr = SNESCreate(PETSC_COMM_WORLD,&snes);CHKERRQ(ierr);
+  ierr = SNESSetDM(snes,da);CHKERRQ(ierr);
+  ierr = SNESSetTolerances(snes,1.e-12,1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = SNESSetFromOptions(snes);CHKERRQ(ierr);
+
+  /* the initial guess solves the linear problem, so the residual starts out nonzero only near the bump */
+  lambda      = user.lambda;
+  user.lambda = 0.0;
+  ierr = VecZeroEntries(U0);CHKERRQ(ierr);
+  ierr = SNESSolve(snes,NULL,U0);CHKERRQ(ierr);
+  user.lambda = lambda;
+
+  ierr = VecCopy(U0,R);CHKERRQ(ierr);
+  user.npoints = 0;
+  ierr = SNESSolve(snes,NULL,R);CHKERRQ(ierr);
+  ierr = SNESGetIterationNumber(snes,&itsfull);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&user.npoints,&nfull,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+
+  ierr = VecCopy(U0,U);CHKERRQ(ierr);
+  user.npoints = 0;
+  ierr = SNESSetLagJacobianPartial(snes,rtol);CHKERRQ(ierr);
+  ierr = SNESSolve(snes,NULL,U);CHKERRQ(ierr);
+  ierr = SNESGetIterationNumber(snes,&itspartial);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&user.npoints,&npartial,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+
+  ierr = VecNorm(R,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(R,-1.0,U);CHKERRQ(ierr);
+  ierr = VecNorm(R,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Full refresh: %D Newton iterations, residual evaluated at %D points\n",itsfull,nfull);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Partial refresh: %D Newton iterations, residual evaluated at %D points\n",itspartial,npartial);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of the solution %g\n",(double)nrm);CHKERRQ(ierr);
+  if (err > 1.e-8*nrm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of the difference of the solutions %g\n",(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of the difference of the solutions < 1.e-8 relative\n");CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&R);CHKERRQ(ierr);
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = VecDestroy(&U0);CHKERRQ(ierr);
+  ierr = SNESDestroy(&snes);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
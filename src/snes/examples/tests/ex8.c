@@ -0,0 +1,133 @@
+
+static char help[] = "Tests MatMFFDMultMultiple() against repeated MatMult() with a matrix-free Jacobian.\n\n\
+  F(u) = -u_xx - u^2 on a 1d grid with homogeneous Dirichlet conditions.\n\
+  -mx <n>         : number of grid points\n\
+  -k <k>          : number of directions\n\
+  -no_multiple    : do not provide a function evaluating several points at once\n\n";
+
+#include <petscsnes.h>
+#include <petscdmda.h>
+
+typedef struct {
+  DM       da;
+  PetscInt nfunc,nmultiple;   /* number of calls of each function */
+} AppCtx;
+
+static PetscErrorCode FormFunctionLocal(AppCtx *user,Vec Ul,Vec F)
+{
+  PetscScalar    *u,*f;
+  PetscReal      hx;
+  PetscInt       i,xs,xm,mx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMDAGetInfo(user->da,NULL,&mx,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  hx   = 1.0/(mx+1);
+  ierr = DMDAGetCorners(user->da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(user->da,Ul,&u);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(user->da,F,&f);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) {
+    PetscScalar ul = i == 0 ? 0.0 : u[i-1],ur = i == mx-1 ? 0.0 : u[i+1];
+    f[i] = (2.0*u[i] - ul - ur)/(hx*hx) - u[i]*u[i];
+  }
+  ierr = DMDAVecRestoreArray(user->da,F,&f);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(user->da,Ul,&u);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode FormFunction(void *ctx,Vec U,Vec F)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  Vec            Ul;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  user->nfunc++;
+  ierr = DMGetLocalVector(user->da,&Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(user->da,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(user->da,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = FormFunctionLocal(user,Ul,F);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(user->da,&Ul);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* evaluates the function at n points, computing each point while the ghost values of the next one are exchanged */
+static PetscErrorCode FormFunctionMultiple(void *ctx,PetscInt n,Vec U[],Vec F[])
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  Vec            Ul[2];
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  user->nmultiple++;
+  ierr = DMGetLocalVector(user->da,&Ul[0]);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(user->da,&Ul[1]);CHKERRQ(ierr);
+  for (i=0; i<=n; i++) {
+    if (i < n) {ierr = DMGlobalToLocalBegin(user->da,U[i],INSERT_VALUES,Ul[i%2]);CHKERRQ(ierr);}
+    if (i > 0) {ierr = FormFunctionLocal(user,Ul[(i-1)%2],F[i-1]);CHKERRQ(ierr);}
+    if (i < n) {ierr = DMGlobalToLocalEnd(user->da,U[i],INSERT_VALUES,Ul[i%2]);CHKERRQ(ierr);}
+  }
+  ierr = DMRestoreLocalVector(user->da,&Ul[1]);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(user->da,&Ul[0]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  AppCtx         user;
+  Mat            J;
+  Vec            U,*A,*Y,Z;
+  PetscRandom    rand;
+  PetscReal      err = 0.0,nrm,e;
+  PetscInt       i,k = 4,m;
+  PetscBool      nomultiple = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-k",&k,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-no_multiple",&nomultiple,NULL);CHKERRQ(ierr);
+  user.nfunc = user.nmultiple = 0;
+  ierr = DMDACreate1d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,32,1,1,NULL,&user.da);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(user.da);CHKERRQ(ierr);
+  ierr = DMSetUp(user.da);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(user.da,&U);CHKERRQ(ierr);
+  ierr = VecDuplicate(U,&Z);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(U,k,&A);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(U,k,&Y);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(U,rand);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {ierr = VecSetRandom(A[i],rand);CHKERRQ(ierr);}
+  /* a zero direction must give a zero product */
+  if (k > 1) {ierr = VecZeroEntries(A[1]);CHKERRQ(ierr);}
+
+  ierr = VecGetLocalSize(U,&m);CHKERRQ(ierr);
+  ierr = MatCreateMFFD(PETSC_COMM_WORLD,m,m,PETSC_DETERMINE,PETSC_DETERMINE,&J);CHKERRQ(ierr);
+  ierr = MatMFFDSetFunction(J,FormFunction,&user);CHKERRQ(ierr);
+  if (!nomultiple) {ierr = MatMFFDSetFunctionMultiple(J,FormFunctionMultiple,&user);CHKERRQ(ierr);}
+  ierr = MatSetFromOptions(J);CHKERRQ(ierr);
+  ierr = MatMFFDSetBase(J,U,NULL);CHKERRQ(ierr);
+
+  ierr = MatMFFDMultMultiple(J,k,A,Y);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Function evaluations: single %D multiple %D\n",user.nfunc,user.nmultiple);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = MatMult(J,A[i],Z);CHKERRQ(ierr);
+    ierr = VecNorm(Z,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    ierr = VecAXPY(Z,-1.0,Y[i]);CHKERRQ(ierr);
+    ierr = VecNorm(Z,NORM_INFINITY,&e);CHKERRQ(ierr);
+    err  = PetscMax(err,e/PetscMax(nrm,1.0));
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Blocked and single products %s\n",err < 1.e-10 ? "agree" : "do not agree");CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(k,&A);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(k,&Y);CHKERRQ(ierr);
+  ierr = VecDestroy(&Z);CHKERRQ(ierr);
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  ierr = DMDestroy(&user.da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
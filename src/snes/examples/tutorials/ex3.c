@@ -5,7 +5,8 @@ The command line options include:\n\
   -pre_check_iterates : activate checking of iterates\n\
   -post_check_iterates : activate checking of iterates\n\
   -check_tol <tol>: set tolerance for iterate checking\n\
-  -user_precond : activate a (trivial) user-defined preconditioner\n\n";
+  -user_precond : activate a (trivial) user-defined preconditioner\n\
+  -fused_norm : compute the local residual norm together with the residual, see SNESSetFunctionAndNorm()\n\n";
 
 /*T
    Concepts: SNES^basic parallel example
@@ -37,6 +38,7 @@ T*/
 */
 PetscErrorCode FormJacobian(SNES,Vec,Mat,Mat,void*);
 PetscErrorCode FormFunction(SNES,Vec,Vec,void*);
+PetscErrorCode FormFunctionAndNorm(SNES,Vec,Vec,PetscReal*,void*);
 PetscErrorCode FormInitialGuess(Vec);
 PetscErrorCode Monitor(SNES,PetscInt,PetscReal,void*);
 PetscErrorCode PreCheck(SNESLineSearch,Vec,Vec,PetscBool*,void*);
@@ -91,7 +93,7 @@ int main(int argc,char **argv)
   PetscErrorCode ierr;
   PetscInt       its,N = 5,i,maxit,maxf,xs,xm;
   PetscReal      abstol,rtol,stol,norm;
-  PetscBool      flg;
+  PetscBool      flg,fused_norm;
 
   ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
   ierr  = MPI_Comm_rank(PETSC_COMM_WORLD,&ctx.rank);CHKERRQ(ierr);
@@ -135,6 +137,15 @@ int main(int argc,char **argv)
   */
   ierr = SNESSetFunction(snes,r,FormFunction,&ctx);CHKERRQ(ierr);
 
+  /*
+     Optionally provide a version of the function evaluation that also returns the
+     local part of the residual norm, saving the line search a pass over the residual.
+  */
+  ierr = PetscOptionsHasName(NULL,NULL,"-fused_norm",&fused_norm);CHKERRQ(ierr);
+  if (fused_norm) {
+    ierr = SNESSetFunctionAndNorm(snes,FormFunctionAndNorm,&ctx);CHKERRQ(ierr);
+  }
+
   /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
      Create matrix data structure; set Jacobian evaluation routine
      - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
@@ -338,10 +349,25 @@ PetscErrorCode FormInitialGuess(Vec x)
    data needed for the function evaluation.
 */
 PetscErrorCode FormFunction(SNES snes,Vec x,Vec f,void *ctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = FormFunctionAndNorm(snes,x,f,NULL,ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* ------------------------------------------------------------------- */
+/*
+   FormFunctionAndNorm - Evaluates nonlinear function, F(x), and if lnorm2 is given
+   the sum of the squares of the locally owned entries of F(x).
+*/
+PetscErrorCode FormFunctionAndNorm(SNES snes,Vec x,Vec f,PetscReal *lnorm2,void *ctx)
 {
   ApplicationCtx *user = (ApplicationCtx*) ctx;
   DM             da    = user->da;
   PetscScalar    *xx,*ff,*FF,d;
+  PetscReal      sum = 0.0;
   PetscErrorCode ierr;
   PetscInt       i,M,xs,xm;
   Vec            xlocal;
@@ -381,10 +407,12 @@ PetscErrorCode FormFunction(SNES snes,Vec x,Vec f,void *ctx)
   */
   if (xs == 0) { /* left boundary */
     ff[0] = xx[0];
+    sum  += PetscRealPart(ff[0]*PetscConj(ff[0]));
     xs++;xm--;
   }
   if (xs+xm == M) {  /* right boundary */
     ff[xs+xm-1] = xx[xs+xm-1] - 1.0;
+    sum        += PetscRealPart(ff[xs+xm-1]*PetscConj(ff[xs+xm-1]));
     xm--;
   }
 
@@ -392,7 +420,11 @@ PetscErrorCode FormFunction(SNES snes,Vec x,Vec f,void *ctx)
      Compute function over locally owned part of the grid (interior points only)
   */
   d = 1.0/(user->h*user->h);
-  for (i=xs; i<xs+xm; i++) ff[i] = d*(xx[i-1] - 2.0*xx[i] + xx[i+1]) + xx[i]*xx[i] - FF[i];
+  for (i=xs; i<xs+xm; i++) {
+    ff[i] = d*(xx[i-1] - 2.0*xx[i] + xx[i+1]) + xx[i]*xx[i] - FF[i];
+    sum  += PetscRealPart(ff[i]*PetscConj(ff[i]));
+  }
+  if (lnorm2) *lnorm2 = sum;
 
   /*
      Restore vectors
@@ -19,6 +19,15 @@ typedef struct {
   PetscReal  damping;             /* damping parameter for updates from the blocks */
   PetscBool  same_local_solves;   /* flag to determine if the solvers have been individually modified */
   PetscBool  weight_set;          /* use a weight in the overlap updates */
+  PetscBool  mergescatters;       /* restrict and extend all local subdomains at once */
+  Vec        xall;                /* holds the arrays of all x followed by all xl */
+  Vec        ball;                /* holds the arrays of all b */
+  Vec        yall;                /* holds the arrays of all y */
+  VecScatter xmscatter;           /* scatter from global space to xall */
+  VecScatter omscatter;           /* scatter from global space to ball (or yall), all oscatter at once */
+  VecScatter imscatter;           /* scatter from global space to yall, all iscatter at once */
+  PetscInt   jaclag;              /* subdomain Jacobians are rebuilt only in every jaclag-th local solve */
+  PetscInt   nlocalsolves;        /* number of local solves since the setup */
 
   /* logging events */
   PetscLogEvent eventrestrictinterp;
@@ -38,6 +47,22 @@ static PetscErrorCode SNESReset_NASM(SNES snes)
   PetscInt       i;
 
   PetscFunctionBegin;
+  if (nasm->xall) {
+    for (i=0; i<nasm->n; i++) {
+      ierr = VecResetArray(nasm->x[i]);CHKERRQ(ierr);
+      ierr = VecResetArray(nasm->xl[i]);CHKERRQ(ierr);
+      ierr = VecResetArray(nasm->b[i]);CHKERRQ(ierr);
+      ierr = VecResetArray(nasm->y[i]);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecDestroy(&nasm->xall);CHKERRQ(ierr);
+  ierr = VecDestroy(&nasm->ball);CHKERRQ(ierr);
+  ierr = VecDestroy(&nasm->yall);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&nasm->xmscatter);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&nasm->omscatter);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&nasm->imscatter);CHKERRQ(ierr);
+  nasm->nlocalsolves = 0;
+
   for (i=0; i<nasm->n; i++) {
     if (nasm->xl) { ierr = VecDestroy(&nasm->xl[i]);CHKERRQ(ierr); }
     if (nasm->x) { ierr = VecDestroy(&nasm->x[i]);CHKERRQ(ierr); }
@@ -93,6 +118,139 @@ static PetscErrorCode DMGlobalToLocalSubDomainDirichletHook_Private(DM dm,Vec g,
   PetscFunctionReturn(0);
 }
 
+/*
+   Appends the pairs (global index, position in the merged vector) of the entries of sub filled by scat; G holds its global indices
+*/
+static PetscErrorCode SNESNASMAppendScatterIndices_Private(VecScatter scat,Vec G,Vec sub,PetscInt offset,PetscInt *cnt,PetscInt from[],PetscInt to[])
+{
+  const PetscScalar *s;
+  PetscInt          j,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(sub,-1.0);CHKERRQ(ierr);
+  ierr = VecScatterBegin(scat,G,sub,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd(scat,G,sub,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(sub,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(sub,&s);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    if (PetscRealPart(s[j]) < 0.0) continue;
+    from[*cnt] = (PetscInt)PetscRealPart(s[j]);
+    to[*cnt]   = offset+j;
+    (*cnt)++;
+  }
+  ierr = VecRestoreArrayRead(sub,&s);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Places the subdomain vectors of all local subdomains into the arrays of xall, ball and yall, and builds the scatters
+   that restrict to, and extend from, all of them at once; the scatters of each subdomain are kept for SNESNASMGetSubdomains()
+*/
+static PetscErrorCode SNESNASMSetUpMergedScatters_Private(SNES snes)
+{
+  SNES_NASM      *nasm = (SNES_NASM*)snes->data;
+  DM             dm;
+  Vec            G;
+  IS             isfrom,isto;
+  PetscScalar    *a;
+  PetscInt       i,j,n,N,rstart,nx = 0,nxl = 0,off,cnt,*from,*to;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!nasm->oscatter || !nasm->gscatter) PetscFunctionReturn(0);
+  ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  ierr = DMGetGlobalVector(dm,&G);CHKERRQ(ierr);
+  ierr = VecGetSize(G,&N);CHKERRQ(ierr);
+  /* the global indices are carried through the scatters as scalars */
+  if ((PetscReal)N > 1.0/PETSC_MACHINE_EPSILON) {
+    ierr = PetscInfo1(snes,"Not merging the subdomain scatters, %D indices are not exact as scalars\n",N);CHKERRQ(ierr);
+    ierr = DMRestoreGlobalVector(dm,&G);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetOwnershipRange(G,&rstart,NULL);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(G,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(G,&a);CHKERRQ(ierr);
+  for (j=0; j<n; j++) a[j] = rstart+j;
+  ierr = VecRestoreArray(G,&a);CHKERRQ(ierr);
+  for (i=0; i<nasm->n; i++) {
+    ierr = VecGetLocalSize(nasm->x[i],&n);CHKERRQ(ierr);
+    nx  += n;
+    ierr = VecGetLocalSize(nasm->xl[i],&n);CHKERRQ(ierr);
+    nxl += n;
+  }
+  ierr = VecCreateSeq(PETSC_COMM_SELF,nx+nxl,&nasm->xall);CHKERRQ(ierr);
+  ierr = VecCreateSeq(PETSC_COMM_SELF,nx,&nasm->ball);CHKERRQ(ierr);
+  ierr = VecCreateSeq(PETSC_COMM_SELF,nx,&nasm->yall);CHKERRQ(ierr);
+  ierr = VecGetArray(nasm->xall,&a);CHKERRQ(ierr);
+  for (i=0,off=0; i<nasm->n; i++) {
+    ierr = VecPlaceArray(nasm->x[i],a+off);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(nasm->x[i],&n);CHKERRQ(ierr);
+    off += n;
+  }
+  for (i=0; i<nasm->n; i++) {
+    ierr = VecPlaceArray(nasm->xl[i],a+off);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(nasm->xl[i],&n);CHKERRQ(ierr);
+    off += n;
+  }
+  ierr = VecRestoreArray(nasm->xall,&a);CHKERRQ(ierr);
+  ierr = VecGetArray(nasm->ball,&a);CHKERRQ(ierr);
+  for (i=0,off=0; i<nasm->n; i++) {
+    ierr = VecPlaceArray(nasm->b[i],a+off);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(nasm->b[i],&n);CHKERRQ(ierr);
+    off += n;
+  }
+  ierr = VecRestoreArray(nasm->ball,&a);CHKERRQ(ierr);
+  ierr = VecGetArray(nasm->yall,&a);CHKERRQ(ierr);
+  for (i=0,off=0; i<nasm->n; i++) {
+    ierr = VecPlaceArray(nasm->y[i],a+off);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(nasm->y[i],&n);CHKERRQ(ierr);
+    off += n;
+  }
+  ierr = VecRestoreArray(nasm->yall,&a);CHKERRQ(ierr);
+
+  /* the x part of xall has the layout of ball and yall, so its scatter is the start of the one to xall */
+  ierr = PetscMalloc2(nx+nxl,&from,nx+nxl,&to);CHKERRQ(ierr);
+  for (i=0,off=0,cnt=0; i<nasm->n; i++) {
+    ierr = SNESNASMAppendScatterIndices_Private(nasm->oscatter[i],G,nasm->x[i],off,&cnt,from,to);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(nasm->x[i],&n);CHKERRQ(ierr);
+    off += n;
+  }
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,cnt,from,PETSC_USE_POINTER,&isfrom);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,cnt,to,PETSC_USE_POINTER,&isto);CHKERRQ(ierr);
+  ierr = VecScatterCreate(G,isfrom,nasm->ball,isto,&nasm->omscatter);CHKERRQ(ierr);
+  ierr = ISDestroy(&isfrom);CHKERRQ(ierr);
+  ierr = ISDestroy(&isto);CHKERRQ(ierr);
+  for (i=0; i<nasm->n; i++) {
+    ierr = SNESNASMAppendScatterIndices_Private(nasm->gscatter[i],G,nasm->xl[i],off,&cnt,from,to);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(nasm->xl[i],&n);CHKERRQ(ierr);
+    off += n;
+  }
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,cnt,from,PETSC_USE_POINTER,&isfrom);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,cnt,to,PETSC_USE_POINTER,&isto);CHKERRQ(ierr);
+  ierr = VecScatterCreate(G,isfrom,nasm->xall,isto,&nasm->xmscatter);CHKERRQ(ierr);
+  ierr = ISDestroy(&isfrom);CHKERRQ(ierr);
+  ierr = ISDestroy(&isto);CHKERRQ(ierr);
+  if (nasm->iscatter) {
+    for (i=0,off=0,cnt=0; i<nasm->n; i++) {
+      ierr = SNESNASMAppendScatterIndices_Private(nasm->iscatter[i],G,nasm->y[i],off,&cnt,from,to);CHKERRQ(ierr);
+      ierr = VecGetLocalSize(nasm->y[i],&n);CHKERRQ(ierr);
+      off += n;
+    }
+    ierr = ISCreateGeneral(PETSC_COMM_SELF,cnt,from,PETSC_USE_POINTER,&isfrom);CHKERRQ(ierr);
+    ierr = ISCreateGeneral(PETSC_COMM_SELF,cnt,to,PETSC_USE_POINTER,&isto);CHKERRQ(ierr);
+    ierr = VecScatterCreate(G,isfrom,nasm->yall,isto,&nasm->imscatter);CHKERRQ(ierr);
+    ierr = ISDestroy(&isfrom);CHKERRQ(ierr);
+    ierr = ISDestroy(&isto);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(from,to);CHKERRQ(ierr);
+  ierr = DMRestoreGlobalVector(dm,&G);CHKERRQ(ierr);
+  /* the entries of the local vectors not filled by the scatters keep the values they were created with */
+  ierr = VecSet(nasm->xall,0.0);CHKERRQ(ierr);
+  ierr = VecSet(nasm->yall,0.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode SNESSetUp_NASM(SNES snes)
 {
   SNES_NASM      *nasm = (SNES_NASM*)snes->data;
@@ -174,6 +332,7 @@ static PetscErrorCode SNESSetUp_NASM(SNES snes)
       ierr = SNESSetUpMatrices(nasm->subsnes[i]);CHKERRQ(ierr);
     }
   }
+  if (nasm->mergescatters) {ierr = SNESNASMSetUpMergedScatters_Private(snes);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
@@ -182,6 +341,7 @@ static PetscErrorCode SNESSetFromOptions_NASM(PetscOptionItems *PetscOptionsObje
   PetscErrorCode    ierr;
   PCASMType         asmtype;
   PetscBool         flg,monflg,subviewflg;
+  PetscInt          lag;
   SNES_NASM         *nasm = (SNES_NASM*)snes->data;
 
   PetscFunctionBegin;
@@ -202,6 +362,9 @@ static PetscErrorCode SNESSetFromOptions_NASM(PetscOptionItems *PetscOptionsObje
   }
   ierr   = PetscOptionsBool("-snes_nasm_finaljacobian","Compute the global jacobian of the final iterate (for ASPIN)","",nasm->finaljacobian,&nasm->finaljacobian,NULL);CHKERRQ(ierr);
   ierr   = PetscOptionsEList("-snes_nasm_finaljacobian_type","The type of the final jacobian computed.","",SNESNASMFJTypes,3,SNESNASMFJTypes[0],&nasm->fjtype,NULL);CHKERRQ(ierr);
+  ierr   = PetscOptionsBool("-snes_nasm_merge_scatters","Restrict to and extend from all local subdomains with one scatter","",nasm->mergescatters,&nasm->mergescatters,NULL);CHKERRQ(ierr);
+  ierr   = PetscOptionsInt("-snes_nasm_jacobian_lag","Rebuild the subdomain Jacobians only in every lag-th local solve","SNESNASMSetJacobianLag",nasm->jaclag,&lag,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = SNESNASMSetJacobianLag(snes,lag);CHKERRQ(ierr);}
   ierr   = PetscOptionsBool("-snes_nasm_log","Log times for subSNES solves and restriction","",monflg,&monflg,&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = PetscLogEventRegister("SNESNASMSubSolve",((PetscObject)snes)->classid,&nasm->eventsubsolve);CHKERRQ(ierr);
@@ -230,6 +393,7 @@ static PetscErrorCode SNESView_NASM(SNES snes, PetscViewer viewer)
   ierr = MPIU_Allreduce(&nasm->n,&N,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer, "  total subdomain blocks = %D\n",N);CHKERRQ(ierr);
+    if (nasm->jaclag > 1) {ierr = PetscViewerASCIIPrintf(viewer,"  subdomain Jacobians are rebuilt every %D local solves\n",nasm->jaclag);CHKERRQ(ierr);}
     if (nasm->same_local_solves) {
       if (nasm->subsnes) {
         ierr = PetscViewerASCIIPrintf(viewer,"  Local solve is the same for all blocks:\n");CHKERRQ(ierr);
@@ -628,6 +792,82 @@ static PetscErrorCode SNESNASMGetDamping_NASM(SNES snes,PetscReal *dmp)
   PetscFunctionReturn(0);
 }
 
+/*@
+   SNESNASMSetJacobianLag - Sets how often the subdomain Jacobians and preconditioners are rebuilt
+
+   Logically collective on SNES
+
+   Input Parameters:
++  snes - the SNES context
+-  lag - the subdomain Jacobians are rebuilt only in every lag-th local solve, 1 rebuilds them as the subdomain solvers ask for
+
+   Options Database:
+.  -snes_nasm_jacobian_lag <lag>
+
+   Level: intermediate
+
+   Notes: In the local solves in between, the subdomain solvers run with the Jacobian and preconditioner of the last
+   rebuild, as with SNESSetLagJacobian() -1, so their Newton iterations become chord iterations.
+   The count runs across calls of SNESSolve(), so the Jacobians are also reused when NASM is the nonlinear preconditioner of
+   another SNES.
+
+.keywords: SNES, NASM, Jacobian, lag
+
+.seealso: SNESNASM, SNESSetLagJacobian(), SNESSetLagPreconditioner()
+@*/
+PetscErrorCode SNESNASMSetJacobianLag(SNES snes,PetscInt lag)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  PetscValidLogicalCollectiveInt(snes,lag,2);
+  ierr = PetscTryMethod(snes,"SNESNASMSetJacobianLag_C",(SNES,PetscInt),(snes,lag));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode SNESNASMSetJacobianLag_NASM(SNES snes,PetscInt lag)
+{
+  SNES_NASM      *nasm = (SNES_NASM*)snes->data;
+
+  PetscFunctionBegin;
+  if (lag < 1) SETERRQ1(PetscObjectComm((PetscObject)snes),PETSC_ERR_ARG_OUTOFRANGE,"Lag must be positive, you gave %D",lag);
+  nasm->jaclag = lag;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Solves on subdomain i from its restricted solution and right hand side, and leaves the damped update in y[i]
+*/
+static PetscErrorCode SNESNASMSubSolve_Private(SNES snes,PetscInt i,Vec Bl,PetscBool reuse)
+{
+  SNES_NASM      *nasm = (SNES_NASM*)snes->data;
+  SNES           subsnes = nasm->subsnes[i];
+  Vec            Xl = nasm->x[i],Yl = nasm->y[i];
+  PetscInt       lag,lagpre;
+  DM             dm,subdm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  ierr = SNESGetDM(subsnes,&subdm);CHKERRQ(ierr);
+  ierr = DMSubDomainRestrict(dm,nasm->oscatter[i],nasm->gscatter[i],subdm);CHKERRQ(ierr);
+  ierr = VecCopy(Xl,Yl);CHKERRQ(ierr);
+  lag    = subsnes->lagjacobian;
+  lagpre = subsnes->lagpreconditioner;
+  if (reuse) {
+    subsnes->lagjacobian       = -1;
+    subsnes->lagpreconditioner = -1;
+  }
+  ierr = SNESSolve(subsnes,Bl,Xl);CHKERRQ(ierr);
+  if (reuse) {
+    subsnes->lagjacobian       = lag;
+    subsnes->lagpreconditioner = lagpre;
+  }
+  ierr = VecAYPX(Yl,-1.0,Xl);CHKERRQ(ierr);
+  ierr = VecScale(Yl, nasm->damping);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 /*
   Input Parameters:
@@ -638,83 +878,97 @@ static PetscErrorCode SNESNASMGetDamping_NASM(SNES snes,PetscReal *dmp)
   Output Parameters:
 . Y - The solution update
 
-  TODO: All scatters should be packed into one
+  With merged scatters the solution (and the RHS) of all local subdomains is restricted with one scatter and the
+  updates are added back with one scatter, otherwise each subdomain scatters on its own.
 */
 PetscErrorCode SNESNASMSolveLocal_Private(SNES snes,Vec B,Vec Y,Vec X)
 {
   SNES_NASM      *nasm = (SNES_NASM*)snes->data;
-  SNES           subsnes;
   PetscInt       i;
   PetscReal      dmp;
+  PetscBool      reuse;
   PetscErrorCode ierr;
   Vec            Xl,Bl,Yl,Xlloc;
   VecScatter     iscat,oscat,gscat,oscat_copy;
-  DM             dm,subdm;
   PCASMType      type;
 
   PetscFunctionBegin;
   ierr = SNESNASMGetType(snes,&type);CHKERRQ(ierr);
-  ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  if (type != PC_ASM_BASIC && type != PC_ASM_RESTRICT) SETERRQ(PetscObjectComm((PetscObject)snes),PETSC_ERR_ARG_WRONGSTATE,"Only basic and restrict types are supported for SNESNASM");
+  reuse = (nasm->jaclag > 1 && nasm->nlocalsolves % nasm->jaclag) ? PETSC_TRUE : PETSC_FALSE;
+  nasm->nlocalsolves++;
   ierr = VecSet(Y,0);CHKERRQ(ierr);
-  if (nasm->eventrestrictinterp) {ierr = PetscLogEventBegin(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
-  for (i=0; i<nasm->n; i++) {
-    /* scatter the solution to the global solution and the local solution */
-    Xl      = nasm->x[i];
-    Xlloc   = nasm->xl[i];
-    oscat   = nasm->oscatter[i];
-    oscat_copy = nasm->oscatter_copy[i];
-    gscat   = nasm->gscatter[i];
-    ierr = VecScatterBegin(oscat,X,Xl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterBegin(gscat,X,Xlloc,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    if (B) {
-      /* scatter the RHS to the local RHS */
-      Bl   = nasm->b[i];
-      ierr = VecScatterBegin(oscat_copy,B,Bl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  if (nasm->xmscatter && (type == PC_ASM_BASIC || nasm->imscatter)) {
+    if (nasm->eventrestrictinterp) {ierr = PetscLogEventBegin(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
+    ierr = VecScatterBegin(nasm->xmscatter,X,nasm->xall,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    if (B) {ierr = VecScatterBegin(nasm->omscatter,B,nasm->ball,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);}
+    ierr = VecScatterEnd(nasm->xmscatter,X,nasm->xall,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    if (B) {ierr = VecScatterEnd(nasm->omscatter,B,nasm->ball,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);}
+    if (nasm->eventrestrictinterp) {ierr = PetscLogEventEnd(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
+    if (nasm->eventsubsolve) {ierr = PetscLogEventBegin(nasm->eventsubsolve,snes,0,0,0);CHKERRQ(ierr);}
+    for (i=0; i<nasm->n; i++) {
+      ierr = SNESNASMSubSolve_Private(snes,i,B ? nasm->b[i] : NULL,reuse);CHKERRQ(ierr);
     }
-  }
-  if (nasm->eventrestrictinterp) {ierr = PetscLogEventEnd(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
-
+    if (nasm->eventsubsolve) {ierr = PetscLogEventEnd(nasm->eventsubsolve,snes,0,0,0);CHKERRQ(ierr);}
+    if (nasm->eventrestrictinterp) {ierr = PetscLogEventBegin(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
+    oscat = type == PC_ASM_BASIC ? nasm->omscatter : nasm->imscatter;
+    ierr  = VecScatterBegin(oscat,nasm->yall,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    ierr  = VecScatterEnd(oscat,nasm->yall,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  } else {
+    if (nasm->eventrestrictinterp) {ierr = PetscLogEventBegin(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
+    for (i=0; i<nasm->n; i++) {
+      /* scatter the solution to the global solution and the local solution */
+      Xl      = nasm->x[i];
+      Xlloc   = nasm->xl[i];
+      oscat   = nasm->oscatter[i];
+      oscat_copy = nasm->oscatter_copy[i];
+      gscat   = nasm->gscatter[i];
+      ierr = VecScatterBegin(oscat,X,Xl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+      ierr = VecScatterBegin(gscat,X,Xlloc,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+      if (B) {
+        /* scatter the RHS to the local RHS */
+        Bl   = nasm->b[i];
+        ierr = VecScatterBegin(oscat_copy,B,Bl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+      }
+    }
+    if (nasm->eventrestrictinterp) {ierr = PetscLogEventEnd(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
 
-  if (nasm->eventsubsolve) {ierr = PetscLogEventBegin(nasm->eventsubsolve,snes,0,0,0);CHKERRQ(ierr);}
-  for (i=0; i<nasm->n; i++) {
-    Xl    = nasm->x[i];
-    Xlloc = nasm->xl[i];
-    Yl    = nasm->y[i];
-    subsnes = nasm->subsnes[i];
-    ierr    = SNESGetDM(subsnes,&subdm);CHKERRQ(ierr);
-    iscat   = nasm->iscatter[i];
-    oscat   = nasm->oscatter[i];
-    oscat_copy = nasm->oscatter_copy[i];
-    gscat   = nasm->gscatter[i];
-    ierr = VecScatterEnd(oscat,X,Xl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(gscat,X,Xlloc,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    if (B) {
-      Bl   = nasm->b[i];
-      ierr = VecScatterEnd(oscat_copy,B,Bl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    } else Bl = NULL;
 
-    ierr = DMSubDomainRestrict(dm,oscat,gscat,subdm);CHKERRQ(ierr);
-    ierr = VecCopy(Xl,Yl);CHKERRQ(ierr);
-    ierr = SNESSolve(subsnes,Bl,Xl);CHKERRQ(ierr);
-    ierr = VecAYPX(Yl,-1.0,Xl);CHKERRQ(ierr);
-    ierr = VecScale(Yl, nasm->damping);CHKERRQ(ierr);
-    if (type == PC_ASM_BASIC) {
-      ierr = VecScatterBegin(oscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-    } else if (type == PC_ASM_RESTRICT) {
-      ierr = VecScatterBegin(iscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-    } else SETERRQ(PetscObjectComm((PetscObject)snes),PETSC_ERR_ARG_WRONGSTATE,"Only basic and restrict types are supported for SNESNASM");
-  }
-  if (nasm->eventsubsolve) {ierr = PetscLogEventEnd(nasm->eventsubsolve,snes,0,0,0);CHKERRQ(ierr);}
-  if (nasm->eventrestrictinterp) {ierr = PetscLogEventBegin(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
-  for (i=0; i<nasm->n; i++) {
-    Yl    = nasm->y[i];
-    iscat   = nasm->iscatter[i];
-    oscat   = nasm->oscatter[i];
-    if (type == PC_ASM_BASIC) {
-      ierr = VecScatterEnd(oscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-    } else if (type == PC_ASM_RESTRICT) {
-      ierr = VecScatterEnd(iscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-    } else SETERRQ(PetscObjectComm((PetscObject)snes),PETSC_ERR_ARG_WRONGSTATE,"Only basic and restrict types are supported for SNESNASM");
+    if (nasm->eventsubsolve) {ierr = PetscLogEventBegin(nasm->eventsubsolve,snes,0,0,0);CHKERRQ(ierr);}
+    for (i=0; i<nasm->n; i++) {
+      Xl    = nasm->x[i];
+      Xlloc = nasm->xl[i];
+      Yl    = nasm->y[i];
+      iscat   = nasm->iscatter[i];
+      oscat   = nasm->oscatter[i];
+      oscat_copy = nasm->oscatter_copy[i];
+      gscat   = nasm->gscatter[i];
+      ierr = VecScatterEnd(oscat,X,Xl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+      ierr = VecScatterEnd(gscat,X,Xlloc,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+      if (B) {
+        Bl   = nasm->b[i];
+        ierr = VecScatterEnd(oscat_copy,B,Bl,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+      } else Bl = NULL;
+
+      ierr = SNESNASMSubSolve_Private(snes,i,Bl,reuse);CHKERRQ(ierr);
+      if (type == PC_ASM_BASIC) {
+        ierr = VecScatterBegin(oscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      } else {
+        ierr = VecScatterBegin(iscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      }
+    }
+    if (nasm->eventsubsolve) {ierr = PetscLogEventEnd(nasm->eventsubsolve,snes,0,0,0);CHKERRQ(ierr);}
+    if (nasm->eventrestrictinterp) {ierr = PetscLogEventBegin(nasm->eventrestrictinterp,snes,0,0,0);CHKERRQ(ierr);}
+    for (i=0; i<nasm->n; i++) {
+      Yl    = nasm->y[i];
+      iscat   = nasm->iscatter[i];
+      oscat   = nasm->oscatter[i];
+      if (type == PC_ASM_BASIC) {
+        ierr = VecScatterEnd(oscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      } else {
+        ierr = VecScatterEnd(iscat,Yl,Y,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      }
+    }
   }
   if (nasm->weight_set) {
     ierr = VecPointwiseMult(Y,Y,nasm->weight);CHKERRQ(ierr);
@@ -872,17 +1126,22 @@ static PetscErrorCode SNESSolve_NASM(SNES snes)
 .  -snes_asm_damping <dmp> - the new solution is obtained as old solution plus dmp times (sum of the solutions on the subdomains)
 .  -snes_nasm_finaljacobian - compute the local and global jacobians of the final iterate
 .  -snes_nasm_finaljacobian_type <finalinner,finalouter,initial> - pick state the jacobian is calculated at
+.  -snes_nasm_merge_scatters <true> - restrict to and extend from all local subdomains with one scatter
+.  -snes_nasm_jacobian_lag <lag> - rebuild the subdomain Jacobians only in every lag-th local solve
 .  -sub_snes_ - options prefix of the subdomain nonlinear solves
 .  -sub_ksp_ - options prefix of the subdomain Krylov solver
 -  -sub_pc_ - options prefix of the subdomain preconditioner
 
    Level: advanced
 
+   Notes: The local subdomains of a process are solved one after another. PETSc objects are not thread safe, so to use all
+   the cores of a node run one MPI process per core.
+
    References:
 .  1. - Peter R. Brune, Matthew G. Knepley, Barry F. Smith, and Xuemin Tu, "Composing Scalable Nonlinear Algebraic Solvers",
    SIAM Review, 57(4), 2015
 
-.seealso: SNESCreate(), SNES, SNESSetType(), SNESType (for list of available types), SNESNASMSetType(), SNESNASMGetType(), SNESNASMSetSubdomains(), SNESNASMGetSubdomains(), SNESNASMGetSubdomainVecs(), SNESNASMSetComputeFinalJacobian(), SNESNASMSetDamping(), SNESNASMGetDamping()
+.seealso: SNESCreate(), SNES, SNESSetType(), SNESType (for list of available types), SNESNASMSetType(), SNESNASMGetType(), SNESNASMSetSubdomains(), SNESNASMGetSubdomains(), SNESNASMGetSubdomainVecs(), SNESNASMSetComputeFinalJacobian(), SNESNASMSetDamping(), SNESNASMGetDamping(), SNESNASMSetJacobianLag()
 M*/
 
 PETSC_EXTERN PetscErrorCode SNESCreate_NASM(SNES snes)
@@ -910,6 +1169,8 @@ PETSC_EXTERN PetscErrorCode SNESCreate_NASM(SNES snes)
   nasm->finaljacobian     = PETSC_FALSE;
   nasm->same_local_solves = PETSC_TRUE;
   nasm->weight_set        = PETSC_FALSE;
+  nasm->mergescatters     = PETSC_TRUE;
+  nasm->jaclag            = 1;
 
   snes->ops->destroy        = SNESDestroy_NASM;
   snes->ops->setup          = SNESSetUp_NASM;
@@ -941,6 +1202,7 @@ PETSC_EXTERN PetscErrorCode SNESCreate_NASM(SNES snes)
   ierr = PetscObjectComposeFunction((PetscObject)snes,"SNESNASMGetDamping_C",SNESNASMGetDamping_NASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)snes,"SNESNASMGetSubdomainVecs_C",SNESNASMGetSubdomainVecs_NASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)snes,"SNESNASMSetComputeFinalJacobian_C",SNESNASMSetComputeFinalJacobian_NASM);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)snes,"SNESNASMSetJacobianLag_C",SNESNASMSetJacobianLag_NASM);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
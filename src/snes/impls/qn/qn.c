@@ -2,6 +2,7 @@
 #include <petscdm.h>
 
 #define H(i,j)  qn->dXdFmat[i*qn->m + j]
+#define G(i,j)  qn->dFdFmat[i*qn->m + j]
 
 const char *const SNESQNScaleTypes[] =        {"DEFAULT","NONE","SHANNO","LINESEARCH","JACOBIAN","SNESQNScaleType","SNES_QN_SCALING_",0};
 const char *const SNESQNRestartTypes[] =      {"DEFAULT","NONE","POWELL","PERIODIC","SNESQNRestartType","SNES_QN_RESTART_",0};
@@ -17,6 +18,10 @@ typedef struct {
   PetscScalar       *dXtdF, *dFtdX, *YtdX;
   PetscBool         singlereduction;      /* Aggregated reduction implementation */
   PetscScalar       *dXdFmat;             /* A matrix of values for dX_i dot dF_j */
+  PetscBool         compact;              /* Compact representation of L-BFGS */
+  PetscScalar       *dFdFmat;             /* A matrix of values for dF_i dot dF_j */
+  PetscScalar       *dFtdF,*YtdF,*coef;   /* work space for the compact representation */
+  Vec               *dXdF;                /* the dX followed by the dF, for VecMAXPY() */
   PetscViewer       monitor;
   PetscReal         powell_gamma;         /* Powell angle restart condition */
   PetscReal         scaling;              /* scaling of H0 */
@@ -274,6 +279,104 @@ PetscErrorCode SNESQNApply_LBFGS(SNES snes,PetscInt it,Vec Y,Vec X,Vec Xold,Vec
   PetscFunctionReturn(0);
 }
 
+/*
+   Compact representation of L-BFGS (Byrd, Nocedal and Schnabel) with H_0 = scaling*I,
+
+     H = H_0 + [S H_0 Z] [R^{-T} (E + Z^T H_0 Z) R^{-1}   -R^{-T}] [S^T    ]
+                         [-R^{-1}                           0    ] [Z^T H_0]
+
+   where S = [dX_0 ... dX_{l-1}] and Z = [dF_0 ... dF_{l-1}] in chronological order, R is the upper triangle of S^T Z and E
+   its diagonal. S^T Z and Z^T Z are updated with the newest pair, and all inner products of an iteration, including those
+   with D, are computed in one reduction. H D is then formed with one VecMAXPY().
+*/
+static PetscErrorCode SNESQNApply_LBFGSCompact(SNES snes,PetscInt it,Vec Y,Vec X,Vec Xold,Vec D,Vec Dold)
+{
+  PetscErrorCode ierr;
+  SNES_QN        *qn    = (SNES_QN*)snes->data;
+  Vec            *dX    = qn->U;
+  Vec            *dF    = qn->V;
+  PetscScalar    *u     = qn->alpha;
+  PetscScalar    *w     = qn->beta;
+  PetscScalar    *coef  = qn->coef;
+  PetscInt       m      = qn->m,l = m;
+  PetscInt       i,j,k,c,d;
+  PetscScalar    gamma,t;
+
+  PetscFunctionBegin;
+  if (it < m) l = it;
+  if (it > 0) {
+    k    = (it-1)%l;
+    ierr = VecWAXPY(dF[k],-1.0,Dold,D);CHKERRQ(ierr);
+    ierr = VecWAXPY(dX[k],-1.0,Xold,X);CHKERRQ(ierr);
+    ierr = VecMDotBegin(dF[k],l,dX,qn->dXtdF);CHKERRQ(ierr);
+    ierr = VecMDotBegin(dX[k],l,dF,qn->dFtdX);CHKERRQ(ierr);
+    ierr = VecMDotBegin(dF[k],l,dF,qn->dFtdF);CHKERRQ(ierr);
+    ierr = VecMDotBegin(D,l,dX,qn->YtdX);CHKERRQ(ierr);
+    ierr = VecMDotBegin(D,l,dF,qn->YtdF);CHKERRQ(ierr);
+    ierr = VecMDotEnd(dF[k],l,dX,qn->dXtdF);CHKERRQ(ierr);
+    ierr = VecMDotEnd(dX[k],l,dF,qn->dFtdX);CHKERRQ(ierr);
+    ierr = VecMDotEnd(dF[k],l,dF,qn->dFtdF);CHKERRQ(ierr);
+    ierr = VecMDotEnd(D,l,dX,qn->YtdX);CHKERRQ(ierr);
+    ierr = VecMDotEnd(D,l,dF,qn->YtdF);CHKERRQ(ierr);
+    for (j=0; j<l; j++) {
+      H(k,j) = qn->dFtdX[j];
+      H(j,k) = qn->dXtdF[j];
+      G(k,j) = G(j,k) = qn->dFtdF[j];
+    }
+    if (qn->scale_type == SNES_QN_SCALE_SHANNO) {
+      qn->scaling = PetscRealPart(H(k,k))/PetscRealPart(G(k,k));
+      if (qn->monitor) {
+        ierr = PetscViewerASCIIAddTab(qn->monitor,((PetscObject)snes)->tablevel+2);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(qn->monitor, "Shanno scaling %D %g\n",it,(double)qn->scaling);CHKERRQ(ierr);
+        ierr = PetscViewerASCIISubtractTab(qn->monitor,((PetscObject)snes)->tablevel+2);CHKERRQ(ierr);
+      }
+    } else if (qn->scale_type == SNES_QN_SCALE_LINESEARCH) {
+      ierr = SNESLineSearchGetLambda(snes->linesearch,&qn->scaling);CHKERRQ(ierr);
+    }
+  }
+  gamma = qn->scaling;
+  ierr  = VecAXPBY(Y,gamma,0.0,D);CHKERRQ(ierr);
+  if (!l) PetscFunctionReturn(0);
+
+  /* u = R^{-1} S^T D, the chronological position c is stored at (it-l+c)%l */
+  for (c=l-1; c>=0; c--) {
+    i = (it-l+c)%l;
+    t = qn->YtdX[i];
+    for (d=c+1; d<l; d++) {
+      j  = (it-l+d)%l;
+      t -= H(i,j)*u[j];
+    }
+    u[i] = t/H(i,i);
+  }
+  /* w = R^{-T} ((E + gamma Z^T Z) u - gamma Z^T D) */
+  for (c=0; c<l; c++) {
+    i = (it-l+c)%l;
+    t = H(i,i)*u[i] - gamma*qn->YtdF[i];
+    for (d=0; d<l; d++) {
+      j  = (it-l+d)%l;
+      t += gamma*G(i,j)*u[j];
+    }
+    for (d=0; d<c; d++) {
+      j  = (it-l+d)%l;
+      t -= H(j,i)*w[j];
+    }
+    w[i] = t/H(i,i);
+  }
+  for (i=0; i<l; i++) {
+    qn->dXdF[i]   = dX[i];
+    qn->dXdF[l+i] = dF[i];
+    coef[i]       = w[i];
+    coef[l+i]     = -gamma*u[i];
+    if (qn->monitor) {
+      ierr = PetscViewerASCIIAddTab(qn->monitor,((PetscObject)snes)->tablevel+2);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPrintf(qn->monitor, "it: %D k: %D dX coefficient: %14.12e dF coefficient: %14.12e\n",it,i,(double)PetscRealPart(coef[i]),(double)PetscRealPart(coef[l+i]));CHKERRQ(ierr);
+      ierr = PetscViewerASCIISubtractTab(qn->monitor,((PetscObject)snes)->tablevel+2);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecMAXPY(Y,2*l,coef,qn->dXdF);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode SNESSolve_QN(SNES snes)
 {
   PetscErrorCode       ierr;
@@ -287,6 +390,7 @@ static PetscErrorCode SNESSolve_QN(SNES snes)
   PetscBool            powell,periodic;
   PetscScalar          DolddotD,DolddotDold;
   SNESConvergedReason  reason;
+  PetscBool            compact = (PetscBool)(qn->type == SNES_QN_LBFGS && qn->compact && qn->scale_type != SNES_QN_SCALE_JACOBIAN);
 
   /* basically just a regular newton's method except for the application of the Jacobian */
 
@@ -368,7 +472,7 @@ static PetscErrorCode SNESSolve_QN(SNES snes)
   }
 
   for (i = 0, i_r = 0; i < snes->max_its; i++, i_r++) {
-    if (qn->scale_type == SNES_QN_SCALE_SHANNO && i_r > 0) {
+    if (qn->scale_type == SNES_QN_SCALE_SHANNO && i_r > 0 && !compact) {
       PetscScalar ff,xf;
       ierr = VecCopy(Dold,Y);CHKERRQ(ierr);
       ierr = VecCopy(Xold,W);CHKERRQ(ierr);
@@ -393,7 +497,11 @@ static PetscErrorCode SNESSolve_QN(SNES snes)
       ierr = SNESQNApply_Broyden(snes,i_r,Y,X,Xold,D);CHKERRQ(ierr);
       break;
     case SNES_QN_LBFGS:
-      SNESQNApply_LBFGS(snes,i_r,Y,X,Xold,D,Dold);CHKERRQ(ierr);
+      if (compact) {
+        ierr = SNESQNApply_LBFGSCompact(snes,i_r,Y,X,Xold,D,Dold);CHKERRQ(ierr);
+      } else {
+        ierr = SNESQNApply_LBFGS(snes,i_r,Y,X,Xold,D,Dold);CHKERRQ(ierr);
+      }
       break;
     }
     /* line search for lambda */
@@ -514,9 +622,12 @@ static PetscErrorCode SNESSetUp_QN(SNES snes)
   if (qn->type != SNES_QN_BROYDEN) ierr = VecDuplicateVecs(snes->vec_sol, qn->m, &qn->V);CHKERRQ(ierr);
   ierr = PetscMalloc4(qn->m,&qn->alpha,qn->m,&qn->beta,qn->m,&qn->dXtdF,qn->m,&qn->lambda);CHKERRQ(ierr);
 
-  if (qn->singlereduction) {
+  if (qn->singlereduction || qn->compact) {
     ierr = PetscMalloc3(qn->m*qn->m,&qn->dXdFmat,qn->m,&qn->dFtdX,qn->m,&qn->YtdX);CHKERRQ(ierr);
   }
+  if (qn->compact) {
+    ierr = PetscMalloc5(qn->m*qn->m,&qn->dFdFmat,qn->m,&qn->dFtdF,qn->m,&qn->YtdF,2*qn->m,&qn->coef,2*qn->m,&qn->dXdF);CHKERRQ(ierr);
+  }
   ierr = SNESSetWorkVecs(snes,4);CHKERRQ(ierr);
   /* set method defaults */
   if (qn->scale_type == SNES_QN_SCALE_DEFAULT) {
@@ -555,9 +666,12 @@ static PetscErrorCode SNESReset_QN(SNES snes)
     if (qn->V) {
       ierr = VecDestroyVecs(qn->m, &qn->V);CHKERRQ(ierr);
     }
-    if (qn->singlereduction) {
+    if (qn->singlereduction || qn->compact) {
       ierr = PetscFree3(qn->dXdFmat, qn->dFtdX, qn->YtdX);CHKERRQ(ierr);
     }
+    if (qn->compact) {
+      ierr = PetscFree5(qn->dFdFmat,qn->dFtdF,qn->YtdF,qn->coef,qn->dXdF);CHKERRQ(ierr);
+    }
     ierr = PetscFree4(qn->alpha,qn->beta,qn->dXtdF,qn->lambda);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
@@ -591,6 +705,7 @@ static PetscErrorCode SNESSetFromOptions_QN(PetscOptionItems *PetscOptionsObject
   ierr = PetscOptionsReal("-snes_qn_powell_gamma","Powell angle tolerance",          "SNESQN", qn->powell_gamma, &qn->powell_gamma, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-snes_qn_monitor",         "Monitor for the QN methods",      "SNESQN", monflg, &monflg, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-snes_qn_single_reduction", "Aggregate reductions",           "SNESQN", qn->singlereduction, &qn->singlereduction, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-snes_qn_compact",         "Use the compact representation of L-BFGS","SNESQN", qn->compact, &qn->compact, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnum("-snes_qn_scale_type","Scaling type","SNESQNSetScaleType",SNESQNScaleTypes,(PetscEnum)stype,(PetscEnum*)&stype,&flg);CHKERRQ(ierr);
   if (flg) ierr = SNESQNSetScaleType(snes,stype);CHKERRQ(ierr);
 
@@ -627,7 +742,9 @@ static PetscErrorCode SNESView_QN(SNES snes, PetscViewer viewer)
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer,"  type is %s, restart type is %s, scale type is %s\n",SNESQNTypes[qn->type],SNESQNRestartTypes[qn->restart_type],SNESQNScaleTypes[qn->scale_type]);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  Stored subspace size: %D\n", qn->m);CHKERRQ(ierr);
-    if (qn->singlereduction) {
+    if (qn->type == SNES_QN_LBFGS && qn->compact) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  Using the compact representation.\n");CHKERRQ(ierr);
+    } else if (qn->singlereduction) {
       ierr = PetscViewerASCIIPrintf(viewer,"  Using the single reduction variant.\n");CHKERRQ(ierr);
     }
   }
@@ -774,6 +891,8 @@ PetscErrorCode SNESQNSetType_QN(SNES snes, SNESQNType qtype)
 .     -snes_qn_type <lbfgs,broyden,badbroyden> - QN type
 .     -snes_qn_scale_type <shanno,none,linesearch,jacobian> - scaling performed on inner Jacobian
 .     -snes_linesearch_type <cp, l2, basic> - Type of line search.
+.     -snes_qn_single_reduction - Aggregate the inner products of the L-BFGS recursion
+.     -snes_qn_compact - Use the compact representation of L-BFGS
 -     -snes_qn_monitor - Monitors the quasi-newton Jacobian.
 
       Notes: This implements the L-BFGS, Broyden, and "Bad" Broyden algorithms for the solution of F(x) = b using
@@ -785,6 +904,10 @@ PetscErrorCode SNESQNSetType_QN(SNES snes, SNESQNType qtype)
       iteration as the current iteration's values when constructing the approximate Jacobian.  The second, composed,
       perturbs the problem the Jacobian represents to be P(x, b) - x = 0, where P(x, b) is the preconditioner.
 
+      The compact representation of L-BFGS [2] keeps the matrices of inner products of the stored updates and needs a
+      single global reduction and a single VecMAXPY() per iteration, instead of the two-loop recursion. It is not used
+      with -snes_qn_scale_type jacobian, since the initial inverse Jacobian is then not a multiple of the identity.
+
       Uses left nonlinear preconditioning by default.
 
       References:
@@ -837,6 +960,7 @@ PETSC_EXTERN PetscErrorCode SNESCreate_QN(SNES snes)
   qn->dXdFmat         = NULL;
   qn->monitor         = NULL;
   qn->singlereduction = PETSC_TRUE;
+  qn->compact         = PETSC_FALSE;
   qn->powell_gamma    = 0.9999;
   qn->scale_type      = SNES_QN_SCALE_DEFAULT;
   qn->restart_type    = SNES_QN_RESTART_DEFAULT;
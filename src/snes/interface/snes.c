@@ -1,5 +1,6 @@
 
 #include <petsc/private/snesimpl.h>      /*I "petscsnes.h"  I*/
+#include <petsc/private/vecimpl.h>
 #include <petscdmshell.h>
 #include <petscdraw.h>
 #include <petscds.h>
@@ -321,6 +322,9 @@ PetscErrorCode  SNESView(SNES snes,PetscViewer viewer)
     } else if (snes->lagjacobian > 1) {
       ierr = PetscViewerASCIIPrintf(viewer,"  Jacobian is rebuilt every %D SNES iterations\n",snes->lagjacobian);CHKERRQ(ierr);
     }
+    if (snes->lagjacpartial > 0.0) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  Jacobian rows are refreshed when their residual changed by more than %g of the largest change\n",(double)snes->lagjacpartial);CHKERRQ(ierr);
+    }
   } else if (isstring) {
     const char *type;
     ierr = SNESGetType(snes,&type);CHKERRQ(ierr);
@@ -713,6 +717,7 @@ PetscErrorCode  SNESMonitorSetFromOptions(SNES snes,const char name[],const char
 .  -snes_max_linear_solve_fail - number of linear solver failures before SNESSolve() stops
 .  -snes_lag_preconditioner <lag> - how often preconditioner is rebuilt (use -1 to never rebuild)
 .  -snes_lag_jacobian <lag> - how often Jacobian is rebuilt (use -1 to never rebuild)
+.  -snes_lag_jacobian_partial <rtol> - refresh only the Jacobian rows whose residual changed by more than rtol times the largest change
 .  -snes_trtol <trtol> - trust region tolerance
 .  -snes_no_convergence_test - skip convergence test in nonlinear
                                solver; hence iterations will continue until max_it
@@ -753,6 +758,7 @@ PetscErrorCode  SNESSetFromOptions(SNES snes)
 {
   PetscBool      flg,pcset,persist,set;
   PetscInt       i,indx,lag,grids;
+  PetscReal      rtol;
   const char     *deft        = SNESNEWTONLS;
   const char     *convtests[] = {"default","skip"};
   SNESKSPEW      *kctx        = NULL;
@@ -800,6 +806,10 @@ PetscErrorCode  SNESSetFromOptions(SNES snes)
   if (flg) {
     ierr = SNESSetLagJacobianPersists(snes,persist);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsReal("-snes_lag_jacobian_partial","Refresh only the Jacobian rows whose residual changed by more than this fraction of the largest change","SNESSetLagJacobianPartial",snes->lagjacpartial,&rtol,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = SNESSetLagJacobianPartial(snes,rtol);CHKERRQ(ierr);
+  }
 
   ierr = PetscOptionsInt("-snes_grid_sequence","Use grid sequencing to generate initial guess","SNESSetGridSequence",snes->gridsequence,&grids,&flg);CHKERRQ(ierr);
   if (flg) {
@@ -1595,6 +1605,7 @@ PetscErrorCode  SNESCreate(MPI_Comm comm,SNES *outsnes)
   snes->lagpreconditioner = 1;
   snes->pre_iter          = 0;
   snes->lagpre_persist    = PETSC_FALSE;
+  snes->lagjacpartial     = 0.0;
   snes->numbermonitors    = 0;
   snes->data              = 0;
   snes->setupcalled       = PETSC_FALSE;
@@ -2194,9 +2205,18 @@ PetscErrorCode  SNESComputeFunction(SNES snes,Vec x,Vec y)
     }
     ierr = VecLockPush(x);CHKERRQ(ierr);
     PetscStackPush("SNES user function");
-    ierr = (*sdm->ops->computefunction)(snes,x,y,sdm->functionctx);CHKERRQ(ierr);
+    if (sdm->ops->computefunctionnorm) {
+      ierr = (*sdm->ops->computefunctionnorm)(snes,x,y,&snes->fnormlocal,sdm->functionnormctx);CHKERRQ(ierr);
+    } else {
+      ierr = (*sdm->ops->computefunction)(snes,x,y,sdm->functionctx);CHKERRQ(ierr);
+    }
     PetscStackPop;
     ierr = VecLockPop(x);CHKERRQ(ierr);
+    if (sdm->ops->computefunctionnorm) {
+      /* remember which residual the local norm belongs to; any later change of y invalidates it */
+      ierr = PetscObjectGetId((PetscObject)y,&snes->fnormlocalid);CHKERRQ(ierr);
+      ierr = PetscObjectStateGet((PetscObject)y,&snes->fnormlocalstate);CHKERRQ(ierr);
+    }
     if (sdm->ops->computefunction != SNESObjectiveComputeFunctionDefaultFD) {
       ierr = PetscLogEventEnd(SNES_FunctionEval,snes,x,y,0);CHKERRQ(ierr);
     }
@@ -2217,6 +2237,80 @@ PetscErrorCode  SNESComputeFunction(SNES snes,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*@
+   SNESFunctionNormBegin - Starts a split phase computation of the 2-norm of a residual computed with SNESComputeFunction()
+
+   Collective on SNES
+
+   Input Parameters:
++  snes - the SNES context
+-  f - the residual
+
+   Output Parameter:
+.  fnorm - where the norm will go, available after SNESFunctionNormEnd()
+
+   Notes:
+   If f was computed by SNESComputeFunction() with a function set with SNESSetFunctionAndNorm() and has not been changed
+   since, the local part of the norm returned by that function is used and f is not read again. Otherwise this is
+   the same as VecNormBegin(f,NORM_2,fnorm).
+
+   The reduction is combined with the other split phase operations started on the communicator, such as VecDotBegin()
+   and VecNormBegin(), before the matching End calls.
+
+   Level: developer
+
+.keywords: SNES, nonlinear, function, norm
+
+.seealso: SNESFunctionNormEnd(), SNESSetFunctionAndNorm(), SNESComputeFunction(), VecNormBegin()
+@*/
+PetscErrorCode SNESFunctionNormBegin(SNES snes,Vec f,PetscReal *fnorm)
+{
+  PetscErrorCode   ierr;
+  PetscObjectId    id;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  PetscValidHeaderSpecific(f,VEC_CLASSID,2);
+  ierr = PetscObjectGetId((PetscObject)f,&id);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)f,&state);CHKERRQ(ierr);
+  if (snes->fnormlocalstate && id == snes->fnormlocalid && state == snes->fnormlocalstate) {
+    ierr = VecNormBeginLocal_Private(f,NORM_2,&snes->fnormlocal);CHKERRQ(ierr);
+  } else {
+    ierr = VecNormBegin(f,NORM_2,fnorm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   SNESFunctionNormEnd - Ends a split phase computation of the 2-norm of a residual started with SNESFunctionNormBegin()
+
+   Collective on SNES
+
+   Input Parameters:
++  snes - the SNES context
+-  f - the residual
+
+   Output Parameter:
+.  fnorm - the 2-norm of f
+
+   Level: developer
+
+.keywords: SNES, nonlinear, function, norm
+
+.seealso: SNESFunctionNormBegin(), SNESSetFunctionAndNorm(), VecNormEnd()
+@*/
+PetscErrorCode SNESFunctionNormEnd(SNES snes,Vec f,PetscReal *fnorm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  PetscValidHeaderSpecific(f,VEC_CLASSID,2);
+  ierr = VecNormEnd(f,NORM_2,fnorm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    SNESComputeNGS - Calls the Gauss-Seidel function that has been set with  SNESSetNGS().
 
@@ -2838,6 +2932,7 @@ PetscErrorCode  SNESReset(SNES snes)
   ierr = VecDestroy(&snes->vec_rhs);CHKERRQ(ierr);
   ierr = VecDestroy(&snes->vec_sol);CHKERRQ(ierr);
   ierr = VecDestroy(&snes->vec_sol_update);CHKERRQ(ierr);
+  ierr = VecDestroy(&snes->vec_jacrefresh);CHKERRQ(ierr);
   ierr = VecDestroy(&snes->vec_func);CHKERRQ(ierr);
   ierr = MatDestroy(&snes->jacobian);CHKERRQ(ierr);
   ierr = MatDestroy(&snes->jacobian_pre);CHKERRQ(ierr);
@@ -3139,6 +3234,74 @@ PetscErrorCode  SNESSetLagJacobianPersists(SNES snes,PetscBool flg)
   PetscFunctionReturn(0);
 }
 
+/*@
+   SNESSetLagJacobianPartial - Refresh only the rows of the Jacobian whose residual changed significantly
+
+   Logically Collective on SNES
+
+   Input Parameters:
++  snes - the SNES context
+-  rtol - a row is recomputed when its residual changed by more than rtol times the largest change of any row since
+          the rows were last computed; 0 (the default) recomputes the whole Jacobian
+
+   Options Database Keys:
+.    -snes_lag_jacobian_partial <rtol>
+
+   Notes:
+   This is useful when most of the rows change little between Newton steps while the rows of a localized feature,
+   such as a reaction front, change a lot. The first Jacobian of each nonlinear solve is computed in full.
+
+   This currently applies to Jacobians of AIJ matrices computed by finite differences with coloring, through
+   SNESComputeJacobianDefaultColor() or a DMDA local residual. Colors that do not perturb any refreshed row are
+   skipped and the matrix values are updated in place, without assembling the matrix again. The full residual is still
+   evaluated for every remaining color; with a DMDA local residual it is only evaluated near the refreshed rows if
+   DMDASNESSetFunctionLocalSubBoxes() or -snes_dmda_fd_subboxes is used, together with -dm_is_coloring_type ghosted and
+   -mat_fd_type ds.
+
+   Level: advanced
+
+.keywords: SNES, nonlinear, lag, Jacobian, coloring
+
+.seealso: SNESSetLagJacobian(), SNESGetLagJacobianPartial(), SNESComputeJacobianDefaultColor(), MatFDColoringSetActiveRows(), DMDASNESSetFunctionLocalSubBoxes()
+
+@*/
+PetscErrorCode  SNESSetLagJacobianPartial(SNES snes,PetscReal rtol)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  PetscValidLogicalCollectiveReal(snes,rtol,2);
+  if (rtol < 0.0 || rtol > 1.0) SETERRQ1(PetscObjectComm((PetscObject)snes),PETSC_ERR_ARG_OUTOFRANGE,"Tolerance %g must be in [0,1]",(double)rtol);
+  snes->lagjacpartial = rtol;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   SNESGetLagJacobianPartial - Gets the tolerance used to refresh only some rows of the Jacobian
+
+   Not Collective
+
+   Input Parameter:
+.  snes - the SNES context
+
+   Output Parameter:
+.  rtol - the tolerance set with SNESSetLagJacobianPartial(), 0 if the whole Jacobian is recomputed
+
+   Level: advanced
+
+.keywords: SNES, nonlinear, lag, Jacobian, coloring
+
+.seealso: SNESSetLagJacobianPartial()
+
+@*/
+PetscErrorCode  SNESGetLagJacobianPartial(SNES snes,PetscReal *rtol)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  PetscValidRealPointer(rtol,2);
+  *rtol = snes->lagjacpartial;
+  PetscFunctionReturn(0);
+}
+
 /*@
    SNESSetLagPreconditionerPersists - Set whether or not the preconditioner lagging persists through multiple solves
 
@@ -4376,6 +4539,81 @@ PetscErrorCode  SNESGetFunction(SNES snes,Vec *r,PetscErrorCode (**f)(SNES,Vec,V
   PetscFunctionReturn(0);
 }
 
+/*@C
+   SNESSetFunctionAndNorm - Sets a residual evaluation routine that also returns the local part of the square of the
+   2-norm of the residual, so that the line searches obtain the norm without another pass over the residual
+
+   Logically Collective on SNES
+
+   Input Parameters:
++  snes - the SNES context
+.  f - the residual evaluation routine
+-  ctx - [optional] user-defined context for private data for the routine (may be NULL)
+
+   Calling sequence of f:
+$  f(SNES snes,Vec x,Vec r,PetscReal *lnorm2,void *ctx);
+
++  x - state at which to evaluate the residual
+.  r - the residual
+.  lnorm2 - the sum of the squares of the absolute values of the locally owned entries of r, with no communication
+-  ctx - [optional] user-defined context
+
+   Notes:
+   The routine computes the same residual as the one given with SNESSetFunction(), which must still be provided since
+   it is used where the norm is not needed, for example by finite difference Jacobians. When this routine is set,
+   SNESComputeFunction() calls it instead.
+
+   The norm is only used if the residual is not changed afterwards, so a right hand side given to SNESSolve() or a
+   domain error makes the line search fall back to VecNorm().
+
+   Level: advanced
+
+.keywords: SNES, nonlinear, set, function, norm
+
+.seealso: SNESGetFunctionAndNorm(), SNESSetFunction(), SNESFunctionNormBegin(), SNESLINESEARCHBT, SNESLINESEARCHL2, SNESLINESEARCHCP
+@*/
+PetscErrorCode SNESSetFunctionAndNorm(SNES snes,PetscErrorCode (*f)(SNES,Vec,Vec,PetscReal*,void*),void *ctx)
+{
+  PetscErrorCode ierr;
+  DM             dm;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  ierr = DMSNESSetFunctionAndNorm(dm,f,ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   SNESGetFunctionAndNorm - Returns the residual evaluation routine set with SNESSetFunctionAndNorm()
+
+   Not Collective
+
+   Input Parameter:
+.  snes - the SNES context
+
+   Output Parameters:
++  f - the routine (or NULL)
+-  ctx - the function context (or NULL)
+
+   Level: advanced
+
+.keywords: SNES, nonlinear, get, function, norm
+
+.seealso: SNESSetFunctionAndNorm(), SNESGetFunction()
+@*/
+PetscErrorCode SNESGetFunctionAndNorm(SNES snes,PetscErrorCode (**f)(SNES,Vec,Vec,PetscReal*,void*),void **ctx)
+{
+  PetscErrorCode ierr;
+  DM             dm;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(snes,SNES_CLASSID,1);
+  ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  ierr = DMSNESGetFunctionAndNorm(dm,f,ctx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    SNESGetNGS - Returns the NGS function and context.
 
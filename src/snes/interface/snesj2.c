@@ -11,6 +11,60 @@ static PetscErrorCode SNESComputeFunctionCtx(SNES snes,Vec x,Vec f,void *ctx)
   return SNESComputeFunction(snes,x,f);
 }
 
+/*
+   Selects the rows refreshed by the next MatFDColoringApply() for SNESSetLagJacobianPartial(). snes->vec_jacrefresh holds,
+   for each row, the residual the row was last computed with. The first Jacobian of a solve, and any Jacobian not
+   computed at the current solution, is computed in full.
+*/
+PetscErrorCode SNESFDColoringSetActiveRows_Private(SNES snes,Vec x1,MatFDColoring color)
+{
+  PetscErrorCode    ierr;
+  Vec               F;
+  IS                rows;
+  PetscScalar       *fref;
+  const PetscScalar *f;
+  PetscReal         lmax = 0.0,dmax;
+  PetscInt          i,n,nrows = 0,rstart,*idx;
+
+  PetscFunctionBegin;
+  if (snes->lagjacpartial <= 0.0) PetscFunctionReturn(0);
+  ierr = SNESGetFunction(snes,&F,NULL,NULL);CHKERRQ(ierr);
+  if (snes->vec_rhs || x1 != snes->vec_sol) {
+    ierr = VecDestroy(&snes->vec_jacrefresh);CHKERRQ(ierr);
+    ierr = MatFDColoringSetActiveRows(color,NULL);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!snes->iter || !snes->vec_jacrefresh) {
+    if (!snes->vec_jacrefresh) {ierr = VecDuplicate(F,&snes->vec_jacrefresh);CHKERRQ(ierr);}
+    ierr = VecCopy(F,snes->vec_jacrefresh);CHKERRQ(ierr);
+    ierr = MatFDColoringSetActiveRows(color,NULL);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = VecGetLocalSize(F,&n);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(F,&rstart,NULL);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(F,&f);CHKERRQ(ierr);
+  ierr = VecGetArray(snes->vec_jacrefresh,&fref);CHKERRQ(ierr);
+  for (i=0; i<n; i++) lmax = PetscMax(lmax,PetscAbsScalar(f[i] - fref[i]));
+  ierr = MPIU_Allreduce(&lmax,&dmax,1,MPIU_REAL,MPIU_MAX,PetscObjectComm((PetscObject)snes));CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&idx);CHKERRQ(ierr);
+  if (dmax > 0.0) {
+    for (i=0; i<n; i++) {
+      if (PetscAbsScalar(f[i] - fref[i]) >= snes->lagjacpartial*dmax) {
+        idx[nrows++] = rstart + i;
+        fref[i]      = f[i];
+      }
+    }
+  }
+  ierr = VecRestoreArray(snes->vec_jacrefresh,&fref);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(F,&f);CHKERRQ(ierr);
+  ierr = PetscInfo2(snes,"Refreshing %D of %D local Jacobian rows\n",nrows,n);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PetscObjectComm((PetscObject)snes),nrows,idx,PETSC_OWN_POINTER,&rows);CHKERRQ(ierr);
+  ierr = MatFDColoringSetActiveRows(color,rows);CHKERRQ(ierr);
+  ierr = ISDestroy(&rows);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
     SNESComputeJacobianDefaultColor - Computes the Jacobian using
     finite differences and coloring to exploit matrix sparsity.
@@ -33,7 +87,8 @@ static PetscErrorCode SNESComputeFunctionCtx(SNES snes,Vec x,Vec f,void *ctx)
 .  -snes_fd_color - Activates SNESComputeJacobianDefaultColor() in SNESSetFromOptions()
 .  -mat_fd_coloring_err <err> - Sets <err> (square root of relative error in the function)
 .  -mat_fd_coloring_umin <umin> - Sets umin, the minimum allowable u-value magnitude
--  -mat_fd_type - Either wp or ds (see MATMFFD_WP or MATMFFD_DS)
+.  -mat_fd_type - Either wp or ds (see MATMFFD_WP or MATMFFD_DS)
+-  -snes_lag_jacobian_partial <rtol> - Recompute only the rows whose residual changed significantly, see SNESSetLagJacobianPartial()
 
     Notes: If the coloring is not provided through the context, this will first try to get the
         coloring from the DM.  If the DM type has no coloring routine, then it will try to
@@ -42,7 +97,7 @@ static PetscErrorCode SNESComputeFunctionCtx(SNES snes,Vec x,Vec f,void *ctx)
 
 .keywords: SNES, finite differences, Jacobian, coloring, sparse
 
-.seealso: SNESSetJacobian(), SNESTestJacobian(), SNESComputeJacobianDefault()
+.seealso: SNESSetJacobian(), SNESTestJacobian(), SNESComputeJacobianDefault(), SNESSetLagJacobianPartial()
           MatFDColoringCreate(), MatFDColoringSetFunction()
 
 @*/
@@ -97,6 +152,7 @@ PetscErrorCode  SNESComputeJacobianDefaultColor(SNES snes,Vec x1,Mat J,Mat B,voi
     ierr = SNESGetFunction(snes,&F,NULL,NULL);CHKERRQ(ierr);
     ierr = MatFDColoringSetF(color,F);CHKERRQ(ierr);
   }
+  ierr = SNESFDColoringSetActiveRows_Private(snes,x1,color);CHKERRQ(ierr);
   ierr = MatFDColoringApply(B,color,x1,snes);CHKERRQ(ierr);
   if (J != B) {
     ierr = MatAssemblyBegin(J,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
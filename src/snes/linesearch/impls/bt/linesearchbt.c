@@ -153,7 +153,8 @@ static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
         gnorm = fnorm;
         ierr  = (*linesearch->ops->vinorm)(snes, G, W, &gnorm);CHKERRQ(ierr);
       } else {
-        ierr = VecNorm(G,NORM_2,&gnorm);CHKERRQ(ierr);
+        ierr = SNESFunctionNormBegin(snes,G,&gnorm);CHKERRQ(ierr);
+        ierr = SNESFunctionNormEnd(snes,G,&gnorm);CHKERRQ(ierr);
       }
       g = PetscSqr(gnorm);
     }
@@ -223,7 +224,8 @@ static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
         gnorm = fnorm;
         ierr = (*linesearch->ops->vinorm)(snes, G, W, &gnorm);CHKERRQ(ierr);
       } else {
-        ierr = VecNorm(G,NORM_2,&gnorm);CHKERRQ(ierr);
+        ierr = SNESFunctionNormBegin(snes,G,&gnorm);CHKERRQ(ierr);
+        ierr = SNESFunctionNormEnd(snes,G,&gnorm);CHKERRQ(ierr);
       }
       g = PetscSqr(gnorm);
     }
@@ -306,7 +308,8 @@ static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
             gnorm = fnorm;
             ierr  = (*linesearch->ops->vinorm)(snes, G, W, &gnorm);CHKERRQ(ierr);
           } else {
-            ierr = VecNorm(G,NORM_2,&gnorm);CHKERRQ(ierr);
+            ierr = SNESFunctionNormBegin(snes,G,&gnorm);CHKERRQ(ierr);
+            ierr = SNESFunctionNormEnd(snes,G,&gnorm);CHKERRQ(ierr);
           }
           g = PetscSqr(gnorm);
         }
@@ -367,24 +370,32 @@ static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
   }
   if (changed_y || changed_w || objective) { /* recompute the function norm if the step has changed or the objective isn't the norm */
     ierr = (*linesearch->ops->snesfunc)(snes,W,G);CHKERRQ(ierr);
+    /* all the norms of the new iterate go in a single reduction */
     if (linesearch->ops->vinorm) {
       gnorm = fnorm;
       ierr  = (*linesearch->ops->vinorm)(snes, G, W, &gnorm);CHKERRQ(ierr);
     } else {
-      ierr = VecNorm(G,NORM_2,&gnorm);CHKERRQ(ierr);
+      ierr = SNESFunctionNormBegin(snes,G,&gnorm);CHKERRQ(ierr);
     }
-    ierr = VecNorm(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+    ierr = VecNormBegin(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+    ierr = VecNormBegin(W,NORM_2,&xnorm);CHKERRQ(ierr);
+    if (!linesearch->ops->vinorm) {
+      ierr = SNESFunctionNormEnd(snes,G,&gnorm);CHKERRQ(ierr);
+    }
+    ierr = VecNormEnd(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+    ierr = VecNormEnd(W,NORM_2,&xnorm);CHKERRQ(ierr);
     if (PetscIsInfOrNanReal(gnorm)) {
       ierr = SNESLineSearchSetReason(linesearch,SNES_LINESEARCH_FAILED_NANORINF);CHKERRQ(ierr);
       ierr = PetscInfo(snes,"Aborted due to Nan or Inf in function evaluation\n");CHKERRQ(ierr);
       PetscFunctionReturn(0);
     }
+  } else {
+    ierr = VecNorm(W, NORM_2, &xnorm);CHKERRQ(ierr);
   }
 
   /* copy the solution over */
   ierr = VecCopy(W, X);CHKERRQ(ierr);
   ierr = VecCopy(G, F);CHKERRQ(ierr);
-  ierr = VecNorm(X, NORM_2, &xnorm);CHKERRQ(ierr);
   ierr = SNESLineSearchSetLambda(linesearch, lambda);CHKERRQ(ierr);
   ierr = SNESLineSearchSetNorms(linesearch, xnorm, gnorm, ynorm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -459,7 +470,7 @@ static PetscErrorCode SNESLineSearchSetFromOptions_BT(PetscOptionItems *PetscOpt
 
 .keywords: SNES, SNESLineSearch, damping
 
-.seealso: SNESLineSearchCreate(), SNESLineSearchSetType()
+.seealso: SNESLineSearchCreate(), SNESLineSearchSetType(), SNESSetFunctionAndNorm()
 M*/
 PETSC_EXTERN PetscErrorCode SNESLineSearchCreate_BT(SNESLineSearch linesearch)
 {
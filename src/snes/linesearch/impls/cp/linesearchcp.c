@@ -5,7 +5,7 @@ static PetscErrorCode SNESLineSearchApply_CP(SNESLineSearch linesearch)
 {
   PetscBool      changed_y, changed_w;
   PetscErrorCode ierr;
-  Vec            X, Y, F, W;
+  Vec            X, Y, F, W, G;
   SNES           snes;
   PetscReal      xnorm, ynorm, gnorm, steptol, atol, rtol, ltol, maxstep;
 
@@ -16,7 +16,7 @@ static PetscErrorCode SNESLineSearchApply_CP(SNESLineSearch linesearch)
   PetscViewer monitor;
 
   PetscFunctionBegin;
-  ierr = SNESLineSearchGetVecs(linesearch, &X, &F, &Y, &W, NULL);CHKERRQ(ierr);
+  ierr = SNESLineSearchGetVecs(linesearch, &X, &F, &Y, &W, &G);CHKERRQ(ierr);
   ierr = SNESLineSearchGetNorms(linesearch, &xnorm, &gnorm, &ynorm);CHKERRQ(ierr);
   ierr = SNESLineSearchGetSNES(linesearch, &snes);CHKERRQ(ierr);
   ierr = SNESLineSearchGetLambda(linesearch, &lambda);CHKERRQ(ierr);
@@ -80,15 +80,18 @@ static PetscErrorCode SNESLineSearchApply_CP(SNESLineSearch linesearch)
       if (linesearch->ops->viproject) {
         ierr = (*linesearch->ops->viproject)(snes, W);CHKERRQ(ierr);
       }
-      ierr = (*linesearch->ops->snesfunc)(snes,W,F);CHKERRQ(ierr);
-      ierr = VecDot(F, Y, &fty_mid1);CHKERRQ(ierr);
+      /* both residuals are evaluated before their products are reduced together */
+      ierr = (*linesearch->ops->snesfunc)(snes,W,G);CHKERRQ(ierr);
       ierr = VecCopy(X, W);CHKERRQ(ierr);
       ierr = VecAXPY(W, -(lambda + 0.5*(lambda - lambda_old)), Y);CHKERRQ(ierr);
       if (linesearch->ops->viproject) {
         ierr = (*linesearch->ops->viproject)(snes, W);CHKERRQ(ierr);
       }
       ierr = (*linesearch->ops->snesfunc)(snes, W, F);CHKERRQ(ierr);
-      ierr = VecDot(F, Y, &fty_mid2);CHKERRQ(ierr);
+      ierr = VecDotBegin(G, Y, &fty_mid1);CHKERRQ(ierr);
+      ierr = VecDotBegin(F, Y, &fty_mid2);CHKERRQ(ierr);
+      ierr = VecDotEnd(G, Y, &fty_mid1);CHKERRQ(ierr);
+      ierr = VecDotEnd(F, Y, &fty_mid2);CHKERRQ(ierr);
       s    = (2.*fty_mid2 + 3.*fty - 6.*fty_mid1 + fty_old) / (3.*delLambda);
     }
     /* if the solve is going in the wrong direction, fix it */
@@ -160,7 +163,7 @@ static PetscErrorCode SNESLineSearchApply_CP(SNESLineSearch linesearch)
 
 .keywords: SNES, SNESLineSearch, damping
 
-.seealso: SNESLineSearchCreate(), SNESLineSearchSetType()
+.seealso: SNESLineSearchCreate(), SNESLineSearchSetType(), SNESSetFunctionAndNorm()
 M*/
 PETSC_EXTERN PetscErrorCode SNESLineSearchCreate_CP(SNESLineSearch linesearch)
 {
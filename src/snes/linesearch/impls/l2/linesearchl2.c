@@ -10,6 +10,7 @@ static PetscErrorCode  SNESLineSearchApply_L2(SNESLineSearch linesearch)
   Vec            F;
   Vec            Y;
   Vec            W;
+  Vec            G;
   SNES           snes;
   PetscReal      gnorm;
   PetscReal      ynorm;
@@ -25,7 +26,7 @@ static PetscErrorCode  SNESLineSearchApply_L2(SNESLineSearch linesearch)
   PetscErrorCode (*objective)(SNES,Vec,PetscReal*,void*);
 
   PetscFunctionBegin;
-  ierr = SNESLineSearchGetVecs(linesearch, &X, &F, &Y, &W, NULL);CHKERRQ(ierr);
+  ierr = SNESLineSearchGetVecs(linesearch, &X, &F, &Y, &W, &G);CHKERRQ(ierr);
   ierr = SNESLineSearchGetNorms(linesearch, &xnorm, &gnorm, &ynorm);CHKERRQ(ierr);
   ierr = SNESLineSearchGetLambda(linesearch, &lambda);CHKERRQ(ierr);
   ierr = SNESLineSearchGetSNES(linesearch, &snes);CHKERRQ(ierr);
@@ -54,13 +55,11 @@ static PetscErrorCode  SNESLineSearchApply_L2(SNESLineSearch linesearch)
         ierr = (*linesearch->ops->viproject)(snes, W);CHKERRQ(ierr);
       }
       if (!objective) {
-        /* compute the norm at the midpoint */
-        ierr = (*linesearch->ops->snesfunc)(snes, W, F);CHKERRQ(ierr);
+        /* compute the norm at the midpoint; the function is kept in G so that both norms go in a single reduction */
+        ierr = (*linesearch->ops->snesfunc)(snes, W, G);CHKERRQ(ierr);
         if (linesearch->ops->vinorm) {
           fnrm_mid = gnorm;
-          ierr     = (*linesearch->ops->vinorm)(snes, F, W, &fnrm_mid);CHKERRQ(ierr);
-        } else {
-          ierr = VecNorm(F,NORM_2,&fnrm_mid);CHKERRQ(ierr);
+          ierr     = (*linesearch->ops->vinorm)(snes, G, W, &fnrm_mid);CHKERRQ(ierr);
         }
 
         /* compute the norm at the new endpoit */
@@ -74,7 +73,10 @@ static PetscErrorCode  SNESLineSearchApply_L2(SNESLineSearch linesearch)
           fnrm = gnorm;
           ierr = (*linesearch->ops->vinorm)(snes, F, W, &fnrm);CHKERRQ(ierr);
         } else {
-          ierr = VecNorm(F,NORM_2,&fnrm);CHKERRQ(ierr);
+          ierr = SNESFunctionNormBegin(snes,G,&fnrm_mid);CHKERRQ(ierr);
+          ierr = SNESFunctionNormBegin(snes,F,&fnrm);CHKERRQ(ierr);
+          ierr = SNESFunctionNormEnd(snes,G,&fnrm_mid);CHKERRQ(ierr);
+          ierr = SNESFunctionNormEnd(snes,F,&fnrm);CHKERRQ(ierr);
         }
         fnrm_mid = fnrm_mid*fnrm_mid;
         fnrm = fnrm*fnrm;
@@ -193,7 +195,7 @@ static PetscErrorCode  SNESLineSearchApply_L2(SNESLineSearch linesearch)
 
 .keywords: SNES, nonlinear, line search, norm, secant
 
-.seealso: SNESLINESEARCHBT, SNESLINESEARCHCP, SNESLineSearch, SNESLineSearchCreate(), SNESLineSearchSetType()
+.seealso: SNESLINESEARCHBT, SNESLINESEARCHCP, SNESLineSearch, SNESLineSearchCreate(), SNESLineSearchSetType(), SNESSetFunctionAndNorm()
 M*/
 PETSC_EXTERN PetscErrorCode SNESLineSearchCreate_L2(SNESLineSearch linesearch)
 {
@@ -1,5 +1,6 @@
 #include <petscdmda.h>          /*I "petscdmda.h" I*/
 #include <petsc/private/dmimpl.h>
+#include <petsc/private/matimpl.h>
 #include <petsc/private/snesimpl.h>   /*I "petscsnes.h" I*/
 
 /* This structure holds the user-provided DMDA callbacks */
@@ -11,6 +12,7 @@ typedef struct {
   void       *jacobianlocalctx;
   void       *objectivelocalctx;
   InsertMode residuallocalimode;
+  PetscBool  residuallocalsubboxes;
 
   /*   For Picard iteration defined locally */
   PetscErrorCode (*rhsplocal)(DMDALocalInfo*,void*,void*,void*);
@@ -111,6 +113,77 @@ static PetscErrorCode SNESComputeFunction_DMDA(SNES snes,Vec X,Vec F,void *ctx)
   PetscFunctionReturn(0);
 }
 
+/*
+   Residual used by MatFDColoringApply() with an IS_COLORING_LOCAL coloring: the state Xloc is the ghosted local vector
+   scattered once per Jacobian, so no ghost update is needed for the perturbed states. The local function is called with
+   the unmodified DMDALocalInfo on every process unless DMDASNESSetFunctionLocalSubBoxes() was used.
+*/
+static PetscErrorCode SNESComputeFunctionLocalColor_DMDA(SNES snes,Vec Xloc,Vec F,void *ctx)
+{
+  PetscErrorCode ierr;
+  DM             dm;
+  DMSNES_DA      *dmdasnes = (DMSNES_DA*)ctx;
+  DMDALocalInfo  info,box;
+  MatFDColoring  fdcoloring = NULL;
+  PetscInt       n,l,d,p,plast,c[3],lo[3],hi[3];
+  const PetscInt *cols;
+  void           *x,*f;
+
+  PetscFunctionBegin;
+  ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
+  ierr = DMDAGetLocalInfo(dm,&info);CHKERRQ(ierr);
+  if (dmdasnes->residuallocalsubboxes) {
+    ierr = PetscObjectQuery((PetscObject)dm,"DMDASNES_FDCOLORING",(PetscObject*)&fdcoloring);CHKERRQ(ierr);
+    if (fdcoloring && fdcoloring->currentcolor < 0) fdcoloring = NULL;
+  }
+  ierr = DMDAVecGetArray(dm,Xloc,&x);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(dm,F,&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(SNES_FunctionEval,snes,Xloc,F,0);CHKERRQ(ierr);
+  if (!fdcoloring) {
+    CHKMEMQ;
+    ierr = (*dmdasnes->residuallocal)(&info,x,f,dmdasnes->residuallocalctx);CHKERRQ(ierr);
+    CHKMEMQ;
+  } else {
+    /* Only the rows within the stencil of a perturbed column differ from the base residual and are read by the
+       coloring, so func is called on the stencil of each perturbed point: one box for DMDA_STENCIL_BOX, one line per
+       direction for DMDA_STENCIL_STAR. The other rows are left zero. */
+    ierr = VecZeroEntries(F);CHKERRQ(ierr);
+    ierr = MatFDColoringGetPerturbedColumns(fdcoloring,&n,&cols);CHKERRQ(ierr);
+    CHKMEMQ;
+    for (l=0,plast=-1; l<n; l++) {
+      p = cols[l]/info.dof;
+      if (p == plast) continue;
+      plast = p;
+      c[0] = info.gxs + p%info.gxm;
+      c[1] = info.gys + (p/info.gxm)%info.gym;
+      c[2] = info.gzs + p/(info.gxm*info.gym);
+      for (d=0; d<(info.st == DMDA_STENCIL_BOX ? 1 : info.dim); d++) {
+        PetscInt e;
+
+        for (e=0; e<3; e++) {
+          PetscInt w = (info.st == DMDA_STENCIL_BOX || e == d) && e < info.dim ? info.sw : 0;
+          lo[e] = c[e] - w;
+          hi[e] = c[e] + w + 1;
+        }
+        box    = info;
+        box.xs = PetscMax(lo[0],info.xs); box.xm = PetscMin(hi[0],info.xs+info.xm) - box.xs;
+        box.ys = PetscMax(lo[1],info.ys); box.ym = PetscMin(hi[1],info.ys+info.ym) - box.ys;
+        box.zs = PetscMax(lo[2],info.zs); box.zm = PetscMin(hi[2],info.zs+info.zm) - box.zs;
+        if (box.xm <= 0 || box.ym <= 0 || box.zm <= 0) continue;
+        ierr = (*dmdasnes->residuallocal)(&box,x,f,dmdasnes->residuallocalctx);CHKERRQ(ierr);
+      }
+    }
+    CHKMEMQ;
+  }
+  ierr = PetscLogEventEnd(SNES_FunctionEval,snes,Xloc,F,0);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(dm,F,&f);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(dm,Xloc,&x);CHKERRQ(ierr);
+  if (snes->domainerror) {
+    ierr = VecSetInf(F);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode SNESComputeObjective_DMDA(SNES snes,Vec X,PetscReal *ob,void *ctx)
 {
   PetscErrorCode ierr;
@@ -169,15 +242,27 @@ PETSC_EXTERN PetscErrorCode SNESComputeJacobian_DMDA(SNES snes,Vec X,Mat A,Mat B
     MatFDColoring fdcoloring;
     ierr = PetscObjectQuery((PetscObject)dm,"DMDASNES_FDCOLORING",(PetscObject*)&fdcoloring);CHKERRQ(ierr);
     if (!fdcoloring) {
-      ISColoring coloring;
+      ISColoring     coloring;
+      ISColoringType ctype;
 
       ierr = DMCreateColoring(dm,dm->coloringtype,&coloring);CHKERRQ(ierr);
+      ierr = ISColoringGetType(coloring,&ctype);CHKERRQ(ierr);
       ierr = MatFDColoringCreate(B,coloring,&fdcoloring);CHKERRQ(ierr);
-      switch (dm->coloringtype) {
+      switch (ctype) {
       case IS_COLORING_GLOBAL:
         ierr = MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))SNESComputeFunction_DMDA,dmdasnes);CHKERRQ(ierr);
         break;
-      default: SETERRQ1(PetscObjectComm((PetscObject)snes),PETSC_ERR_SUP,"No support for coloring type '%s'",ISColoringTypes[dm->coloringtype]);
+      case IS_COLORING_LOCAL: {
+        PetscBool isaij;
+
+        ierr = PetscObjectTypeCompareAny((PetscObject)B,&isaij,MATSEQAIJ,MATMPIAIJ,"");CHKERRQ(ierr);
+        if (!isaij) SETERRQ1(PetscObjectComm((PetscObject)snes),PETSC_ERR_SUP,"Coloring type 'ghosted' requires an AIJ matrix, not %s",((PetscObject)B)->type_name);
+        if (dmdasnes->residuallocalimode != INSERT_VALUES) SETERRQ(PetscObjectComm((PetscObject)snes),PETSC_ERR_SUP,"Coloring type 'ghosted' requires a local function set with INSERT_VALUES");
+        ierr = PetscOptionsGetBool(((PetscObject)snes)->options,((PetscObject)snes)->prefix,"-snes_dmda_fd_subboxes",&dmdasnes->residuallocalsubboxes,NULL);CHKERRQ(ierr);
+        ierr = MatFDColoringSetFunction(fdcoloring,(PetscErrorCode (*)(void))SNESComputeFunctionLocalColor_DMDA,dmdasnes);CHKERRQ(ierr);
+        ierr = MatFDColoringUseDM(B,fdcoloring);CHKERRQ(ierr);
+      } break;
+      default: SETERRQ1(PetscObjectComm((PetscObject)snes),PETSC_ERR_SUP,"No support for coloring type '%s'",ISColoringTypes[ctype]);
       }
       ierr = PetscObjectSetOptionsPrefix((PetscObject)fdcoloring,((PetscObject)dm)->prefix);CHKERRQ(ierr);
       ierr = MatFDColoringSetFromOptions(fdcoloring);CHKERRQ(ierr);
@@ -194,6 +279,7 @@ PETSC_EXTERN PetscErrorCode SNESComputeJacobian_DMDA(SNES snes,Vec X,Mat A,Mat B
        */
       ierr = PetscObjectDereference((PetscObject)dm);CHKERRQ(ierr);
     }
+    ierr  = SNESFDColoringSetActiveRows_Private(snes,X,fdcoloring);CHKERRQ(ierr);
     ierr  = MatFDColoringApply(B,fdcoloring,X,snes);CHKERRQ(ierr);
   }
   /* This will be redundant if the user called both, but it's too common to forget. */
@@ -222,9 +308,14 @@ PETSC_EXTERN PetscErrorCode SNESComputeJacobian_DMDA(SNES snes,Vec X,Mat A,Mat B
 .  f - dimensional pointer to residual, write the residual here (e.g. PetscScalar *f or **f or ***f)
 -  ctx - optional context passed above
 
+   Notes:
+   If no Jacobian is provided with DMDASNESSetJacobianLocal(), the Jacobian is computed with colored finite differences.
+   With -dm_is_coloring_type ghosted and imode INSERT_VALUES, the ghost values are scattered once per Jacobian instead of
+   once per color. See DMDASNESSetFunctionLocalSubBoxes() to also restrict each colored evaluation to the perturbed stencils.
+
    Level: beginner
 
-.seealso: DMDASNESSetJacobianLocal(), DMSNESSetFunction(), DMDACreate1d(), DMDACreate2d(), DMDACreate3d()
+.seealso: DMDASNESSetJacobianLocal(), DMSNESSetFunction(), DMDACreate1d(), DMDACreate2d(), DMDACreate3d(), DMDASNESSetFunctionLocalSubBoxes()
 @*/
 PetscErrorCode DMDASNESSetFunctionLocal(DM dm,InsertMode imode,PetscErrorCode (*func)(DMDALocalInfo*,void*,void*,void*),void *ctx)
 {
@@ -248,6 +339,49 @@ PetscErrorCode DMDASNESSetFunctionLocal(DM dm,InsertMode imode,PetscErrorCode (*
   PetscFunctionReturn(0);
 }
 
+/*@
+   DMDASNESSetFunctionLocalSubBoxes - evaluate the local residual only near the perturbed unknowns when the Jacobian is
+   computed with a ghosted finite difference coloring
+
+   Logically Collective
+
+   Input Arguments:
++  dm - DM with a local residual set by DMDASNESSetFunctionLocal()
+-  flg - PETSC_TRUE to call the local residual on sub-boxes of the local domain
+
+   Options Database:
+.  -snes_dmda_fd_subboxes - use sub-boxes
+
+   Notes:
+   Without a Jacobian from DMDASNESSetJacobianLocal() and with -dm_is_coloring_type ghosted, each color of the coloring
+   costs one call of the local residual on the whole local domain. With this option, the local residual is instead called,
+   for each perturbed grid point, on the stencil around that point intersected with the owned region: one box for
+   DMDA_STENCIL_BOX and one line per direction for DMDA_STENCIL_STAR. The xs,xm,ys,ym,zs,zm fields of the DMDALocalInfo
+   passed to the local residual then describe the sub-box, the local residual must only write f inside them and it must not
+   call collective operations, since different processes make different numbers of calls (possibly none).
+
+   The stencils of the points of one color of a full DMDA coloring cover most of the local domain, so this pays off when
+   only some columns are perturbed, for instance when MatFDColoringSetActiveRows() restricts the rows to recompute.
+
+   Level: advanced
+
+.seealso: DMDASNESSetFunctionLocal(), MatFDColoringGetPerturbedColumns()
+@*/
+PetscErrorCode DMDASNESSetFunctionLocalSubBoxes(DM dm,PetscBool flg)
+{
+  PetscErrorCode ierr;
+  DMSNES         sdm;
+  DMSNES_DA      *dmdasnes;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  PetscValidLogicalCollectiveBool(dm,flg,2);
+  ierr = DMGetDMSNESWrite(dm,&sdm);CHKERRQ(ierr);
+  ierr = DMDASNESGetContext(dm,sdm,&dmdasnes);CHKERRQ(ierr);
+  dmdasnes->residuallocalsubboxes = flg;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMDASNESSetJacobianLocal - set a local Jacobian evaluation function
 
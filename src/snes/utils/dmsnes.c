@@ -148,16 +148,18 @@ PetscErrorCode DMSNESCopy(DMSNES kdm,DMSNES nkdm)
   PetscFunctionBegin;
   PetscValidHeaderSpecific(kdm,DMSNES_CLASSID,1);
   PetscValidHeaderSpecific(nkdm,DMSNES_CLASSID,2);
-  nkdm->ops->computefunction  = kdm->ops->computefunction;
-  nkdm->ops->computejacobian  = kdm->ops->computejacobian;
-  nkdm->ops->computegs        = kdm->ops->computegs;
-  nkdm->ops->computeobjective = kdm->ops->computeobjective;
-  nkdm->ops->computepjacobian = kdm->ops->computepjacobian;
-  nkdm->ops->computepfunction = kdm->ops->computepfunction;
-  nkdm->ops->destroy          = kdm->ops->destroy;
-  nkdm->ops->duplicate        = kdm->ops->duplicate;
-
-  nkdm->functionctx  = kdm->functionctx;
+  nkdm->ops->computefunction     = kdm->ops->computefunction;
+  nkdm->ops->computefunctionnorm = kdm->ops->computefunctionnorm;
+  nkdm->ops->computejacobian     = kdm->ops->computejacobian;
+  nkdm->ops->computegs           = kdm->ops->computegs;
+  nkdm->ops->computeobjective    = kdm->ops->computeobjective;
+  nkdm->ops->computepjacobian    = kdm->ops->computepjacobian;
+  nkdm->ops->computepfunction    = kdm->ops->computepfunction;
+  nkdm->ops->destroy             = kdm->ops->destroy;
+  nkdm->ops->duplicate           = kdm->ops->duplicate;
+
+  nkdm->functionctx     = kdm->functionctx;
+  nkdm->functionnormctx = kdm->functionnormctx;
   nkdm->gsctx        = kdm->gsctx;
   nkdm->pctx         = kdm->pctx;
   nkdm->jacobianctx  = kdm->jacobianctx;
@@ -347,6 +349,64 @@ PetscErrorCode DMSNESGetFunction(DM dm,PetscErrorCode (**f)(SNES,Vec,Vec,void*),
   PetscFunctionReturn(0);
 }
 
+/*@C
+   DMSNESSetFunctionAndNorm - set a SNES residual evaluation function that also returns the local square of the 2-norm of the residual
+
+   Not Collective
+
+   Input Arguments:
++  dm - DM to be used with SNES
+.  f - residual evaluation function; see SNESSetFunctionAndNorm() for details
+-  ctx - context for residual evaluation
+
+   Level: advanced
+
+.seealso: DMSNESSetContext(), SNESSetFunctionAndNorm(), DMSNESSetFunction()
+@*/
+PetscErrorCode DMSNESSetFunctionAndNorm(DM dm,PetscErrorCode (*f)(SNES,Vec,Vec,PetscReal*,void*),void *ctx)
+{
+  PetscErrorCode ierr;
+  DMSNES         sdm;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (f || ctx) {
+    ierr = DMGetDMSNESWrite(dm,&sdm);CHKERRQ(ierr);
+  }
+  if (f) sdm->ops->computefunctionnorm = f;
+  if (ctx) sdm->functionnormctx = ctx;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   DMSNESGetFunctionAndNorm - get the SNES residual evaluation function that also returns the local square of the 2-norm of the residual
+
+   Not Collective
+
+   Input Argument:
+.  dm - DM to be used with SNES
+
+   Output Arguments:
++  f - residual evaluation function; see SNESSetFunctionAndNorm() for details
+-  ctx - context for residual evaluation
+
+   Level: advanced
+
+.seealso: DMSNESSetContext(), DMSNESSetFunctionAndNorm(), SNESGetFunctionAndNorm()
+@*/
+PetscErrorCode DMSNESGetFunctionAndNorm(DM dm,PetscErrorCode (**f)(SNES,Vec,Vec,PetscReal*,void*),void **ctx)
+{
+  PetscErrorCode ierr;
+  DMSNES         sdm;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  ierr = DMGetDMSNES(dm,&sdm);CHKERRQ(ierr);
+  if (f) *f = sdm->ops->computefunctionnorm;
+  if (ctx) *ctx = sdm->functionnormctx;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMSNESSetObjective - set SNES objective evaluation function
 
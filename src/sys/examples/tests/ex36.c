@@ -0,0 +1,53 @@
+
+static char help[] = "Tests an options database with many options, overriding an option with a different case and deleting one.\n\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscOptions   options;
+  PetscInt       i,j,n = 600,val,nfound = 0,nwrong = 0;
+  char           name[32],value[32];
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsCreate(&options);CHKERRQ(ierr);
+
+  /* insert the names out of order, so most of them go in the middle of the sorted table */
+  for (i=0; i<n; i++) {
+    j    = (7*i) % n;
+    ierr = PetscSNPrintf(name,sizeof(name),"-opt_%04D",j);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(value,sizeof(value),"%D",j);CHKERRQ(ierr);
+    ierr = PetscOptionsSetValue(options,name,value);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsSetValue(options,"-OPT_0123","-1");CHKERRQ(ierr);
+  ierr = PetscOptionsClearValue(options,"-opt_0050");CHKERRQ(ierr);
+
+  for (i=0; i<n; i++) {
+    ierr = PetscSNPrintf(name,sizeof(name),"-opt_%04D",i);CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(options,NULL,name,&val,&flg);CHKERRQ(ierr);
+    if (!flg) continue;
+    nfound++;
+    if (val != (i == 123 ? -1 : i)) nwrong++;
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Found %D of %D options, %D with a wrong value\n",nfound,n,nwrong);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(options,NULL,"-Opt_0123",&val,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"-opt_0123 %s %D\n",flg ? "set to" : "not set",flg ? val : 0);CHKERRQ(ierr);
+  ierr = PetscOptionsHasName(options,NULL,"-opt_0050",&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"-opt_0050 %s\n",flg ? "set" : "deleted");CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(options,NULL,"-opt_0051",&val,&flg);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"-opt_0051 %s %D\n",flg ? "set to" : "not set",flg ? val : 0);CHKERRQ(ierr);
+
+  ierr = PetscOptionsDestroy(&options);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+
+TEST*/
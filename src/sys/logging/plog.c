@@ -1632,6 +1632,14 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
     }
     ierr = PetscCommDestroy(&newcomm);CHKERRQ(ierr);
   }
+  {
+    PetscInt64     nlookups,nfound;
+    PetscLogDouble ltime,maxtime;
+
+    ierr = PetscOptionsGetLookupCounts(NULL,&nlookups,&nfound,&ltime);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(&ltime,&maxtime,1,MPIU_PETSCLOGDOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm,fd,"Options database lookups: %lld (%lld found), time %g (max over processes)\n",(long long)nlookups,(long long)nfound,maxtime);CHKERRQ(ierr);
+  }
   ierr = PetscOptionsView(NULL,viewer);CHKERRQ(ierr);
 
   /* Machine and compile information */
@@ -0,0 +1,334 @@
+
+/*
+      Timeline logging of PETSc events.
+
+      Every event begin and end appends a fixed size record to a ring buffer on each process, so logging costs a
+   timer call and a few stores per event. The buffers are converted to a Chrome trace (viewable with chrome://tracing
+   or Perfetto) with one track per process when the log is dumped.
+*/
+#include <petsc/private/logimpl.h>        /*I    "petscsys.h"   I*/
+#include <petsctime.h>
+
+#if defined(PETSC_USE_LOG)
+
+typedef struct {
+  PetscLogDouble time;
+  PetscLogDouble flops;
+  PetscLogDouble numMessages;
+  PetscLogDouble messageLength;
+  PetscLogDouble numReductions;
+  int            event;
+  int            stage;
+  PetscBool      end;
+} PetscTimelineRecord;
+
+typedef struct {
+  PetscTimelineRecord *records;
+  PetscInt            size,head;       /* capacity of the ring buffer and position of the next record */
+  PetscInt64          count;           /* number of records ever written, the oldest are overwritten */
+  PetscLogDouble      time0,offset0;   /* local time and offset to the clock of process 0 when the logging started */
+  PetscLogDouble      origin;          /* time of process 0 when the logging started */
+  PetscErrorCode      (*plb)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject);
+  PetscErrorCode      (*ple)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject);
+} PetscTimeline;
+
+static PetscTimeline petsc_timeline;
+
+/* the trace of a process is formatted into a growing string, which is sent to process 0 as a single message */
+typedef struct {
+  char   *str;
+  size_t len,size;
+} PetscTimelineString;
+
+#define PETSC_TIMELINE_SIZE 100000
+#define PETSC_TIMELINE_SYNC 5
+
+PETSC_STATIC_INLINE void PetscLogTimelineFill_Private(PetscTimelineRecord *rec,PetscLogEvent event,PetscBool end)
+{
+  PetscTime(&rec->time);
+  rec->flops         = petsc_TotalFlops;
+  rec->numMessages   = petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
+  rec->messageLength = petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
+  rec->numReductions = petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+  rec->event         = event;
+  rec->stage         = petsc_stageLog->curStage;
+  rec->end           = end;
+}
+
+PETSC_STATIC_INLINE void PetscLogTimelineRecord_Private(PetscLogEvent event,PetscBool end)
+{
+  PetscLogTimelineFill_Private(&petsc_timeline.records[petsc_timeline.head],event,end);
+  if (++petsc_timeline.head == petsc_timeline.size) petsc_timeline.head = 0;
+  petsc_timeline.count++;
+}
+
+/* the handler that was active before is called outside of the recorded interval */
+static PetscErrorCode PetscLogEventBeginTimeline(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (petsc_timeline.plb) {ierr = (*petsc_timeline.plb)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  PetscLogTimelineRecord_Private(event,PETSC_FALSE);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscLogEventEndTimeline(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscLogTimelineRecord_Private(event,PETSC_TRUE);
+  if (petsc_timeline.ple) {ierr = (*petsc_timeline.ple)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   Estimates the offset of the local clock to the clock of process 0 with the round trip of the fastest of a few
+   ping-pongs between process 0 and each process, and returns the local time at which it was measured.
+*/
+static PetscErrorCode PetscLogTimelineSyncClocks_Private(PetscLogDouble *time,PetscLogDouble *offset)
+{
+  MPI_Comm       comm;
+  MPI_Status     status;
+  PetscMPIInt    rank,size,r,tag;
+  PetscLogDouble t0,t1,tr,best,off = 0.0;
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscCommDuplicate(PETSC_COMM_WORLD,&comm,&tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  *offset = 0.0;
+  if (!rank) {
+    for (r=1; r<size; r++) {
+      best = PETSC_MAX_REAL;
+      for (k=0; k<PETSC_TIMELINE_SYNC; k++) {
+        PetscTime(&t0);
+        ierr = MPI_Send(&t0,1,MPIU_PETSCLOGDOUBLE,r,tag,comm);CHKERRQ(ierr);
+        ierr = MPI_Recv(&tr,1,MPIU_PETSCLOGDOUBLE,r,tag,comm,&status);CHKERRQ(ierr);
+        PetscTime(&t1);
+        if (t1-t0 < best) {best = t1-t0; off = tr-0.5*(t0+t1);}
+      }
+      ierr = MPI_Send(&off,1,MPIU_PETSCLOGDOUBLE,r,tag,comm);CHKERRQ(ierr);
+    }
+  } else {
+    for (k=0; k<PETSC_TIMELINE_SYNC; k++) {
+      ierr = MPI_Recv(&tr,1,MPIU_PETSCLOGDOUBLE,0,tag,comm,&status);CHKERRQ(ierr);
+      PetscTime(&tr);
+      ierr = MPI_Send(&tr,1,MPIU_PETSCLOGDOUBLE,0,tag,comm);CHKERRQ(ierr);
+    }
+    ierr = MPI_Recv(offset,1,MPIU_PETSCLOGDOUBLE,0,tag,comm,&status);CHKERRQ(ierr);
+  }
+  PetscTime(time);
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscTimelineStringPrintf_Private(PetscTimelineString *s,const char format[],...)
+{
+  va_list        Argp;
+  size_t         need = 1024,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  while (1) {
+    if (s->size-s->len < need) {
+      s->size = PetscMax(2*s->size,s->len+need);
+      ierr    = PetscRealloc(s->size,&s->str);CHKERRQ(ierr);
+    }
+    va_start(Argp,format);
+    ierr = PetscVSNPrintf(s->str+s->len,s->size-s->len,format,&n,Argp);CHKERRQ(ierr);
+    va_end(Argp);
+    if (n+1 < s->size-s->len) break;
+    need = 2*(s->size-s->len); /* truncated */
+  }
+  s->len += n;
+  PetscFunctionReturn(0);
+}
+
+/* writes the traces of the processes to fd on process 0 in the order of the ranks */
+static PetscErrorCode PetscTimelineStringWrite_Private(PetscTimelineString *s,FILE *fd)
+{
+  MPI_Comm       comm;
+  MPI_Status     status;
+  PetscMPIInt    rank,size,r,tag,len;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscCommDuplicate(PETSC_COMM_WORLD,&comm,&tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (!rank) {
+    for (r=0; r<size; r++) {
+      if (r) {
+        ierr = MPI_Recv(&len,1,MPI_INT,r,tag,comm,&status);CHKERRQ(ierr);
+        if ((size_t)len > s->size) {
+          s->size = len;
+          ierr    = PetscRealloc(s->size,&s->str);CHKERRQ(ierr);
+        }
+        ierr   = MPI_Recv(s->str,len,MPI_CHAR,r,tag,comm,&status);CHKERRQ(ierr);
+        s->len = len;
+      }
+      if (s->len && fwrite(s->str,1,s->len,fd) != s->len) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Error writing the timeline");
+    }
+  } else {
+    ierr = PetscMPIIntCast(s->len,&len);CHKERRQ(ierr);
+    ierr = MPI_Send(&len,1,MPI_INT,0,tag,comm);CHKERRQ(ierr);
+    ierr = MPI_Send(s->str,len,MPI_CHAR,0,tag,comm);CHKERRQ(ierr);
+  }
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* converts a local time to microseconds since the start of the logging on process 0 */
+PETSC_STATIC_INLINE PetscLogDouble PetscLogTimelineTime_Private(PetscLogDouble t,PetscLogDouble drift)
+{
+  return 1.e6*(t-petsc_timeline.offset0-drift*(t-petsc_timeline.time0)-petsc_timeline.origin);
+}
+
+static PetscErrorCode PetscLogTimelineFinalize_Private(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (PetscLogPLB == PetscLogEventBeginTimeline) {ierr = PetscLogSet(petsc_timeline.plb,petsc_timeline.ple);CHKERRQ(ierr);}
+  ierr = PetscFree(petsc_timeline.records);CHKERRQ(ierr);
+  ierr = PetscMemzero(&petsc_timeline,sizeof(petsc_timeline));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTimelineBegin - Turns on the logging of a timeline of events. The beginning and end of every event is
+  recorded in a buffer on each process, which PetscLogTimelineDump() converts to a trace with one track per process.
+
+  Collective on PETSC_COMM_WORLD
+
+  Input Parameter:
+. size - the number of records kept by each process, or PETSC_DEFAULT
+
+  Options Database Keys:
++ -log_timeline [filename] - Activates PetscLogTimelineBegin() and dumps the trace to filename (default timeline.json) in PetscFinalize()
+- -log_timeline_size <size> - The number of records kept by each process
+
+  Notes:
+  Each event begin and each event end uses one record, which holds the time, the stage and the flop, message and
+  reduction counters. When the buffer is full the oldest records are overwritten, so that the trace shows the end of
+  the run.
+
+  The logging functions that were active before, for example the ones of -log_view, are still called, so this
+  routine should be called after PetscLogDefaultBegin() or PetscLogNestedBegin().
+
+  Level: advanced
+
+.keywords: log, timeline, trace, begin
+.seealso: PetscLogTimelineDump(), PetscLogDefaultBegin(), PetscLogTraceBegin(), PetscLogView()
+@*/
+PetscErrorCode PetscLogTimelineBegin(PetscInt size)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (petsc_timeline.records) PetscFunctionReturn(0);
+  if (size == PETSC_DEFAULT || size == PETSC_DECIDE) size = PETSC_TIMELINE_SIZE;
+  if (size < 2) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Timeline buffer must hold at least 2 records, not %D",size);
+  ierr = PetscMalloc1(size,&petsc_timeline.records);CHKERRQ(ierr);
+  petsc_timeline.size  = size;
+  petsc_timeline.head  = 0;
+  petsc_timeline.count = 0;
+  ierr = PetscLogTimelineSyncClocks_Private(&petsc_timeline.time0,&petsc_timeline.offset0);CHKERRQ(ierr);
+  petsc_timeline.origin = petsc_timeline.time0;
+  ierr = MPI_Bcast(&petsc_timeline.origin,1,MPIU_PETSCLOGDOUBLE,0,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscRegisterFinalize(PetscLogTimelineFinalize_Private);CHKERRQ(ierr);
+
+  petsc_timeline.plb = PetscLogPLB;
+  petsc_timeline.ple = PetscLogPLE;
+  ierr = PetscLogSet(PetscLogEventBeginTimeline,PetscLogEventEndTimeline);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTimelineDump - Writes the timeline of events logged since PetscLogTimelineBegin() in the Chrome trace
+  format, which can be viewed with chrome://tracing or https://ui.perfetto.dev
+
+  Collective on PETSC_COMM_WORLD
+
+  Input Parameter:
+. filename - the name of the file, or NULL for timeline.json
+
+  Notes:
+  Each process is shown as a track with its events; the arguments of an event are the flops, messages, message length
+  and reductions done between its beginning and its end. Events that have not ended are shown up to the time of the
+  dump.
+
+  The clocks of the processes are aligned with the one of process 0 from round trips measured when the logging started
+  and in this routine, with a linear interpolation in between to correct for drift.
+
+  Level: advanced
+
+.keywords: log, timeline, trace, dump
+.seealso: PetscLogTimelineBegin(), PetscLogDump()
+@*/
+PetscErrorCode PetscLogTimelineDump(const char filename[])
+{
+  PetscStageLog       stageLog;
+  PetscEventRegLog    eventRegLog;
+  PetscTimelineRecord *recs = petsc_timeline.records,*b,*e,last;
+  PetscTimelineString trace = {NULL,0,0};
+  FILE                *fd;
+  PetscLogDouble      time1,offset1,drift;
+  PetscInt64          dropped;
+  PetscInt            i,j,n,start,*stack,depth = 0;
+  PetscMPIInt         rank;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (!recs) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Must call PetscLogTimelineBegin() or use -log_timeline before calling this routine");
+  ierr = PetscLogTimelineSyncClocks_Private(&time1,&offset1);CHKERRQ(ierr);
+  drift = time1 > petsc_timeline.time0 ? (offset1-petsc_timeline.offset0)/(time1-petsc_timeline.time0) : 0.0;
+
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscLogGetStageLog(&stageLog);CHKERRQ(ierr);
+  ierr = PetscStageLogGetEventRegLog(stageLog,&eventRegLog);CHKERRQ(ierr);
+  n       = (PetscInt)PetscMin(petsc_timeline.count,(PetscInt64)petsc_timeline.size);
+  start   = petsc_timeline.count > petsc_timeline.size ? petsc_timeline.head : 0;
+  dropped = petsc_timeline.count-n;
+  if (dropped) {ierr = PetscInfo2(NULL,"Timeline buffer overwrote %lld records, the trace contains the last %D\n",(long long)dropped,n);CHKERRQ(ierr);}
+
+  ierr = PetscFOpen(PETSC_COMM_WORLD,filename ? filename : "timeline.json","w",&fd);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_WORLD,fd,"{\"traceEvents\":[\n");CHKERRQ(ierr);
+  trace.size = 128*(n+2);
+  ierr = PetscMalloc1(trace.size,&trace.str);CHKERRQ(ierr);
+  ierr = PetscTimelineStringPrintf_Private(&trace,"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"Process %d\"}}\n",rank ? "," : "",rank,rank);CHKERRQ(ierr);
+  ierr = PetscTimelineStringPrintf_Private(&trace,",{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"sort_index\":%d}}\n",rank,rank);CHKERRQ(ierr);
+
+  /* match each end with the begin on top of the stack of open events; ends whose begin was overwritten are skipped */
+  ierr = PetscMalloc1(n,&stack);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    j = (start+i)%petsc_timeline.size;
+    e = &recs[j];
+    if (!e->end) {stack[depth++] = j; continue;}
+    if (!depth || recs[stack[depth-1]].event != e->event) continue;
+    b    = &recs[stack[--depth]];
+    ierr = PetscTimelineStringPrintf_Private(&trace,",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"flops\":%.0f,\"messages\":%.0f,\"length\":%.0f,\"reductions\":%.0f}}\n",
+                                             eventRegLog->eventInfo[e->event].name,stageLog->stageInfo[b->stage].name,rank,PetscLogTimelineTime_Private(b->time,drift),PetscLogTimelineTime_Private(e->time,drift)-PetscLogTimelineTime_Private(b->time,drift),
+                                             e->flops-b->flops,e->numMessages-b->numMessages,e->messageLength-b->messageLength,e->numReductions-b->numReductions);CHKERRQ(ierr);
+  }
+  /* events that are still running end at the time of the dump */
+  PetscLogTimelineFill_Private(&last,-1,PETSC_TRUE);
+  while (depth) {
+    b    = &recs[stack[--depth]];
+    ierr = PetscTimelineStringPrintf_Private(&trace,",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"flops\":%.0f,\"messages\":%.0f,\"length\":%.0f,\"reductions\":%.0f}}\n",
+                                             eventRegLog->eventInfo[b->event].name,stageLog->stageInfo[b->stage].name,rank,PetscLogTimelineTime_Private(b->time,drift),PetscLogTimelineTime_Private(last.time,drift)-PetscLogTimelineTime_Private(b->time,drift),
+                                             last.flops-b->flops,last.numMessages-b->numMessages,last.messageLength-b->messageLength,last.numReductions-b->numReductions);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(stack);CHKERRQ(ierr);
+  ierr = PetscTimelineStringWrite_Private(&trace,fd);CHKERRQ(ierr);
+  ierr = PetscFree(trace.str);CHKERRQ(ierr);
+  ierr = PetscFPrintf(PETSC_COMM_WORLD,fd,"],\"displayTimeUnit\":\"ms\"}\n");CHKERRQ(ierr);
+  ierr = PetscFClose(PETSC_COMM_WORLD,fd);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#endif
@@ -531,6 +531,13 @@ PetscErrorCode  PetscOptionsCheckInitial_Private(void)
       ierr = PetscLogDefaultBegin();CHKERRQ(ierr);
     }
   }
+
+  ierr = PetscOptionsHasName(NULL,NULL,"-log_timeline",&flg1);CHKERRQ(ierr);
+  if (flg1) {
+    PetscInt size = PETSC_DEFAULT;
+    ierr = PetscOptionsGetInt(NULL,NULL,"-log_timeline_size",&size,NULL);CHKERRQ(ierr);
+    ierr = PetscLogTimelineBegin(size);CHKERRQ(ierr);
+  }
 #endif
 
   ierr = PetscOptionsGetBool(NULL,NULL,"-saws_options",&PetscOptionsPublish,NULL);CHKERRQ(ierr);
@@ -647,6 +654,8 @@ PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -get_total_flops: total flops over all processors\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log[_summary _summary_python]: logging objects and events\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_trace [filename]: prints trace of all PETSc calls\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_timeline [filename]: writes a Chrome trace of the events of all processes\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_timeline_size <size>: number of events kept by each process\n");CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MPE)
     ierr = (*PetscHelpPrintf)(comm," -log_mpe: Also create logfile viewable through Jumpshot\n");CHKERRQ(ierr);
 #endif
@@ -11,7 +11,9 @@
 */
 
 #include <petsc/private/petscimpl.h>        /*I  "petscsys.h"   I*/
+#include <petsc/private/hash.h>
 #include <petscviewer.h>
+#include <petsctime.h>
 #include <ctype.h>
 #if defined(PETSC_HAVE_MALLOC_H)
 #include <malloc.h>
@@ -27,18 +29,40 @@
 #endif
 
 /*
-    This table holds all the options set by the user. For simplicity, we use a static size database
+    This table holds all the options set by the user, sorted by name. It grows as needed, and a hash table gives the
+    position of a name in it
 */
-#define MAXOPTIONS 512
 #define MAXALIASES 25
 #define MAXOPTIONSMONITORS 5
 #define MAXPREFIXES 25
 
+/* the option names are case insensitive */
+PETSC_STATIC_INLINE khint_t PetscOptionsHashName(const char *s)
+{
+  khint_t h = 0;
+  for (; *s; s++) h = (h << 5) - h + (khint_t)tolower((unsigned char)*s);
+  return h;
+}
+
+PETSC_STATIC_INLINE int PetscOptionsEqualName(const char *a,const char *b)
+{
+#if defined(PETSC_HAVE_STRCASECMP)
+  return !strcasecmp(a,b);
+#elif defined(PETSC_HAVE_STRICMP)
+  return !stricmp(a,b);
+#else
+  Error
+#endif
+}
+
+KHASH_INIT(HTO,kh_cstr_t,int,1,PetscOptionsHashName,PetscOptionsEqualName)
+
 struct  _n_PetscOptions {
-  int            N,argc,Naliases;
-  char           **args,*names[MAXOPTIONS],*values[MAXOPTIONS];
+  int            N,Nmax,argc,Naliases;
+  char           **args,**names,**values;
   char           *aliases1[MAXALIASES],*aliases2[MAXALIASES];
-  PetscBool      used[MAXOPTIONS];
+  PetscBool      *used;
+  khash_t(HTO)   *ht;                    /* position of each name in names[] */
   PetscBool      namegiven;
   char           programname[PETSC_MAX_PATH_LEN]; /* HP includes entire path in name */
 
@@ -51,6 +75,10 @@ struct  _n_PetscOptions {
   /* Prefixes */
   PetscInt prefixind,prefixstack[MAXPREFIXES];
   char     prefix[2048];
+
+  /* Lookups, for -log_view */
+  PetscInt64     nlookups,nfound;
+  PetscLogDouble lookuptime;
 };
 
 
@@ -972,6 +1000,7 @@ PetscErrorCode  PetscOptionsClear(PetscOptions options)
     if (options->names[i])  free(options->names[i]);
     if (options->values[i]) free(options->values[i]);
   }
+  if (options->ht) kh_clear(HTO,options->ht);
   for (i=0; i<options->Naliases; i++) {
     free(options->aliases1[i]);
     free(options->aliases2[i]);
@@ -1047,6 +1076,10 @@ PetscErrorCode  PetscOptionsDestroy(PetscOptions *options)
 
   PetscFunctionBegin;
   ierr = PetscOptionsClear(*options);CHKERRQ(ierr);
+  free((*options)->names);
+  free((*options)->values);
+  free((*options)->used);
+  kh_destroy(HTO,(*options)->ht);
   free(*options);
   *options = NULL;
   PetscFunctionReturn(0);
@@ -1091,11 +1124,11 @@ PetscErrorCode  PetscOptionsSetValue(PetscOptions options,const char iname[],con
 {
   size_t         len;
   PetscErrorCode ierr;
-  PetscInt       N,n,i;
-  char           **names;
+  PetscInt       N,n,i,lo,hi;
   char           fullname[2048];
   const char     *name = iname;
   int            match;
+  khint_t        k,ret;
 
   if (!options) {
     if (!defaultoptions) {
@@ -1132,33 +1165,44 @@ PetscErrorCode  PetscOptionsSetValue(PetscOptions options,const char iname[],con
     }
   }
 
-  N     = options->N;
-  n     = N;
-  names = options->names;
-
-  for (i=0; i<N; i++) {
-#if defined(PETSC_HAVE_STRCASECMP)
-    match = strcasecmp(names[i],name);
-#elif defined(PETSC_HAVE_STRICMP)
-    match = stricmp(names[i],name);
-#else
-    Error
-#endif
-    if (!match) {
-      if (options->values[i]) free(options->values[i]);
-      len = value ? strlen(value) : 0;
-      if (len) {
-        options->values[i] = (char*)malloc((len+1)*sizeof(char));
-        if (!options->values[i]) return PETSC_ERR_MEM;
-        strcpy(options->values[i],value);
-      } else options->values[i] = 0;
-      return 0;
-    } else if (strcmp(names[i],name) > 0) {
-      n = i;
-      break;
-    }
+  if (!options->ht) {
+    options->ht = kh_init(HTO);
+    if (!options->ht) return PETSC_ERR_MEM;
+  }
+  k = kh_get(HTO,options->ht,name);
+  if (k != kh_end(options->ht)) {
+    i = kh_val(options->ht,k);
+    if (options->values[i]) free(options->values[i]);
+    len = value ? strlen(value) : 0;
+    if (len) {
+      options->values[i] = (char*)malloc((len+1)*sizeof(char));
+      if (!options->values[i]) return PETSC_ERR_MEM;
+      strcpy(options->values[i],value);
+    } else options->values[i] = 0;
+    return 0;
+  }
+
+  /* the new name goes before the first larger one */
+  N  = options->N;
+  lo = 0; hi = N;
+  while (lo < hi) {
+    i = (lo+hi)/2;
+    if (strcmp(options->names[i],name) > 0) hi = i;
+    else lo = i+1;
+  }
+  n = lo;
+  if (N >= options->Nmax) {
+    int  Nmax = options->Nmax ? 2*options->Nmax : 512;
+    void *tmp;
+
+    tmp = realloc(options->names,Nmax*sizeof(char*));if (!tmp) return PETSC_ERR_MEM;
+    options->names = (char**)tmp;
+    tmp = realloc(options->values,Nmax*sizeof(char*));if (!tmp) return PETSC_ERR_MEM;
+    options->values = (char**)tmp;
+    tmp = realloc(options->used,Nmax*sizeof(PetscBool));if (!tmp) return PETSC_ERR_MEM;
+    options->used = (PetscBool*)tmp;
+    options->Nmax = Nmax;
   }
-  if (N >= MAXOPTIONS) abort();
 
   /* shift remaining values down 1 */
   for (i=N; i>n; i--) {
@@ -1166,11 +1210,16 @@ PetscErrorCode  PetscOptionsSetValue(PetscOptions options,const char iname[],con
     options->values[i] = options->values[i-1];
     options->used[i]   = options->used[i-1];
   }
+  for (k=kh_begin(options->ht); k!=kh_end(options->ht); k++) {
+    if (kh_exist(options->ht,k) && kh_val(options->ht,k) >= n) kh_val(options->ht,k)++;
+  }
   /* insert new name and value */
   len = strlen(name);
   options->names[n] = (char*)malloc((len+1)*sizeof(char));
   if (!options->names[n]) return PETSC_ERR_MEM;
   strcpy(options->names[n],name);
+  k = kh_put(HTO,options->ht,options->names[n],&ret);
+  kh_val(options->ht,k) = n;
   len = value ? strlen(value) : 0;
   if (len) {
     options->values[n] = (char*)malloc((len+1)*sizeof(char));
@@ -1200,39 +1249,34 @@ PetscErrorCode  PetscOptionsSetValue(PetscOptions options,const char iname[],con
 @*/
 PetscErrorCode  PetscOptionsClearValue(PetscOptions options,const char iname[])
 {
-  PetscErrorCode ierr;
   PetscInt       N,n,i;
-  char           **names,*name=(char*)iname;
-  PetscBool      gt,match;
+  char           *name=(char*)iname;
+  khint_t        k;
 
   PetscFunctionBegin;
   options = options ? options : defaultoptions;
   if (name[0] != '-') SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Name must begin with -: Instead %s",name);
   name++;
 
-  N     = options->N; n = 0;
-  names = options->names;
-
-  for (i=0; i<N; i++) {
-    ierr  = PetscStrcasecmp(names[i],name,&match);CHKERRQ(ierr);
-    ierr  = PetscStrgrt(names[i],name,&gt);CHKERRQ(ierr);
-    if (match) {
-      if (options->names[i])  free(options->names[i]);
-      if (options->values[i]) free(options->values[i]);
-      PetscOptionsMonitor(name,"");
-      break;
-    } else if (gt) PetscFunctionReturn(0); /* it was not listed */
-
-    n++;
-  }
-  if (n == N) PetscFunctionReturn(0); /* it was not listed */
+  if (!options->ht) PetscFunctionReturn(0);
+  k = kh_get(HTO,options->ht,name);
+  if (k == kh_end(options->ht)) PetscFunctionReturn(0); /* it was not listed */
+  n = kh_val(options->ht,k);
+  kh_del(HTO,options->ht,k);
+  free(options->names[n]);
+  if (options->values[n]) free(options->values[n]);
+  PetscOptionsMonitor(name,"");
 
   /* shift remaining values down 1 */
+  N = options->N;
   for (i=n; i<N-1; i++) {
     options->names[i]  = options->names[i+1];
     options->values[i] = options->values[i+1];
     options->used[i]   = options->used[i+1];
   }
+  for (k=kh_begin(options->ht); k!=kh_end(options->ht); k++) {
+    if (kh_exist(options->ht,k) && kh_val(options->ht,k) > n) kh_val(options->ht,k)--;
+  }
   options->N--;
   PetscFunctionReturn(0);
 }
@@ -1281,19 +1325,15 @@ PetscErrorCode  PetscOptionsSetAlias(PetscOptions options,const char inewname[],
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode PetscOptionsFindPair_Private(PetscOptions options,const char pre[],const char name[],char *value[],PetscBool  *flg)
+static PetscErrorCode PetscOptionsFindPair_Hash(PetscOptions options,const char pre[],const char name[],char *value[],PetscBool  *flg)
 {
   PetscErrorCode ierr;
-  PetscInt       i,N;
+  PetscInt       i;
   size_t         len;
-  char           **names,tmp[256];
-  PetscBool      match;
+  char           tmp[256];
+  khint_t        k;
 
   PetscFunctionBegin;
-  options = options ? options : defaultoptions;
-  N     = options->N;
-  names = options->names;
-
   if (name[0] != '-') SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Name must begin with -: Instead %s",name);
 
   /* append prefix to name, if prefix="foo_" and option='--bar", prefixed option is --foo_bar */
@@ -1324,15 +1364,14 @@ PetscErrorCode PetscOptionsFindPair_Private(PetscOptions options,const char pre[
   }
 #endif
 
-  /* slow search */
   *flg = PETSC_FALSE;
-  for (i=0; i<N; i++) {
-    ierr = PetscStrcasecmp(names[i],tmp,&match);CHKERRQ(ierr);
-    if (match) {
+  if (options->ht) {
+    k = kh_get(HTO,options->ht,tmp);
+    if (k != kh_end(options->ht)) {
+      i                = kh_val(options->ht,k);
       *value           = options->values[i];
       options->used[i] = PETSC_TRUE;
       *flg             = PETSC_TRUE;
-      break;
     }
   }
   if (!*flg) {
@@ -1358,7 +1397,7 @@ PetscErrorCode PetscOptionsFindPair_Private(PetscOptions options,const char pre[
         ierr = PetscStrcpy(tmp2,"-");CHKERRQ(ierr);
         ierr = PetscStrncat(tmp2,tmp,locs[i]);CHKERRQ(ierr);
         ierr = PetscStrcat(tmp2,tmp+loce[i]);CHKERRQ(ierr);
-        ierr = PetscOptionsFindPair_Private(options,NULL,tmp2,value,flg);CHKERRQ(ierr);
+        ierr = PetscOptionsFindPair_Hash(options,NULL,tmp2,value,flg);CHKERRQ(ierr);
         if (*flg) break;
       }
     }
@@ -1366,6 +1405,27 @@ PetscErrorCode PetscOptionsFindPair_Private(PetscOptions options,const char pre[
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode PetscOptionsFindPair_Private(PetscOptions options,const char pre[],const char name[],char *value[],PetscBool  *flg)
+{
+  PetscErrorCode ierr;
+#if defined(PETSC_USE_LOG)
+  PetscLogDouble t0 = 0.0,t1;
+#endif
+
+  PetscFunctionBegin;
+  options = options ? options : defaultoptions;
+#if defined(PETSC_USE_LOG)
+  if (PetscLogPLB) PetscTime(&t0);
+#endif
+  ierr = PetscOptionsFindPair_Hash(options,pre,name,value,flg);CHKERRQ(ierr);
+  options->nlookups++;
+  if (*flg) options->nfound++;
+#if defined(PETSC_USE_LOG)
+  if (PetscLogPLB) {PetscTime(&t1); options->lookuptime += t1-t0;}
+#endif
+  PetscFunctionReturn(0);
+}
+
 PETSC_EXTERN PetscErrorCode PetscOptionsFindPairPrefix_Private(PetscOptions options,const char pre[], const char name[], char *value[], PetscBool *flg)
 {
   PetscErrorCode ierr;
@@ -1409,15 +1469,17 @@ PETSC_EXTERN PetscErrorCode PetscOptionsFindPairPrefix_Private(PetscOptions opti
   }
 #endif
 
-  /* slow search */
-  *flg = PETSC_FALSE;
+  /* slow search, names are only matched by their beginning */
+  if (flg) *flg = PETSC_FALSE;
   ierr = PetscStrlen(tmp,&len);CHKERRQ(ierr);
+  options->nlookups++;
   for (i = 0; i < N; ++i) {
     ierr = PetscStrncmp(names[i], tmp, len, &match);CHKERRQ(ierr);
     if (match) {
       if (value) *value = options->values[i];
       options->used[i]  = PETSC_TRUE;
       if (flg)   *flg   = PETSC_TRUE;
+      options->nfound++;
       break;
     }
   }
@@ -2521,6 +2583,36 @@ PetscErrorCode  PetscOptionsLeftGet(PetscOptions options,PetscInt *N,char **name
 }
 
 
+/*@C
+  PetscOptionsGetLookupCounts - Gets the number of queries of the options database and the time spent in them
+
+  Not collective
+
+  Input Parameter:
+. options - options database, use NULL for default global database
+
+  Output Parameters:
++ nlookups - the number of queries of option names
+. nfound - the number of queries that found the option
+- time - the time spent in the queries, only measured while logging with -log_view
+
+  Notes:
+  Any of the output arguments may be NULL. The counts are printed by -log_view.
+
+  Level: advanced
+
+.seealso: PetscOptionsView(), PetscLogView()
+@*/
+PetscErrorCode PetscOptionsGetLookupCounts(PetscOptions options,PetscInt64 *nlookups,PetscInt64 *nfound,PetscLogDouble *time)
+{
+  PetscFunctionBegin;
+  options = options ? options : defaultoptions;
+  if (nlookups) *nlookups = options->nlookups;
+  if (nfound)   *nfound   = options->nfound;
+  if (time)     *time     = options->lookuptime;
+  PetscFunctionReturn(0);
+}
+
 /*@C
   PetscOptionsLeftRestore - Free memory for the unused PETSc options obtained using PetscOptionsLeftGet.
 
@@ -663,6 +663,7 @@ PetscErrorCode  PetscInitializeSAWs(const char help[])
         summary is written to the file.  See PetscLogView().
 .  -log_exclude: <vec,mat,pc.ksp,snes> - excludes subset of object classes from logging
 .  -log_all [filename] - Logs extensive profiling information  See PetscLogDump().
+.  -log_timeline [filename] - Writes a timeline of the events of all processes in the Chrome trace format, see PetscLogTimelineDump().
 .  -log [filename] - Logs basic profiline information  See PetscLogDump().
 -  -log_mpe [filename] - Creates a logfile viewable by the utility Jumpshot (in MPICH distribution)
 
@@ -1254,6 +1255,13 @@ PetscErrorCode  PetscFinalize(void)
     if (mname[0]) PetscLogDump(mname);
     else          PetscLogDump(0);
   }
+
+  mname[0] = 0;
+  ierr = PetscOptionsGetString(NULL,NULL,"-log_timeline",mname,PETSC_MAX_PATH_LEN,&flg1);CHKERRQ(ierr);
+  if (flg1) {
+    if (mname[0]) {ierr = PetscLogTimelineDump(mname);CHKERRQ(ierr);}
+    else          {ierr = PetscLogTimelineDump(NULL);CHKERRQ(ierr);}
+  }
 #endif
 
   ierr = PetscStackDestroy();CHKERRQ(ierr);
@@ -136,6 +136,7 @@ static PetscErrorCode TaoSolve_GPCG(Tao tao)
   PetscInt                     its;
   PetscReal                    actred,f,f_new,gnorm,gdx,stepsize,xtb;
   PetscReal                    xtHx;
+  PetscObjectId                hid,pid;
   TaoConvergedReason           reason = TAO_CONTINUE_ITERATING;
   TaoLineSearchConvergedReason ls_status = TAOLINESEARCH_CONTINUE_ITERATING;
 
@@ -177,12 +178,10 @@ static PetscErrorCode TaoSolve_GPCG(Tao tao)
 
     f=gpcg->f; gnorm=gpcg->gnorm;
 
-    ierr = KSPReset(tao->ksp);CHKERRQ(ierr);
-
     if (gpcg->n_free > 0){
       /* Create a reduced linear system */
-      ierr = VecDestroy(&gpcg->R);CHKERRQ(ierr);
-      ierr = VecDestroy(&gpcg->DXFree);CHKERRQ(ierr);
+      hid  = gpcg->Hsub ? ((PetscObject)gpcg->Hsub)->id : 0;
+      pid  = gpcg->Hsub_pre ? ((PetscObject)gpcg->Hsub_pre)->id : 0;
       ierr = TaoVecGetSubVec(tao->gradient,gpcg->Free_Local, tao->subset_type, 0.0, &gpcg->R);CHKERRQ(ierr);
       ierr = VecScale(gpcg->R, -1.0);CHKERRQ(ierr);
       ierr = TaoVecGetSubVec(tao->stepdirection,gpcg->Free_Local,tao->subset_type, 0.0, &gpcg->DXFree);CHKERRQ(ierr);
@@ -195,10 +194,13 @@ static PetscErrorCode TaoSolve_GPCG(Tao tao)
         ierr = PetscObjectReference((PetscObject)gpcg->Hsub);CHKERRQ(ierr);
         gpcg->Hsub_pre = gpcg->Hsub;
       }  else {
-        ierr = TaoMatGetSubMat(tao->hessian, gpcg->Free_Local, gpcg->Work, tao->subset_type, &gpcg->Hsub_pre);CHKERRQ(ierr);
+        ierr = TaoMatGetSubMat(tao->hessian_pre, gpcg->Free_Local, gpcg->Work, tao->subset_type, &gpcg->Hsub_pre);CHKERRQ(ierr);
       }
 
-      ierr = KSPReset(tao->ksp);CHKERRQ(ierr);
+      /* new reduced matrices, the active set changed */
+      if (((PetscObject)gpcg->Hsub)->id != hid || ((PetscObject)gpcg->Hsub_pre)->id != pid) {
+        ierr = KSPReset(tao->ksp);CHKERRQ(ierr);
+      }
       ierr = KSPSetOperators(tao->ksp,gpcg->Hsub,gpcg->Hsub_pre);CHKERRQ(ierr);
 
       ierr = KSPSolve(tao->ksp,gpcg->R,gpcg->DXFree);CHKERRQ(ierr);
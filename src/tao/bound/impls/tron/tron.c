@@ -96,6 +96,7 @@ static PetscErrorCode TaoSolve_TRON(Tao tao)
   TaoConvergedReason           reason = TAO_CONTINUE_ITERATING;
   TaoLineSearchConvergedReason ls_reason = TAOLINESEARCH_CONTINUE_ITERATING;
   PetscReal                    prered,actred,delta,f,f_new,rhok,gdx,xdiff,stepsize;
+  PetscObjectId                hid,pid;
 
   PetscFunctionBegin;
   tron->pgstepsize=1.0;
@@ -142,6 +143,8 @@ static PetscErrorCode TaoSolve_TRON(Tao tao)
       break;
     }
     /* use free_local to mask/submat gradient, hessian, stepdirection */
+    hid  = tron->H_sub ? ((PetscObject)tron->H_sub)->id : 0;
+    pid  = tron->Hpre_sub ? ((PetscObject)tron->Hpre_sub)->id : 0;
     ierr = TaoVecGetSubVec(tao->gradient,tron->Free_Local,tao->subset_type,0.0,&tron->R);CHKERRQ(ierr);
     ierr = TaoVecGetSubVec(tao->gradient,tron->Free_Local,tao->subset_type,0.0,&tron->DXFree);CHKERRQ(ierr);
     ierr = VecSet(tron->DXFree,0.0);CHKERRQ(ierr);
@@ -154,7 +157,10 @@ static PetscErrorCode TaoSolve_TRON(Tao tao)
     } else {
       ierr = TaoMatGetSubMat(tao->hessian_pre, tron->Free_Local, tron->diag, tao->subset_type,&tron->Hpre_sub);CHKERRQ(ierr);
     }
-    ierr = KSPReset(tao->ksp);CHKERRQ(ierr);
+    /* new reduced matrices, the active set changed */
+    if (((PetscObject)tron->H_sub)->id != hid || ((PetscObject)tron->Hpre_sub)->id != pid) {
+      ierr = KSPReset(tao->ksp);CHKERRQ(ierr);
+    }
     ierr = KSPSetOperators(tao->ksp, tron->H_sub, tron->Hpre_sub);CHKERRQ(ierr);
     while (1) {
 
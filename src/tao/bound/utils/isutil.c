@@ -2,6 +2,85 @@
 #include <petsc/private/taoimpl.h>
 #include <../src/tao/matrix/submatfree.h>
 
+/* whether the vector v, which may be NULL, has nlocal entries on every process and flg is true on every process */
+static PetscErrorCode TaoVecReusable_Private(MPI_Comm comm,Vec v,PetscInt nlocal,PetscBool flg,PetscBool *reuse)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = -1;
+
+  PetscFunctionBegin;
+  if (v) {ierr = VecGetLocalSize(v,&n);CHKERRQ(ierr);}
+  flg  = (PetscBool)(flg && n == nlocal);
+  ierr = MPIU_Allreduce(&flg,reuse,1,MPIU_BOOL,MPI_MIN,comm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the matrix a submatrix was extracted from, its nonzero state and the index set of the extraction */
+typedef struct {
+  PetscObjectId    id;
+  PetscObjectState nzstate;
+  IS               is;
+} TaoSubMatInfo;
+
+static PetscErrorCode TaoSubMatInfoDestroy_Private(void *ptr)
+{
+  TaoSubMatInfo  *info = (TaoSubMatInfo*)ptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = ISDestroy(&info->is);CHKERRQ(ierr);
+  ierr = PetscFree(info);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* whether Msub was extracted from M, whose nonzero pattern has not changed since, with the same index set if is is
+   given; otherwise records the extraction in info so that it can be attached to the new submatrix. The reduced
+   matrices are thus reused while the active set does not change, and then the preconditioner keeps its setup */
+static PetscErrorCode TaoSubMatReusable_Private(Mat M,IS is,Mat Msub,PetscBool *reuse,TaoSubMatInfo **info)
+{
+  PetscErrorCode   ierr;
+  PetscContainer   container = NULL;
+  TaoSubMatInfo    *old = NULL;
+  PetscObjectId    id;
+  PetscObjectState nzstate;
+  PetscBool        flg = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetId((PetscObject)M,&id);CHKERRQ(ierr);
+  ierr = MatGetNonzeroState(M,&nzstate);CHKERRQ(ierr);
+  if (Msub) {ierr = PetscObjectQuery((PetscObject)Msub,"TaoSubMatInfo",(PetscObject*)&container);CHKERRQ(ierr);}
+  if (container) {
+    ierr = PetscContainerGetPointer(container,(void**)&old);CHKERRQ(ierr);
+    flg  = (PetscBool)(old->id == id && old->nzstate == nzstate);
+  }
+  ierr = MPIU_Allreduce(&flg,reuse,1,MPIU_BOOL,MPI_MIN,PetscObjectComm((PetscObject)M));CHKERRQ(ierr);
+  if (*reuse && is) {ierr = ISEqual(old->is,is,reuse);CHKERRQ(ierr);}
+  *info = NULL;
+  if (!*reuse) {
+    ierr = PetscNew(info);CHKERRQ(ierr);
+    (*info)->id      = id;
+    (*info)->nzstate = nzstate;
+    if (is) {
+      ierr = ISDuplicate(is,&(*info)->is);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TaoSubMatAttachInfo_Private(Mat Msub,TaoSubMatInfo *info)
+{
+  PetscErrorCode ierr;
+  PetscContainer container;
+
+  PetscFunctionBegin;
+  ierr = PetscContainerCreate(PetscObjectComm((PetscObject)Msub),&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,info);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,TaoSubMatInfoDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)Msub,"TaoSubMatInfo",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   TaoVecGetSubVec - Gets a subvector using the IS
 
@@ -17,11 +96,14 @@
   Notes:
   maskvalue should usually be 0.0, unless a pointwise divide will be used.
 
+  A previous vreduced of the right size is reused. With TAO_SUBSET_SUBVEC and an index set of locally owned entries,
+  such as the free variables of VecWhichBetween(), the entries are then copied without creating a scatter.
+
 @*/
 PetscErrorCode TaoVecGetSubVec(Vec vfull, IS is, TaoSubsetType reduced_type, PetscReal maskvalue, Vec *vreduced)
 {
   PetscErrorCode ierr;
-  PetscInt       nfull,nreduced,nreduced_local,rlow,rhigh,flow,fhigh;
+  PetscInt       nfull,nreduced,nreduced_local,rlow,rhigh,flow,fhigh,imin,imax;
   PetscInt       i,nlocal;
   PetscReal      *fv,*rv;
   const PetscInt *s;
@@ -29,6 +111,7 @@ PetscErrorCode TaoVecGetSubVec(Vec vfull, IS is, TaoSubsetType reduced_type, Pet
   VecType        vtype;
   VecScatter     scatter;
   MPI_Comm       comm;
+  PetscBool      reuse;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(vfull,VEC_CLASSID,1);
@@ -36,18 +119,35 @@ PetscErrorCode TaoVecGetSubVec(Vec vfull, IS is, TaoSubsetType reduced_type, Pet
 
   ierr = VecGetSize(vfull, &nfull);CHKERRQ(ierr);
   ierr = ISGetSize(is, &nreduced);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(vfull,&flow,&fhigh);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)vfull,&comm);CHKERRQ(ierr);
 
   if (nreduced == nfull) {
-    ierr = VecDestroy(vreduced);CHKERRQ(ierr);
-    ierr = VecDuplicate(vfull,vreduced);CHKERRQ(ierr);
+    ierr = TaoVecReusable_Private(comm,*vreduced,fhigh-flow,PETSC_TRUE,&reuse);CHKERRQ(ierr);
+    if (!reuse) {
+      ierr = VecDestroy(vreduced);CHKERRQ(ierr);
+      ierr = VecDuplicate(vfull,vreduced);CHKERRQ(ierr);
+    }
     ierr = VecCopy(vfull,*vreduced);CHKERRQ(ierr);
   } else {
     switch (reduced_type) {
     case TAO_SUBSET_SUBVEC:
-      ierr = VecGetType(vfull,&vtype);CHKERRQ(ierr);
-      ierr = VecGetOwnershipRange(vfull,&flow,&fhigh);CHKERRQ(ierr);
       ierr = ISGetLocalSize(is,&nreduced_local);CHKERRQ(ierr);
-      ierr = PetscObjectGetComm((PetscObject)vfull,&comm);CHKERRQ(ierr);
+      ierr = ISGetMinMax(is,&imin,&imax);CHKERRQ(ierr);
+      /* indices owned by this process, as the ones of VecWhichBetween(), are copied into the previous subvector when it
+         has the right size, without creating a scatter */
+      ierr = TaoVecReusable_Private(comm,*vreduced,nreduced_local,(PetscBool)(!nreduced_local || (imin >= flow && imax < fhigh)),&reuse);CHKERRQ(ierr);
+      if (reuse) {
+        ierr = VecGetArray(vfull,&fv);CHKERRQ(ierr);
+        ierr = VecGetArray(*vreduced,&rv);CHKERRQ(ierr);
+        ierr = ISGetIndices(is,&s);CHKERRQ(ierr);
+        for (i=0;i<nreduced_local;i++) rv[i] = fv[s[i]-flow];
+        ierr = ISRestoreIndices(is,&s);CHKERRQ(ierr);
+        ierr = VecRestoreArray(vfull,&fv);CHKERRQ(ierr);
+        ierr = VecRestoreArray(*vreduced,&rv);CHKERRQ(ierr);
+        break;
+      }
+      ierr = VecGetType(vfull,&vtype);CHKERRQ(ierr);
       if (*vreduced) {
         ierr = VecDestroy(vreduced);CHKERRQ(ierr);
       }
@@ -68,13 +168,14 @@ PetscErrorCode TaoVecGetSubVec(Vec vfull, IS is, TaoSubsetType reduced_type, Pet
     case TAO_SUBSET_MATRIXFREE:
       /* vr[i] = vf[i]   if i in is
        vr[i] = 0       otherwise */
-      if (!*vreduced) {
+      ierr = TaoVecReusable_Private(comm,*vreduced,fhigh-flow,PETSC_TRUE,&reuse);CHKERRQ(ierr);
+      if (!reuse) {
+        ierr = VecDestroy(vreduced);CHKERRQ(ierr);
         ierr = VecDuplicate(vfull,vreduced);CHKERRQ(ierr);
       }
 
       ierr = VecSet(*vreduced,maskvalue);CHKERRQ(ierr);
       ierr = ISGetLocalSize(is,&nlocal);CHKERRQ(ierr);
-      ierr = VecGetOwnershipRange(vfull,&flow,&fhigh);CHKERRQ(ierr);
       ierr = VecGetArray(vfull,&fv);CHKERRQ(ierr);
       ierr = VecGetArray(*vreduced,&rv);CHKERRQ(ierr);
       ierr = ISGetIndices(is,&s);CHKERRQ(ierr);
@@ -101,22 +202,38 @@ PetscErrorCode TaoVecGetSubVec(Vec vfull, IS is, TaoSubsetType reduced_type, Pet
 - subset_type - the method TAO is using for subsetting (TAO_SUBSET_SUBVEC, TAO_SUBSET_MASK,
   TAO_SUBSET_MATRIXFREE)
 
-  Output Parameters:
-. Msub - the submatrix
+  Input/Output Parameters:
+. Msub - the submatrix, the previous one on input
+
+  Notes:
+  The submatrix of the previous call is reused instead of being created again when possible. With TAO_SUBSET_SUBVEC it
+  is refilled with the values of M when it was extracted from M with the same index set and M kept its nonzero pattern,
+  that is when the active set has not changed. With TAO_SUBSET_MATRIXFREE the masked operator on M only gets the new
+  index set, and with TAO_SUBSET_MASK and -different_submatrix the copy of M is refilled.
+
 @*/
 PetscErrorCode TaoMatGetSubMat(Mat M, IS is, Vec v1, TaoSubsetType subset_type, Mat *Msub)
 {
   PetscErrorCode ierr;
   IS             iscomp;
-  PetscBool      flg = PETSC_FALSE;
+  PetscBool      flg = PETSC_FALSE,reuse;
+  TaoSubMatInfo  *info;
+  void           (*destroy)(void);
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(M,MAT_CLASSID,1);
   PetscValidHeaderSpecific(is,IS_CLASSID,2);
-  ierr = MatDestroy(Msub);CHKERRQ(ierr);
   switch (subset_type) {
   case TAO_SUBSET_SUBVEC:
-    ierr = MatCreateSubMatrix(M, is, is, MAT_INITIAL_MATRIX, Msub);CHKERRQ(ierr);
+    ierr = TaoSubMatReusable_Private(M,is,*Msub,&reuse,&info);CHKERRQ(ierr);
+    if (reuse) {
+      ierr = PetscInfo(M,"Active set unchanged, refilling the previous submatrix\n");CHKERRQ(ierr);
+      ierr = MatCreateSubMatrix(M, is, is, MAT_REUSE_MATRIX, Msub);CHKERRQ(ierr);
+    } else {
+      ierr = MatDestroy(Msub);CHKERRQ(ierr);
+      ierr = MatCreateSubMatrix(M, is, is, MAT_INITIAL_MATRIX, Msub);CHKERRQ(ierr);
+      ierr = TaoSubMatAttachInfo_Private(*Msub,info);CHKERRQ(ierr);
+    }
     break;
 
   case TAO_SUBSET_MASK:
@@ -128,8 +245,17 @@ PetscErrorCode TaoMatGetSubMat(Mat M, IS is, Vec v1, TaoSubsetType subset_type,
     ierr = PetscOptionsBool("-different_submatrix","use separate hessian matrix when computing submatrices","TaoSubsetType",flg,&flg,NULL);CHKERRQ(ierr);
     ierr = PetscOptionsEnd();CHKERRQ(ierr);
     if (flg) {
-      ierr = MatDuplicate(M, MAT_COPY_VALUES, Msub);CHKERRQ(ierr);
+      /* the zeroed entries stay in the nonzero pattern of the copy, so it can be refilled whatever the active set */
+      ierr = TaoSubMatReusable_Private(M,NULL,*Msub != M ? *Msub : NULL,&reuse,&info);CHKERRQ(ierr);
+      if (reuse) {
+        ierr = MatCopy(M, *Msub, SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      } else {
+        ierr = MatDestroy(Msub);CHKERRQ(ierr);
+        ierr = MatDuplicate(M, MAT_COPY_VALUES, Msub);CHKERRQ(ierr);
+        ierr = TaoSubMatAttachInfo_Private(*Msub,info);CHKERRQ(ierr);
+      }
     } else {
+      ierr = MatDestroy(Msub);CHKERRQ(ierr);
       /* Act on hessian directly (default) */
       ierr = PetscObjectReference((PetscObject)M);CHKERRQ(ierr);
       *Msub = M;
@@ -147,7 +273,28 @@ PetscErrorCode TaoMatGetSubMat(Mat M, IS is, Vec v1, TaoSubsetType subset_type,
     break;
   case TAO_SUBSET_MATRIXFREE:
     ierr = ISComplementVec(is,v1,&iscomp);CHKERRQ(ierr);
-    ierr = MatCreateSubMatrixFree(M,iscomp,iscomp,Msub);CHKERRQ(ierr);
+    /* the masked operator on M only needs the new active set */
+    flg = PETSC_FALSE;
+    if (*Msub) {
+      ierr = PetscObjectTypeCompare((PetscObject)*Msub,MATSHELL,&flg);CHKERRQ(ierr);
+    }
+    if (flg) {
+      MatSubMatFreeCtx ctx;
+
+      ierr = MatShellGetOperation(*Msub,MATOP_DESTROY,&destroy);CHKERRQ(ierr);
+      flg  = (PetscBool)(destroy == (void (*)(void))MatDestroy_SMF);
+      if (flg) {
+        ierr = MatShellGetContext(*Msub,(void**)&ctx);CHKERRQ(ierr);
+        flg  = (PetscBool)(ctx->A == M);
+      }
+    }
+    if (flg) {
+      ierr = MatSMFResetRowColumn(*Msub,iscomp,iscomp);CHKERRQ(ierr);
+      ierr = PetscObjectStateIncrease((PetscObject)*Msub);CHKERRQ(ierr);
+    } else {
+      ierr = MatDestroy(Msub);CHKERRQ(ierr);
+      ierr = MatCreateSubMatrixFree(M,iscomp,iscomp,Msub);CHKERRQ(ierr);
+    }
     ierr = ISDestroy(&iscomp);CHKERRQ(ierr);
     break;
   }
@@ -0,0 +1,238 @@
+/* Program usage: mpiexec -n <procs> blocktoy [-help] [-nb <blocks>] [all TAO options] */
+
+/* ----------------------------------------------------------------------
+A distributed block version of the toy problem with linear constraints,
+for each block k of the variables (x1,x2) = (x[2k],x[2k+1])
+
+min f=(x1-2)^2 + (x2-2)^2 -2*x1-2*x2
+s.t.     x1 + x2 = 2
+      -0.5 <= x1 - x2 <= 1
+      -1 <= x1,x2 <= 2
+
+The variables, the equality and the inequality constraints are distributed
+independently, so a block may have its variables and constraints on different
+processes.
+---------------------------------------------------------------------- */
+
+#include <petsctao.h>
+
+static  char help[]="Solves a distributed block version of the toy problem with the interior point method.\n\
+Options:\n\
+ -nb <blocks> : number of blocks of 2 variables\n\n";
+
+/*T
+   Concepts: TAO^Solving a constrained minimization problem
+   Routines: TaoCreate(); TaoSetType(); TaoSetInitialVector();
+   Routines: TaoSetVariableBounds(); TaoSetObjectiveAndGradientRoutine();
+   Routines: TaoSetEqualityConstraintsRoutine(); TaoSetInequalityConstraintsRoutine();
+   Routines: TaoSetJacobianEqualityRoutine(); TaoSetJacobianInequalityRoutine();
+   Routines: TaoSetHessianRoutine(); TaoSetFromOptions(); TaoSolve();
+   Routines: TaoGetSolutionStatus(); TaoDestroy();
+   Processors: n
+T*/
+
+/*
+   User-defined application context - contains data needed by the
+   application-provided call-back routines. The constraints are linear,
+   ce = Ae*x - 2 and ci = Ai*x + bi, and the Hessian is 2*I.
+*/
+typedef struct {
+  PetscInt nb; /* number of blocks */
+  PetscInt n;  /* length x */
+  PetscInt ne; /* number of equality constraints */
+  PetscInt ni; /* number of inequality constraints */
+  Vec      x,xl,xu;
+  Vec      ce,ci,bi;
+  Mat      Ae,Ai,H;
+} AppCtx;
+
+/* -------- User-defined Routines --------- */
+
+PetscErrorCode InitializeProblem(AppCtx *);
+PetscErrorCode DestroyProblem(AppCtx *);
+PetscErrorCode FormFunctionGradient(Tao,Vec,PetscReal *,Vec,void *);
+PetscErrorCode FormHessian(Tao,Vec,Mat,Mat, void*);
+PetscErrorCode FormInequalityConstraints(Tao,Vec,Vec,void*);
+PetscErrorCode FormEqualityConstraints(Tao,Vec,Vec,void*);
+PetscErrorCode FormInequalityJacobian(Tao,Vec,Mat,Mat, void*);
+PetscErrorCode FormEqualityJacobian(Tao,Vec,Mat,Mat, void*);
+
+PetscErrorCode main(int argc,char **argv)
+{
+  PetscErrorCode     ierr;                /* used to check for functions returning nonzeros */
+  Tao                tao;
+  PetscReal          f,gnorm;
+  PetscInt           its;
+  TaoConvergedReason reason;
+  AppCtx             user;                /* application context */
+
+  ierr = PetscInitialize(&argc,&argv,(char *)0,help);CHKERRQ(ierr);
+  user.nb = 5;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nb",&user.nb,NULL);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"\n---- Block TOY Problem -----\n");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Solution should be f(1,...,1)=%D\n",-2*user.nb);CHKERRQ(ierr);
+  ierr = InitializeProblem(&user);CHKERRQ(ierr);
+  ierr = TaoCreate(PETSC_COMM_WORLD,&tao);CHKERRQ(ierr);
+  ierr = TaoSetType(tao,TAOIPM);CHKERRQ(ierr);
+  ierr = TaoSetInitialVector(tao,user.x);CHKERRQ(ierr);
+  ierr = TaoSetVariableBounds(tao,user.xl,user.xu);CHKERRQ(ierr);
+  ierr = TaoSetObjectiveAndGradientRoutine(tao,FormFunctionGradient,(void*)&user);CHKERRQ(ierr);
+
+  ierr = TaoSetEqualityConstraintsRoutine(tao,user.ce,FormEqualityConstraints,(void*)&user);CHKERRQ(ierr);
+  ierr = TaoSetInequalityConstraintsRoutine(tao,user.ci,FormInequalityConstraints,(void*)&user);CHKERRQ(ierr);
+
+  ierr = TaoSetJacobianEqualityRoutine(tao,user.Ae,user.Ae,FormEqualityJacobian,(void*)&user);CHKERRQ(ierr);
+  ierr = TaoSetJacobianInequalityRoutine(tao,user.Ai,user.Ai,FormInequalityJacobian,(void*)&user);CHKERRQ(ierr);
+  ierr = TaoSetHessianRoutine(tao,user.H,user.H,FormHessian,(void*)&user);CHKERRQ(ierr);
+  ierr = TaoSetTolerances(tao,1.e-5,0,0);CHKERRQ(ierr);
+  ierr = TaoSetFromOptions(tao);CHKERRQ(ierr);
+
+  ierr = TaoSolve(tao);CHKERRQ(ierr);
+  ierr = TaoGetSolutionStatus(tao,&its,&f,&gnorm,NULL,NULL,&reason);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Converged reason %s, f = %.6f\n",TaoConvergedReasons[reason],(double)f);CHKERRQ(ierr);
+
+  ierr = DestroyProblem(&user);CHKERRQ(ierr);
+  ierr = TaoDestroy(&tao);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+PetscErrorCode InitializeProblem(AppCtx *user)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,k,rstart,rend,cols[2];
+  PetscScalar    vals[2];
+
+  PetscFunctionBegin;
+  user->n = 2*user->nb;
+  ierr = VecCreate(PETSC_COMM_WORLD,&user->x);CHKERRQ(ierr);
+  ierr = VecSetSizes(user->x,PETSC_DECIDE,user->n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(user->x);CHKERRQ(ierr);
+  ierr = VecDuplicate(user->x,&user->xl);CHKERRQ(ierr);
+  ierr = VecDuplicate(user->x,&user->xu);CHKERRQ(ierr);
+  ierr = VecSet(user->x,0.0);CHKERRQ(ierr);
+  ierr = VecSet(user->xl,-1.0);CHKERRQ(ierr);
+  ierr = VecSet(user->xu,2.0);CHKERRQ(ierr);
+
+  user->ne = user->nb;
+  ierr = VecCreate(PETSC_COMM_WORLD,&user->ce);CHKERRQ(ierr);
+  ierr = VecSetSizes(user->ce,PETSC_DECIDE,user->ne);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(user->ce);CHKERRQ(ierr);
+
+  user->ni = 2*user->nb;
+  ierr = VecCreate(PETSC_COMM_WORLD,&user->ci);CHKERRQ(ierr);
+  ierr = VecSetSizes(user->ci,PETSC_DECIDE,user->ni);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(user->ci);CHKERRQ(ierr);
+  ierr = VecDuplicate(user->ci,&user->bi);CHKERRQ(ierr);
+
+  /* Ae has the row [1 1] and Ai the rows [1 -1] and [-1 1] in the columns of each block */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,user->ne,user->n,2,NULL,2,NULL,&user->Ae);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(user->Ae);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(user->Ae,&rstart,&rend);CHKERRQ(ierr);
+  for (k=rstart; k<rend; k++) {
+    cols[0] = 2*k; cols[1] = 2*k+1;
+    vals[0] = 1.0; vals[1] = 1.0;
+    ierr = MatSetValues(user->Ae,1,&k,2,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(user->Ae,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(user->Ae,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,user->ni,user->n,2,NULL,2,NULL,&user->Ai);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(user->Ai);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(user->Ai,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    k       = i/2;
+    cols[0] = 2*k; cols[1] = 2*k+1;
+    vals[0] = (i%2) ? -1.0 : 1.0; vals[1] = -vals[0];
+    ierr = MatSetValues(user->Ai,1,&i,2,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = VecSetValue(user->bi,i,(i%2) ? 1.0 : 0.5,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(user->Ai,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(user->Ai,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(user->bi);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(user->bi);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,user->n,user->n,1,NULL,0,NULL,&user->H);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(user->H);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(user->H,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    ierr = MatSetValue(user->H,i,i,2.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(user->H,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(user->H,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DestroyProblem(AppCtx *user)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroy(&user->Ae);CHKERRQ(ierr);
+  ierr = MatDestroy(&user->Ai);CHKERRQ(ierr);
+  ierr = MatDestroy(&user->H);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&user->x);CHKERRQ(ierr);
+  ierr = VecDestroy(&user->ce);CHKERRQ(ierr);
+  ierr = VecDestroy(&user->ci);CHKERRQ(ierr);
+  ierr = VecDestroy(&user->bi);CHKERRQ(ierr);
+  ierr = VecDestroy(&user->xl);CHKERRQ(ierr);
+  ierr = VecDestroy(&user->xu);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* f = sum_i (x_i-2)^2 - 2*x_i = x'*x - 6*sum(x) + 4*n */
+PetscErrorCode FormFunctionGradient(Tao tao, Vec X, PetscReal *f, Vec G, void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  PetscScalar    xx,sum;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDot(X,X,&xx);CHKERRQ(ierr);
+  ierr = VecSum(X,&sum);CHKERRQ(ierr);
+  *f   = PetscRealPart(xx - 6.0*sum) + 4.0*user->n;
+  ierr = VecCopy(X,G);CHKERRQ(ierr);
+  ierr = VecScale(G,2.0);CHKERRQ(ierr);
+  ierr = VecShift(G,-6.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode FormHessian(Tao tao, Vec x, Mat H, Mat Hpre, void *ctx)
+{
+  PetscFunctionBegin;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode FormInequalityConstraints(Tao tao, Vec X, Vec CI, void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultAdd(user->Ai,X,user->bi,CI);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode FormEqualityConstraints(Tao tao, Vec X, Vec CE,void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMult(user->Ae,X,CE);CHKERRQ(ierr);
+  ierr = VecShift(CE,-2.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode FormInequalityJacobian(Tao tao, Vec X, Mat JI, Mat JIpre,  void *ctx)
+{
+  PetscFunctionBegin;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode FormEqualityJacobian(Tao tao, Vec X, Mat JE, Mat JEpre, void *ctx)
+{
+  PetscFunctionBegin;
+  PetscFunctionReturn(0);
+}
@@ -29,6 +29,7 @@ static PetscErrorCode IPMUpdateAi(Tao tao);
 static PetscErrorCode IPMGatherRHS(Tao tao,Vec,Vec,Vec,Vec,Vec);
 static PetscErrorCode IPMScatterStep(Tao tao,Vec,Vec,Vec,Vec,Vec);
 static PetscErrorCode IPMInitializeBounds(Tao tao);
+static PetscErrorCode IPMDestroyK(Tao tao);
 
 static PetscErrorCode TaoSolve_IPM(Tao tao)
 {
@@ -200,7 +201,6 @@ static PetscErrorCode TaoSetup_IPM(Tao tao)
 
   PetscFunctionBegin;
   ipmP->nb = ipmP->mi = ipmP->me = 0;
-  ipmP->K=0;
   ierr = VecGetSize(tao->solution,&ipmP->n);CHKERRQ(ierr);
   if (!tao->gradient) {
     ierr = VecDuplicate(tao->solution, &tao->gradient);CHKERRQ(ierr);
@@ -229,28 +229,21 @@ static PetscErrorCode IPMInitializeBounds(Tao tao)
 {
   TAO_IPM        *ipmP = (TAO_IPM*)tao->data;
   Vec            xtmp;
-  PetscInt       xstart,xend;
-  PetscInt       ucstart,ucend; /* user ci */
-  PetscInt       ucestart,uceend; /* user ce */
-  PetscInt       sstart,send;
-  PetscInt       bigsize;
-  PetscInt       i,counter,nloc;
-  PetscInt       *cind,*xind,*ucind,*uceind,*stepind;
+  PetscInt       i,nloc,meloc = 0,miloc = 0,nxlloc = 0,nxuloc = 0,sloc = 0,dloc;
   VecType        vtype;
-  const PetscInt *xli,*xui;
-  PetscInt       xl_offset,xu_offset;
-  IS             bigxl,bigxu,isuc,isc,isx,sis,is1;
+  PetscMPIInt    size;
   PetscErrorCode ierr;
   MPI_Comm       comm;
 
   PetscFunctionBegin;
-  cind=xind=ucind=uceind=stepind=0;
   ipmP->mi=0;
   ipmP->nxlb=0;
   ipmP->nxub=0;
   ipmP->nb=0;
   ipmP->nslack=0;
 
+  ierr = ISDestroy(&ipmP->isxl);CHKERRQ(ierr);
+  ierr = ISDestroy(&ipmP->isxu);CHKERRQ(ierr);
   ierr = VecDuplicate(tao->solution,&xtmp);CHKERRQ(ierr);
   if (!tao->XL && !tao->XU && tao->ops->computebounds) {
     ierr = TaoComputeVariableBounds(tao);CHKERRQ(ierr);
@@ -259,6 +252,7 @@ static PetscErrorCode IPMInitializeBounds(Tao tao)
     ierr = VecSet(xtmp,PETSC_NINFINITY);CHKERRQ(ierr);
     ierr = VecWhichGreaterThan(tao->XL,xtmp,&ipmP->isxl);CHKERRQ(ierr);
     ierr = ISGetSize(ipmP->isxl,&ipmP->nxlb);CHKERRQ(ierr);
+    ierr = ISGetLocalSize(ipmP->isxl,&nxlloc);CHKERRQ(ierr);
   } else {
     ipmP->nxlb=0;
   }
@@ -266,12 +260,14 @@ static PetscErrorCode IPMInitializeBounds(Tao tao)
     ierr = VecSet(xtmp,PETSC_INFINITY);CHKERRQ(ierr);
     ierr = VecWhichLessThan(tao->XU,xtmp,&ipmP->isxu);CHKERRQ(ierr);
     ierr = ISGetSize(ipmP->isxu,&ipmP->nxub);CHKERRQ(ierr);
+    ierr = ISGetLocalSize(ipmP->isxu,&nxuloc);CHKERRQ(ierr);
   } else {
     ipmP->nxub=0;
   }
   ierr = VecDestroy(&xtmp);CHKERRQ(ierr);
   if (tao->constraints_inequality) {
     ierr = VecGetSize(tao->constraints_inequality,&ipmP->mi);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(tao->constraints_inequality,&miloc);CHKERRQ(ierr);
   } else {
     ipmP->mi = 0;
   }
@@ -279,15 +275,12 @@ static PetscErrorCode IPMInitializeBounds(Tao tao)
 
   ierr = PetscObjectGetComm((PetscObject)tao->solution,&comm);CHKERRQ(ierr);
 
-  bigsize = ipmP->n+2*ipmP->nb+ipmP->me;
-  ierr = PetscMalloc1(bigsize,&stepind);CHKERRQ(ierr);
-  ierr = PetscMalloc1(ipmP->n,&xind);CHKERRQ(ierr);
-  ierr = PetscMalloc1(ipmP->me,&uceind);CHKERRQ(ierr);
-  ierr = VecGetOwnershipRange(tao->solution,&xstart,&xend);CHKERRQ(ierr);
-
   if (ipmP->nb > 0) {
+    /* the slacks of a process are its inequality constraints followed by the bounds of its variables, so that ci and
+       Ai are formed without communication */
+    sloc = miloc + nxlloc + nxuloc;
     ierr = VecCreate(comm,&ipmP->s);CHKERRQ(ierr);
-    ierr = VecSetSizes(ipmP->s,PETSC_DECIDE,ipmP->nb);CHKERRQ(ierr);
+    ierr = VecSetSizes(ipmP->s,sloc,ipmP->nb);CHKERRQ(ierr);
     ierr = VecSetFromOptions(ipmP->s);CHKERRQ(ierr);
     ierr = VecDuplicate(ipmP->s,&ipmP->ds);CHKERRQ(ierr);
     ierr = VecDuplicate(ipmP->s,&ipmP->rhs_s);CHKERRQ(ierr);
@@ -307,159 +300,32 @@ static PetscErrorCode IPMInitializeBounds(Tao tao)
     ierr = VecSet(ipmP->One_nb,1.0);CHKERRQ(ierr);
     ierr = VecDuplicate(ipmP->s,&ipmP->Inf_nb);CHKERRQ(ierr);
     ierr = VecSet(ipmP->Inf_nb,PETSC_INFINITY);CHKERRQ(ierr);
-
-    ierr = PetscMalloc1(ipmP->nb,&cind);CHKERRQ(ierr);
-    ierr = PetscMalloc1(ipmP->mi,&ucind);CHKERRQ(ierr);
-    ierr = VecGetOwnershipRange(ipmP->s,&sstart,&send);CHKERRQ(ierr);
-
-    if (ipmP->mi > 0) {
-      ierr = VecGetOwnershipRange(tao->constraints_inequality,&ucstart,&ucend);CHKERRQ(ierr);
-      counter=0;
-      for (i=ucstart;i<ucend;i++) {
-        cind[counter++] = i;
-      }
-      ierr = ISCreateGeneral(comm,counter,cind,PETSC_COPY_VALUES,&isuc);CHKERRQ(ierr);
-      ierr = ISCreateGeneral(comm,counter,cind,PETSC_COPY_VALUES,&isc);CHKERRQ(ierr);
-      ierr = VecScatterCreate(tao->constraints_inequality,isuc,ipmP->ci,isc,&ipmP->ci_scat);CHKERRQ(ierr);
-
-      ierr = ISDestroy(&isuc);CHKERRQ(ierr);
-      ierr = ISDestroy(&isc);CHKERRQ(ierr);
-    }
-    /* need to know how may xbound indices are on each process */
-    /* TODO better way */
-    if (ipmP->nxlb) {
-      ierr = ISAllGather(ipmP->isxl,&bigxl);CHKERRQ(ierr);
-      ierr = ISGetIndices(bigxl,&xli);CHKERRQ(ierr);
-      /* find offsets for this processor */
-      xl_offset = ipmP->mi;
-      for (i=0;i<ipmP->nxlb;i++) {
-        if (xli[i] < xstart) {
-          xl_offset++;
-        } else break;
-      }
-      ierr = ISRestoreIndices(bigxl,&xli);CHKERRQ(ierr);
-
-      ierr = ISGetIndices(ipmP->isxl,&xli);CHKERRQ(ierr);
-      ierr = ISGetLocalSize(ipmP->isxl,&nloc);CHKERRQ(ierr);
-      for (i=0;i<nloc;i++) {
-        xind[i] = xli[i];
-        cind[i] = xl_offset+i;
-      }
-
-      ierr = ISCreateGeneral(comm,nloc,xind,PETSC_COPY_VALUES,&isx);CHKERRQ(ierr);
-      ierr = ISCreateGeneral(comm,nloc,cind,PETSC_COPY_VALUES,&isc);CHKERRQ(ierr);
-      ierr = VecScatterCreate(tao->XL,isx,ipmP->ci,isc,&ipmP->xl_scat);CHKERRQ(ierr);
-      ierr = ISDestroy(&isx);CHKERRQ(ierr);
-      ierr = ISDestroy(&isc);CHKERRQ(ierr);
-      ierr = ISDestroy(&bigxl);CHKERRQ(ierr);
-    }
-
-    if (ipmP->nxub) {
-      ierr = ISAllGather(ipmP->isxu,&bigxu);CHKERRQ(ierr);
-      ierr = ISGetIndices(bigxu,&xui);CHKERRQ(ierr);
-      /* find offsets for this processor */
-      xu_offset = ipmP->mi + ipmP->nxlb;
-      for (i=0;i<ipmP->nxub;i++) {
-        if (xui[i] < xstart) {
-          xu_offset++;
-        } else break;
-      }
-      ierr = ISRestoreIndices(bigxu,&xui);CHKERRQ(ierr);
-
-      ierr = ISGetIndices(ipmP->isxu,&xui);CHKERRQ(ierr);
-      ierr = ISGetLocalSize(ipmP->isxu,&nloc);CHKERRQ(ierr);
-      for (i=0;i<nloc;i++) {
-        xind[i] = xui[i];
-        cind[i] = xu_offset+i;
-      }
-
-      ierr = ISCreateGeneral(comm,nloc,xind,PETSC_COPY_VALUES,&isx);CHKERRQ(ierr);
-      ierr = ISCreateGeneral(comm,nloc,cind,PETSC_COPY_VALUES,&isc);CHKERRQ(ierr);
-      ierr = VecScatterCreate(tao->XU,isx,ipmP->ci,isc,&ipmP->xu_scat);CHKERRQ(ierr);
-      ierr = ISDestroy(&isx);CHKERRQ(ierr);
-      ierr = ISDestroy(&isc);CHKERRQ(ierr);
-      ierr = ISDestroy(&bigxu);CHKERRQ(ierr);
-    }
   }
+  if (ipmP->me > 0) {
+    ierr = VecGetLocalSize(tao->constraints_equality,&meloc);CHKERRQ(ierr);
+  }
+
+  /* every process owns its part of x followed by its parts of lamdae, lamdai and s, see IPMUpdateK() */
+  ierr = VecGetLocalSize(tao->solution,&nloc);CHKERRQ(ierr);
+  dloc = meloc + 2*sloc;
   ierr = VecCreate(comm,&ipmP->bigrhs);CHKERRQ(ierr);
   ierr = VecGetType(tao->solution,&vtype);CHKERRQ(ierr);
   ierr = VecSetType(ipmP->bigrhs,vtype);CHKERRQ(ierr);
-  ierr = VecSetSizes(ipmP->bigrhs,PETSC_DECIDE,bigsize);CHKERRQ(ierr);
+  ierr = VecSetSizes(ipmP->bigrhs,nloc+dloc,ipmP->n+ipmP->me+2*ipmP->nb);CHKERRQ(ierr);
   ierr = VecSetFromOptions(ipmP->bigrhs);CHKERRQ(ierr);
   ierr = VecDuplicate(ipmP->bigrhs,&ipmP->bigstep);CHKERRQ(ierr);
 
-  /* create scatters for step->x and x->rhs */
-  for (i=xstart;i<xend;i++) {
-    stepind[i-xstart] = i;
-    xind[i-xstart] = i;
-  }
-  ierr = ISCreateGeneral(comm,xend-xstart,stepind,PETSC_COPY_VALUES,&sis);CHKERRQ(ierr);
-  ierr = ISCreateGeneral(comm,xend-xstart,xind,PETSC_COPY_VALUES,&is1);CHKERRQ(ierr);
-  ierr = VecScatterCreate(ipmP->bigstep,sis,tao->solution,is1,&ipmP->step1);CHKERRQ(ierr);
-  ierr = VecScatterCreate(tao->solution,is1,ipmP->bigrhs,sis,&ipmP->rhs1);CHKERRQ(ierr);
-  ierr = ISDestroy(&sis);CHKERRQ(ierr);
-  ierr = ISDestroy(&is1);CHKERRQ(ierr);
-
-  if (ipmP->nb > 0) {
-    for (i=sstart;i<send;i++) {
-      stepind[i-sstart] = i+ipmP->n;
-      cind[i-sstart] = i;
-    }
-    ierr = ISCreateGeneral(comm,send-sstart,stepind,PETSC_COPY_VALUES,&sis);CHKERRQ(ierr);
-    ierr = ISCreateGeneral(comm,send-sstart,cind,PETSC_COPY_VALUES,&is1);CHKERRQ(ierr);
-    ierr = VecScatterCreate(ipmP->bigstep,sis,ipmP->s,is1,&ipmP->step2);CHKERRQ(ierr);
-    ierr = ISDestroy(&sis);CHKERRQ(ierr);
-
-    for (i=sstart;i<send;i++) {
-      stepind[i-sstart] = i+ipmP->n+ipmP->me;
-      cind[i-sstart] = i;
-    }
-    ierr = ISCreateGeneral(comm,send-sstart,stepind,PETSC_COPY_VALUES,&sis);CHKERRQ(ierr);
-    ierr = VecScatterCreate(ipmP->s,is1,ipmP->bigrhs,sis,&ipmP->rhs3);CHKERRQ(ierr);
-    ierr = ISDestroy(&sis);CHKERRQ(ierr);
-    ierr = ISDestroy(&is1);CHKERRQ(ierr);
-  }
-
-  if (ipmP->me > 0) {
-    ierr = VecGetOwnershipRange(tao->constraints_equality,&ucestart,&uceend);CHKERRQ(ierr);
-    for (i=ucestart;i<uceend;i++) {
-      stepind[i-ucestart] = i + ipmP->n+ipmP->nb;
-      uceind[i-ucestart] = i;
-    }
-
-    ierr = ISCreateGeneral(comm,uceend-ucestart,stepind,PETSC_COPY_VALUES,&sis);CHKERRQ(ierr);
-    ierr = ISCreateGeneral(comm,uceend-ucestart,uceind,PETSC_COPY_VALUES,&is1);CHKERRQ(ierr);
-    ierr = VecScatterCreate(ipmP->bigstep,sis,tao->constraints_equality,is1,&ipmP->step3);CHKERRQ(ierr);
-    ierr = ISDestroy(&sis);CHKERRQ(ierr);
-
-    for (i=ucestart;i<uceend;i++) {
-      stepind[i-ucestart] = i + ipmP->n;
-    }
-
-    ierr = ISCreateGeneral(comm,uceend-ucestart,stepind,PETSC_COPY_VALUES,&sis);CHKERRQ(ierr);
-    ierr = VecScatterCreate(tao->constraints_equality,is1,ipmP->bigrhs,sis,&ipmP->rhs2);CHKERRQ(ierr);
-    ierr = ISDestroy(&sis);CHKERRQ(ierr);
-    ierr = ISDestroy(&is1);CHKERRQ(ierr);
-  }
-
-  if (ipmP->nb > 0) {
-    for (i=sstart;i<send;i++) {
-      stepind[i-sstart] = i + ipmP->n + ipmP->nb + ipmP->me;
-      cind[i-sstart] = i;
-    }
-    ierr = ISCreateGeneral(comm,send-sstart,cind,PETSC_COPY_VALUES,&is1);CHKERRQ(ierr);
-    ierr = ISCreateGeneral(comm,send-sstart,stepind,PETSC_COPY_VALUES,&sis);CHKERRQ(ierr);
-    ierr = VecScatterCreate(ipmP->bigstep,sis,ipmP->s,is1,&ipmP->step4);CHKERRQ(ierr);
-    ierr = VecScatterCreate(ipmP->s,is1,ipmP->bigrhs,sis,&ipmP->rhs4);CHKERRQ(ierr);
-    ierr = ISDestroy(&sis);CHKERRQ(ierr);
-    ierr = ISDestroy(&is1);CHKERRQ(ierr);
+  /* the ownership ranges of the two fields number the columns of the blocks of K */
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscFree2(ipmP->xranges,ipmP->dranges);CHKERRQ(ierr);
+  ierr = PetscMalloc2(size+1,&ipmP->xranges,size+1,&ipmP->dranges);CHKERRQ(ierr);
+  ipmP->xranges[0] = ipmP->dranges[0] = 0;
+  ierr = MPI_Allgather(&nloc,1,MPIU_INT,ipmP->xranges+1,1,MPIU_INT,comm);CHKERRQ(ierr);
+  ierr = MPI_Allgather(&dloc,1,MPIU_INT,ipmP->dranges+1,1,MPIU_INT,comm);CHKERRQ(ierr);
+  for (i=0; i<size; i++) {
+    ipmP->xranges[i+1] += ipmP->xranges[i];
+    ipmP->dranges[i+1] += ipmP->dranges[i];
   }
-
-  ierr = PetscFree(stepind);CHKERRQ(ierr);
-  ierr = PetscFree(cind);CHKERRQ(ierr);
-  ierr = PetscFree(ucind);CHKERRQ(ierr);
-  ierr = PetscFree(uceind);CHKERRQ(ierr);
-  ierr = PetscFree(xind);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -489,20 +355,6 @@ static PetscErrorCode TaoDestroy_IPM(Tao tao)
   ierr = VecDestroy(&ipmP->save_lamdai);CHKERRQ(ierr);
   ierr = VecDestroy(&ipmP->save_s);CHKERRQ(ierr);
 
-  ierr = VecScatterDestroy(&ipmP->step1);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->step2);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->step3);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->step4);CHKERRQ(ierr);
-
-  ierr = VecScatterDestroy(&ipmP->rhs1);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->rhs2);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->rhs3);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->rhs4);CHKERRQ(ierr);
-
-  ierr = VecScatterDestroy(&ipmP->ci_scat);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->xl_scat);CHKERRQ(ierr);
-  ierr = VecScatterDestroy(&ipmP->xu_scat);CHKERRQ(ierr);
-
   ierr = VecDestroy(&ipmP->dlamdai);CHKERRQ(ierr);
   ierr = VecDestroy(&ipmP->dlamdae);CHKERRQ(ierr);
   ierr = VecDestroy(&ipmP->Zero_nb);CHKERRQ(ierr);
@@ -513,7 +365,8 @@ static PetscErrorCode TaoDestroy_IPM(Tao tao)
   ierr = VecDestroy(&ipmP->bigrhs);CHKERRQ(ierr);
   ierr = VecDestroy(&ipmP->bigstep);CHKERRQ(ierr);
   ierr = MatDestroy(&ipmP->Ai);CHKERRQ(ierr);
-  ierr = MatDestroy(&ipmP->K);CHKERRQ(ierr);
+  ierr = IPMDestroyK(tao);CHKERRQ(ierr);
+  ierr = PetscFree2(ipmP->xranges,ipmP->dranges);CHKERRQ(ierr);
   ierr = ISDestroy(&ipmP->isxu);CHKERRQ(ierr);
   ierr = ISDestroy(&ipmP->isxl);CHKERRQ(ierr);
   ierr = PetscFree(tao->data);CHKERRQ(ierr);
@@ -530,6 +383,7 @@ static PetscErrorCode TaoSetFromOptions_IPM(PetscOptionItems *PetscOptionsObject
   ierr = PetscOptionsBool("-tao_ipm_monitorkkt","monitor kkt status",NULL,ipmP->monitorkkt,&ipmP->monitorkkt,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsReal("-tao_ipm_pushs","parameter to push initial slack variables away from bounds",NULL,ipmP->pushs,&ipmP->pushs,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsReal("-tao_ipm_pushnu","parameter to push initial (inequality) dual variables away from bounds",NULL,ipmP->pushnu,&ipmP->pushnu,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-tao_ipm_kkt_nest","use the MATNEST of the blocks of the KKT matrix instead of an AIJ matrix",NULL,ipmP->kkt_nest,&ipmP->kkt_nest,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   ierr = KSPSetFromOptions(tao->ksp);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -690,306 +544,357 @@ PetscErrorCode IPMUpdateAi(Tao tao)
 
   TAO_IPM           *ipmP = (TAO_IPM *)tao->data;
   MPI_Comm          comm;
-  PetscInt          i;
-  PetscScalar       newval;
+  PetscInt          i,j,k,nloc,sloc,miloc = 0,nbnd;
+  PetscScalar       newval,*ci;
   PetscInt          newrow,newcol,ncols;
-  const PetscScalar *vals;
-  const PetscInt    *cols;
-  PetscInt          astart,aend,jstart,jend;
-  PetscInt          *nonzeros;
-  PetscInt          r2,r3,r4;
-  PetscMPIInt       size;
+  const PetscScalar *vals,*c,*x,*b;
+  const PetscInt    *cols,*bnd;
+  PetscInt          astart,xstart,xend,jstart = 0,jend = 0;
+  PetscInt          *d_nnz,*o_nnz;
+  PetscObjectState  state;
   PetscErrorCode    ierr;
 
   PetscFunctionBegin;
-  r2 = ipmP->mi;
-  r3 = r2 + ipmP->nxlb;
-  r4 = r3 + ipmP->nxub;
-
   if (!ipmP->nb) PetscFunctionReturn(0);
 
-  /* Create Ai matrix if it doesn't exist yet */
+  comm = ((PetscObject)(tao->solution))->comm;
+  ierr = VecGetOwnershipRange(tao->solution,&xstart,&xend);CHKERRQ(ierr);
+  if (ipmP->mi) {
+    ierr = VecGetLocalSize(tao->constraints_inequality,&miloc);CHKERRQ(ierr);
+    ierr = MatGetOwnershipRange(tao->jacobian_inequality,&jstart,&jend);CHKERRQ(ierr);
+    if (jend-jstart != miloc) SETERRQ2(comm,PETSC_ERR_ARG_SIZ,"Inequality Jacobian has %D local rows but there are %D local inequality constraints",jend-jstart,miloc);
+    /* a new nonzero pattern of the user Jacobian needs a new Ai, and thus a new K */
+    ierr = MatGetNonzeroState(tao->jacobian_inequality,&state);CHKERRQ(ierr);
+    if (ipmP->Ai && state != ipmP->jistate) {
+      ierr = MatDestroy(&ipmP->Ai);CHKERRQ(ierr);
+      ierr = IPMDestroyK(tao);CHKERRQ(ierr);
+    }
+    ipmP->jistate = state;
+  }
+
+  /* Create Ai matrix if it doesn't exist yet, with the rows of the bounds on the process of their variable */
   if (!ipmP->Ai) {
-    comm = ((PetscObject)(tao->solution))->comm;
-    ierr = PetscMalloc1(ipmP->nb,&nonzeros);CHKERRQ(ierr);
-    ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
-    if (size == 1) {
-      for (i=0;i<ipmP->mi;i++) {
-        ierr = MatGetRow(tao->jacobian_inequality,i,&ncols,NULL,NULL);CHKERRQ(ierr);
-        nonzeros[i] = ncols;
-        ierr = MatRestoreRow(tao->jacobian_inequality,i,&ncols,NULL,NULL);CHKERRQ(ierr);
-      }
-      for (i=r2;i<r4;i++) {
-        nonzeros[i] = 1;
+    ierr = VecGetLocalSize(ipmP->s,&sloc);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(tao->solution,&nloc);CHKERRQ(ierr);
+    ierr = PetscMalloc2(sloc,&d_nnz,sloc,&o_nnz);CHKERRQ(ierr);
+    for (i=0;i<sloc;i++) {
+      d_nnz[i] = 1;
+      o_nnz[i] = 0;
+    }
+    for (i=jstart;i<jend;i++) {
+      ierr = MatGetRow(tao->jacobian_inequality,i,&ncols,&cols,NULL);CHKERRQ(ierr);
+      d_nnz[i-jstart] = 0;
+      for (j=0;j<ncols;j++) {
+        if (cols[j] >= xstart && cols[j] < xend) d_nnz[i-jstart]++;
+        else o_nnz[i-jstart]++;
       }
+      ierr = MatRestoreRow(tao->jacobian_inequality,i,&ncols,&cols,NULL);CHKERRQ(ierr);
     }
     ierr = MatCreate(comm,&ipmP->Ai);CHKERRQ(ierr);
     ierr = MatSetType(ipmP->Ai,MATAIJ);CHKERRQ(ierr);
-    ierr = MatSetSizes(ipmP->Ai,PETSC_DECIDE,PETSC_DECIDE,ipmP->nb,ipmP->n);CHKERRQ(ierr);
+    ierr = MatSetSizes(ipmP->Ai,sloc,nloc,ipmP->nb,ipmP->n);CHKERRQ(ierr);
     ierr = MatSetFromOptions(ipmP->Ai);CHKERRQ(ierr);
-    ierr = MatMPIAIJSetPreallocation(ipmP->Ai,ipmP->nb,NULL,ipmP->nb,NULL);CHKERRQ(ierr);
-    ierr = MatSeqAIJSetPreallocation(ipmP->Ai,PETSC_DEFAULT,nonzeros);CHKERRQ(ierr);
-    if (size ==1) {
-      ierr = PetscFree(nonzeros);CHKERRQ(ierr);
-    }
+    ierr = MatMPIAIJSetPreallocation(ipmP->Ai,0,d_nnz,0,o_nnz);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(ipmP->Ai,0,d_nnz);CHKERRQ(ierr);
+    ierr = PetscFree2(d_nnz,o_nnz);CHKERRQ(ierr);
   }
 
-  /* Copy values from user jacobian to Ai */
-  ierr = MatGetOwnershipRange(ipmP->Ai,&astart,&aend);CHKERRQ(ierr);
+  /* Copy values from user jacobian to Ai, the pattern does not change so every entry is overwritten */
+  ierr = MatGetOwnershipRange(ipmP->Ai,&astart,NULL);CHKERRQ(ierr);
 
   /* Ai w/lb */
-  if (ipmP->mi) {
-    ierr = MatZeroEntries(ipmP->Ai);CHKERRQ(ierr);
-    ierr = MatGetOwnershipRange(tao->jacobian_inequality,&jstart,&jend);CHKERRQ(ierr);
-    for (i=jstart;i<jend;i++) {
-      ierr = MatGetRow(tao->jacobian_inequality,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-      newrow = i;
-      ierr = MatSetValues(ipmP->Ai,1,&newrow,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
-      ierr = MatRestoreRow(tao->jacobian_inequality,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-    }
+  for (i=jstart;i<jend;i++) {
+    ierr = MatGetRow(tao->jacobian_inequality,i,&ncols,&cols,&vals);CHKERRQ(ierr);
+    newrow = astart+i-jstart;
+    ierr = MatSetValues(ipmP->Ai,1,&newrow,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = MatRestoreRow(tao->jacobian_inequality,i,&ncols,&cols,&vals);CHKERRQ(ierr);
   }
 
+  /* ci = [user ci; x - xl; xu - x] on the entries of this process */
+  ierr = VecGetArray(ipmP->ci,&ci);CHKERRQ(ierr);
+  if (ipmP->mi > 0) {
+    ierr = VecGetArrayRead(tao->constraints_inequality,&c);CHKERRQ(ierr);
+    ierr = PetscMemcpy(ci,c,miloc*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(tao->constraints_inequality,&c);CHKERRQ(ierr);
+  }
+  k = miloc;
+  ierr = VecGetArrayRead(tao->solution,&x);CHKERRQ(ierr);
   /* I w/ xlb */
   if (ipmP->nxlb) {
-    for (i=0;i<ipmP->nxlb;i++) {
-      if (i>=astart && i<aend) {
-        newrow = i+r2;
-        newcol = i;
-        newval = 1.0;
-        ierr = MatSetValues(ipmP->Ai,1,&newrow,1,&newcol,&newval,INSERT_VALUES);CHKERRQ(ierr);
-      }
+    ierr = ISGetLocalSize(ipmP->isxl,&nbnd);CHKERRQ(ierr);
+    ierr = ISGetIndices(ipmP->isxl,&bnd);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(tao->XL,&b);CHKERRQ(ierr);
+    newval = 1.0;
+    for (i=0;i<nbnd;i++,k++) {
+      newrow = astart+k;
+      newcol = bnd[i];
+      ierr = MatSetValues(ipmP->Ai,1,&newrow,1,&newcol,&newval,INSERT_VALUES);CHKERRQ(ierr);
+      ci[k] = x[bnd[i]-xstart] - b[bnd[i]-xstart];
     }
+    ierr = VecRestoreArrayRead(tao->XL,&b);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(ipmP->isxl,&bnd);CHKERRQ(ierr);
   }
+  /* -I w/ xub */
   if (ipmP->nxub) {
-    /* I w/ xub */
-    for (i=0;i<ipmP->nxub;i++) {
-      if (i>=astart && i<aend) {
-      newrow = i+r3;
-      newcol = i;
-      newval = -1.0;
+    ierr = ISGetLocalSize(ipmP->isxu,&nbnd);CHKERRQ(ierr);
+    ierr = ISGetIndices(ipmP->isxu,&bnd);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(tao->XU,&b);CHKERRQ(ierr);
+    newval = -1.0;
+    for (i=0;i<nbnd;i++,k++) {
+      newrow = astart+k;
+      newcol = bnd[i];
       ierr = MatSetValues(ipmP->Ai,1,&newrow,1,&newcol,&newval,INSERT_VALUES);CHKERRQ(ierr);
-      }
+      ci[k] = b[bnd[i]-xstart] - x[bnd[i]-xstart];
     }
+    ierr = VecRestoreArrayRead(tao->XU,&b);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(ipmP->isxu,&bnd);CHKERRQ(ierr);
   }
+  ierr = VecRestoreArrayRead(tao->solution,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(ipmP->ci,&ci);CHKERRQ(ierr);
 
   ierr = MatAssemblyBegin(ipmP->Ai,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(ipmP->Ai,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
-  CHKMEMQ;
+  PetscFunctionReturn(0);
+}
 
-  ierr = VecSet(ipmP->ci,0.0);CHKERRQ(ierr);
+static PetscErrorCode IPMDestroyK(Tao tao)
+{
+  TAO_IPM        *ipmP = (TAO_IPM *)tao->data;
+  PetscErrorCode ierr;
 
-  /* user ci */
-  if (ipmP->mi > 0) {
-    ierr = VecScatterBegin(ipmP->ci_scat,tao->constraints_inequality,ipmP->ci,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->ci_scat,tao->constraints_inequality,ipmP->ci,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  if (!ipmP->work){
-    VecDuplicate(tao->solution,&ipmP->work);
-  }
-  ierr = VecCopy(tao->solution,ipmP->work);CHKERRQ(ierr);
-  if (tao->XL) {
-    ierr = VecAXPY(ipmP->work,-1.0,tao->XL);CHKERRQ(ierr);
+  PetscFunctionBegin;
+  ierr = MatDestroy(&ipmP->K);CHKERRQ(ierr);
+  ierr = MatDestroy(&ipmP->B);CHKERRQ(ierr);
+  ierr = MatDestroy(&ipmP->Bt);CHKERRQ(ierr);
+  ierr = MatDestroy(&ipmP->C);CHKERRQ(ierr);
+  ierr = VecDestroy(&ipmP->bsign);CHKERRQ(ierr);
+  ierr = ISDestroy(&ipmP->kkt_is[0]);CHKERRQ(ierr);
+  ierr = ISDestroy(&ipmP->kkt_is[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
-    /* lower bounds on variables */
-    if (ipmP->nxlb > 0) {
-      ierr = VecScatterBegin(ipmP->xl_scat,ipmP->work,ipmP->ci,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecScatterEnd(ipmP->xl_scat,ipmP->work,ipmP->ci,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    }
-  }
-  if (tao->XU) {
-    /* upper bounds on variables */
-    ierr = VecCopy(tao->solution,ipmP->work);CHKERRQ(ierr);
-    ierr = VecScale(ipmP->work,-1.0);CHKERRQ(ierr);
-    ierr = VecAXPY(ipmP->work,1.0,tao->XU);CHKERRQ(ierr);
-    if (ipmP->nxub > 0) {
-      ierr = VecScatterBegin(ipmP->xu_scat,ipmP->work,ipmP->ci,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecScatterEnd(ipmP->xu_scat,ipmP->work,ipmP->ci,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    }
+/* global number in K of the column col of the primal (field 0) or dual (field 1) field */
+PETSC_STATIC_INLINE PetscInt IPMKColumn(TAO_IPM *ipmP,PetscMPIInt size,PetscInt field,PetscInt col)
+{
+  const PetscInt *ranges = field ? ipmP->dranges : ipmP->xranges;
+  PetscInt       lo = 0,hi = size,p;
+
+  while (hi - lo > 1) {
+    p = (lo + hi)/2;
+    if (col < ranges[p]) hi = p;
+    else lo = p;
   }
-  PetscFunctionReturn(0);
+  return ipmP->xranges[lo] + ipmP->dranges[lo] + (field ? ipmP->xranges[lo+1] - ipmP->xranges[lo] : 0) + col - ranges[lo];
 }
 
-/* create K = [ Hlag , 0 , Ae', -Ai'];
-              [Ae , 0,   0  , 0];
-              [Ai ,-I,   0 ,  0];
-              [ 0 , S ,  0,   Y ];  */
-PetscErrorCode IPMUpdateK(Tao tao)
+/* copies the blocks into the rows of the AIJ matrix K, or only counts the entries of its rows when K is not created yet */
+static PetscErrorCode IPMAssembleK(Tao tao,Mat blocks[],PetscInt *d_nnz,PetscInt *o_nnz)
 {
-  TAO_IPM         *ipmP = (TAO_IPM *)tao->data;
-  MPI_Comm        comm;
-  PetscMPIInt     size;
-  PetscErrorCode  ierr;
-  PetscInt        i,j,row;
-  PetscInt        ncols,newcol,newcols[2],newrow;
-  const PetscInt  *cols;
-  const PetscReal *vals;
-  const PetscReal *l,*y;
-  PetscReal       *newvals;
-  PetscReal       newval;
-  PetscInt        subsize;
-  const PetscInt  *indices;
-  PetscInt        *nonzeros,*d_nonzeros,*o_nonzeros;
-  PetscInt        bigsize;
-  PetscInt        r1,r2,r3;
-  PetscInt        c1,c2,c3;
-  PetscInt        klocalsize;
-  PetscInt        hstart,hend,kstart,kend;
-  PetscInt        aistart,aiend,aestart,aeend;
-  PetscInt        sstart,send;
+  TAO_IPM           *ipmP = (TAO_IPM *)tao->data;
+  PetscMPIInt       size,rank;
+  PetscInt          f,g,i,j,row,bstart,bend,ncols,maxcols = 0,*kcols = NULL;
+  PetscInt          kstart,kend,nloc;
+  const PetscInt    *cols;
+  const PetscScalar *vals;
+  PetscErrorCode    ierr;
 
   PetscFunctionBegin;
-  comm = ((PetscObject)(tao->solution))->comm;
-  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
-  ierr = IPMUpdateAi(tao);CHKERRQ(ierr);
-
-  /* allocate workspace */
-  subsize = PetscMax(ipmP->n,ipmP->nb);
-  subsize = PetscMax(ipmP->me,subsize);
-  subsize = PetscMax(2,subsize);
-  ierr = PetscMalloc1(subsize,&indices);CHKERRQ(ierr);
-  ierr = PetscMalloc1(subsize,&newvals);CHKERRQ(ierr);
-
-  r1 = c1 = ipmP->n;
-  r2 = r1 + ipmP->me;  c2 = c1 + ipmP->nb;
-  r3 = c3 = r2 + ipmP->nb;
-
-  bigsize = ipmP->n+2*ipmP->nb+ipmP->me;
-  ierr = VecGetOwnershipRange(ipmP->bigrhs,&kstart,&kend);CHKERRQ(ierr);
-  ierr = MatGetOwnershipRange(tao->hessian,&hstart,&hend);CHKERRQ(ierr);
-  klocalsize = kend-kstart;
-  if (!ipmP->K) {
-    if (size == 1) {
-      ierr = PetscMalloc1(kend-kstart,&nonzeros);CHKERRQ(ierr);
-      for (i=0;i<bigsize;i++) {
-        if (i<r1) {
-          ierr = MatGetRow(tao->hessian,i,&ncols,NULL,NULL);CHKERRQ(ierr);
-          nonzeros[i] = ncols;
-          ierr = MatRestoreRow(tao->hessian,i,&ncols,NULL,NULL);CHKERRQ(ierr);
-          nonzeros[i] += ipmP->me+ipmP->nb;
-        } else if (i<r2) {
-          nonzeros[i-kstart] = ipmP->n;
-        } else if (i<r3) {
-          nonzeros[i-kstart] = ipmP->n+1;
-        } else if (i<bigsize) {
-          nonzeros[i-kstart] = 2;
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)tao),&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)tao),&rank);CHKERRQ(ierr);
+  nloc   = ipmP->xranges[rank+1] - ipmP->xranges[rank];
+  kstart = ipmP->xranges[rank] + ipmP->dranges[rank];
+  kend   = ipmP->xranges[rank+1] + ipmP->dranges[rank+1];
+  for (f=0; f<2; f++) {
+    for (g=0; g<2; g++) {
+      if (!blocks[2*f+g]) continue;
+      ierr = MatGetOwnershipRange(blocks[2*f+g],&bstart,&bend);CHKERRQ(ierr);
+      for (i=bstart; i<bend; i++) {
+        row  = (f ? nloc : 0) + i - bstart;
+        ierr = MatGetRow(blocks[2*f+g],i,&ncols,&cols,&vals);CHKERRQ(ierr);
+        if (ncols > maxcols) {
+          maxcols = ncols;
+          ierr = PetscFree(kcols);CHKERRQ(ierr);
+          ierr = PetscMalloc1(maxcols,&kcols);CHKERRQ(ierr);
         }
-      }
-      ierr = MatCreate(comm,&ipmP->K);CHKERRQ(ierr);
-      ierr = MatSetType(ipmP->K,MATSEQAIJ);CHKERRQ(ierr);
-      ierr = MatSetSizes(ipmP->K,klocalsize,klocalsize,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
-      ierr = MatSeqAIJSetPreallocation(ipmP->K,0,nonzeros);CHKERRQ(ierr);
-      ierr = MatSetFromOptions(ipmP->K);CHKERRQ(ierr);
-      ierr = PetscFree(nonzeros);CHKERRQ(ierr);
-    } else {
-      ierr = PetscMalloc1(kend-kstart,&d_nonzeros);CHKERRQ(ierr);
-      ierr = PetscMalloc1(kend-kstart,&o_nonzeros);CHKERRQ(ierr);
-      for (i=kstart;i<kend;i++) {
-        if (i<r1) {
-          /* TODO fix preallocation for mpi mats */
-          d_nonzeros[i-kstart] = PetscMin(ipmP->n+ipmP->me+ipmP->nb,kend-kstart);
-          o_nonzeros[i-kstart] = PetscMin(ipmP->n+ipmP->me+ipmP->nb,bigsize-(kend-kstart));
-        } else if (i<r2) {
-          d_nonzeros[i-kstart] = PetscMin(ipmP->n,kend-kstart);
-          o_nonzeros[i-kstart] = PetscMin(ipmP->n,bigsize-(kend-kstart));
-        } else if (i<r3) {
-          d_nonzeros[i-kstart] = PetscMin(ipmP->n+2,kend-kstart);
-          o_nonzeros[i-kstart] = PetscMin(ipmP->n+2,bigsize-(kend-kstart));
+        for (j=0; j<ncols; j++) kcols[j] = IPMKColumn(ipmP,size,g,cols[j]);
+        if (d_nnz) {
+          for (j=0; j<ncols; j++) {
+            if (kcols[j] >= kstart && kcols[j] < kend) d_nnz[row]++;
+            else o_nnz[row]++;
+          }
         } else {
-          d_nonzeros[i-kstart] = PetscMin(2,kend-kstart);
-          o_nonzeros[i-kstart] = PetscMin(2,bigsize-(kend-kstart));
+          row += kstart;
+          ierr = MatSetValues(ipmP->K,1,&row,ncols,kcols,vals,INSERT_VALUES);CHKERRQ(ierr);
         }
+        ierr = MatRestoreRow(blocks[2*f+g],i,&ncols,&cols,&vals);CHKERRQ(ierr);
       }
-      ierr = MatCreate(comm,&ipmP->K);CHKERRQ(ierr);
-      ierr = MatSetType(ipmP->K,MATMPIAIJ);CHKERRQ(ierr);
-      ierr = MatSetSizes(ipmP->K,klocalsize,klocalsize,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
-      ierr = MatMPIAIJSetPreallocation(ipmP->K,0,d_nonzeros,0,o_nonzeros);CHKERRQ(ierr);
-      ierr = PetscFree(d_nonzeros);CHKERRQ(ierr);
-      ierr = PetscFree(o_nonzeros);CHKERRQ(ierr);
-      ierr = MatSetFromOptions(ipmP->K);CHKERRQ(ierr);
     }
   }
+  ierr = PetscFree(kcols);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
-  ierr = MatZeroEntries(ipmP->K);CHKERRQ(ierr);
-  /* Copy H */
-  for (i=hstart;i<hend;i++) {
-    ierr = MatGetRow(tao->hessian,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-    if (ncols > 0) {
-      ierr = MatSetValues(ipmP->K,1,&i,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
-    }
-    ierr = MatRestoreRow(tao->hessian,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-  }
+/* create K = [ H  Bt ]   for the primal field x and the dual field [lamdae; lamdai; s]
+              [ B  C  ]
 
-  /* Copy Ae and Ae' */
+   B = [ Ae ]   Bt = [ Ae' -Ai' 0 ]   C = [ 0  0  0 ]
+       [ Ai ]                             [ 0  0 -I ]
+       [ 0  ]                             [ 0  S  L ]
+
+   with S = diag(s) and L = diag(lamdai). Each process owns its rows of x, followed by its rows of lamdae, lamdai and s,
+   so the blocks are assembled from local rows only. K is the MATNEST of the blocks with -tao_ipm_kkt_nest, and otherwise
+   an AIJ matrix copied from them. The nonzero patterns are kept while the ones of H, Ae and Ai do not change */
+PetscErrorCode IPMUpdateK(Tao tao)
+{
+  TAO_IPM           *ipmP = (TAO_IPM *)tao->data;
+  MPI_Comm          comm;
+  PetscMPIInt       size,rank;
+  PetscErrorCode    ierr;
+  PetscInt          i,j,k,row,cols[2];
+  PetscInt          ncols,nloc,meloc = 0,sloc = 0,dloc,dstart;
+  PetscInt          aestart,aeend,aistart,aiend;
+  const PetscInt    *jcols;
+  const PetscScalar *jvals,*l,*y;
+  PetscScalar       vals[2],*sgn;
+  PetscInt          *d_nnz,*o_nnz;
+  PetscObjectState  hstate,aestate = 0;
+  Mat               blocks[4];
+  PC                pc;
+  PetscBool         isfs;
+
+  PetscFunctionBegin;
+  comm = ((PetscObject)(tao->solution))->comm;
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+
+  nloc   = ipmP->xranges[rank+1] - ipmP->xranges[rank];
+  dloc   = ipmP->dranges[rank+1] - ipmP->dranges[rank];
+  dstart = ipmP->dranges[rank];
   if (ipmP->me > 0) {
+    ierr = VecGetLocalSize(ipmP->lamdae,&meloc);CHKERRQ(ierr);
     ierr = MatGetOwnershipRange(tao->jacobian_equality,&aestart,&aeend);CHKERRQ(ierr);
-    for (i=aestart;i<aeend;i++) {
-      ierr = MatGetRow(tao->jacobian_equality,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-      if (ncols > 0) {
-        /*Ae*/
-        row = i+r1;
-        ierr = MatSetValues(ipmP->K,1,&row,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
-        /*Ae'*/
-        for (j=0;j<ncols;j++) {
-          newcol = i + c2;
-          newrow = cols[j];
-          newval = vals[j];
-          ierr = MatSetValues(ipmP->K,1,&newrow,1,&newcol,&newval,INSERT_VALUES);CHKERRQ(ierr);
-        }
-      }
-      ierr = MatRestoreRow(tao->jacobian_equality,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-    }
+    if (aeend-aestart != meloc) SETERRQ2(comm,PETSC_ERR_ARG_SIZ,"Equality Jacobian has %D local rows but there are %D local equality constraints",aeend-aestart,meloc);
+    ierr = MatGetNonzeroState(tao->jacobian_equality,&aestate);CHKERRQ(ierr);
   }
-
   if (ipmP->nb > 0) {
+    ierr = VecGetLocalSize(ipmP->s,&sloc);CHKERRQ(ierr);
     ierr = MatGetOwnershipRange(ipmP->Ai,&aistart,&aiend);CHKERRQ(ierr);
-    /* Copy Ai,and Ai' */
-    for (i=aistart;i<aiend;i++) {
-      row = i+r2;
-      ierr = MatGetRow(ipmP->Ai,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-      if (ncols > 0) {
-        /*Ai*/
-        ierr = MatSetValues(ipmP->K,1,&row,ncols,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
-        /*-Ai'*/
-        for (j=0;j<ncols;j++) {
-          newcol = i + c3;
-          newrow = cols[j];
-          newval = -vals[j];
-          ierr = MatSetValues(ipmP->K,1,&newrow,1,&newcol,&newval,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatGetLocalSize(tao->hessian,&i,NULL);CHKERRQ(ierr);
+  if (i != nloc) SETERRQ2(comm,PETSC_ERR_ARG_SIZ,"Hessian has %D local rows but there are %D local variables",i,nloc);
+  ierr = MatGetNonzeroState(tao->hessian,&hstate);CHKERRQ(ierr);
+  if (ipmP->K && (hstate != ipmP->hstate || aestate != ipmP->aestate)) {
+    ierr = IPMDestroyK(tao);CHKERRQ(ierr);
+  }
+  ipmP->hstate  = hstate;
+  ipmP->aestate = aestate;
+
+  if (ipmP->me + ipmP->nb > 0) {
+    if (!ipmP->K) {
+      /* B, with exact preallocation */
+      ierr = PetscCalloc2(dloc,&d_nnz,dloc,&o_nnz);CHKERRQ(ierr);
+      for (i=0; i<meloc; i++) {
+        ierr = MatGetRow(tao->jacobian_equality,aestart+i,&ncols,&jcols,NULL);CHKERRQ(ierr);
+        for (j=0; j<ncols; j++) {
+          if (jcols[j] >= ipmP->xranges[rank] && jcols[j] < ipmP->xranges[rank+1]) d_nnz[i]++;
+          else o_nnz[i]++;
         }
+        ierr = MatRestoreRow(tao->jacobian_equality,aestart+i,&ncols,&jcols,NULL);CHKERRQ(ierr);
       }
-      ierr = MatRestoreRow(ipmP->Ai,i,&ncols,&cols,&vals);CHKERRQ(ierr);
-    }
+      for (i=0; i<sloc; i++) {
+        ierr = MatGetRow(ipmP->Ai,aistart+i,&ncols,&jcols,NULL);CHKERRQ(ierr);
+        for (j=0; j<ncols; j++) {
+          if (jcols[j] >= ipmP->xranges[rank] && jcols[j] < ipmP->xranges[rank+1]) d_nnz[meloc+i]++;
+          else o_nnz[meloc+i]++;
+        }
+        ierr = MatRestoreRow(ipmP->Ai,aistart+i,&ncols,&jcols,NULL);CHKERRQ(ierr);
+      }
+      ierr = MatCreateAIJ(comm,dloc,nloc,PETSC_DETERMINE,ipmP->n,0,d_nnz,0,o_nnz,&ipmP->B);CHKERRQ(ierr);
 
-    /* -I */
-    for (i=kstart;i<kend;i++) {
-      if (i>=r2 && i<r3) {
-        newrow = i;
-        newcol = i-r2+c1;
-        newval = -1.0;
-        MatSetValues(ipmP->K,1,&newrow,1,&newcol,&newval,INSERT_VALUES);CHKERRQ(ierr);
+      /* C */
+      for (i=0; i<dloc; i++) {
+        d_nnz[i] = i < meloc ? 0 : (i < meloc+sloc ? 1 : 2);
+        o_nnz[i] = 0;
+      }
+      ierr = MatCreateAIJ(comm,dloc,dloc,PETSC_DETERMINE,PETSC_DETERMINE,0,d_nnz,0,o_nnz,&ipmP->C);CHKERRQ(ierr);
+      ierr = PetscFree2(d_nnz,o_nnz);CHKERRQ(ierr);
+
+      /* Bt is the transpose of B with its lamdai columns negated */
+      ierr = MatCreateVecs(ipmP->B,NULL,&ipmP->bsign);CHKERRQ(ierr);
+      ierr = VecGetArray(ipmP->bsign,&sgn);CHKERRQ(ierr);
+      for (i=0; i<dloc; i++) sgn[i] = (i >= meloc && i < meloc+sloc) ? -1.0 : 1.0;
+      ierr = VecRestoreArray(ipmP->bsign,&sgn);CHKERRQ(ierr);
+    }
+
+    /* Copy Ae and Ai */
+    for (i=0; i<meloc; i++) {
+      row  = dstart+i;
+      ierr = MatGetRow(tao->jacobian_equality,aestart+i,&ncols,&jcols,&jvals);CHKERRQ(ierr);
+      ierr = MatSetValues(ipmP->B,1,&row,ncols,jcols,jvals,INSERT_VALUES);CHKERRQ(ierr);
+      ierr = MatRestoreRow(tao->jacobian_equality,aestart+i,&ncols,&jcols,&jvals);CHKERRQ(ierr);
+    }
+    for (i=0; i<sloc; i++) {
+      row  = dstart+meloc+i;
+      ierr = MatGetRow(ipmP->Ai,aistart+i,&ncols,&jcols,&jvals);CHKERRQ(ierr);
+      ierr = MatSetValues(ipmP->B,1,&row,ncols,jcols,jvals,INSERT_VALUES);CHKERRQ(ierr);
+      ierr = MatRestoreRow(ipmP->Ai,aistart+i,&ncols,&jcols,&jvals);CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(ipmP->B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(ipmP->B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatTranspose(ipmP->B,ipmP->Bt ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,&ipmP->Bt);CHKERRQ(ierr);
+    ierr = MatDiagonalScale(ipmP->Bt,NULL,ipmP->bsign);CHKERRQ(ierr);
+
+    /* -I, S and L */
+    if (ipmP->nb > 0) {
+      ierr = VecGetArrayRead(ipmP->lamdai,&l);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(ipmP->s,&y);CHKERRQ(ierr);
+      for (i=0; i<sloc; i++) {
+        k       = dstart+meloc+i;
+        row     = k;
+        cols[0] = k+sloc;
+        vals[0] = -1.0;
+        ierr    = MatSetValues(ipmP->C,1,&row,1,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+        row     = k+sloc;
+        cols[0] = k;
+        cols[1] = k+sloc;
+        vals[0] = y[i];
+        vals[1] = l[i];
+        ierr    = MatSetValues(ipmP->C,1,&row,2,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
       }
+      ierr = VecRestoreArrayRead(ipmP->lamdai,&l);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(ipmP->s,&y);CHKERRQ(ierr);
     }
+    ierr = MatAssemblyBegin(ipmP->C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(ipmP->C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
 
-    /* Copy L,Y */
-    ierr = VecGetOwnershipRange(ipmP->s,&sstart,&send);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(ipmP->lamdai,&l);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(ipmP->s,&y);CHKERRQ(ierr);
-
-    for (i=sstart;i<send;i++) {
-      newcols[0] = c1+i;
-      newcols[1] = c3+i;
-      newvals[0] = l[i-sstart];
-      newvals[1] = y[i-sstart];
-      newrow = r3+i;
-      ierr = MatSetValues(ipmP->K,1,&newrow,2,newcols,newvals,INSERT_VALUES);CHKERRQ(ierr);
+  blocks[0] = tao->hessian; blocks[1] = ipmP->Bt;
+  blocks[2] = ipmP->B;      blocks[3] = ipmP->C;
+  if (!ipmP->K) {
+    i    = ipmP->xranges[rank] + ipmP->dranges[rank];
+    ierr = ISCreateStride(comm,nloc,i,1,&ipmP->kkt_is[0]);CHKERRQ(ierr);
+    ierr = ISCreateStride(comm,dloc,i+nloc,1,&ipmP->kkt_is[1]);CHKERRQ(ierr);
+    if (ipmP->kkt_nest) {
+      ierr = MatCreateNest(comm,ipmP->B ? 2 : 1,ipmP->kkt_is,ipmP->B ? 2 : 1,ipmP->kkt_is,blocks,&ipmP->K);CHKERRQ(ierr);
+    } else {
+      ierr = PetscCalloc2(nloc+dloc,&d_nnz,nloc+dloc,&o_nnz);CHKERRQ(ierr);
+      ierr = IPMAssembleK(tao,blocks,d_nnz,o_nnz);CHKERRQ(ierr);
+      ierr = MatCreateAIJ(comm,nloc+dloc,nloc+dloc,PETSC_DETERMINE,PETSC_DETERMINE,0,d_nnz,0,o_nnz,&ipmP->K);CHKERRQ(ierr);
+      ierr = PetscFree2(d_nnz,o_nnz);CHKERRQ(ierr);
+    }
+    /* let PCFIELDSPLIT, for instance with a Schur complement, use the two fields */
+    ierr = KSPGetPC(tao->ksp,&pc);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)pc,PCFIELDSPLIT,&isfs);CHKERRQ(ierr);
+    if (isfs && ipmP->B && !ipmP->kkt_fieldsplit) {
+      ierr = PCFieldSplitSetIS(pc,"primal",ipmP->kkt_is[0]);CHKERRQ(ierr);
+      ierr = PCFieldSplitSetIS(pc,"dual",ipmP->kkt_is[1]);CHKERRQ(ierr);
+      ipmP->kkt_fieldsplit = PETSC_TRUE;
     }
-
-    ierr = VecRestoreArrayRead(ipmP->lamdai,&l);CHKERRQ(ierr);
-    ierr = VecRestoreArrayRead(ipmP->s,&y);CHKERRQ(ierr);
   }
-
-  ierr = PetscFree(indices);CHKERRQ(ierr);
-  ierr = PetscFree(newvals);CHKERRQ(ierr);
+  if (!ipmP->kkt_nest) {
+    ierr = IPMAssembleK(tao,blocks,NULL,NULL);CHKERRQ(ierr);
+  }
+  /* also marks the MATNEST as changed, so that the preconditioner is set up again */
   ierr = MatAssemblyBegin(ipmP->K,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(ipmP->K,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -998,62 +903,66 @@ PetscErrorCode IPMUpdateK(Tao tao)
 PetscErrorCode IPMGatherRHS(Tao tao,Vec RHS,Vec X1,Vec X2,Vec X3,Vec X4)
 {
   TAO_IPM        *ipmP = (TAO_IPM *)tao->data;
+  PetscInt       i,n[4];
+  Vec            X[4];
+  PetscScalar    *rhs;
+  const PetscScalar *x;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   /* rhs = [x1      (n)
             x2     (me)
             x3     (nb)
-            x4     (nb)] */
-  if (X1) {
-    ierr = VecScatterBegin(ipmP->rhs1,X1,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->rhs1,X1,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  if (ipmP->me > 0 && X2) {
-    ierr = VecScatterBegin(ipmP->rhs2,X2,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->rhs2,X2,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  if (ipmP->nb > 0) {
-    if (X3) {
-      ierr = VecScatterBegin(ipmP->rhs3,X3,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecScatterEnd(ipmP->rhs3,X3,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    }
-    if (X4) {
-      ierr = VecScatterBegin(ipmP->rhs4,X4,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecScatterEnd(ipmP->rhs4,X4,RHS,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    }
-  }
+            x4     (nb)] on the entries of each process */
+  X[0] = X1; X[1] = ipmP->me > 0 ? X2 : NULL; X[2] = ipmP->nb > 0 ? X3 : NULL; X[3] = ipmP->nb > 0 ? X4 : NULL;
+  ierr = VecGetLocalSize(tao->solution,&n[0]);CHKERRQ(ierr);
+  n[1] = n[2] = n[3] = 0;
+  if (ipmP->me > 0) {ierr = VecGetLocalSize(ipmP->lamdae,&n[1]);CHKERRQ(ierr);}
+  if (ipmP->nb > 0) {ierr = VecGetLocalSize(ipmP->s,&n[2]);CHKERRQ(ierr); n[3] = n[2];}
+  ierr = VecGetArray(RHS,&rhs);CHKERRQ(ierr);
+  for (i=0; i<4; i++) {
+    if (X[i]) {
+      ierr = VecGetArrayRead(X[i],&x);CHKERRQ(ierr);
+      ierr = PetscMemcpy(rhs,x,n[i]*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(X[i],&x);CHKERRQ(ierr);
+    }
+    rhs += n[i];
+  }
+  rhs -= n[0]+n[1]+n[2]+n[3];
+  ierr = VecRestoreArray(RHS,&rhs);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
 PetscErrorCode IPMScatterStep(Tao tao, Vec STEP, Vec X1, Vec X2, Vec X3, Vec X4)
 {
   TAO_IPM        *ipmP = (TAO_IPM *)tao->data;
+  PetscInt       i,n[4];
+  Vec            X[4];
+  PetscScalar    *x;
+  const PetscScalar *step;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  CHKMEMQ;
   /*        [x1    (n)
-             x2    (nb) may be 0
              x3    (me) may be 0
-             x4    (nb) may be 0 */
-  if (X1) {
-    ierr = VecScatterBegin(ipmP->step1,STEP,X1,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->step1,STEP,X1,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  if (X2 && ipmP->nb > 0) {
-    ierr = VecScatterBegin(ipmP->step2,STEP,X2,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->step2,STEP,X2,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  if (X3 && ipmP->me > 0) {
-    ierr = VecScatterBegin(ipmP->step3,STEP,X3,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->step3,STEP,X3,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  if (X4 && ipmP->nb > 0) {
-    ierr = VecScatterBegin(ipmP->step4,STEP,X4,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(ipmP->step4,STEP,X4,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  }
-  CHKMEMQ;
+             x4    (nb) may be 0
+             x2    (nb) may be 0 ] on the entries of each process */
+  X[0] = X1; X[1] = ipmP->me > 0 ? X3 : NULL; X[2] = ipmP->nb > 0 ? X4 : NULL; X[3] = ipmP->nb > 0 ? X2 : NULL;
+  ierr = VecGetLocalSize(tao->solution,&n[0]);CHKERRQ(ierr);
+  n[1] = n[2] = n[3] = 0;
+  if (ipmP->me > 0) {ierr = VecGetLocalSize(ipmP->lamdae,&n[1]);CHKERRQ(ierr);}
+  if (ipmP->nb > 0) {ierr = VecGetLocalSize(ipmP->s,&n[2]);CHKERRQ(ierr); n[3] = n[2];}
+  ierr = VecGetArrayRead(STEP,&step);CHKERRQ(ierr);
+  for (i=0; i<4; i++) {
+    if (X[i]) {
+      ierr = VecGetArray(X[i],&x);CHKERRQ(ierr);
+      ierr = PetscMemcpy(x,step,n[i]*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = VecRestoreArray(X[i],&x);CHKERRQ(ierr);
+    }
+    step += n[i];
+  }
+  step -= n[0]+n[1]+n[2]+n[3];
+  ierr = VecRestoreArrayRead(STEP,&step);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1063,8 +972,14 @@ PetscErrorCode IPMScatterStep(Tao tao, Vec STEP, Vec X1, Vec X2, Vec X3, Vec X4)
   Option Database Keys:
 +   -tao_ipm_pushnu - parameter to push initial dual variables away from bounds
 .   -tao_ipm_pushs - parameter to push initial slack variables away from bounds
+-   -tao_ipm_kkt_nest - solve with the MATNEST of the blocks of the KKT matrix instead of an assembled AIJ matrix
+
+  Notes: The KKT matrix has a primal field, the variables, and a dual field, the multipliers and the slack variables. When
+  the preconditioner is PCFIELDSPLIT these are given as its splits "primal" and "dual", for instance for
+  -pc_fieldsplit_type schur. The nonzero pattern of the KKT matrix is kept while the ones of the Hessian and the
+  constraint Jacobians do not change.
 
-  Notes: This algorithm is more of a place-holder for future constrained optimization algorithms and should not yet be used for large problems or production code.
+  This algorithm is more of a place-holder for future constrained optimization algorithms and should not yet be used for large problems or production code.
   Level: beginner
 
 M*/
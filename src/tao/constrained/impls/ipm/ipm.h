@@ -31,20 +31,21 @@ typedef struct {
               -JacI (ub)
               I (xlb)
               -I (xub) */
-  Mat K; /* [ H , 0,   Ae',-Ai'];
-            [Ae , 0,   0  , 0];
-            [Ai ,-Imi, 0 ,  0];
-            [ 0 , L ,  0 ,  Y ];  */
+  Mat K; /* [ H , Bt ]   MATNEST or AIJ, see IPMUpdateK()
+            [ B , C  ]  */
+  Mat B,Bt,C;        /* blocks of K coupling the primal field x and the dual field [lamdae; lamdai; s] */
+  Vec bsign;         /* scaling of the columns of B' giving Bt = [Ae', -Ai', 0] */
+  IS  kkt_is[2];     /* rows of K of the primal and dual fields */
+  PetscInt *xranges,*dranges; /* ownership ranges of the primal and dual fields */
+  PetscObjectState hstate,aestate,jistate; /* nonzero states of H, Ae and Ji when the patterns of K and Ai were built */
+  PetscBool kkt_nest,kkt_fieldsplit;
 
-  Vec bigrhs; /* rhs [x; lamdae; yi; lamdai] */
-  Vec bigstep; /* [dx; dyi; dlamdae; dlamdai] */
+  Vec bigrhs; /* rhs [x; lamdae; lamdai; s] on each process */
+  Vec bigstep; /* [dx; dlamdae; dlamdai; ds] on each process */
   PetscBool monitorkkt;
   PetscScalar alpha1,alpha2;
   PetscScalar pushs,pushnu;
   IS isxl,isxu,isil,isiu;
-  VecScatter ci_scat,xl_scat,xu_scat;
-  VecScatter step1,step2,step3,step4;
-  VecScatter rhs1,rhs2,rhs3,rhs4;
 } TAO_IPM;
 
 #endif /* ifndef __TAO_IPM_H */
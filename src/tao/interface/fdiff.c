@@ -32,7 +32,8 @@ static PetscErrorCode Fsnes(SNES snes ,Vec X,Vec G,void*ctx)
 
    Options Database Key:
 +  -tao_fd_gradient - Activates TaoDefaultComputeGradient()
--  -tao_fd_delta <delta> - change in x used to calculate finite differences
+.  -tao_fd_delta <delta> - change in x used to calculate finite differences
+-  -tao_fd_gradient_batch <n> - number of coordinates whose perturbed points are evaluated together
 
    Level: advanced
 
@@ -48,7 +49,11 @@ static PetscErrorCode Fsnes(SNES snes ,Vec X,Vec G,void*ctx)
    Note:
    This finite difference gradient evaluation can be set using the routine TaoSetGradientRoutine() or by using the command line option -tao_fd_gradient
 
-.seealso: TaoSetGradientRoutine()
+   Note:
+   If a routine evaluating several points was given with TaoSetObjectiveMultipleRoutine(), or the processes are split
+   in groups with TaoSetObjectiveGroups(), the perturbed points are evaluated in batches with TaoComputeObjectiveMultiple().
+
+.seealso: TaoSetGradientRoutine(), TaoSetObjectiveMultipleRoutine(), TaoSetObjectiveGroups()
 
 @*/
 PetscErrorCode TaoDefaultComputeGradient(Tao tao,Vec X,Vec G,void *dummy)
@@ -56,14 +61,46 @@ PetscErrorCode TaoDefaultComputeGradient(Tao tao,Vec X,Vec G,void *dummy)
   PetscScalar    *x,*g;
   PetscReal      f, f2;
   PetscErrorCode ierr;
-  PetscInt       low,high,N,i;
+  PetscInt       low,high,N,i,j,nb,batch=16;
   PetscBool      flg;
-  PetscReal      h=.5*PETSC_SQRT_MACHINE_EPSILON;
+  PetscReal      h=.5*PETSC_SQRT_MACHINE_EPSILON,*fv;
+  Vec            *P;
 
   PetscFunctionBegin;
   ierr = PetscOptionsGetReal(((PetscObject)tao)->options,((PetscObject)tao)->prefix,"-tao_fd_delta",&h,&flg);CHKERRQ(ierr);
   ierr = VecGetSize(X,&N);CHKERRQ(ierr);
   ierr = VecGetOwnershipRange(X,&low,&high);CHKERRQ(ierr);
+  if (tao->ops->computeobjectivemultiple || tao->objgroups > 1) {
+    /* points x - h e_i and x + h e_i of batch coordinates at a time */
+    ierr = PetscOptionsGetInt(((PetscObject)tao)->options,((PetscObject)tao)->prefix,"-tao_fd_gradient_batch",&batch,&flg);CHKERRQ(ierr);
+    batch = PetscMax(1,PetscMin(batch,N));
+    ierr = VecDuplicateVecs(X,2*batch,&P);CHKERRQ(ierr);
+    ierr = PetscMalloc1(2*batch,&fv);CHKERRQ(ierr);
+    for (i=0; i<N; i+=batch) {
+      nb = PetscMin(batch,N-i);
+      for (j=0; j<nb; j++) {
+        ierr = VecCopy(X,P[2*j]);CHKERRQ(ierr);
+        ierr = VecCopy(X,P[2*j+1]);CHKERRQ(ierr);
+        if (i+j>=low && i+j<high) {
+          ierr = VecGetArray(P[2*j],&x);CHKERRQ(ierr);
+          x[i+j-low] -= h;
+          ierr = VecRestoreArray(P[2*j],&x);CHKERRQ(ierr);
+          ierr = VecGetArray(P[2*j+1],&x);CHKERRQ(ierr);
+          x[i+j-low] += h;
+          ierr = VecRestoreArray(P[2*j+1],&x);CHKERRQ(ierr);
+        }
+      }
+      ierr = TaoComputeObjectiveMultiple(tao,2*nb,P,fv);CHKERRQ(ierr);
+      ierr = VecGetArray(G,&g);CHKERRQ(ierr);
+      for (j=0; j<nb; j++) {
+        if (i+j>=low && i+j<high) g[i+j-low] = (fv[2*j+1]-fv[2*j])/(2.0*h);
+      }
+      ierr = VecRestoreArray(G,&g);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(fv);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(2*batch,&P);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecGetArray(G,&g);CHKERRQ(ierr);
   for (i=0;i<N;i++) {
     if (i>=low && i<high) {
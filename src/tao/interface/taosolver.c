@@ -116,6 +116,7 @@ PetscErrorCode TaoCreate(MPI_Comm comm, Tao *newtao)
 
   tao->max_it     = 10000;
   tao->max_funcs   = 10000;
+  tao->objgroups   = 1;
 #if defined(PETSC_USE_REAL_SINGLE)
   tao->gatol       = 1e-5;
   tao->grtol       = 1e-5;
@@ -320,6 +321,7 @@ PetscErrorCode TaoDestroy(Tao *tao)
   ierr = ISDestroy(&(*tao)->state_is);CHKERRQ(ierr);
   ierr = ISDestroy(&(*tao)->design_is);CHKERRQ(ierr);
   ierr = VecDestroy(&(*tao)->sep_weights_v);CHKERRQ(ierr);
+  ierr = PetscSubcommDestroy(&(*tao)->objsubcomm);CHKERRQ(ierr);
   ierr = TaoCancelMonitors(*tao);CHKERRQ(ierr);
   if ((*tao)->hist_malloc) {
     ierr = PetscFree((*tao)->hist_obj);CHKERRQ(ierr);
@@ -366,6 +368,7 @@ PetscErrorCode TaoDestroy(Tao *tao)
 . -tao_draw_step - graphically view step vector at each iteration
 . -tao_draw_gradient - graphically view gradient at each iteration
 . -tao_fd_gradient - use gradient computed with finite differences
+. -tao_objective_groups <ngroups> - number of groups of processes evaluating points concurrently
 . -tao_cancelmonitors - cancels all monitors (except those set with command line)
 . -tao_view - prints information about the Tao after solving
 - -tao_converged_reason - prints the reason TAO stopped iterating
@@ -383,6 +386,7 @@ PetscErrorCode TaoSetFromOptions(Tao tao)
   char           type[256], monfilename[PETSC_MAX_PATH_LEN];
   PetscViewer    monviewer;
   PetscBool      flg;
+  PetscInt       ngroups;
   MPI_Comm       comm;
 
   PetscFunctionBegin;
@@ -502,6 +506,10 @@ PetscErrorCode TaoSetFromOptions(Tao tao)
     if (flg) {
       ierr = TaoSetGradientRoutine(tao,TaoDefaultComputeGradient,NULL);CHKERRQ(ierr);
     }
+    ierr = PetscOptionsInt("-tao_objective_groups","Number of groups of processes evaluating points concurrently","TaoSetObjectiveGroups",tao->objgroups,&ngroups,&flg);CHKERRQ(ierr);
+    if (flg) {
+      ierr = TaoSetObjectiveGroups(tao,ngroups);CHKERRQ(ierr);
+    }
     ierr = PetscOptionsEnum("-tao_subset_type","subset type", "", TaoSubSetTypes,(PetscEnum)tao->subset_type, (PetscEnum*)&tao->subset_type, 0);CHKERRQ(ierr);
 
     if (tao->ops->setfromoptions) {
@@ -602,6 +610,9 @@ PetscErrorCode TaoView(Tao tao, PetscViewer viewer)
       ierr = PetscViewerASCIIPrintf(viewer,"total number of function evaluations=%D,",tao->nfuncs);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPrintf(viewer,"                max: %D\n",tao->max_funcs);CHKERRQ(ierr);
     }
+    if (tao->objgroups>1){
+      ierr = PetscViewerASCIIPrintf(viewer,"function evaluations split in %D groups of processes\n",tao->objgroups);CHKERRQ(ierr);
+    }
     if (tao->ngrads>0){
       ierr = PetscViewerASCIIPrintf(viewer,"total number of gradient evaluations=%D,",tao->ngrads);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPrintf(viewer,"                max: %D\n",tao->max_funcs);CHKERRQ(ierr);
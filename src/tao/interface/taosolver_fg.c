@@ -1,4 +1,5 @@
 #include <petsc/private/taoimpl.h> /*I "petsctao.h" I*/
+#include <petscsf.h>
 
 /*@
   TaoSetInitialVector - Sets the initial guess for the solve
@@ -185,6 +186,50 @@ PetscErrorCode TaoComputeObjectiveAndGradient(Tao tao, Vec X, PetscReal *f, Vec
   PetscFunctionReturn(0);
 }
 
+/*@
+  TaoComputeBatchObjectiveAndGradient - Computes the sum of the objective function terms of some samples and of their
+  gradients
+
+  Not collective
+
+  Input Parameters:
++ tao - the Tao context
+. X - all the optimization variables, a sequential vector
+. n - the number of samples
+- samples - the global numbers of the samples, owned by this process
+
+  Output Parameters:
++ f - the sum of the objective function terms
+- G - the sum of their gradients, a sequential vector
+
+  Notes:
+  TaoComputeBatchObjectiveAndGradient() is typically used within minimization implementations, such as TAOSGD, so
+  most users would not generally call this routine themselves. No evaluation is counted, since each process evaluates
+  its part of a mini-batch.
+
+  Level: developer
+
+.seealso: TaoSetBatchObjectiveAndGradientRoutine(), TaoComputeObjectiveAndGradient()
+@*/
+PetscErrorCode TaoComputeBatchObjectiveAndGradient(Tao tao, Vec X, PetscInt n, const PetscInt samples[], PetscReal *f, Vec G)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  PetscValidHeaderSpecific(X,VEC_CLASSID,2);
+  if (n) PetscValidIntPointer(samples,4);
+  PetscValidRealPointer(f,5);
+  PetscValidHeaderSpecific(G,VEC_CLASSID,6);
+  if (!tao->ops->computebatchobjectiveandgradient) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"TaoSetBatchObjectiveAndGradientRoutine() not set");
+  ierr = PetscLogEventBegin(Tao_ObjGradientEval,tao,X,G,NULL);CHKERRQ(ierr);
+  PetscStackPush("Tao user batch objective/gradient evaluation routine");
+  ierr = (*tao->ops->computebatchobjectiveandgradient)(tao,X,n,samples,f,G,tao->user_batchobjgradP);CHKERRQ(ierr);
+  PetscStackPop;
+  ierr = PetscLogEventEnd(Tao_ObjGradientEval,tao,X,G,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   TaoSetObjectiveRoutine - Sets the function evaluation routine for minimization
 
@@ -344,6 +389,413 @@ PetscErrorCode TaoComputeSeparableObjective(Tao tao, Vec X, Vec F)
   PetscFunctionReturn(0);
 }
 
+/*@C
+  TaoSetObjectiveMultipleRoutine - Sets a routine that evaluates the objective function at several points in one call
+
+  Logically collective on Tao
+
+  Input Parameter:
++ tao - the Tao context
+. func - the routine evaluating the objective function at several points
+- ctx - [optional] user-defined context for private data for the function evaluation
+        routine (may be NULL)
+
+  Calling sequence of func:
+$      func (Tao tao, PetscInt n, Vec x[], PetscReal f[], void *ctx);
+
++ n - number of points
+. x - the points
+. f - the function values at the points
+- ctx - [optional] user-defined function context
+
+  Notes:
+  The routine set with TaoSetObjectiveRoutine() is still required; this one is used by TaoComputeObjectiveMultiple(),
+  for example in the finite difference gradient TaoDefaultComputeGradient(), so that the application can evaluate
+  the points concurrently.
+
+  When the evaluation is split in groups with TaoSetObjectiveGroups() the points x live on the communicator
+  of the group, which is not the communicator of the Tao. The routine must only communicate on PetscObjectComm((PetscObject)x[0]).
+
+  Level: intermediate
+
+.seealso: TaoSetObjectiveRoutine(), TaoComputeObjectiveMultiple(), TaoSetObjectiveGroups(), TaoSetSeparableObjectiveMultipleRoutine()
+@*/
+PetscErrorCode TaoSetObjectiveMultipleRoutine(Tao tao, PetscErrorCode (*func)(Tao, PetscInt, Vec[], PetscReal[], void*),void *ctx)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  tao->user_objmultP = ctx;
+  tao->ops->computeobjectivemultiple = func;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  TaoSetSeparableObjectiveMultipleRoutine - Sets a routine that evaluates the separable objective function at several points in one call
+
+  Logically collective on Tao
+
+  Input Parameter:
++ tao - the Tao context
+. func - the routine evaluating the separable objective function at several points
+- ctx - [optional] user-defined context for private data for the function evaluation
+        routine (may be NULL)
+
+  Calling sequence of func:
+$      func (Tao tao, PetscInt n, Vec x[], Vec f[], void *ctx);
+
++ n - number of points
+. x - the points
+. f - the function value vectors at the points
+- ctx - [optional] user-defined function context
+
+  Notes:
+  The routine set with TaoSetSeparableObjectiveRoutine() is still required; this one is used by
+  TaoComputeSeparableObjectiveMultiple(), for example by TAOPOUNDERS to evaluate its interpolation points.
+
+  When the evaluation is split in groups with TaoSetObjectiveGroups() the vectors x and f live on the communicator
+  of the group. The routine must only communicate on PetscObjectComm((PetscObject)x[0]).
+
+  Level: intermediate
+
+.seealso: TaoSetSeparableObjectiveRoutine(), TaoComputeSeparableObjectiveMultiple(), TaoSetObjectiveGroups()
+@*/
+PetscErrorCode TaoSetSeparableObjectiveMultipleRoutine(Tao tao, PetscErrorCode (*func)(Tao, PetscInt, Vec[], Vec[], void*),void *ctx)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  tao->user_sepobjmultP = ctx;
+  tao->ops->computeseparableobjectivemultiple = func;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TaoSetObjectiveGroups - Splits the processes of the Tao in groups that evaluate disjoint sets of points concurrently
+  in TaoComputeObjectiveMultiple() and TaoComputeSeparableObjectiveMultiple()
+
+  Logically collective on Tao
+
+  Input Parameters:
++ tao - the Tao context
+- ngroups - the number of groups, 1 (the default) to evaluate all points on the communicator of the Tao
+
+  Options Database Key:
+. -tao_objective_groups <ngroups> - the number of groups
+
+  Notes:
+  This is meant for problems with few optimization variables, for which each function evaluation (a simulation) is
+  expensive. The evaluation routines get vectors on the communicator of their group; the points and the function values
+  are only moved between the processes owning their entries.
+
+  Level: intermediate
+
+.seealso: TaoGetObjectiveGroups(), TaoSetObjectiveMultipleRoutine(), TaoSetSeparableObjectiveMultipleRoutine()
+@*/
+PetscErrorCode TaoSetObjectiveGroups(Tao tao, PetscInt ngroups)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  PetscValidLogicalCollectiveInt(tao,ngroups,2);
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)tao),&size);CHKERRQ(ierr);
+  if (ngroups < 1 || ngroups > size) SETERRQ2(PetscObjectComm((PetscObject)tao),PETSC_ERR_ARG_OUTOFRANGE,"Number of groups %D must be between 1 and the number of processes %d",ngroups,size);
+  if (ngroups != tao->objgroups) {ierr = PetscSubcommDestroy(&tao->objsubcomm);CHKERRQ(ierr);}
+  tao->objgroups = ngroups;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TaoGetObjectiveGroups - Gets the number of groups of processes evaluating points concurrently
+
+  Not collective
+
+  Input Parameter:
+. tao - the Tao context
+
+  Output Parameter:
+. ngroups - the number of groups
+
+  Level: intermediate
+
+.seealso: TaoSetObjectiveGroups()
+@*/
+PetscErrorCode TaoGetObjectiveGroups(Tao tao, PetscInt *ngroups)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  PetscValidIntPointer(ngroups,2);
+  *ngroups = tao->objgroups;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Creates the star forest whose roots are the entries of n vectors with the layout of V, stored point after point on
+   each process, and whose leaves are the entries of the group vectors Vs owned by the process, point i being in the
+   group i % ngroups
+*/
+static PetscErrorCode TaoGroupsCreateSF_Private(Tao tao, PetscInt n, Vec V, PetscInt nloc, Vec Vs[], PetscSF *sf)
+{
+  PetscErrorCode ierr;
+  const PetscInt *ranges;
+  PetscInt       i,j,k,l,r,mloc,lo = 0,hi = 0;
+  PetscSFNode    *remote;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(V,&mloc);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRanges(V,&ranges);CHKERRQ(ierr);
+  if (nloc) {ierr = VecGetOwnershipRange(Vs[0],&lo,&hi);CHKERRQ(ierr);}
+  ierr = PetscMalloc1(nloc*(hi-lo),&remote);CHKERRQ(ierr);
+  for (k=0,l=0; k<nloc; k++) {
+    i = tao->objsubcomm->color + k*tao->objsubcomm->n;
+    for (j=lo,r=0; j<hi; j++,l++) {
+      while (j >= ranges[r+1]) r++;
+      remote[l].rank  = r;
+      remote[l].index = i*(ranges[r+1]-ranges[r]) + j-ranges[r];
+    }
+  }
+  ierr = PetscSFCreate(PetscObjectComm((PetscObject)tao),sf);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(*sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*sf,n*mloc,nloc*(hi-lo),NULL,PETSC_OWN_POINTER,remote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Evaluates the objective (F == NULL) or the separable objective at the n points X, point i by group i % ngroups.
+   The entries of the points are sent to their owners in vectors on the communicator of the group, and the entries of
+   the separable objectives back to their owners in F; only the objective values are reduced over the Tao.
+*/
+static PetscErrorCode TaoComputeMultipleGroups_Private(Tao tao, PetscInt n, Vec X[], PetscReal f[], Vec F[])
+{
+  PetscErrorCode    ierr;
+  MPI_Comm          comm = PetscObjectComm((PetscObject)tao),subcomm;
+  PetscMPIInt       subrank,color,ngroups,cnt;
+  PetscInt          i,k,nloc,N,M = 0,mloc,lo,hi;
+  Vec               temp,*Xs,*Fs = NULL;
+  PetscSF           sf;
+  const PetscScalar *xa;
+  PetscScalar       *a,*roots,*leaves;
+  PetscReal         *fs = NULL,*fvals;
+
+  PetscFunctionBegin;
+  if (!tao->objsubcomm) {
+    ierr = PetscSubcommCreate(comm,&tao->objsubcomm);CHKERRQ(ierr);
+    ierr = PetscSubcommSetNumber(tao->objsubcomm,tao->objgroups);CHKERRQ(ierr);
+    ierr = PetscSubcommSetType(tao->objsubcomm,PETSC_SUBCOMM_CONTIGUOUS);CHKERRQ(ierr);
+  }
+  subcomm = PetscSubcommChild(tao->objsubcomm);
+  color   = tao->objsubcomm->color;
+  ngroups = tao->objsubcomm->n;
+  ierr = MPI_Comm_rank(subcomm,&subrank);CHKERRQ(ierr);
+  nloc = n/ngroups + (color < n%ngroups ? 1 : 0);
+  ierr = VecGetSize(X[0],&N);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nloc,&Xs);CHKERRQ(ierr);
+  for (k=0; k<nloc; k++) {ierr = VecCreateMPI(subcomm,PETSC_DECIDE,N,&Xs[k]);CHKERRQ(ierr);}
+  if (F) {
+    ierr = VecGetSize(F[0],&M);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nloc,&Fs);CHKERRQ(ierr);
+    for (k=0; k<nloc; k++) {ierr = VecCreateMPI(subcomm,PETSC_DECIDE,M,&Fs[k]);CHKERRQ(ierr);}
+  } else {
+    ierr = PetscMalloc1(nloc,&fs);CHKERRQ(ierr);
+  }
+
+  /* send the points to the groups */
+  lo = hi = 0;
+  if (nloc) {ierr = VecGetOwnershipRange(Xs[0],&lo,&hi);CHKERRQ(ierr);}
+  ierr = VecGetLocalSize(X[0],&mloc);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n*mloc,&roots,nloc*(hi-lo),&leaves);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = VecGetArrayRead(X[i],&xa);CHKERRQ(ierr);
+    ierr = PetscMemcpy(roots+i*mloc,xa,mloc*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(X[i],&xa);CHKERRQ(ierr);
+  }
+  ierr = TaoGroupsCreateSF_Private(tao,n,X[0],nloc,Xs,&sf);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sf,MPIU_SCALAR,roots,leaves);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_SCALAR,roots,leaves);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  for (k=0; k<nloc; k++) {
+    ierr = VecGetArray(Xs[k],&a);CHKERRQ(ierr);
+    ierr = PetscMemcpy(a,leaves+k*(hi-lo),(hi-lo)*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = VecRestoreArray(Xs[k],&a);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(roots,leaves);CHKERRQ(ierr);
+
+  ierr = PetscLogEventBegin(Tao_ObjectiveEval,tao,NULL,NULL,NULL);CHKERRQ(ierr);
+  if (F) {
+    if (tao->ops->computeseparableobjectivemultiple) {
+      PetscStackPush("Tao user separable objective evaluation routine for several points");
+      ierr = (*tao->ops->computeseparableobjectivemultiple)(tao,nloc,Xs,Fs,tao->user_sepobjmultP);CHKERRQ(ierr);
+      PetscStackPop;
+    } else if (tao->ops->computeseparableobjective) {
+      for (k=0; k<nloc; k++) {
+        PetscStackPush("Tao user separable objective evaluation routine");
+        ierr = (*tao->ops->computeseparableobjective)(tao,Xs[k],Fs[k],tao->user_sepobjP);CHKERRQ(ierr);
+        PetscStackPop;
+      }
+    } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"TaoSetSeparableObjectiveRoutine() has not been called");
+  } else {
+    if (tao->ops->computeobjectivemultiple) {
+      PetscStackPush("Tao user objective evaluation routine for several points");
+      ierr = (*tao->ops->computeobjectivemultiple)(tao,nloc,Xs,fs,tao->user_objmultP);CHKERRQ(ierr);
+      PetscStackPop;
+    } else if (tao->ops->computeobjective) {
+      for (k=0; k<nloc; k++) {
+        PetscStackPush("Tao user objective evaluation routine");
+        ierr = (*tao->ops->computeobjective)(tao,Xs[k],&fs[k],tao->user_objP);CHKERRQ(ierr);
+        PetscStackPop;
+      }
+    } else if (tao->ops->computeobjectiveandgradient) {
+      for (k=0; k<nloc; k++) {
+        ierr = VecDuplicate(Xs[k],&temp);CHKERRQ(ierr);
+        PetscStackPush("Tao user objective/gradient evaluation routine");
+        ierr = (*tao->ops->computeobjectiveandgradient)(tao,Xs[k],&fs[k],temp,tao->user_objgradP);CHKERRQ(ierr);
+        PetscStackPop;
+        ierr = VecDestroy(&temp);CHKERRQ(ierr);
+      }
+    } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"TaoSetObjectiveRoutine() has not been called");
+  }
+  ierr = PetscLogEventEnd(Tao_ObjectiveEval,tao,NULL,NULL,NULL);CHKERRQ(ierr);
+  tao->nfuncs += n;
+
+  if (F) {
+    /* send the entries of the separable objectives back to their owners in F */
+    lo = hi = 0;
+    if (nloc) {ierr = VecGetOwnershipRange(Fs[0],&lo,&hi);CHKERRQ(ierr);}
+    ierr = VecGetLocalSize(F[0],&mloc);CHKERRQ(ierr);
+    ierr = PetscMalloc2(n*mloc,&roots,nloc*(hi-lo),&leaves);CHKERRQ(ierr);
+    for (k=0; k<nloc; k++) {
+      ierr = VecGetArrayRead(Fs[k],&xa);CHKERRQ(ierr);
+      ierr = PetscMemcpy(leaves+k*(hi-lo),xa,(hi-lo)*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(Fs[k],&xa);CHKERRQ(ierr);
+    }
+    ierr = TaoGroupsCreateSF_Private(tao,n,F[0],nloc,Fs,&sf);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(sf,MPIU_SCALAR,leaves,roots,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sf,MPIU_SCALAR,leaves,roots,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      ierr = VecGetArray(F[i],&a);CHKERRQ(ierr);
+      ierr = PetscMemcpy(a,roots+i*mloc,mloc*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = VecRestoreArray(F[i],&a);CHKERRQ(ierr);
+    }
+    ierr = PetscFree2(roots,leaves);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(nloc,&Fs);CHKERRQ(ierr);
+  } else {
+    /* every value is contributed by the first process of its group, the others add zeros */
+    ierr = PetscCalloc1(n,&fvals);CHKERRQ(ierr);
+    if (!subrank) {
+      for (k=0; k<nloc; k++) fvals[color + k*ngroups] = fs[k];
+    }
+    ierr = PetscMPIIntCast(n,&cnt);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(fvals,f,cnt,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+    ierr = PetscFree(fvals);CHKERRQ(ierr);
+    ierr = PetscFree(fs);CHKERRQ(ierr);
+  }
+  ierr = VecDestroyVecs(nloc,&Xs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TaoComputeObjectiveMultiple - Computes the objective function value at several points
+
+  Collective on Tao
+
+  Input Parameters:
++ tao - the Tao context
+. n - the number of points
+- X - the points
+
+  Output Parameter:
+. f - the objective values at the points
+
+  Notes:
+  This uses the routine set with TaoSetObjectiveMultipleRoutine() if there is one, otherwise it evaluates the points
+  one after the other. With TaoSetObjectiveGroups() the points are distributed over groups of processes.
+
+  Level: developer
+
+.seealso: TaoComputeObjective(), TaoSetObjectiveMultipleRoutine(), TaoSetObjectiveGroups()
+@*/
+PetscErrorCode TaoComputeObjectiveMultiple(Tao tao, PetscInt n, Vec X[], PetscReal f[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  if (n <= 0) PetscFunctionReturn(0);
+  PetscValidPointer(X,3);
+  PetscValidRealPointer(f,4);
+  PetscValidHeaderSpecific(X[0],VEC_CLASSID,3);
+  PetscCheckSameComm(tao,1,X[0],3);
+  if (tao->objgroups > 1) {
+    ierr = TaoComputeMultipleGroups_Private(tao,n,X,f,NULL);CHKERRQ(ierr);
+  } else if (tao->ops->computeobjectivemultiple) {
+    ierr = PetscLogEventBegin(Tao_ObjectiveEval,tao,X[0],NULL,NULL);CHKERRQ(ierr);
+    PetscStackPush("Tao user objective evaluation routine for several points");
+    ierr = (*tao->ops->computeobjectivemultiple)(tao,n,X,f,tao->user_objmultP);CHKERRQ(ierr);
+    PetscStackPop;
+    ierr = PetscLogEventEnd(Tao_ObjectiveEval,tao,X[0],NULL,NULL);CHKERRQ(ierr);
+    tao->nfuncs += n;
+  } else {
+    for (i=0; i<n; i++) {ierr = TaoComputeObjective(tao,X[i],&f[i]);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscInfo1(tao,"TAO Function evaluation at %D points\n",n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TaoComputeSeparableObjectiveMultiple - Computes the separable objective function vector at several points
+
+  Collective on Tao
+
+  Input Parameters:
++ tao - the Tao context
+. n - the number of points
+- X - the points
+
+  Output Parameter:
+. F - the objective vectors at the points
+
+  Notes:
+  This uses the routine set with TaoSetSeparableObjectiveMultipleRoutine() if there is one, otherwise it evaluates the
+  points one after the other. With TaoSetObjectiveGroups() the points are distributed over groups of processes.
+
+  Level: developer
+
+.seealso: TaoComputeSeparableObjective(), TaoSetSeparableObjectiveMultipleRoutine(), TaoSetObjectiveGroups()
+@*/
+PetscErrorCode TaoComputeSeparableObjectiveMultiple(Tao tao, PetscInt n, Vec X[], Vec F[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  if (n <= 0) PetscFunctionReturn(0);
+  PetscValidPointer(X,3);
+  PetscValidPointer(F,4);
+  PetscValidHeaderSpecific(X[0],VEC_CLASSID,3);
+  PetscValidHeaderSpecific(F[0],VEC_CLASSID,4);
+  PetscCheckSameComm(tao,1,X[0],3);
+  PetscCheckSameComm(tao,1,F[0],4);
+  if (tao->objgroups > 1) {
+    ierr = TaoComputeMultipleGroups_Private(tao,n,X,NULL,F);CHKERRQ(ierr);
+  } else if (tao->ops->computeseparableobjectivemultiple) {
+    ierr = PetscLogEventBegin(Tao_ObjectiveEval,tao,X[0],NULL,NULL);CHKERRQ(ierr);
+    PetscStackPush("Tao user separable objective evaluation routine for several points");
+    ierr = (*tao->ops->computeseparableobjectivemultiple)(tao,n,X,F,tao->user_sepobjmultP);CHKERRQ(ierr);
+    PetscStackPop;
+    ierr = PetscLogEventEnd(Tao_ObjectiveEval,tao,X[0],NULL,NULL);CHKERRQ(ierr);
+    tao->nfuncs += n;
+  } else {
+    for (i=0; i<n; i++) {ierr = TaoComputeSeparableObjective(tao,X[i],F[i]);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscInfo1(tao,"TAO separable function evaluation at %D points\n",n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
   TaoSetGradientRoutine - Sets the gradient evaluation routine for minimization
 
@@ -408,6 +860,86 @@ PetscErrorCode TaoSetObjectiveAndGradientRoutine(Tao tao, PetscErrorCode (*func)
   PetscFunctionReturn(0);
 }
 
+/*@C
+  TaoSetBatchObjectiveAndGradientRoutine - Sets a routine that evaluates an objective function that is a sum over
+  samples, and its gradient, for a subset of the samples
+
+  Collective on Tao
+
+  Input Parameters:
++ tao - the Tao context
+. n - the number of samples owned by this process (or PETSC_DECIDE to have it computed)
+. N - the total number of samples (or PETSC_DETERMINE to have it computed)
+. func - the routine evaluating the objective function and its gradient over samples
+- ctx - [optional] user-defined context for private data for the evaluation routine (may be NULL)
+
+  Calling sequence of func:
+$      func (Tao tao, Vec x, PetscInt n, const PetscInt samples[], PetscReal *f, Vec g, void *ctx);
+
++ x - all the optimization variables, a sequential vector
+. n - the number of samples
+. samples - the global numbers of the samples, all owned by this process
+. f - the sum of the objective function terms of the samples (output)
+. g - the sum of the gradients of the terms of the samples, a sequential vector with all the variables (output)
+- ctx - [optional] user-defined function context
+
+  Notes:
+  The objective function is f(x) = 1/N sum_{i<N} f_i(x). The samples are numbered contiguously by process, like the
+  rows of a matrix, so the application only needs the data of its own samples.
+
+  The routine is called by each process independently with some of its own samples, possibly none, and it must not
+  communicate. Every process has a copy of all the optimization variables, so this is meant for problems with many
+  samples, such as parameter fitting, and a moderate number of variables. The stochastic solvers of TAOSGD use it.
+
+  Level: intermediate
+
+.seealso: TaoGetBatchSamples(), TaoComputeBatchObjectiveAndGradient(), TAOSGD
+@*/
+PetscErrorCode TaoSetBatchObjectiveAndGradientRoutine(Tao tao, PetscInt n, PetscInt N, PetscErrorCode (*func)(Tao, Vec, PetscInt, const PetscInt[], PetscReal*, Vec, void*), void *ctx)
+{
+  PetscErrorCode ierr;
+  MPI_Comm       comm;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  ierr = PetscObjectGetComm((PetscObject)tao,&comm);CHKERRQ(ierr);
+  ierr = PetscSplitOwnership(comm,&n,&N);CHKERRQ(ierr);
+  ierr = MPI_Scan(&n,&tao->sample_start,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  tao->sample_start -= n;
+  tao->nsamples_local = n;
+  tao->nsamples       = N;
+  tao->user_batchobjgradP = ctx;
+  tao->ops->computebatchobjectiveandgradient = func;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TaoGetBatchSamples - Gets the samples of the objective function set with TaoSetBatchObjectiveAndGradientRoutine()
+
+  Not collective
+
+  Input Parameter:
+. tao - the Tao context
+
+  Output Parameters:
++ rstart - the global number of the first sample owned by this process
+. n - the number of samples owned by this process
+- N - the total number of samples
+
+  Level: intermediate
+
+.seealso: TaoSetBatchObjectiveAndGradientRoutine()
+@*/
+PetscErrorCode TaoGetBatchSamples(Tao tao, PetscInt *rstart, PetscInt *n, PetscInt *N)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(tao,TAO_CLASSID,1);
+  if (rstart) *rstart = tao->sample_start;
+  if (n)      *n      = tao->nsamples_local;
+  if (N)      *N      = tao->nsamples;
+  PetscFunctionReturn(0);
+}
+
 /*@
   TaoIsObjectiveDefined -- Checks to see if the user has
   declared an objective-only routine.  Useful for determining when
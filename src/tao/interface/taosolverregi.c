@@ -23,6 +23,7 @@ PETSC_EXTERN PetscErrorCode TaoCreate_SSFLS(Tao);
 PETSC_EXTERN PetscErrorCode TaoCreate_ASILS(Tao);
 PETSC_EXTERN PetscErrorCode TaoCreate_ASFLS(Tao);
 PETSC_EXTERN PetscErrorCode TaoCreate_IPM(Tao);
+PETSC_EXTERN PetscErrorCode TaoCreate_SGD(Tao);
 
 /*
    Offset the convergence reasons so negative number represent diverged and
@@ -87,6 +88,7 @@ PetscErrorCode TaoRegisterAll(void)
   ierr = TaoRegister(TAOASILS,TaoCreate_ASILS);CHKERRQ(ierr);
   ierr = TaoRegister(TAOASFLS,TaoCreate_ASFLS);CHKERRQ(ierr);
   ierr = TaoRegister(TAOIPM,TaoCreate_IPM);CHKERRQ(ierr);
+  ierr = TaoRegister(TAOSGD,TaoCreate_SGD);CHKERRQ(ierr);
 #endif
   ierr = TaoRegister(TAOTEST,TaoCreate_Test);CHKERRQ(ierr);
   PetscFunctionReturn(0);
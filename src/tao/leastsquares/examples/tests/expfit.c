@@ -0,0 +1,138 @@
+
+static char help[] = "Tests the evaluation of several points at once, split over groups of processes, with TaoSetObjectiveGroups().\n\
+  Fits y = b1 exp(-b2 t) + b3 with POUNDERS, or by minimizing the sum of squares with a finite difference gradient.\n\
+  -fd          : minimize the sum of squares with -tao_fd_gradient instead of using the separable objective\n\
+  -no_multiple : do not provide routines evaluating several points at once\n\n";
+
+#include <petsctao.h>
+
+#define NOBSERVATIONS 24
+#define NPARAMETERS   3
+
+typedef struct {
+  PetscReal t[NOBSERVATIONS],y[NOBSERVATIONS];
+} AppCtx;
+
+/* gathers the parameters on every process of the communicator of X, which is the one of a group of processes when
+   the evaluations are split in groups */
+static PetscErrorCode GetParameters(Vec X,PetscReal b[])
+{
+  Vec               Xall;
+  VecScatter        scat;
+  const PetscScalar *x;
+  PetscInt          i;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecScatterCreateToAll(X,&scat,&Xall);CHKERRQ(ierr);
+  ierr = VecScatterBegin(scat,X,Xall,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd(scat,X,Xall,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(Xall,&x);CHKERRQ(ierr);
+  for (i=0; i<NPARAMETERS; i++) b[i] = PetscRealPart(x[i]);
+  ierr = VecRestoreArrayRead(Xall,&x);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&scat);CHKERRQ(ierr);
+  ierr = VecDestroy(&Xall);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode EvaluateResiduals(Tao tao,Vec X,Vec F,void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  PetscReal      b[NPARAMETERS];
+  PetscScalar    *f;
+  PetscInt       i,lo,hi;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = GetParameters(X,b);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(F,&lo,&hi);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  for (i=lo; i<hi; i++) f[i-lo] = b[0]*PetscExpReal(-b[1]*user->t[i]) + b[2] - user->y[i];
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode EvaluateResidualsMultiple(Tao tao,PetscInt n,Vec X[],Vec F[],void *ctx)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<n; i++) {ierr = EvaluateResiduals(tao,X[i],F[i],ctx);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* every process sums all the squares so that the value does not depend on the communicator of X */
+static PetscErrorCode EvaluateObjective(Tao tao,Vec X,PetscReal *fsum,void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  PetscReal      b[NPARAMETERS],r;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr  = GetParameters(X,b);CHKERRQ(ierr);
+  *fsum = 0.0;
+  for (i=0; i<NOBSERVATIONS; i++) {
+    r      = b[0]*PetscExpReal(-b[1]*user->t[i]) + b[2] - user->y[i];
+    *fsum += r*r;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode EvaluateObjectiveMultiple(Tao tao,PetscInt n,Vec X[],PetscReal f[],void *ctx)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<n; i++) {ierr = EvaluateObjective(tao,X[i],&f[i],ctx);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Tao            tao;
+  Vec            x,f;
+  AppCtx         user;
+  PetscScalar    *xa;
+  PetscInt       i,lo,hi;
+  PetscBool      fd = PETSC_FALSE,nomultiple = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-fd",&fd,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-no_multiple",&nomultiple,NULL);CHKERRQ(ierr);
+  for (i=0; i<NOBSERVATIONS; i++) {
+    user.t[i] = 3.0*i/(NOBSERVATIONS-1);
+    user.y[i] = 2.0*PetscExpReal(-1.3*user.t[i]) + 0.5 + 0.01*PetscSinReal(7.0*i);
+  }
+
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,PETSC_DECIDE,NPARAMETERS,&x);CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,PETSC_DECIDE,NOBSERVATIONS,&f);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(x,&lo,&hi);CHKERRQ(ierr);
+  ierr = VecGetArray(x,&xa);CHKERRQ(ierr);
+  for (i=lo; i<hi; i++) xa[i-lo] = 1.0;
+  ierr = VecRestoreArray(x,&xa);CHKERRQ(ierr);
+
+  ierr = TaoCreate(PETSC_COMM_WORLD,&tao);CHKERRQ(ierr);
+  if (fd) {
+    ierr = TaoSetType(tao,TAOLMVM);CHKERRQ(ierr);
+    ierr = TaoSetObjectiveRoutine(tao,EvaluateObjective,&user);CHKERRQ(ierr);
+    if (!nomultiple) {ierr = TaoSetObjectiveMultipleRoutine(tao,EvaluateObjectiveMultiple,&user);CHKERRQ(ierr);}
+  } else {
+    ierr = TaoSetType(tao,TAOPOUNDERS);CHKERRQ(ierr);
+    ierr = TaoSetSeparableObjectiveRoutine(tao,f,EvaluateResiduals,&user);CHKERRQ(ierr);
+    if (!nomultiple) {ierr = TaoSetSeparableObjectiveMultipleRoutine(tao,EvaluateResidualsMultiple,&user);CHKERRQ(ierr);}
+  }
+  ierr = TaoSetInitialVector(tao,x);CHKERRQ(ierr);
+  ierr = TaoSetFromOptions(tao);CHKERRQ(ierr);
+  ierr = TaoSolve(tao);CHKERRQ(ierr);
+  ierr = VecView(x,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+
+  ierr = TaoDestroy(&tao);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&f);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
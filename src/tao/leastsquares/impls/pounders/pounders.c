@@ -26,27 +26,71 @@ static PetscErrorCode  pounders_fg(Tao subtao, Vec x, PetscReal *f, Vec g, void
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode pounders_feval(Tao tao, Vec x, Vec F, PetscReal *fsum)
+/* gives the entries of the vector X, gathered in the sequential vector local by scatter when running on several processes */
+static PetscErrorCode pounders_getarray(TAO_POUNDERS *mfqP, VecScatter scatter, Vec X, Vec local, const PetscReal **x)
 {
   PetscErrorCode ierr;
-  TAO_POUNDERS   *mfqP = (TAO_POUNDERS*)tao->data;
-  PetscInt i,row,col;
-  PetscReal fr,fc;
+
+  PetscFunctionBegin;
+  if (mfqP->size == 1) {
+    ierr = VecGetArrayRead(X,x);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterBegin(scatter,X,local,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(scatter,X,local,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(local,x);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode pounders_restorearray(TAO_POUNDERS *mfqP, Vec X, Vec local, const PetscReal **x)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mfqP->size == 1) {
+    ierr = VecRestoreArrayRead(X,x);CHKERRQ(ierr);
+  } else {
+    ierr = VecRestoreArrayRead(local,x);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* copies the vector X with the layout of the solution to the sequential vector seqx */
+static PetscErrorCode pounders_copytoseq(TAO_POUNDERS *mfqP, Vec X, Vec seqx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mfqP->size == 1) {
+    ierr = VecCopy(X,seqx);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterBegin(mfqP->scatterx,X,seqx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(mfqP->scatterx,X,seqx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode pounders_fsum(Tao tao, Vec F, PetscReal *fsum)
+{
+  PetscErrorCode  ierr;
+  TAO_POUNDERS    *mfqP = (TAO_POUNDERS*)tao->data;
+  PetscInt        i,row,col;
+  const PetscReal *f;
+
   PetscFunctionBegin;
-  ierr = TaoComputeSeparableObjective(tao,x,F);CHKERRQ(ierr);
   if (tao->sep_weights_v) {
     ierr = VecPointwiseMult(mfqP->workfvec,tao->sep_weights_v,F);CHKERRQ(ierr);
     ierr = VecNorm(mfqP->workfvec,NORM_2,fsum);CHKERRQ(ierr);
     *fsum*=(*fsum);
   } else if (tao->sep_weights_w) {
     *fsum=0;
+    ierr = pounders_getarray(mfqP,mfqP->scatterf,F,mfqP->localf,&f);CHKERRQ(ierr);
     for (i=0;i<tao->sep_weights_n;i++) {
       row=tao->sep_weights_rows[i];
       col=tao->sep_weights_cols[i];
-      ierr = VecGetValues(F,1,&row,&fr);CHKERRQ(ierr);
-      ierr = VecGetValues(F,1,&col,&fc);CHKERRQ(ierr);
-      *fsum += tao->sep_weights_w[i]*fc*fr;
+      *fsum += tao->sep_weights_w[i]*f[col]*f[row];
     }
+    ierr = pounders_restorearray(mfqP,F,mfqP->localf,&f);CHKERRQ(ierr);
   } else {
     ierr = VecNorm(F,NORM_2,fsum);CHKERRQ(ierr);
     *fsum*=(*fsum);
@@ -55,6 +99,30 @@ static PetscErrorCode pounders_feval(Tao tao, Vec x, Vec F, PetscReal *fsum)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode pounders_feval(Tao tao, Vec x, Vec F, PetscReal *fsum)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TaoComputeSeparableObjective(tao,x,F);CHKERRQ(ierr);
+  ierr = pounders_fsum(tao,F,fsum);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* evaluates n points together so that the application (or the groups of processes set with TaoSetObjectiveGroups()) can compute them concurrently */
+static PetscErrorCode pounders_feval_multiple(Tao tao, PetscInt n, Vec X[], Vec F[], PetscReal fsum[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  ierr = TaoComputeSeparableObjectiveMultiple(tao,n,X,F);CHKERRQ(ierr);
+  for (i=0;i<n;i++) {
+    ierr = pounders_fsum(tao,F[i],&fsum[i]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode gqtwrap(Tao tao,PetscReal *gnorm, PetscReal *qmin)
 {
   PetscErrorCode ierr;
@@ -93,11 +161,11 @@ PetscErrorCode gqtwrap(Tao tao,PetscReal *gnorm, PetscReal *qmin)
     /* ierr = TaoSetTolerances(mfqP->subtao,*gnorm,*gnorm,PETSC_DEFAULT);CHKERRQ(ierr); */
     /* enforce bound constraints -- experimental */
     if (tao->XU && tao->XL) {
-      ierr = VecCopy(tao->XU,mfqP->subxu);CHKERRQ(ierr);
-      ierr = VecAXPY(mfqP->subxu,-1.0,tao->solution);CHKERRQ(ierr);
+      ierr = VecWAXPY(mfqP->workxvec,-1.0,tao->solution,tao->XU);CHKERRQ(ierr);
+      ierr = pounders_copytoseq(mfqP,mfqP->workxvec,mfqP->subxu);CHKERRQ(ierr);
       ierr = VecScale(mfqP->subxu,1.0/mfqP->delta);CHKERRQ(ierr);
-      ierr = VecCopy(tao->XL,mfqP->subxl);CHKERRQ(ierr);
-      ierr = VecAXPY(mfqP->subxl,-1.0,tao->solution);CHKERRQ(ierr);
+      ierr = VecWAXPY(mfqP->workxvec,-1.0,tao->solution,tao->XL);CHKERRQ(ierr);
+      ierr = pounders_copytoseq(mfqP,mfqP->workxvec,mfqP->subxl);CHKERRQ(ierr);
       ierr = VecScale(mfqP->subxl,1.0/mfqP->delta);CHKERRQ(ierr);
 
       ierr = VecPointwiseMin(mfqP->subxu,mfqP->subxu,mfqP->subpdel);CHKERRQ(ierr);
@@ -358,12 +426,12 @@ PetscErrorCode morepoints(TAO_POUNDERS *mfqP)
   PetscFunctionBegin;
   /* Initialize M,N */
   for (i=0;i<mfqP->n+1;i++) {
-    ierr = VecGetArrayRead(mfqP->Xhist[mfqP->model_indices[i]],&x);CHKERRQ(ierr);
+    ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[mfqP->model_indices[i]],mfqP->localx,&x);CHKERRQ(ierr);
     mfqP->M[(mfqP->n+1)*i] = 1.0;
     for (j=0;j<mfqP->n;j++) {
       mfqP->M[j+1+((mfqP->n+1)*i)] = (x[j]  - mfqP->xmin[j]) / mfqP->delta;
     }
-    ierr = VecRestoreArrayRead(mfqP->Xhist[mfqP->model_indices[i]],&x);CHKERRQ(ierr);
+    ierr = pounders_restorearray(mfqP,mfqP->Xhist[mfqP->model_indices[i]],mfqP->localx,&x);CHKERRQ(ierr);
     ierr = phi2eval(&mfqP->M[1+((mfqP->n+1)*i)],mfqP->n,&mfqP->N[mfqP->n*(mfqP->n+1)/2 * i]);CHKERRQ(ierr);
   }
 
@@ -395,12 +463,12 @@ PetscErrorCode morepoints(TAO_POUNDERS *mfqP)
       continue;
     }
 
-    ierr = VecGetArrayRead(mfqP->Xhist[point],&x);CHKERRQ(ierr);
+    ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[point],mfqP->localx,&x);CHKERRQ(ierr);
     mfqP->M[(mfqP->n+1)*mfqP->nmodelpoints] = 1.0;
     for (j=0;j<mfqP->n;j++) {
       mfqP->M[j+1+((mfqP->n+1)*mfqP->nmodelpoints)] = (x[j]  - mfqP->xmin[j]) / mfqP->delta;
     }
-    ierr = VecRestoreArrayRead(mfqP->Xhist[point],&x);CHKERRQ(ierr);
+    ierr = pounders_restorearray(mfqP,mfqP->Xhist[point],mfqP->localx,&x);CHKERRQ(ierr);
     ierr = phi2eval(&mfqP->M[1+(mfqP->n+1)*mfqP->nmodelpoints],mfqP->n,&mfqP->N[mfqP->n*(mfqP->n+1)/2 * (mfqP->nmodelpoints)]);CHKERRQ(ierr);
 
     /* Update QR factorization */
@@ -494,7 +562,7 @@ PetscErrorCode morepoints(TAO_POUNDERS *mfqP)
   PetscFunctionReturn(0);
 }
 
-/* Only call from modelimprove, addpoint() needs ->Q_tmp and ->work to be set */
+/* Only call from modelimprove, addpoint() needs ->Q_tmp and ->work to be set; modelimprove() evaluates the new points */
 PetscErrorCode addpoint(Tao tao, TAO_POUNDERS *mfqP, PetscInt index)
 {
   PetscErrorCode ierr;
@@ -512,10 +580,7 @@ PetscErrorCode addpoint(Tao tao, TAO_POUNDERS *mfqP, PetscInt index)
     ierr = VecMedian(mfqP->Xhist[mfqP->nHist], tao->XL, tao->XU, mfqP->Xhist[mfqP->nHist]);CHKERRQ(ierr);
   }
 
-  /* Compute value of new vector */
   ierr = VecDuplicate(mfqP->Fhist[0],&mfqP->Fhist[mfqP->nHist]);CHKERRQ(ierr);
-  CHKMEMQ;
-  ierr = pounders_feval(tao,mfqP->Xhist[mfqP->nHist],mfqP->Fhist[mfqP->nHist],&mfqP->Fres[mfqP->nHist]);CHKERRQ(ierr);
 
   /* Add new vector to model */
   mfqP->model_indices[mfqP->nmodelpoints] = mfqP->nHist;
@@ -528,7 +593,7 @@ PetscErrorCode modelimprove(Tao tao, TAO_POUNDERS *mfqP, PetscInt addallpoints)
 {
   /* modeld = Q(:,np+1:n)' */
   PetscErrorCode ierr;
-  PetscInt       i,j,minindex=0;
+  PetscInt       i,j,minindex=0,first=mfqP->nHist;
   PetscReal      dp,half=0.5,one=1.0,minvalue=PETSC_INFINITY;
   PetscBLASInt   blasn=mfqP->n,  blasnpmax = mfqP->npmax, blask,info;
   PetscBLASInt   blas1=1,blasnmax = mfqP->nmax;
@@ -571,6 +636,9 @@ PetscErrorCode modelimprove(Tao tao, TAO_POUNDERS *mfqP, PetscInt addallpoints)
   if (!addallpoints) {
     ierr = addpoint(tao,mfqP,minindex);CHKERRQ(ierr);
   }
+  /* Compute values of the new vectors */
+  CHKMEMQ;
+  ierr = pounders_feval_multiple(tao,mfqP->nHist-first,&mfqP->Xhist[first],&mfqP->Fhist[first],&mfqP->Fres[first]);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -586,11 +654,11 @@ PetscErrorCode affpoints(TAO_POUNDERS *mfqP, PetscReal *xmin,PetscReal c)
 
   PetscFunctionBegin;
   for (i=mfqP->nHist-1;i>=0;i--) {
-    ierr = VecGetArrayRead(mfqP->Xhist[i],&x);CHKERRQ(ierr);
+    ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[i],mfqP->localx,&x);CHKERRQ(ierr);
     for (j=0;j<mfqP->n;j++) {
       mfqP->work[j] = (x[j] - xmin[j])/mfqP->delta;
     }
-    ierr = VecRestoreArrayRead(mfqP->Xhist[i],&x);CHKERRQ(ierr);
+    ierr = pounders_restorearray(mfqP,mfqP->Xhist[i],mfqP->localx,&x);CHKERRQ(ierr);
     PetscStackCallBLAS("BLAScopy",BLAScopy_(&blasn,mfqP->work,&ione,mfqP->work2,&ione));
     normd = BLASnrm2_(&blasn,mfqP->work,&ione);
     if (normd <= c*c) {
@@ -632,8 +700,8 @@ static PetscErrorCode TaoSolve_POUNDERS(Tao tao)
   TaoConvergedReason reason = TAO_CONTINUE_ITERATING;
   PetscInt           low,high;
   PetscReal          minnorm;
-  PetscReal          *x,*f;
-  const PetscReal    *xmint,*fmin;
+  PetscReal          *xp;
+  const PetscReal    *x,*f,*xmint,*fmin;
   PetscReal          cres,deltaold;
   PetscReal          gnorm;
   PetscBLASInt       info,ione=1,iblas;
@@ -699,12 +767,14 @@ static PetscErrorCode TaoSolve_POUNDERS(Tao tao)
   for (i=1;i<mfqP->n+1;i++) {
     ierr = VecCopy(tao->solution,mfqP->Xhist[i]);CHKERRQ(ierr);
     if (i-1 >= low && i-1 < high) {
-      ierr = VecGetArray(mfqP->Xhist[i],&x);CHKERRQ(ierr);
-      x[i-1-low] += mfqP->delta;
-      ierr = VecRestoreArray(mfqP->Xhist[i],&x);CHKERRQ(ierr);
+      ierr = VecGetArray(mfqP->Xhist[i],&xp);CHKERRQ(ierr);
+      xp[i-1-low] += mfqP->delta;
+      ierr = VecRestoreArray(mfqP->Xhist[i],&xp);CHKERRQ(ierr);
     }
-    CHKMEMQ;
-    ierr = pounders_feval(tao,mfqP->Xhist[i],mfqP->Fhist[i],&mfqP->Fres[i]);CHKERRQ(ierr);
+  }
+  CHKMEMQ;
+  ierr = pounders_feval_multiple(tao,mfqP->n,&mfqP->Xhist[1],&mfqP->Fhist[1],&mfqP->Fres[1]);CHKERRQ(ierr);
+  for (i=1;i<mfqP->n+1;i++) {
     if (mfqP->Fres[i] < minnorm) {
       mfqP->minindex = i;
       minnorm = mfqP->Fres[i];
@@ -721,67 +791,30 @@ static PetscErrorCode TaoSolve_POUNDERS(Tao tao)
   /* (Column oriented for blas calls) */
   ii=0;
 
-  if (mfqP->size == 1) {
-    ierr = VecGetArrayRead(mfqP->Xhist[mfqP->minindex],&xmint);CHKERRQ(ierr);
-    for (i=0;i<mfqP->n;i++) mfqP->xmin[i] = xmint[i];
-    ierr = VecRestoreArrayRead(mfqP->Xhist[mfqP->minindex],&xmint);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(mfqP->Fhist[mfqP->minindex],&fmin);CHKERRQ(ierr);
-    for (i=0;i<mfqP->n+1;i++) {
-      if (i == mfqP->minindex) continue;
-
-      ierr = VecGetArray(mfqP->Xhist[i],&x);CHKERRQ(ierr);
-      for (j=0;j<mfqP->n;j++) {
-        mfqP->Disp[ii+mfqP->npmax*j] = (x[j] - mfqP->xmin[j])/mfqP->delta;
-      }
-      ierr = VecRestoreArray(mfqP->Xhist[i],&x);CHKERRQ(ierr);
-
-      ierr = VecGetArray(mfqP->Fhist[i],&f);CHKERRQ(ierr);
-      for (j=0;j<mfqP->m;j++) {
-        mfqP->Fdiff[ii+mfqP->n*j] = f[j] - fmin[j];
-      }
-      ierr = VecRestoreArray(mfqP->Fhist[i],&f);CHKERRQ(ierr);
-      mfqP->model_indices[ii++] = i;
+  ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[mfqP->minindex],mfqP->localxmin,&xmint);CHKERRQ(ierr);
+  for (i=0;i<mfqP->n;i++) mfqP->xmin[i] = xmint[i];
+  ierr = pounders_restorearray(mfqP,mfqP->Xhist[mfqP->minindex],mfqP->localxmin,&xmint);CHKERRQ(ierr);
+  ierr = pounders_getarray(mfqP,mfqP->scatterf,mfqP->Fhist[mfqP->minindex],mfqP->localfmin,&fmin);CHKERRQ(ierr);
+  for (i=0;i<mfqP->n+1;i++) {
+    if (i == mfqP->minindex) continue;
 
+    ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[i],mfqP->localx,&x);CHKERRQ(ierr);
+    for (j=0;j<mfqP->n;j++) {
+      mfqP->Disp[ii+mfqP->npmax*j] = (x[j] - mfqP->xmin[j])/mfqP->delta;
     }
-    for (j=0;j<mfqP->m;j++) {
-      mfqP->C[j] = fmin[j];
-    }
-    ierr = VecRestoreArrayRead(mfqP->Fhist[mfqP->minindex],&fmin);CHKERRQ(ierr);
-  } else {
-    ierr = VecScatterBegin(mfqP->scatterx,mfqP->Xhist[mfqP->minindex],mfqP->localxmin,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(mfqP->scatterx,mfqP->Xhist[mfqP->minindex],mfqP->localxmin,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(mfqP->localxmin,&xmint);CHKERRQ(ierr);
-    for (i=0;i<mfqP->n;i++) mfqP->xmin[i] = xmint[i];
-    ierr = VecRestoreArrayRead(mfqP->localxmin,&xmint);CHKERRQ(ierr);
-
-    ierr = VecScatterBegin(mfqP->scatterf,mfqP->Fhist[mfqP->minindex],mfqP->localfmin,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecScatterEnd(mfqP->scatterf,mfqP->Fhist[mfqP->minindex],mfqP->localfmin,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(mfqP->localfmin,&fmin);CHKERRQ(ierr);
-    for (i=0;i<mfqP->n+1;i++) {
-      if (i == mfqP->minindex) continue;
-
-      mfqP->model_indices[ii++] = i;
-      ierr = VecScatterBegin(mfqP->scatterx,mfqP->Xhist[ii],mfqP->localx,INSERT_VALUES, SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecScatterEnd(mfqP->scatterx,mfqP->Xhist[ii],mfqP->localx,INSERT_VALUES, SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecGetArray(mfqP->localx,&x);CHKERRQ(ierr);
-      for (j=0;j<mfqP->n;j++) {
-        mfqP->Disp[i+mfqP->npmax*j] = (x[j] - mfqP->xmin[j])/mfqP->delta;
-      }
-      ierr = VecRestoreArray(mfqP->localx,&x);CHKERRQ(ierr);
+    ierr = pounders_restorearray(mfqP,mfqP->Xhist[i],mfqP->localx,&x);CHKERRQ(ierr);
 
-      ierr = VecScatterBegin(mfqP->scatterf,mfqP->Fhist[ii],mfqP->localf,INSERT_VALUES, SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecScatterEnd(mfqP->scatterf,mfqP->Fhist[ii],mfqP->localf,INSERT_VALUES, SCATTER_FORWARD);CHKERRQ(ierr);
-      ierr = VecGetArray(mfqP->localf,&f);CHKERRQ(ierr);
-      for (j=0;j<mfqP->m;j++) {
-        mfqP->Fdiff[i*mfqP->n+j] = f[j] - fmin[j];
-      }
-      ierr = VecRestoreArray(mfqP->localf,&f);CHKERRQ(ierr);
-    }
+    ierr = pounders_getarray(mfqP,mfqP->scatterf,mfqP->Fhist[i],mfqP->localf,&f);CHKERRQ(ierr);
     for (j=0;j<mfqP->m;j++) {
-      mfqP->C[j] = fmin[j];
+      mfqP->Fdiff[ii+mfqP->n*j] = f[j] - fmin[j];
     }
-    ierr = VecRestoreArrayRead(mfqP->localfmin,&fmin);CHKERRQ(ierr);
+    ierr = pounders_restorearray(mfqP,mfqP->Fhist[i],mfqP->localf,&f);CHKERRQ(ierr);
+    mfqP->model_indices[ii++] = i;
+  }
+  for (j=0;j<mfqP->m;j++) {
+    mfqP->C[j] = fmin[j];
   }
+  ierr = pounders_restorearray(mfqP,mfqP->Fhist[mfqP->minindex],mfqP->localfmin,&fmin);CHKERRQ(ierr);
 
   /* Determine the initial quadratic models */
   /* G = D(ModelIn,:) \ (F(ModelIn,1:m)-repmat(F(xkin,1:m),n,1)); */
@@ -858,11 +891,11 @@ static PetscErrorCode TaoSolve_POUNDERS(Tao tao)
       minnorm = mfqP->Fres[mfqP->minindex];
       ierr = VecCopy(mfqP->Fhist[mfqP->minindex],tao->sep_objective);CHKERRQ(ierr);
       /* Change current center */
-      ierr = VecGetArrayRead(mfqP->Xhist[mfqP->minindex],&xmint);CHKERRQ(ierr);
+      ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[mfqP->minindex],mfqP->localxmin,&xmint);CHKERRQ(ierr);
       for (i=0;i<mfqP->n;i++) {
         mfqP->xmin[i] = xmint[i];
       }
-      ierr = VecRestoreArrayRead(mfqP->Xhist[mfqP->minindex],&xmint);CHKERRQ(ierr);
+      ierr = pounders_restorearray(mfqP,mfqP->Xhist[mfqP->minindex],mfqP->localxmin,&xmint);CHKERRQ(ierr);
     }
 
     /* Evaluate at a model-improving point if necessary */
@@ -910,12 +943,12 @@ static PetscErrorCode TaoSolve_POUNDERS(Tao tao)
     mfqP->model_indices[0] = mfqP->minindex;
     ierr = morepoints(mfqP);CHKERRQ(ierr);
     for (i=0;i<mfqP->nmodelpoints;i++) {
-      ierr = VecGetArray(mfqP->Xhist[mfqP->model_indices[i]],&x);CHKERRQ(ierr);
+      ierr = pounders_getarray(mfqP,mfqP->scatterx,mfqP->Xhist[mfqP->model_indices[i]],mfqP->localx,&x);CHKERRQ(ierr);
       for (j=0;j<mfqP->n;j++) {
         mfqP->Disp[i + mfqP->npmax*j] = (x[j]  - mfqP->xmin[j]) / deltaold;
       }
-      ierr = VecRestoreArray(mfqP->Xhist[mfqP->model_indices[i]],&x);CHKERRQ(ierr);
-      ierr = VecGetArray(mfqP->Fhist[mfqP->model_indices[i]],&f);CHKERRQ(ierr);
+      ierr = pounders_restorearray(mfqP,mfqP->Xhist[mfqP->model_indices[i]],mfqP->localx,&x);CHKERRQ(ierr);
+      ierr = pounders_getarray(mfqP,mfqP->scatterf,mfqP->Fhist[mfqP->model_indices[i]],mfqP->localf,&f);CHKERRQ(ierr);
       for (j=0;j<mfqP->m;j++) {
         for (k=0;k<mfqP->n;k++)  {
           mfqP->work[k]=0.0;
@@ -925,13 +958,14 @@ static PetscErrorCode TaoSolve_POUNDERS(Tao tao)
         }
         mfqP->RES[j*mfqP->npmax + i] = -mfqP->C[j] - BLASdot_(&blasn,&mfqP->Fdiff[j*mfqP->n],&ione,&mfqP->Disp[i],&blasnpmax) - 0.5*BLASdot_(&blasn,mfqP->work,&ione,&mfqP->Disp[i],&blasnpmax) + f[j];
       }
-      ierr = VecRestoreArray(mfqP->Fhist[mfqP->model_indices[i]],&f);CHKERRQ(ierr);
+      ierr = pounders_restorearray(mfqP,mfqP->Fhist[mfqP->model_indices[i]],mfqP->localf,&f);CHKERRQ(ierr);
     }
 
     /* Update the quadratic model */
     ierr = getquadpounders(mfqP);CHKERRQ(ierr);
-    ierr = VecGetArrayRead(mfqP->Fhist[mfqP->minindex],&fmin);CHKERRQ(ierr);
+    ierr = pounders_getarray(mfqP,mfqP->scatterf,mfqP->Fhist[mfqP->minindex],mfqP->localfmin,&fmin);CHKERRQ(ierr);
     PetscStackCallBLAS("BLAScopy",BLAScopy_(&blasm,fmin,&ione,mfqP->C,&ione));
+    ierr = pounders_restorearray(mfqP,mfqP->Fhist[mfqP->minindex],mfqP->localfmin,&fmin);CHKERRQ(ierr);
     /* G = G*(delta/deltaold) + Gdel */
     ratio = mfqP->delta/deltaold;
     iblas = blasm*blasn;
@@ -0,0 +1,100 @@
+
+static char help[] = "Fits a linear model to many samples with the stochastic gradient methods of TAOSGD.\n\
+  Minimizes 1/N sum_i (a_i^T x - b_i)^2 / 2 where the samples a_i, b_i are computed by the process owning them.\n\
+  -nvars <n>    : number of parameters\n\
+  -nsamples <N> : number of samples\n\n";
+
+/*T
+   Concepts: TAO^Solving an unconstrained minimization problem with mini-batch gradients
+   Routines: TaoCreate(); TaoSetType(); TaoSetBatchObjectiveAndGradientRoutine();
+   Routines: TaoSetInitialVector(); TaoSetFromOptions(); TaoSolve(); TaoDestroy();
+   Processors: n
+T*/
+
+#include <petsctao.h>
+
+typedef struct {
+  PetscInt nvars;
+} AppCtx;
+
+/* the sample i, with the exact parameters x_j = 1/(j+1) so that the model fits all the samples */
+static void Sample(AppCtx *user,PetscInt i,PetscReal a[],PetscReal *b)
+{
+  PetscInt j;
+
+  *b = 0.0;
+  for (j=0; j<user->nvars; j++) {
+    a[j] = PetscSinReal(0.7*i*(j+1) + 1.3*j*j + 0.1*i);
+    *b  += a[j]/(j+1);
+  }
+}
+
+static PetscErrorCode FormBatchFunctionGradient(Tao tao,Vec X,PetscInt n,const PetscInt samples[],PetscReal *f,Vec G,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  const PetscScalar *x;
+  PetscScalar       *g;
+  PetscReal         *a,b,r;
+  PetscInt          i,j;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscMalloc1(user->nvars,&a);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(G,&g);CHKERRQ(ierr);
+  *f   = 0.0;
+  for (j=0; j<user->nvars; j++) g[j] = 0.0;
+  for (i=0; i<n; i++) {
+    Sample(user,samples[i],a,&b);
+    r = -b;
+    for (j=0; j<user->nvars; j++) r += a[j]*PetscRealPart(x[j]);
+    *f += 0.5*r*r;
+    for (j=0; j<user->nvars; j++) g[j] += r*a[j];
+  }
+  ierr = VecRestoreArray(G,&g);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = PetscFree(a);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*n*user->nvars);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Tao            tao;
+  Vec            x;
+  AppCtx         user;
+  PetscScalar    *xa;
+  PetscReal      f,err;
+  PetscInt       i,its,lo,hi,nsamples = 2000;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  user.nvars = 8;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nvars",&user.nvars,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsamples",&nsamples,NULL);CHKERRQ(ierr);
+
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,PETSC_DECIDE,user.nvars,&x);CHKERRQ(ierr);
+  ierr = VecZeroEntries(x);CHKERRQ(ierr);
+
+  ierr = TaoCreate(PETSC_COMM_WORLD,&tao);CHKERRQ(ierr);
+  ierr = TaoSetType(tao,TAOSGD);CHKERRQ(ierr);
+  ierr = TaoSetBatchObjectiveAndGradientRoutine(tao,PETSC_DECIDE,nsamples,FormBatchFunctionGradient,&user);CHKERRQ(ierr);
+  ierr = TaoSetInitialVector(tao,x);CHKERRQ(ierr);
+  ierr = TaoSetFromOptions(tao);CHKERRQ(ierr);
+  ierr = TaoSolve(tao);CHKERRQ(ierr);
+  ierr = TaoGetSolutionStatus(tao,&its,&f,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Iterations %D, objective %s 1e-12\n",its,f < 1.e-12 ? "below" : "above");CHKERRQ(ierr);
+
+  /* compare with the exact parameters */
+  ierr = VecGetOwnershipRange(x,&lo,&hi);CHKERRQ(ierr);
+  ierr = VecGetArray(x,&xa);CHKERRQ(ierr);
+  for (i=lo; i<hi; i++) xa[i-lo] -= 1.0/(i+1);
+  ierr = VecRestoreArray(x,&xa);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in the parameters %s 1e-4\n",err < 1.e-4 ? "below" : "above");CHKERRQ(ierr);
+
+  ierr = TaoDestroy(&tao);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,305 @@
+#include <../src/tao/unconstrained/impls/sgd/sgd.h>
+
+#define SGD_Momentum 0
+#define SGD_Adam     1
+#define SGD_SVRG     2
+#define SGD_Types    3
+
+static const char *SGD_Table[64] = {"momentum", "adam", "svrg"};
+
+/* shuffles the samples of this process for the next pass over them */
+static PetscErrorCode TaoSGDShuffle(Tao tao)
+{
+  TAO_SGD        *sgd = (TAO_SGD*)tao->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j,t;
+  PetscReal      r;
+
+  PetscFunctionBegin;
+  for (i=tao->nsamples_local-1; i>0; i--) {
+    ierr = PetscRandomGetValueReal(sgd->rand,&r);CHKERRQ(ierr);
+    j = PetscMin((PetscInt)(r*(i+1)),i);
+    t = sgd->perm[i]; sgd->perm[i] = sgd->perm[j]; sgd->perm[j] = t;
+  }
+  sgd->pos = 0;
+  PetscFunctionReturn(0);
+}
+
+/* the mean of the objective terms and of their gradients, in sgd->G, over n samples of which this process has nlocal;
+   the contributions of all processes are summed with a single reduction */
+static PetscErrorCode TaoSGDMean(Tao tao,PetscInt nlocal,const PetscInt samples[],PetscInt n,PetscBool variance,PetscReal *f)
+{
+  TAO_SGD        *sgd = (TAO_SGD*)tao->data;
+  PetscErrorCode ierr;
+  PetscInt       nvars;
+  PetscReal      fl,fsnap;
+
+  PetscFunctionBegin;
+  ierr = VecGetSize(sgd->X,&nvars);CHKERRQ(ierr);
+  ierr = TaoComputeBatchObjectiveAndGradient(tao,sgd->X,nlocal,samples,&fl,sgd->Gsend);CHKERRQ(ierr);
+  if (variance) {
+    /* SVRG: the gradient at the snapshot of the same samples is subtracted */
+    ierr = TaoComputeBatchObjectiveAndGradient(tao,sgd->Xsnap,nlocal,samples,&fsnap,sgd->W);CHKERRQ(ierr);
+    ierr = VecAXPY(sgd->Gsend,-1.0,sgd->W);CHKERRQ(ierr);
+  }
+  sgd->sendbuf[nvars] = fl;
+  ierr = MPIU_Allreduce(sgd->sendbuf,sgd->recvbuf,nvars+1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)tao));CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)sgd->G);CHKERRQ(ierr);
+  *f   = PetscRealPart(sgd->recvbuf[nvars])/n;
+  ierr = VecScale(sgd->G,1.0/n);CHKERRQ(ierr);
+  if (variance) {
+    ierr = VecAXPY(sgd->G,1.0,sgd->Mu);CHKERRQ(ierr);
+  }
+  tao->nfuncgrads++;
+  sgd->npasses += (PetscReal)n/tao->nsamples;
+  PetscFunctionReturn(0);
+}
+
+/* copies the local part of a vector with all the variables into a vector distributed like the solution */
+static PetscErrorCode TaoSGDCopyLocal(Vec Xall,Vec X)
+{
+  PetscErrorCode    ierr;
+  const PetscScalar *xall;
+  PetscScalar       *x;
+  PetscInt          lo,hi;
+
+  PetscFunctionBegin;
+  ierr = VecGetOwnershipRange(X,&lo,&hi);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(Xall,&xall);CHKERRQ(ierr);
+  ierr = VecGetArray(X,&x);CHKERRQ(ierr);
+  ierr = PetscMemcpy(x,xall+lo,(hi-lo)*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = VecRestoreArray(X,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(Xall,&xall);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TaoSolve_SGD(Tao tao)
+{
+  TAO_SGD            *sgd = (TAO_SGD*)tao->data;
+  PetscErrorCode     ierr;
+  TaoConvergedReason reason = TAO_CONTINUE_ITERATING;
+  PetscInt           i,nvars,batch,nlocal,svrg_steps;
+  PetscInt64         rstart = tao->sample_start,rend = tao->sample_start+tao->nsamples_local;
+  PetscReal          f,fsnap,gnorm,c1,c2;
+  PetscScalar        *x,*m,*v;
+  const PetscScalar  *g;
+
+  PetscFunctionBegin;
+  if (tao->XL || tao->XU || tao->ops->computebounds) {
+    ierr = PetscPrintf(((PetscObject)tao)->comm,"WARNING: Variable bounds have been set but will be ignored by sgd algorithm\n");CHKERRQ(ierr);
+  }
+  ierr = VecScatterBegin(sgd->toall,tao->solution,sgd->X,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd(sgd->toall,tao->solution,sgd->X,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecGetSize(sgd->X,&nvars);CHKERRQ(ierr);
+  ierr = VecZeroEntries(sgd->V);CHKERRQ(ierr);
+  if (sgd->W) {ierr = VecZeroEntries(sgd->W);CHKERRQ(ierr);}
+  ierr = TaoSGDShuffle(tao);CHKERRQ(ierr);
+  sgd->npasses = 0.0;
+
+  /* the mini-batch is split between the processes in proportion to their numbers of samples */
+  batch  = PetscMin(sgd->batchsize,tao->nsamples);
+  nlocal = (PetscInt)((batch*rend)/tao->nsamples - (batch*rstart)/tao->nsamples);
+  svrg_steps = sgd->svrg_steps > 0 ? sgd->svrg_steps : PetscMax(tao->nsamples/batch,1);
+  sgd->nsteps = svrg_steps;
+
+  while (1) {
+    if (sgd->sgd_type == SGD_SVRG && sgd->nsteps == svrg_steps) {
+      ierr = VecCopy(sgd->X,sgd->Xsnap);CHKERRQ(ierr);
+      ierr = TaoSGDMean(tao,tao->nsamples_local,sgd->samples,tao->nsamples,PETSC_FALSE,&fsnap);CHKERRQ(ierr);
+      ierr = VecCopy(sgd->G,sgd->Mu);CHKERRQ(ierr);
+      ierr = PetscInfo1(tao,"SVRG snapshot, objective %g\n",(double)fsnap);CHKERRQ(ierr);
+      sgd->nsteps = 0;
+    }
+    if (sgd->pos+nlocal > tao->nsamples_local) {ierr = TaoSGDShuffle(tao);CHKERRQ(ierr);}
+    ierr = TaoSGDMean(tao,nlocal,sgd->perm+sgd->pos,batch,(PetscBool)(sgd->sgd_type == SGD_SVRG),&f);CHKERRQ(ierr);
+    sgd->pos += nlocal;
+    ierr = VecNorm(sgd->G,NORM_2,&gnorm);CHKERRQ(ierr);
+    if (PetscIsInfOrNanReal(f) || PetscIsInfOrNanReal(gnorm)) SETERRQ(PETSC_COMM_SELF,1,"User provided compute function generated Inf or NaN");
+
+    ierr = TaoSGDCopyLocal(sgd->X,tao->solution);CHKERRQ(ierr);
+    ierr = TaoSGDCopyLocal(sgd->G,tao->gradient);CHKERRQ(ierr);
+    ierr = TaoMonitor(tao,tao->niter,f,gnorm,0.0,sgd->lr,&reason);CHKERRQ(ierr);
+    if (reason != TAO_CONTINUE_ITERATING) break;
+
+    /* every process makes the same update of its copy of the variables */
+    switch (sgd->sgd_type) {
+    case SGD_Momentum:
+      ierr = VecAXPBY(sgd->V,-sgd->lr,sgd->momentum,sgd->G);CHKERRQ(ierr);
+      ierr = VecAXPY(sgd->X,1.0,sgd->V);CHKERRQ(ierr);
+      break;
+
+    case SGD_Adam:
+      c1   = 1.0 - PetscPowRealInt(sgd->beta1,tao->niter+1);
+      c2   = 1.0 - PetscPowRealInt(sgd->beta2,tao->niter+1);
+      ierr = VecGetArray(sgd->X,&x);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(sgd->G,&g);CHKERRQ(ierr);
+      ierr = VecGetArray(sgd->V,&m);CHKERRQ(ierr);
+      ierr = VecGetArray(sgd->W,&v);CHKERRQ(ierr);
+      for (i=0; i<nvars; i++) {
+        m[i]  = sgd->beta1*m[i] + (1.0-sgd->beta1)*g[i];
+        v[i]  = sgd->beta2*v[i] + (1.0-sgd->beta2)*g[i]*g[i];
+        x[i] -= sgd->lr*(m[i]/c1)/(PetscSqrtReal(PetscRealPart(v[i])/c2) + sgd->epsilon);
+      }
+      ierr = VecRestoreArray(sgd->W,&v);CHKERRQ(ierr);
+      ierr = VecRestoreArray(sgd->V,&m);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(sgd->G,&g);CHKERRQ(ierr);
+      ierr = VecRestoreArray(sgd->X,&x);CHKERRQ(ierr);
+      ierr = PetscObjectStateIncrease((PetscObject)sgd->X);CHKERRQ(ierr);
+      ierr = PetscLogFlops(13.0*nvars);CHKERRQ(ierr);
+      break;
+
+    case SGD_SVRG:
+      ierr = VecAXPY(sgd->X,-sgd->lr,sgd->G);CHKERRQ(ierr);
+      sgd->nsteps++;
+      break;
+    }
+    tao->niter++;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TaoSetUp_SGD(Tao tao)
+{
+  TAO_SGD        *sgd = (TAO_SGD*)tao->data;
+  PetscErrorCode ierr;
+  PetscInt       i,nvars;
+
+  PetscFunctionBegin;
+  if (!tao->ops->computebatchobjectiveandgradient) SETERRQ(PetscObjectComm((PetscObject)tao),PETSC_ERR_ARG_WRONGSTATE,"TAOSGD requires TaoSetBatchObjectiveAndGradientRoutine()");
+  if (tao->nsamples < 1) SETERRQ1(PetscObjectComm((PetscObject)tao),PETSC_ERR_ARG_OUTOFRANGE,"Number of samples %D must be positive",tao->nsamples);
+  if (sgd->batchsize < 1) SETERRQ1(PetscObjectComm((PetscObject)tao),PETSC_ERR_ARG_OUTOFRANGE,"Mini-batch size %D must be positive",sgd->batchsize);
+  if (!tao->gradient) {ierr = VecDuplicate(tao->solution,&tao->gradient);CHKERRQ(ierr);}
+  ierr = VecScatterCreateToAll(tao->solution,&sgd->toall,&sgd->X);CHKERRQ(ierr);
+  ierr = VecGetSize(sgd->X,&nvars);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nvars+1,&sgd->recvbuf,nvars+1,&sgd->sendbuf);CHKERRQ(ierr);
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF,1,nvars,sgd->recvbuf,&sgd->G);CHKERRQ(ierr);
+  ierr = VecCreateSeqWithArray(PETSC_COMM_SELF,1,nvars,sgd->sendbuf,&sgd->Gsend);CHKERRQ(ierr);
+  ierr = VecDuplicate(sgd->X,&sgd->V);CHKERRQ(ierr);
+  if (sgd->sgd_type == SGD_Adam || sgd->sgd_type == SGD_SVRG) {ierr = VecDuplicate(sgd->X,&sgd->W);CHKERRQ(ierr);}
+  if (sgd->sgd_type == SGD_SVRG) {
+    ierr = VecDuplicate(sgd->X,&sgd->Xsnap);CHKERRQ(ierr);
+    ierr = VecDuplicate(sgd->X,&sgd->Mu);CHKERRQ(ierr);
+  }
+  ierr = PetscMalloc2(tao->nsamples_local,&sgd->perm,tao->nsamples_local,&sgd->samples);CHKERRQ(ierr);
+  for (i=0; i<tao->nsamples_local; i++) sgd->perm[i] = sgd->samples[i] = tao->sample_start+i;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TaoDestroy_SGD(Tao tao)
+{
+  TAO_SGD        *sgd = (TAO_SGD*)tao->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (tao->setupcalled) {
+    ierr = VecScatterDestroy(&sgd->toall);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->X);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->G);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->Gsend);CHKERRQ(ierr);
+    ierr = PetscFree2(sgd->recvbuf,sgd->sendbuf);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->V);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->W);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->Xsnap);CHKERRQ(ierr);
+    ierr = VecDestroy(&sgd->Mu);CHKERRQ(ierr);
+    ierr = PetscFree2(sgd->perm,sgd->samples);CHKERRQ(ierr);
+  }
+  ierr = PetscRandomDestroy(&sgd->rand);CHKERRQ(ierr);
+  ierr = PetscFree(tao->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TaoSetFromOptions_SGD(PetscOptionItems *PetscOptionsObject,Tao tao)
+{
+  TAO_SGD        *sgd = (TAO_SGD*)tao->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"Stochastic mini-batch gradient methods for unconstrained optimization");CHKERRQ(ierr);
+  ierr = PetscOptionsEList("-tao_sgd_type","update formula","",SGD_Table,SGD_Types,SGD_Table[sgd->sgd_type],&sgd->sgd_type,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-tao_sgd_batch_size","number of samples of a mini-batch","",sgd->batchsize,&sgd->batchsize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tao_sgd_learning_rate","learning rate","",sgd->lr,&sgd->lr,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tao_sgd_momentum","momentum of the momentum method","",sgd->momentum,&sgd->momentum,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tao_sgd_adam_beta1","decay rate of the first moment of Adam","",sgd->beta1,&sgd->beta1,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tao_sgd_adam_beta2","decay rate of the second moment of Adam","",sgd->beta2,&sgd->beta2,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-tao_sgd_adam_epsilon","regularization of the Adam step","",sgd->epsilon,&sgd->epsilon,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-tao_sgd_svrg_steps","steps between full gradients of SVRG, 0 for one pass over the samples","",sgd->svrg_steps,&sgd->svrg_steps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(sgd->rand);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TaoView_SGD(Tao tao, PetscViewer viewer)
+{
+  TAO_SGD        *sgd = (TAO_SGD*)tao->data;
+  PetscBool      isascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &isascii);CHKERRQ(ierr);
+  if (isascii) {
+    ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer, "SGD Type: %s\n", SGD_Table[sgd->sgd_type]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer, "Mini-batch size: %D of %D samples, learning rate %g\n", PetscMin(sgd->batchsize,tao->nsamples), tao->nsamples, (double)sgd->lr);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer, "Passes over the samples: %g\n", (double)sgd->npasses);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     TAOSGD - Stochastic gradient methods for objective functions that are a sum over many samples, each step uses
+     the gradient of a random mini-batch of samples.
+
+   Options Database Keys:
++      -tao_sgd_type <momentum,adam,svrg> - update formula
+.      -tao_sgd_batch_size <n> - number of samples of a mini-batch
+.      -tao_sgd_learning_rate <r> - learning rate
+.      -tao_sgd_momentum <r> - momentum of the momentum method, 0 for plain stochastic gradient descent
+.      -tao_sgd_adam_beta1 <r> - decay rate of the first moment of Adam
+.      -tao_sgd_adam_beta2 <r> - decay rate of the second moment of Adam
+.      -tao_sgd_adam_epsilon <r> - regularization of the Adam step
+-      -tao_sgd_svrg_steps <n> - steps between full gradients of SVRG, 0 for one pass over the samples
+
+  Notes:
+     The objective function is set with TaoSetBatchObjectiveAndGradientRoutine(). Each process evaluates its share of
+     the mini-batch, drawn from its own samples, and the gradient is summed over the processes with a single reduction
+     per step. Every process then makes the same update of its copy of the variables.
+
+     The update formulas are:
+         "momentum" - stochastic gradient descent with heavy ball momentum
+         "adam" - Adam, with bias corrected moments
+         "svrg" - stochastic variance reduced gradient, the mini-batch gradient is corrected with the full gradient
+                  at a snapshot that is refreshed periodically
+
+     The objective value and gradient norm given to the monitors and convergence test are the ones of the mini-batch.
+  Level: beginner
+M*/
+
+PETSC_EXTERN PetscErrorCode TaoCreate_SGD(Tao tao)
+{
+  TAO_SGD        *sgd;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  tao->ops->setup = TaoSetUp_SGD;
+  tao->ops->solve = TaoSolve_SGD;
+  tao->ops->view = TaoView_SGD;
+  tao->ops->setfromoptions = TaoSetFromOptions_SGD;
+  tao->ops->destroy = TaoDestroy_SGD;
+
+  /* Override default settings (unless already changed) */
+  if (!tao->max_it_changed) tao->max_it = 10000;
+  if (!tao->max_funcs_changed) tao->max_funcs = 100000;
+
+  ierr = PetscNewLog(tao,&sgd);CHKERRQ(ierr);
+  tao->data = (void*)sgd;
+  sgd->sgd_type  = SGD_Momentum;
+  sgd->batchsize = 32;
+  sgd->lr        = 0.01;
+  sgd->momentum  = 0.9;
+  sgd->beta1     = 0.9;
+  sgd->beta2     = 0.999;
+  sgd->epsilon   = 1.e-8;
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&sgd->rand);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
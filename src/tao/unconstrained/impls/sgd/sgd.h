@@ -0,0 +1,35 @@
+/*
+    Context for stochastic mini-batch gradient methods (unconstrained minimization)
+ */
+
+#ifndef __TAO_SGD_H
+#define __TAO_SGD_H
+
+#include <petsc/private/taoimpl.h>
+
+typedef struct {
+  PetscInt    sgd_type;     /* update formula */
+  PetscInt    batchsize;    /* number of samples of a mini-batch, over all processes */
+  PetscReal   lr;           /* learning rate */
+  PetscReal   momentum;
+  PetscReal   beta1,beta2;  /* decay rates of the moments of Adam */
+  PetscReal   epsilon;
+  PetscInt    svrg_steps;   /* steps between the full gradients of SVRG, 0 for one pass over the samples */
+
+  /* every process has all the variables and updates them redundantly with the reduced mini-batch gradient */
+  VecScatter  toall;
+  Vec         X;
+  Vec         G,Gsend;      /* reduced mini-batch gradient and the contribution of this process */
+  PetscScalar *recvbuf,*sendbuf; /* arrays of G and Gsend, followed by the objective */
+  Vec         V,W;          /* velocity or first moment, and second moment */
+  Vec         Xsnap,Mu;     /* SVRG snapshot and its full gradient */
+
+  PetscInt    *perm;        /* samples of this process in random order, the next mini-batch starts at pos */
+  PetscInt    *samples;     /* samples of this process in order */
+  PetscInt    pos;
+  PetscRandom rand;
+  PetscInt    nsteps;       /* number of steps since the last SVRG snapshot */
+  PetscReal   npasses;      /* number of passes over the samples */
+} TAO_SGD;
+
+#endif /* ifndef __TAO_SGD_H */
@@ -0,0 +1,128 @@
+
+static char help[] = "Tests the time-parallel integration of a pendulum with TSPARAREAL.\n\n\
+Each process integrates a group of time slices of the whole state, so the test runs on any number of processes.\n\n";
+
+#include <petscts.h>
+
+typedef struct {
+  PetscInt  nmon;     /* number of calls of the monitor on this process */
+  PetscInt  lastmon;  /* step number of the last call */
+  PetscReal tmon;     /* time of the last call */
+} AppCtx;
+
+static PetscErrorCode RHSFunction(TS ts,PetscReal t,Vec X,Vec F,void *ctx)
+{
+  const PetscScalar *x;
+  PetscScalar       *f;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  f[0] = x[1];
+  f[1] = -PetscSinScalar(x[0]) - 0.1*x[1];
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Monitor(TS ts,PetscInt step,PetscReal t,Vec X,void *ctx)
+{
+  AppCtx *user = (AppCtx*)ctx;
+
+  PetscFunctionBeginUser;
+  user->nmon++;
+  user->lastmon = step;
+  user->tmon    = t;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Solve(TS ts,Vec X,PetscReal dt)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecSet(X,0.0);CHKERRQ(ierr);
+  ierr = VecSetValue(X,0,2.0,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(X);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(X);CHKERRQ(ierr);
+  ierr = TSSetTime(ts,0.0);CHKERRQ(ierr);
+  ierr = TSSetStepNumber(ts,0);CHKERRQ(ierr);
+  ierr = TSSetTimeStep(ts,dt);CHKERRQ(ierr);
+  ierr = TSSolve(ts,X);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  TS             ts,ref;
+  Vec            X,Xref,Y;
+  MPI_Comm       scomm,tcomm;
+  PetscMPIInt    rank;
+  PetscInt       its,steps,nmon,lastmon;
+  PetscReal      dt = 0.01,err,errmon,tmon;
+  AppCtx         user;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscMemzero(&user,sizeof(user));CHKERRQ(ierr);
+
+  /* every process holds the whole state, the time communicator connects all of them */
+  ierr = MPI_Comm_split(PETSC_COMM_WORLD,rank,0,&scomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_split(PETSC_COMM_WORLD,0,rank,&tcomm);CHKERRQ(ierr);
+
+  ierr = VecCreateSeq(scomm,2,&X);CHKERRQ(ierr);
+  ierr = VecDuplicate(X,&Xref);CHKERRQ(ierr);
+  ierr = VecDuplicate(X,&Y);CHKERRQ(ierr);
+
+  ierr = TSCreate(scomm,&ts);CHKERRQ(ierr);
+  ierr = TSSetType(ts,TSPARAREAL);CHKERRQ(ierr);
+  ierr = TSSetRHSFunction(ts,NULL,RHSFunction,NULL);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(ts,4.0);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(ts,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  ierr = TSMonitorSet(ts,Monitor,&user,NULL);CHKERRQ(ierr);
+  ierr = TSPararealSetTimeComm(ts,tcomm);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(ts);CHKERRQ(ierr);
+  ierr = Solve(ts,X,dt);CHKERRQ(ierr);
+  ierr = TSPararealGetIterationNumber(ts,&its);CHKERRQ(ierr);
+  ierr = TSGetStepNumber(ts,&steps);CHKERRQ(ierr);
+
+  /* the monitors must not change the solution */
+  ierr = TSMonitorCancel(ts);CHKERRQ(ierr);
+  ierr = Solve(ts,Y,dt);CHKERRQ(ierr);
+  ierr = VecAXPY(Y,-1.0,X);CHKERRQ(ierr);
+  ierr = VecNorm(Y,NORM_INFINITY,&errmon);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&errmon,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+
+  /* the same fine integrator over the whole interval */
+  ierr = TSCreate(scomm,&ref);CHKERRQ(ierr);
+  ierr = TSSetOptionsPrefix(ref,"parareal_fine_");CHKERRQ(ierr);
+  ierr = TSSetType(ref,TSRK);CHKERRQ(ierr);
+  ierr = TSSetRHSFunction(ref,NULL,RHSFunction,NULL);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(ref,4.0);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(ref,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(ref);CHKERRQ(ierr);
+  ierr = Solve(ref,Xref,dt);CHKERRQ(ierr);
+
+  ierr = VecAXPY(Xref,-1.0,X);CHKERRQ(ierr);
+  ierr = VecNorm(Xref,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&err,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&user.nmon,&nmon,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&user.lastmon,&lastmon,1,MPIU_INT,MPI_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&user.tmon,&tmon,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%D iterations, %D fine steps\n",its,steps);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Parareal and sequential solutions %s\n",err < 1.e-6 ? "agree" : "differ");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Monitor called %D times, last at step %D time %g\n",nmon,lastmon,(double)tmon);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Solutions with and without monitor %s\n",errmon == 0.0 ? "are identical" : "differ");CHKERRQ(ierr);
+
+  ierr = TSDestroy(&ref);CHKERRQ(ierr);
+  ierr = TSDestroy(&ts);CHKERRQ(ierr);
+  ierr = VecDestroy(&Xref);CHKERRQ(ierr);
+  ierr = VecDestroy(&Y);CHKERRQ(ierr);
+  ierr = VecDestroy(&X);CHKERRQ(ierr);
+  ierr = MPI_Comm_free(&tcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_free(&scomm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,150 @@
+
+static char help[] = "Tests TSENSEMBLE with an ensemble of Robertson chemical kinetics problems with different rates.\n\n\
+  -members <n> : total number of members\n\
+  -jac         : provide the Jacobian instead of differencing the right hand side\n\n";
+
+#include <petscts.h>
+
+typedef struct {
+  PetscInt  rstart;    /* global number of the first local member */
+  PetscInt  nbad;      /* number of member times outside of the current step of the TS */
+  PetscInt  nmembers;
+} AppCtx;
+
+PETSC_STATIC_INLINE PetscReal Rate(AppCtx *user,PetscInt m)
+{
+  return 0.04*(1.0 + (PetscReal)m/user->nmembers);
+}
+
+static PetscErrorCode RHSFunction(TS ts,PetscReal t,Vec X,Vec F,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  const PetscScalar *x;
+  PetscScalar       *f;
+  const PetscReal   *times;
+  PetscReal         dt;
+  PetscInt          m,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = TSEnsembleGetStageTimes(ts,&times);CHKERRQ(ierr);
+  ierr = TSGetTimeStep(ts,&dt);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  for (m=0; m<n/3; m++) {
+    const PetscScalar *y = x + 3*m;
+    PetscReal         k1 = Rate(user,user->rstart+m);
+    f[3*m]   = -k1*y[0] + 1.e4*y[1]*y[2];
+    f[3*m+1] =  k1*y[0] - 1.e4*y[1]*y[2] - 3.e7*y[1]*y[1];
+    f[3*m+2] =  3.e7*y[1]*y[1];
+    if (times[m] < t || times[m] > t + dt*(1.0 + PETSC_SMALL)) user->nbad++;
+  }
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode RHSJacobian(TS ts,PetscReal t,Vec X,Mat A,Mat B,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  const PetscScalar *y;
+  PetscScalar       v[9];
+  PetscInt          m,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&y);CHKERRQ(ierr);
+  for (m=0; m<n/3; m++,y+=3) {
+    PetscReal k1  = Rate(user,user->rstart+m);
+    PetscInt  row = user->rstart+m;
+    v[0] = -k1; v[1] = 1.e4*y[2];                   v[2] = 1.e4*y[1];
+    v[3] =  k1; v[4] = -1.e4*y[2] - 6.e7*y[1];      v[5] = -1.e4*y[1];
+    v[6] = 0.0; v[7] = 6.e7*y[1];                   v[8] = 0.0;
+    ierr = MatSetValuesBlocked(B,1,&row,1,&row,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(X,&y);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  if (A != B) {
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  TS                 ts;
+  Vec                X;
+  Mat                J = NULL;
+  AppCtx             user;
+  PetscInt           m,n,nlast,nmembers = 16;
+  PetscReal          err = 0.0,y[3];
+  PetscBool          jac = PETSC_FALSE;
+  const PetscScalar  *x;
+  PetscScalar        *xw;
+  PetscMPIInt        size,rank;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-members",&nmembers,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-jac",&jac,NULL);CHKERRQ(ierr);
+  ierr = PetscMemzero(&user,sizeof(user));CHKERRQ(ierr);
+  user.nmembers = nmembers;
+
+  ierr = VecCreate(PETSC_COMM_WORLD,&X);CHKERRQ(ierr);
+  ierr = VecSetSizes(X,PETSC_DECIDE,3*nmembers);CHKERRQ(ierr);
+  ierr = VecSetBlockSize(X,3);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(X);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(X,&user.rstart,NULL);CHKERRQ(ierr);
+  user.rstart /= 3;
+  ierr = VecGetArray(X,&xw);CHKERRQ(ierr);
+  for (m=0; m<n/3; m++) {
+    xw[3*m] = 1.0; xw[3*m+1] = 0.0; xw[3*m+2] = 0.0;
+  }
+  ierr = VecRestoreArray(X,&xw);CHKERRQ(ierr);
+
+  ierr = TSCreate(PETSC_COMM_WORLD,&ts);CHKERRQ(ierr);
+  ierr = TSSetType(ts,TSENSEMBLE);CHKERRQ(ierr);
+  ierr = TSSetRHSFunction(ts,NULL,RHSFunction,&user);CHKERRQ(ierr);
+  if (jac) {
+    ierr = MatCreateBAIJ(PETSC_COMM_WORLD,3,n,n,PETSC_DETERMINE,PETSC_DETERMINE,1,NULL,0,NULL,&J);CHKERRQ(ierr);
+    ierr = TSSetRHSJacobian(ts,J,J,RHSJacobian,&user);CHKERRQ(ierr);
+  }
+  ierr = TSSetTime(ts,0.0);CHKERRQ(ierr);
+  ierr = TSSetTimeStep(ts,10.0);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(ts,40.0);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(ts,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  ierr = TSSetTolerances(ts,1.e-10,NULL,1.e-6,NULL);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(ts);CHKERRQ(ierr);
+  ierr = TSSolve(ts,X);CHKERRQ(ierr);
+
+  /* the total concentration is conserved */
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  for (m=0; m<n/3; m++) err = PetscMax(err,PetscAbsScalar(x[3*m] + x[3*m+1] + x[3*m+2] - 1.0));
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&err,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&user.nbad,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Total concentration %s conserved\n",err < 1.e-8 ? "is" : "is not");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Member times %s within the steps of the TS\n",user.nbad ? "are not" : "are");CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Member 0: %.4f %.4f %.4f\n",(double)PetscRealPart(x[0]),(double)(1.e5*PetscRealPart(x[1])),(double)PetscRealPart(x[2]));CHKERRQ(ierr);
+  }
+  if (rank == size-1) {
+    nlast = n/3-1;
+    y[0]  = PetscRealPart(x[3*nlast]); y[1] = 1.e5*PetscRealPart(x[3*nlast+1]); y[2] = PetscRealPart(x[3*nlast+2]);
+  }
+  ierr = MPI_Bcast(y,3,MPIU_REAL,size-1,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Member %D: %.4f %.4f %.4f\n",nmembers-1,(double)y[0],(double)y[1],(double)y[2]);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  ierr = TSDestroy(&ts);CHKERRQ(ierr);
+  ierr = VecDestroy(&X);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
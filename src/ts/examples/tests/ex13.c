@@ -0,0 +1,170 @@
+
+static char help[] = "Tests the exponential Rosenbrock methods of TSEXPRB with a stiff semilinear heat equation.\n\n\
+  u_t = u_xx - u^2 + g(t,x) on (0,1) with u = 0 on the boundary, g is chosen so that u = sin(pi x) cos(t).\n\
+  -mx <n>   : number of grid points\n\
+  -ifunc    : give the problem as an implicit function\n\n";
+
+#include <petscts.h>
+#include <petscdm.h>
+#include <petscdmda.h>
+
+typedef struct {
+  DM da;
+} AppCtx;
+
+static PetscReal Exact(PetscReal t,PetscReal x)
+{
+  return PetscSinReal(PETSC_PI*x)*PetscCosReal(t);
+}
+
+static PetscErrorCode RHSFunction(TS ts,PetscReal t,Vec U,Vec F,void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  Vec            Ul;
+  PetscScalar    *u,*f;
+  PetscReal      hx,x,ue,g;
+  PetscInt       i,xs,xm,mx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMDAGetInfo(user->da,NULL,&mx,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  hx   = 1.0/(mx-1);
+  ierr = DMGetLocalVector(user->da,&Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(user->da,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(user->da,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(user->da,Ul,&u);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(user->da,F,&f);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(user->da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) {
+    if (i == 0 || i == mx-1) {f[i] = 0.0; continue;}
+    x    = i*hx;
+    ue   = Exact(t,x);
+    g    = -PetscSinReal(PETSC_PI*x)*PetscSinReal(t) + PETSC_PI*PETSC_PI*ue + ue*ue;
+    f[i] = (u[i-1] - 2.0*u[i] + u[i+1])/(hx*hx) - u[i]*u[i] + g;
+  }
+  ierr = DMDAVecRestoreArray(user->da,F,&f);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(user->da,Ul,&u);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(user->da,&Ul);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode RHSJacobian(TS ts,PetscReal t,Vec U,Mat A,Mat B,void *ctx)
+{
+  AppCtx         *user = (AppCtx*)ctx;
+  PetscScalar    *u,v[3];
+  PetscReal      hx;
+  PetscInt       i,xs,xm,mx,col[3];
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMDAGetInfo(user->da,NULL,&mx,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  hx   = 1.0/(mx-1);
+  ierr = DMDAVecGetArrayRead(user->da,U,&u);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(user->da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) {
+    if (i == 0 || i == mx-1) {
+      v[0] = 0.0;
+      ierr = MatSetValues(B,1,&i,1,&i,v,INSERT_VALUES);CHKERRQ(ierr);
+      continue;
+    }
+    col[0] = i-1; col[1] = i; col[2] = i+1;
+    v[0]   = 1.0/(hx*hx); v[1] = -2.0/(hx*hx) - 2.0*u[i]; v[2] = 1.0/(hx*hx);
+    ierr = MatSetValues(B,1,&i,3,col,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = DMDAVecRestoreArrayRead(user->da,U,&u);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  if (A != B) {
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* F(t,U,U_t) = U_t - G(t,U) */
+static PetscErrorCode IFunction(TS ts,PetscReal t,Vec U,Vec Udot,Vec F,void *ctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = RHSFunction(ts,t,U,F,ctx);CHKERRQ(ierr);
+  ierr = VecAYPX(F,-1.0,Udot);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode IJacobian(TS ts,PetscReal t,Vec U,Vec Udot,PetscReal a,Mat A,Mat B,void *ctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = RHSJacobian(ts,t,U,A,B,ctx);CHKERRQ(ierr);
+  ierr = MatScale(B,-1.0);CHKERRQ(ierr);
+  ierr = MatShift(B,a);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  TS                ts;
+  Vec               U,E;
+  Mat               J;
+  AppCtx            user;
+  PetscScalar       *e;
+  PetscReal         hx,tf = 1.0,err;
+  PetscInt          i,xs,xm,mx = 65;
+  PetscBool         ifunc = PETSC_FALSE;
+  TSConvergedReason reason;
+  PetscErrorCode    ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-mx",&mx,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-ifunc",&ifunc,NULL);CHKERRQ(ierr);
+  ierr = DMDACreate1d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,mx,1,1,NULL,&user.da);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(user.da);CHKERRQ(ierr);
+  ierr = DMSetUp(user.da);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(user.da,&U);CHKERRQ(ierr);
+  ierr = VecDuplicate(U,&E);CHKERRQ(ierr);
+  ierr = DMCreateMatrix(user.da,&J);CHKERRQ(ierr);
+
+  ierr = TSCreate(PETSC_COMM_WORLD,&ts);CHKERRQ(ierr);
+  ierr = TSSetDM(ts,user.da);CHKERRQ(ierr);
+  ierr = TSSetType(ts,TSEXPRB);CHKERRQ(ierr);
+  if (ifunc) {
+    ierr = TSSetIFunction(ts,NULL,IFunction,&user);CHKERRQ(ierr);
+    ierr = TSSetIJacobian(ts,J,J,IJacobian,&user);CHKERRQ(ierr);
+  } else {
+    ierr = TSSetRHSFunction(ts,NULL,RHSFunction,&user);CHKERRQ(ierr);
+    ierr = TSSetRHSJacobian(ts,J,J,RHSJacobian,&user);CHKERRQ(ierr);
+  }
+  ierr = TSSetTimeStep(ts,0.05);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(ts,tf);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(ts,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  ierr = TSSetTolerances(ts,1.e-6,NULL,1.e-6,NULL);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(ts);CHKERRQ(ierr);
+
+  /* initial condition and exact solution at the final time */
+  hx   = 1.0/(mx-1);
+  ierr = DMDAGetCorners(user.da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(user.da,E,&e);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) e[i] = Exact(0.0,i*hx);
+  ierr = DMDAVecRestoreArray(user.da,E,&e);CHKERRQ(ierr);
+  ierr = VecCopy(E,U);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(user.da,E,&e);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) e[i] = Exact(tf,i*hx);
+  ierr = DMDAVecRestoreArray(user.da,E,&e);CHKERRQ(ierr);
+
+  ierr = TSSolve(ts,U);CHKERRQ(ierr);
+  ierr = TSGetConvergedReason(ts,&reason);CHKERRQ(ierr);
+  ierr = VecAXPY(E,-1.0,U);CHKERRQ(ierr);
+  ierr = VecNorm(E,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s\n",TSConvergedReasons[reason]);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Error %s the discretization error\n",err < 1.e-3 ? "within" : "above");CHKERRQ(ierr);
+
+  ierr = TSDestroy(&ts);CHKERRQ(ierr);
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  ierr = VecDestroy(&E);CHKERRQ(ierr);
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = DMDestroy(&user.da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
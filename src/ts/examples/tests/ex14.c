@@ -0,0 +1,146 @@
+
+static char help[] = "Tests the multirate method TSMPRK with coupled pairs of fast and slow components.\n\n\
+  u_f' = -50 (u_f - u_s cos(t)),  u_s' = -a u_s + u_f/2 with a different rate a for each pair.\n\
+  -pairs <n> : number of pairs of components\n\
+  -split     : give the right hand side of each split instead of evaluating the full right hand side\n\n";
+
+#include <petscts.h>
+
+typedef struct {
+  PetscInt  rstart;    /* global number of the first local pair */
+  PetscInt  npairs;
+} AppCtx;
+
+PETSC_STATIC_INLINE PetscReal Rate(AppCtx *user,PetscInt i)
+{
+  return 1.0 + (PetscReal)i/user->npairs;
+}
+
+static PetscErrorCode RHSFunction(TS ts,PetscReal t,Vec U,Vec F,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  const PetscScalar *u;
+  PetscScalar       *f;
+  PetscInt          i,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetLocalSize(U,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(U,&u);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  for (i=0; i<n/2; i++) {
+    f[2*i]   = -50.0*(u[2*i] - u[2*i+1]*PetscCosReal(t));
+    f[2*i+1] = -Rate(user,user->rstart+i)*u[2*i+1] + 0.5*u[2*i];
+  }
+  ierr = VecRestoreArrayRead(U,&u);CHKERRQ(ierr);
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode RHSFunctionFast(TS ts,PetscReal t,Vec U,Vec F,void *ctx)
+{
+  const PetscScalar *u;
+  PetscScalar       *f;
+  PetscInt          i,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetLocalSize(F,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(U,&u);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  for (i=0; i<n; i++) f[i] = -50.0*(u[2*i] - u[2*i+1]*PetscCosReal(t));
+  ierr = VecRestoreArrayRead(U,&u);CHKERRQ(ierr);
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode RHSFunctionSlow(TS ts,PetscReal t,Vec U,Vec F,void *ctx)
+{
+  AppCtx            *user = (AppCtx*)ctx;
+  const PetscScalar *u;
+  PetscScalar       *f;
+  PetscInt          i,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetLocalSize(F,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(U,&u);CHKERRQ(ierr);
+  ierr = VecGetArray(F,&f);CHKERRQ(ierr);
+  for (i=0; i<n; i++) f[i] = -Rate(user,user->rstart+i)*u[2*i+1] + 0.5*u[2*i];
+  ierr = VecRestoreArrayRead(U,&u);CHKERRQ(ierr);
+  ierr = VecRestoreArray(F,&f);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Solve(AppCtx *user,TSType type,IS isfast,IS isslow,PetscBool split,Vec U)
+{
+  TS             ts;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = TSCreate(PETSC_COMM_WORLD,&ts);CHKERRQ(ierr);
+  ierr = TSSetType(ts,type);CHKERRQ(ierr);
+  ierr = TSSetRHSFunction(ts,NULL,RHSFunction,user);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(ts,1.0);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(ts,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  ierr = TSSetTimeStep(ts,0.05);CHKERRQ(ierr);
+  if (isfast) {
+    ierr = TSRHSSplitSetIS(ts,"fast",isfast);CHKERRQ(ierr);
+    if (split) {
+      ierr = TSRHSSplitSetIS(ts,"slow",isslow);CHKERRQ(ierr);
+      ierr = TSRHSSplitSetRHSFunction(ts,"fast",RHSFunctionFast,user);CHKERRQ(ierr);
+      ierr = TSRHSSplitSetRHSFunction(ts,"slow",RHSFunctionSlow,user);CHKERRQ(ierr);
+    }
+    ierr = TSMPRKSetRatio(ts,10);CHKERRQ(ierr);
+    ierr = TSSetFromOptions(ts);CHKERRQ(ierr);
+  } else {
+    /* reference solution */
+    ierr = TSSetTolerances(ts,1.e-12,NULL,1.e-12,NULL);CHKERRQ(ierr);
+  }
+  ierr = TSSolve(ts,U);CHKERRQ(ierr);
+  ierr = TSDestroy(&ts);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            U,R;
+  IS             isfast,isslow;
+  AppCtx         user;
+  PetscInt       n,rstart;
+  PetscReal      err;
+  PetscBool      split = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  user.npairs = 8;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-pairs",&user.npairs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-split",&split,NULL);CHKERRQ(ierr);
+
+  ierr = VecCreate(PETSC_COMM_WORLD,&U);CHKERRQ(ierr);
+  ierr = VecSetSizes(U,PETSC_DECIDE,2*user.npairs);CHKERRQ(ierr);
+  ierr = VecSetBlockSize(U,2);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(U);CHKERRQ(ierr);
+  ierr = VecDuplicate(U,&R);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(U,&n);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(U,&rstart,NULL);CHKERRQ(ierr);
+  user.rstart = rstart/2;
+  ierr = ISCreateStride(PETSC_COMM_WORLD,n/2,rstart,2,&isfast);CHKERRQ(ierr);
+  ierr = ISCreateStride(PETSC_COMM_WORLD,n/2,rstart+1,2,&isslow);CHKERRQ(ierr);
+
+  ierr = VecSet(U,1.0);CHKERRQ(ierr);
+  ierr = Solve(&user,TSMPRK,isfast,isslow,split,U);CHKERRQ(ierr);
+  ierr = VecSet(R,1.0);CHKERRQ(ierr);
+  ierr = Solve(&user,TSRK,NULL,NULL,PETSC_FALSE,R);CHKERRQ(ierr);
+
+  ierr = VecAXPY(R,-1.0,U);CHKERRQ(ierr);
+  ierr = VecNorm(R,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Multirate and reference solutions %s\n",err < 1.e-3 ? "agree" : "do not agree");CHKERRQ(ierr);
+
+  ierr = ISDestroy(&isfast);CHKERRQ(ierr);
+  ierr = ISDestroy(&isslow);CHKERRQ(ierr);
+  ierr = VecDestroy(&R);CHKERRQ(ierr);
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
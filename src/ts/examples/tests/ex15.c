@@ -0,0 +1,137 @@
+
+static char help[] = "Tests the reuse of the Jacobian and preconditioner across implicit stages and steps with TSSetJacobianReuse().\n\n\
+  u_t = u_xx + u (1 - u) on (0,1) with homogeneous Neumann conditions.\n\
+  -mx <n> : number of grid points\n\n";
+
+#include <petscts.h>
+#include <petscdm.h>
+#include <petscdmda.h>
+
+static PetscErrorCode IFunction(TS ts,PetscReal t,Vec U,Vec Udot,Vec F,void *ctx)
+{
+  DM             da;
+  Vec            Ul;
+  PetscScalar    *u,*udot,*f;
+  PetscReal      hx;
+  PetscInt       i,xs,xm,mx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = TSGetDM(ts,&da);CHKERRQ(ierr);
+  ierr = DMDAGetInfo(da,NULL,&mx,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  hx   = 1.0/(mx-1);
+  ierr = DMGetLocalVector(da,&Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(da,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(da,U,INSERT_VALUES,Ul);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(da,Ul,&u);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(da,Udot,&udot);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(da,F,&f);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) {
+    PetscScalar ul = i == 0 ? u[i+1] : u[i-1],ur = i == mx-1 ? u[i-1] : u[i+1];
+    f[i] = udot[i] - (ul - 2.0*u[i] + ur)/(hx*hx) - u[i]*(1.0 - u[i]);
+  }
+  ierr = DMDAVecRestoreArray(da,F,&f);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(da,Udot,&udot);CHKERRQ(ierr);
+  ierr = DMDAVecRestoreArray(da,Ul,&u);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(da,&Ul);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode IJacobian(TS ts,PetscReal t,Vec U,Vec Udot,PetscReal a,Mat A,Mat B,void *ctx)
+{
+  DM             da;
+  PetscScalar    *u,v[3];
+  PetscReal      hx;
+  PetscInt       i,xs,xm,mx,col[3];
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = TSGetDM(ts,&da);CHKERRQ(ierr);
+  ierr = DMDAGetInfo(da,NULL,&mx,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  hx   = 1.0/(mx-1);
+  ierr = DMDAVecGetArrayRead(da,U,&u);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) {
+    /* the reflected neighbor of a boundary point appears twice in its row */
+    col[0] = i-1; col[1] = i; col[2] = i+1;
+    v[0]   = -1.0/(hx*hx); v[1] = a + 2.0/(hx*hx) - 1.0 + 2.0*u[i]; v[2] = -1.0/(hx*hx);
+    if (i == 0)    {v[2] *= 2.0; ierr = MatSetValues(B,1,&i,2,&col[1],&v[1],INSERT_VALUES);CHKERRQ(ierr);}
+    else if (i == mx-1) {v[0] *= 2.0; ierr = MatSetValues(B,1,&i,2,col,v,INSERT_VALUES);CHKERRQ(ierr);}
+    else {ierr = MatSetValues(B,1,&i,3,col,v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = DMDAVecRestoreArrayRead(da,U,&u);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  if (A != B) {
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Solve(DM da,PetscBool reuse,Vec U,PetscInt *computed,PetscInt *reused)
+{
+  TS             ts;
+  Mat            J;
+  PetscScalar    *u;
+  PetscReal      hx;
+  PetscInt       i,xs,xm,mx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMDAGetInfo(da,NULL,&mx,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  hx   = 1.0/(mx-1);
+  ierr = DMDAGetCorners(da,&xs,NULL,NULL,&xm,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMDAVecGetArray(da,U,&u);CHKERRQ(ierr);
+  for (i=xs; i<xs+xm; i++) u[i] = 0.5 + 0.4*PetscCosReal(PETSC_PI*i*hx);
+  ierr = DMDAVecRestoreArray(da,U,&u);CHKERRQ(ierr);
+
+  ierr = DMCreateMatrix(da,&J);CHKERRQ(ierr);
+  ierr = TSCreate(PETSC_COMM_WORLD,&ts);CHKERRQ(ierr);
+  ierr = TSSetDM(ts,da);CHKERRQ(ierr);
+  ierr = TSSetIFunction(ts,NULL,IFunction,NULL);CHKERRQ(ierr);
+  ierr = TSSetIJacobian(ts,J,J,IJacobian,NULL);CHKERRQ(ierr);
+  ierr = TSSetTimeStep(ts,0.01);CHKERRQ(ierr);
+  ierr = TSSetMaxTime(ts,0.5);CHKERRQ(ierr);
+  ierr = TSSetExactFinalTime(ts,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  ierr = TSSetTolerances(ts,1.e-6,NULL,1.e-6,NULL);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(ts);CHKERRQ(ierr);
+  ierr = TSSetJacobianReuse(ts,reuse);CHKERRQ(ierr);
+  ierr = TSSolve(ts,U);CHKERRQ(ierr);
+  ierr = TSGetJacobianReuseCounts(ts,computed,reused);CHKERRQ(ierr);
+  ierr = TSDestroy(&ts);CHKERRQ(ierr);
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  DM             da;
+  Vec            U,R;
+  PetscInt       computed,reused;
+  PetscReal      err,nrm;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = DMDACreate1d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,65,1,1,NULL,&da);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(da,&U);CHKERRQ(ierr);
+  ierr = VecDuplicate(U,&R);CHKERRQ(ierr);
+
+  ierr = Solve(da,PETSC_FALSE,R,NULL,NULL);CHKERRQ(ierr);
+  ierr = Solve(da,PETSC_TRUE,U,&computed,&reused);CHKERRQ(ierr);
+
+  ierr = VecNorm(R,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(R,-1.0,U);CHKERRQ(ierr);
+  ierr = VecNorm(R,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Solutions with and without reuse %s\n",err < 1.e-4*nrm ? "agree" : "do not agree");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Jacobian evaluations %s avoided\n",reused > 0 ? "were" : "were not");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&R);CHKERRQ(ierr);
+  ierr = VecDestroy(&U);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -1051,9 +1051,12 @@ static PetscErrorCode SNESTSFormJacobian_ARKIMEX(SNES snes,Vec X,Mat A,Mat B,TS
   DM             dm,dmsave;
   Vec            Ydot;
   PetscReal      shift = ark->scoeff / ts->time_step;
+  PetscBool      reuse;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = TSJacobianReuseCheck_Private(ts,snes,shift,A,B,&reuse);CHKERRQ(ierr);
+  if (reuse) PetscFunctionReturn(0);
   ierr = SNESGetDM(snes,&dm);CHKERRQ(ierr);
   ierr = TSARKIMEXGetVecs(ts,dm,NULL,&Ydot);CHKERRQ(ierr);
   /* ark->Ydot has already been computed in SNESTSFormFunction_ARKIMEX (SNES guarantees this) */
@@ -1061,6 +1064,7 @@ static PetscErrorCode SNESTSFormJacobian_ARKIMEX(SNES snes,Vec X,Mat A,Mat B,TS
   ts->dm = dm;
 
   ierr = TSComputeIJacobian(ts,ark->stage_time,X,Ydot,shift,A,B,ark->imex);CHKERRQ(ierr);
+  ierr = TSJacobianReuseUpdate_Private(ts,shift,B);CHKERRQ(ierr);
 
   ts->dm = dmsave;
   ierr   = TSARKIMEXRestoreVecs(ts,dm,NULL,&Ydot);CHKERRQ(ierr);
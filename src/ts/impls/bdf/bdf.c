@@ -282,7 +282,7 @@ static PetscErrorCode SNESTSFormFunction_BDF(PETSC_UNUSED SNES snes,Vec X,Vec F,
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode SNESTSFormJacobian_BDF(PETSC_UNUSED SNES snes,
+static PetscErrorCode SNESTSFormJacobian_BDF(SNES snes,
                                              PETSC_UNUSED Vec X,
                                              Mat J,Mat P,
                                              TS ts)
@@ -291,11 +291,15 @@ static PetscErrorCode SNESTSFormJacobian_BDF(PETSC_UNUSED SNES snes,
   PetscReal      t = bdf->time[0];
   Vec            V = bdf->vec_dot;
   PetscReal      dVdX = bdf->shift;
+  PetscBool      reuse;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = TSJacobianReuseCheck_Private(ts,snes,dVdX,J,P,&reuse);CHKERRQ(ierr);
+  if (reuse) PetscFunctionReturn(0);
   /* J,P = Jacobian(t,X,V) */
   ierr = TSComputeIJacobian(ts,t,X,V,dVdX,J,P,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = TSJacobianReuseUpdate_Private(ts,dVdX,P);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -14,6 +14,8 @@ static TSRKType  TSRKDefault = TSRK3BS;
 static PetscBool TSRKRegisterAllCalled;
 static PetscBool TSRKPackageInitialized;
 
+typedef enum {RK_LOWSTORAGE_NONE,RK_LOWSTORAGE_2N,RK_LOWSTORAGE_3SSTAR} RKLowStorageType;
+
 typedef struct _RKTableau *RKTableau;
 struct _RKTableau {
   char      *name;
@@ -25,6 +27,9 @@ struct _RKTableau {
   PetscReal *bembed;              /* Embedded formula of order one less (order-1)               */
   PetscReal *binterp;             /* Dense output formula                                       */
   PetscReal  ccfl;                /* Placeholder for CFL coefficient relative to forward Euler  */
+  RKLowStorageType lstype;        /* Form of the low-storage step, none for the Butcher form    */
+  PetscReal *lsA,*lsB;            /* 2N form: Q = lsA_i Q + h F(U), U = U + lsB_i Q              */
+  PetscReal *gamma,*beta,*delta;  /* 3S* form, gamma is s x 3 and delta has s+2 entries         */
 };
 typedef struct _RKTableauLink *RKTableauLink;
 struct _RKTableauLink {
@@ -41,6 +46,10 @@ typedef struct {
   Vec          *VecDeltaMu;      /* Increment of the adjoint sensitivity w.r.t P at stage */
   Vec          *VecSensiTemp;    /* Vector to be timed with Jacobian transpose */
   Vec          VecCostIntegral0; /* backup for roll-backs due to events */
+  Vec          U0;               /* Solution at the start of the step, for the low-storage schemes */
+  Vec          Q;                /* Second register of the low-storage schemes */
+  Vec          E;                /* Error of the embedded method, for the 2N schemes */
+  Vec          Ydot;             /* Function evaluation, for the low-storage schemes */
   PetscScalar  *work;            /* Scalar work */
   PetscReal    stage_time;
   TSStepStatus status;
@@ -150,6 +159,63 @@ M*/
 
 .seealso: TSRK, TSRKType, TSRKSetType()
 M*/
+/*MC
+     TSRK3W - Third order low-storage RK scheme of Williamson with a 2nd order embedded method.
+
+     This method has three stages and is implemented in the 2N form, the step keeps two registers, and one for the embedded error, instead of the stages.
+
+     Options database:
+.     -ts_rk_type 3w
+
+     Level: advanced
+
+     References: https://doi.org/10.1016/0021-9991(80)90033-9
+
+.seealso: TSRK, TSRKType, TSRKSetType(), TSRKRegister2N()
+M*/
+/*MC
+     TSRK4CK - Fourth order low-storage RK scheme of Carpenter and Kennedy with a 3rd order embedded method.
+
+     This method has five stages and is implemented in the 2N form, the step keeps two registers, and one for the embedded error, instead of the stages.
+
+     Options database:
+.     -ts_rk_type 4ck
+
+     Level: advanced
+
+     References: Carpenter and Kennedy, Fourth-order 2N-storage Runge-Kutta schemes, NASA TM-109112, 1994
+
+.seealso: TSRK, TSRKType, TSRKSetType(), TSRKRegister2N()
+M*/
+/*MC
+     TSRK3SSP - Third order strong stability preserving RK scheme of Shu and Osher with a 2nd order embedded method.
+
+     This method has three stages and is implemented in the 3S* form, the step keeps three registers instead of the stages.
+
+     Options database:
+.     -ts_rk_type 3ssp
+
+     Level: advanced
+
+     References: https://doi.org/10.1016/0021-9991(88)90177-5
+
+.seealso: TSRK, TSRKType, TSRKSetType(), TSRKRegister3Sstar(), TSSSP
+M*/
+/*MC
+     TSRK4SSP - Fourth order strong stability preserving RK scheme of Ketcheson.
+
+     This method has ten stages, a strong stability preserving coefficient of six, and is implemented in the 3S* form,
+     the step keeps three registers instead of the stages.
+
+     Options database:
+.     -ts_rk_type 4ssp
+
+     Level: advanced
+
+     References: https://doi.org/10.1137/07070485X
+
+.seealso: TSRK, TSRKType, TSRKSetType(), TSRKRegister3Sstar(), TSSSP
+M*/
 
 /*@C
   TSRKRegisterAll - Registers all of the Runge-Kutta explicit methods in TSRK
@@ -251,6 +317,50 @@ PetscErrorCode TSRKRegisterAll(void)
       bembed[8] =  {RC(2479.0)/RC(34992.0),0,RC(123.0)/RC(416.0),RC(612941.0)/RC(3411720.0),RC(43.0)/RC(1440.0),RC(2272.0)/RC(6561.0),RC(79937.0)/RC(1113912.0),RC(3293.0)/RC(556956.0)};
     ierr = TSRKRegister(TSRK5BS,5,8,&A[0][0],b,NULL,bembed,0,NULL);CHKERRQ(ierr);
   }
+  {
+    const PetscReal
+      A[3]      = {0,RC(-5.0)/RC(9.0),RC(-153.0)/RC(128.0)},
+      B[3]      = {RC(1.0)/RC(3.0),RC(15.0)/RC(16.0),RC(8.0)/RC(15.0)},
+      bembed[3] = {0,RC(3.0)/RC(5.0),RC(2.0)/RC(5.0)};
+    ierr = TSRKRegister2N(TSRK3W,3,3,A,B,bembed);CHKERRQ(ierr);
+  }
+  {
+    const PetscReal
+      A[5]      = {0,RC(-567301805773.0)/RC(1357537059087.0),RC(-2404267990393.0)/RC(2016746695238.0),
+                   RC(-3550918686646.0)/RC(2091501179385.0),RC(-1275806237668.0)/RC(842570457699.0)},
+      B[5]      = {RC(1432997174477.0)/RC(9575080441755.0),RC(5161836677717.0)/RC(13612068292357.0),RC(1720146321549.0)/RC(2090206949498.0),
+                   RC(3134564353537.0)/RC(4481467310338.0),RC(2277821191437.0)/RC(14882151754819.0)},
+      bembed[5] = {RC(0.16592854486508934094566715615),0,RC(0.27298494277824932127295287086),
+                   RC(0.41304217797261046898204208712),RC(0.14804433438405086879933788587)};
+    ierr = TSRKRegister2N(TSRK4CK,4,5,A,B,bembed);CHKERRQ(ierr);
+  }
+  {
+    const PetscReal
+      gamma[3][3]   = {{RC(1.0),0,0},
+                       {RC(0.25),0,RC(0.75)},
+                       {RC(2.0)/RC(3.0),0,RC(1.0)/RC(3.0)}},
+      beta[3]       =  {RC(1.0),RC(0.25),RC(2.0)/RC(3.0)},
+      delta[3]      =  {0,0,RC(2.0)},
+      deltaembed[2] =  {0,RC(-1.0)};
+    ierr = TSRKRegister3Sstar(TSRK3SSP,3,3,&gamma[0][0],beta,delta,deltaembed);CHKERRQ(ierr);
+  }
+  {
+    const PetscReal
+      gamma[10][3] = {{RC(1.0),0,0},
+                      {RC(1.0),0,0},
+                      {RC(1.0),0,0},
+                      {RC(1.0),0,0},
+                      {RC(0.4),0,RC(0.6)},
+                      {RC(1.0),0,0},
+                      {RC(1.0),0,0},
+                      {RC(1.0),0,0},
+                      {RC(1.0),0,0},
+                      {RC(0.6),RC(1.0),RC(-0.5)}},
+      beta[10]     =  {RC(1.0)/RC(6.0),RC(1.0)/RC(6.0),RC(1.0)/RC(6.0),RC(1.0)/RC(6.0),RC(1.0)/RC(15.0),
+                       RC(1.0)/RC(6.0),RC(1.0)/RC(6.0),RC(1.0)/RC(6.0),RC(1.0)/RC(6.0),RC(0.1)},
+      delta[10]    =  {0,0,0,0,0,RC(0.9),0,0,0,0};
+    ierr = TSRKRegister3Sstar(TSRK4SSP,4,10,&gamma[0][0],beta,delta,NULL);CHKERRQ(ierr);
+  }
 #undef RC
   PetscFunctionReturn(0);
 }
@@ -277,6 +387,8 @@ PetscErrorCode TSRKRegisterDestroy(void)
     ierr = PetscFree3(t->A,t->b,t->c);  CHKERRQ(ierr);
     ierr = PetscFree (t->bembed);       CHKERRQ(ierr);
     ierr = PetscFree (t->binterp);      CHKERRQ(ierr);
+    ierr = PetscFree2(t->lsA,t->lsB);   CHKERRQ(ierr);
+    ierr = PetscFree3(t->gamma,t->beta,t->delta);CHKERRQ(ierr);
     ierr = PetscFree (t->name);         CHKERRQ(ierr);
     ierr = PetscFree (link);            CHKERRQ(ierr);
   }
@@ -397,6 +509,142 @@ PetscErrorCode TSRKRegister(TSRKType name,PetscInt order,PetscInt s,
   PetscFunctionReturn(0);
 }
 
+/*@C
+   TSRKRegister2N - register a low-storage RK scheme in the 2N form of Williamson
+
+   Not Collective, but the same schemes should be registered on all processes on which they will be used
+
+   Input Parameters:
++  name - identifier for method
+.  order - approximation order of method
+.  s - number of stages
+.  A - coefficients of the second register (dimension s, the first one is ignored)
+.  B - coefficients of the solution update (dimension s)
+-  bembed - completion table for embedded method in the Butcher form (dimension s; NULL if not available)
+
+   Notes:
+   Starting from U = u_n, each stage i computes
+.vb
+   Q = A_i Q + h F(t_n + c_i h,U)
+   U = U + B_i Q
+.ve
+   so the step keeps U, Q and the function evaluation instead of all the stages. The scheme is registered with TSRKRegister()
+   through its Butcher tableau, which gives the abscissa and is used by TSView(). The embedded method, if any, needs a third register.
+
+   Level: advanced
+
+.keywords: TS, register, low-storage
+
+.seealso: TSRK, TSRKRegister(), TSRKRegister3Sstar()
+@*/
+PetscErrorCode TSRKRegister2N(TSRKType name,PetscInt order,PetscInt s,const PetscReal A[],const PetscReal B[],const PetscReal bembed[])
+{
+  RKTableau      t;
+  PetscReal      *Ab,*b,*q;
+  PetscInt       i,j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidCharPointer(name,1);
+  PetscValidRealPointer(A,4);
+  PetscValidRealPointer(B,5);
+  if (bembed) PetscValidRealPointer(bembed,6);
+  /* the registers are combinations of u_n with coefficient one and of the h F_j, b accumulates U and q accumulates Q */
+  ierr = PetscCalloc3(s*s,&Ab,s,&b,s,&q);CHKERRQ(ierr);
+  for (i=0; i<s; i++) {
+    for (j=0; j<s; j++) Ab[i*s+j] = b[j];
+    for (j=0; j<s; j++) q[j] = i ? A[i]*q[j] : 0;
+    q[i] += 1;
+    for (j=0; j<s; j++) b[j] += B[i]*q[j];
+  }
+  ierr = TSRKRegister(name,order,s,Ab,b,NULL,bembed,0,NULL);CHKERRQ(ierr);
+  ierr = PetscFree3(Ab,b,q);CHKERRQ(ierr);
+
+  t = &RKTableauList->tab;
+  t->FSAL   = PETSC_FALSE;
+  t->lstype = RK_LOWSTORAGE_2N;
+  ierr = PetscMalloc2(s,&t->lsA,s,&t->lsB);CHKERRQ(ierr);
+  ierr = PetscMemcpy(t->lsA,A,s*sizeof(A[0]));CHKERRQ(ierr);
+  ierr = PetscMemcpy(t->lsB,B,s*sizeof(B[0]));CHKERRQ(ierr);
+  t->lsA[0] = 0;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   TSRKRegister3Sstar - register a low-storage RK scheme in the 3S* form of Ketcheson
+
+   Not Collective, but the same schemes should be registered on all processes on which they will be used
+
+   Input Parameters:
++  name - identifier for method
+.  order - approximation order of method
+.  s - number of stages
+.  gamma - coefficients of the three registers in the stage update (dimension s*3, row-major)
+.  beta - coefficients of the function evaluations (dimension s)
+.  delta - coefficients of the accumulation in the second register (dimension s)
+-  deltaembed - coefficients of the last stage and of u_n in the embedded method (dimension 2; NULL if not available)
+
+   Notes:
+   Starting from S1 = S3 = u_n and S2 = 0, each stage i computes
+.vb
+   S2 = S2 + delta_i S1
+   S1 = gamma_i1 S1 + gamma_i2 S2 + gamma_i3 S3 + beta_i h F(t_n + c_i h,S1)
+.ve
+   and u_{n+1} = S1. The embedded method is (S2 + deltaembed_0 S1 + deltaembed_1 S3)/(sum delta + sum deltaembed), so it needs no
+   additional register. The scheme is registered with TSRKRegister() through its Butcher tableau.
+
+   Level: advanced
+
+.keywords: TS, register, low-storage
+
+.seealso: TSRK, TSRKRegister(), TSRKRegister2N()
+@*/
+PetscErrorCode TSRKRegister3Sstar(TSRKType name,PetscInt order,PetscInt s,const PetscReal gamma[],const PetscReal beta[],const PetscReal delta[],const PetscReal deltaembed[])
+{
+  RKTableau      t;
+  PetscReal      *Ab,*S1,*S2,*bembed = NULL,sum;
+  PetscInt       i,j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidCharPointer(name,1);
+  PetscValidRealPointer(gamma,4);
+  PetscValidRealPointer(beta,5);
+  PetscValidRealPointer(delta,6);
+  if (deltaembed) PetscValidRealPointer(deltaembed,7);
+  /* the registers are combinations of u_n, entry 0, and of the h F_j, entries 1 to s; S3 is u_n */
+  ierr = PetscCalloc3(s*s,&Ab,s+1,&S1,s+1,&S2);CHKERRQ(ierr);
+  S1[0] = 1;
+  for (i=0; i<s; i++) {
+    for (j=0; j<=s; j++) S2[j] += delta[i]*S1[j];
+    if (PetscAbsReal(S1[0]-1) > 100*PETSC_MACHINE_EPSILON) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Stage %D of 3S* scheme %s is not consistent",i,name);
+    for (j=0; j<s; j++) Ab[i*s+j] = S1[1+j];
+    for (j=0; j<=s; j++) S1[j] = gamma[i*3+0]*S1[j] + gamma[i*3+1]*S2[j];
+    S1[0]   += gamma[i*3+2];
+    S1[1+i] += beta[i];
+  }
+  if (PetscAbsReal(S1[0]-1) > 100*PETSC_MACHINE_EPSILON) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"3S* scheme %s is not consistent",name);
+  if (deltaembed) {
+    for (i=0,sum=deltaembed[0]+deltaembed[1]; i<s; i++) sum += delta[i];
+    ierr = PetscMalloc1(s,&bembed);CHKERRQ(ierr);
+    for (j=0; j<s; j++) bembed[j] = (S2[1+j] + deltaembed[0]*S1[1+j])/sum;
+  }
+  ierr = TSRKRegister(name,order,s,Ab,&S1[1],NULL,bembed,0,NULL);CHKERRQ(ierr);
+  ierr = PetscFree3(Ab,S1,S2);CHKERRQ(ierr);
+  ierr = PetscFree(bembed);CHKERRQ(ierr);
+
+  t = &RKTableauList->tab;
+  t->FSAL   = PETSC_FALSE;
+  t->lstype = RK_LOWSTORAGE_3SSTAR;
+  ierr = PetscMalloc3(3*s,&t->gamma,s,&t->beta,s+2,&t->delta);CHKERRQ(ierr);
+  ierr = PetscMemcpy(t->gamma,gamma,3*s*sizeof(gamma[0]));CHKERRQ(ierr);
+  ierr = PetscMemcpy(t->beta,beta,s*sizeof(beta[0]));CHKERRQ(ierr);
+  ierr = PetscMemcpy(t->delta,delta,s*sizeof(delta[0]));CHKERRQ(ierr);
+  t->delta[s] = deltaembed ? deltaembed[0] : 0;
+  t->delta[s+1] = deltaembed ? deltaembed[1] : 0;
+  PetscFunctionReturn(0);
+}
+
 /*
  The step completion formula is
 
@@ -597,6 +845,127 @@ static PetscErrorCode TSStep_RK(TS ts)
   PetscFunctionReturn(0);
 }
 
+/*
+  The low-storage schemes update ts->vec_sol in place stage after stage, rk->U0 keeps u_n for the rejected steps and,
+  in the 3S* form, is the third register. The stage values are not stored so there is no interpolation, adjoint, or cost integral.
+*/
+static PetscErrorCode TSEvaluateStep_RK_LowStorage(TS ts,PetscInt order,Vec X,PetscBool *done)
+{
+  TS_RK          *rk  = (TS_RK*)ts->data;
+  RKTableau      tab  = rk->tableau;
+  PetscInt       s    = tab->s,j;
+  PetscReal      sum;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (rk->status == TS_STEP_INCOMPLETE) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_SUP,"RK '%s' is a low-storage scheme, it can only evaluate a completed step",tab->name);
+  if (order == tab->order) {
+    ierr = VecCopy(ts->vec_sol,X);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  } else if (order == tab->order-1 && tab->bembed) {
+    if (tab->lstype == RK_LOWSTORAGE_2N) {
+      ierr = VecWAXPY(X,1.0,rk->E,ts->vec_sol);CHKERRQ(ierr);
+    } else {
+      for (j=0,sum=0; j<s+2; j++) sum += tab->delta[j];
+      ierr = VecCopy(rk->Q,X);CHKERRQ(ierr);
+      ierr = VecAXPBYPCZ(X,tab->delta[s]/sum,tab->delta[s+1]/sum,1.0/sum,ts->vec_sol,rk->U0);CHKERRQ(ierr);
+    }
+    if (done) *done = PETSC_TRUE;
+    PetscFunctionReturn(0);
+  }
+  if (done) *done = PETSC_FALSE;
+  else SETERRQ3(PetscObjectComm((PetscObject)ts),PETSC_ERR_SUP,"RK '%s' of order %D cannot evaluate step at order %D. Consider using -ts_adapt_type none or a different method that has an embedded estimate.",tab->name,tab->order,order);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSRollBack_RK_LowStorage(TS ts)
+{
+  TS_RK          *rk = (TS_RK*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecCopy(rk->U0,ts->vec_sol);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSStep_RK_LowStorage(TS ts)
+{
+  TS_RK           *rk   = (TS_RK*)ts->data;
+  RKTableau        tab  = rk->tableau;
+  const PetscInt   s = tab->s;
+  const PetscReal *c = tab->c,*b = tab->b,*bembed = tab->bembed;
+  Vec              U = ts->vec_sol,U0 = rk->U0,Q = rk->Q,E = rk->E,F = rk->Ydot;
+  Vec              *Y = rk->Y;
+  TSAdapt          adapt;
+  PetscInt         i;
+  PetscInt         rejections = 0;
+  PetscBool        stageok,accept = PETSC_TRUE;
+  PetscReal        next_time_step = ts->time_step;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<s; i++) Y[i] = U;
+  ierr = VecCopy(U,U0);CHKERRQ(ierr);
+
+  rk->status = TS_STEP_INCOMPLETE;
+  while (!ts->reason && rk->status != TS_STEP_COMPLETE) {
+    PetscReal t = ts->ptime;
+    PetscReal h = ts->time_step;
+    for (i=0; i<s; i++) {
+      rk->stage_time = t + h*c[i];
+      ierr = TSPreStage(ts,rk->stage_time);CHKERRQ(ierr);
+      ierr = TSPostStage(ts,rk->stage_time,i,Y);CHKERRQ(ierr);
+      ierr = TSGetAdapt(ts,&adapt);CHKERRQ(ierr);
+      ierr = TSAdaptCheckStage(adapt,ts,rk->stage_time,U,&stageok);CHKERRQ(ierr);
+      if (!stageok) goto reject_step;
+      if (tab->lstype == RK_LOWSTORAGE_3SSTAR) { /* S2 = S2 + delta_i S1 before S1 is overwritten */
+        if (!i) {ierr = VecAXPBY(Q,tab->delta[0],0.0,U);CHKERRQ(ierr);}
+        else if (tab->delta[i] != 0) {ierr = VecAXPY(Q,tab->delta[i],U);CHKERRQ(ierr);}
+      }
+      ierr = TSComputeRHSFunction(ts,rk->stage_time,U,F);CHKERRQ(ierr);
+      if (tab->lstype == RK_LOWSTORAGE_2N) {
+        ierr = VecAXPBY(Q,h,i ? tab->lsA[i] : 0.0,F);CHKERRQ(ierr);
+        ierr = VecAXPY(U,tab->lsB[i],Q);CHKERRQ(ierr);
+        if (bembed) {ierr = VecAXPBY(E,h*(bembed[i]-b[i]),i ? 1.0 : 0.0,F);CHKERRQ(ierr);}
+      } else {
+        PetscScalar w[3];
+        Vec         X[3];
+        PetscInt    n = 0;
+
+        ierr = VecScale(U,tab->gamma[i*3+0]);CHKERRQ(ierr);
+        if (tab->gamma[i*3+1] != 0) {w[n] = tab->gamma[i*3+1]; X[n++] = Q;}
+        if (tab->gamma[i*3+2] != 0) {w[n] = tab->gamma[i*3+2]; X[n++] = U0;}
+        w[n] = h*tab->beta[i]; X[n++] = F;
+        ierr = VecMAXPY(U,n,w,X);CHKERRQ(ierr);
+      }
+    }
+
+    rk->status = TS_STEP_PENDING;
+    ierr = TSGetAdapt(ts,&adapt);CHKERRQ(ierr);
+    ierr = TSAdaptCandidatesClear(adapt);CHKERRQ(ierr);
+    ierr = TSAdaptCandidateAdd(adapt,tab->name,tab->order,1,tab->ccfl,(PetscReal)tab->s,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = TSAdaptChoose(adapt,ts,ts->time_step,NULL,&next_time_step,&accept);CHKERRQ(ierr);
+    rk->status = accept ? TS_STEP_COMPLETE : TS_STEP_INCOMPLETE;
+    if (!accept) {
+      ts->time_step = next_time_step;
+      goto reject_step;
+    }
+
+    ts->ptime += ts->time_step;
+    ts->time_step = next_time_step;
+    break;
+
+  reject_step:
+    ierr = VecCopy(U0,U);CHKERRQ(ierr);
+    ts->reject++; accept = PETSC_FALSE;
+    if (!ts->reason && ++rejections > ts->max_reject && ts->max_reject >= 0) {
+      ts->reason = TS_DIVERGED_STEP_REJECTED;
+      ierr = PetscInfo2(ts,"Step=%D, step rejections %D greater than current TS allowed, stopping solve\n",ts->steps,rejections);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode TSAdjointSetUp_RK(TS ts)
 {
   TS_RK         *rk  = (TS_RK*)ts->data;
@@ -730,6 +1099,14 @@ static PetscErrorCode TSRKTableauReset(TS ts)
   PetscFunctionBegin;
   if (!tab) PetscFunctionReturn(0);
   ierr = PetscFree(rk->work);CHKERRQ(ierr);
+  if (tab->lstype) {
+    ierr = PetscFree(rk->Y);CHKERRQ(ierr);
+    ierr = VecDestroy(&rk->U0);CHKERRQ(ierr);
+    ierr = VecDestroy(&rk->Q);CHKERRQ(ierr);
+    ierr = VecDestroy(&rk->E);CHKERRQ(ierr);
+    ierr = VecDestroy(&rk->Ydot);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecDestroyVecs(tab->s,&rk->Y);CHKERRQ(ierr);
   ierr = VecDestroyVecs(tab->s,&rk->YdotRHS);CHKERRQ(ierr);
   ierr = VecDestroyVecs(tab->s*ts->numcost,&rk->VecDeltaLam);CHKERRQ(ierr);
@@ -808,6 +1185,14 @@ static PetscErrorCode TSRKTableauSetUp(TS ts)
 
   PetscFunctionBegin;
   ierr = PetscMalloc1(tab->s,&rk->work);CHKERRQ(ierr);
+  if (tab->lstype) {
+    ierr = PetscCalloc1(tab->s,&rk->Y);CHKERRQ(ierr);
+    ierr = VecDuplicate(ts->vec_sol,&rk->U0);CHKERRQ(ierr);
+    ierr = VecDuplicate(ts->vec_sol,&rk->Q);CHKERRQ(ierr);
+    ierr = VecDuplicate(ts->vec_sol,&rk->Ydot);CHKERRQ(ierr);
+    if (tab->lstype == RK_LOWSTORAGE_2N && tab->bembed) {ierr = VecDuplicate(ts->vec_sol,&rk->E);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
   ierr = VecDuplicateVecs(ts->vec_sol,tab->s,&rk->Y);CHKERRQ(ierr);
   ierr = VecDuplicateVecs(ts->vec_sol,tab->s,&rk->YdotRHS);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -893,6 +1278,7 @@ static PetscErrorCode TSView_RK(TS ts,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"  RK type %s\n",rktype);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  Order: %D\n",tab->order);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  FSAL property: %s\n",tab->FSAL ? "yes" : "no");CHKERRQ(ierr);
+    if (tab->lstype) {ierr = PetscViewerASCIIPrintf(viewer,"  Low-storage form: %s\n",tab->lstype == RK_LOWSTORAGE_2N ? "2N" : "3S*");CHKERRQ(ierr);}
     ierr = PetscFormatRealArray(buf,sizeof(buf),"% 8.6f",tab->s,tab->c);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  Abscissa c = %s\n",buf);CHKERRQ(ierr);
   }
@@ -920,11 +1306,11 @@ static PetscErrorCode TSLoad_RK(TS ts,PetscViewer viewer)
 -  rktype - type of RK-scheme
 
   Options Database:
-.   -ts_rk_type - <1fe,2a,3,3bs,4,5f,5dp,5bs>
+.   -ts_rk_type - <1fe,2a,3,3bs,4,5f,5dp,5bs,3w,4ck,3ssp,4ssp>
 
   Level: intermediate
 
-.seealso: TSRKGetType(), TSRK, TSRKType, TSRK1FE, TSRK2A, TSRK3, TSRK3BS, TSRK4, TSRK5F, TSRK5DP, TSRK5BS
+.seealso: TSRKGetType(), TSRK, TSRKType, TSRK1FE, TSRK2A, TSRK3, TSRK3BS, TSRK4, TSRK5F, TSRK5DP, TSRK5BS, TSRK3W, TSRK4CK, TSRK3SSP, TSRK4SSP
 @*/
 PetscErrorCode TSRKSetType(TS ts,TSRKType rktype)
 {
@@ -962,6 +1348,16 @@ PetscErrorCode TSRKGetType(TS ts,TSRKType *rktype)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode  TSGetStages_RK(TS ts,PetscInt *ns,Vec **Y)
+{
+  TS_RK          *rk = (TS_RK*)ts->data;
+
+  PetscFunctionBegin;
+  *ns = rk->tableau->s;
+  if(Y) *Y  = rk->Y;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode TSRKGetType_RK(TS ts,TSRKType *rktype)
 {
   TS_RK *rk = (TS_RK*)ts->data;
@@ -989,6 +1385,27 @@ static PetscErrorCode TSRKSetType_RK(TS ts,TSRKType rktype)
       rk->tableau = &link->tab;
       if (ts->setupcalled) {ierr = TSRKTableauSetUp(ts);CHKERRQ(ierr);}
       ts->default_adapt_type = rk->tableau->bembed ? TSADAPTBASIC : TSADAPTNONE;
+      if (rk->tableau->lstype) { /* the stages are not stored */
+        ts->ops->step            = TSStep_RK_LowStorage;
+        ts->ops->evaluatestep    = TSEvaluateStep_RK_LowStorage;
+        ts->ops->rollback        = TSRollBack_RK_LowStorage;
+        ts->ops->interpolate     = NULL;
+        ts->ops->adjointsetup    = NULL;
+        ts->ops->adjointstep     = NULL;
+        ts->ops->adjointintegral = NULL;
+        ts->ops->forwardintegral = NULL;
+        ts->ops->getstages       = NULL;
+      } else {
+        ts->ops->step            = TSStep_RK;
+        ts->ops->evaluatestep    = TSEvaluateStep_RK;
+        ts->ops->rollback        = TSRollBack_RK;
+        ts->ops->interpolate     = TSInterpolate_RK;
+        ts->ops->adjointsetup    = TSAdjointSetUp_RK;
+        ts->ops->adjointstep     = TSAdjointStep_RK;
+        ts->ops->adjointintegral = TSAdjointCostIntegral_RK;
+        ts->ops->forwardintegral = TSForwardCostIntegral_RK;
+        ts->ops->getstages       = TSGetStages_RK;
+      }
       PetscFunctionReturn(0);
     }
   }
@@ -996,16 +1413,6 @@ static PetscErrorCode TSRKSetType_RK(TS ts,TSRKType rktype)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode  TSGetStages_RK(TS ts,PetscInt *ns,Vec **Y)
-{
-  TS_RK          *rk = (TS_RK*)ts->data;
-
-  PetscFunctionBegin;
-  *ns = rk->tableau->s;
-  if(Y) *Y  = rk->Y;
-  PetscFunctionReturn(0);
-}
-
 static PetscErrorCode TSDestroy_RK(TS ts)
 {
   PetscErrorCode ierr;
@@ -1032,6 +1439,10 @@ static PetscErrorCode TSDestroy_RK(TS ts)
   Notes:
   The default is TSRK3BS, it can be changed with TSRKSetType() or -ts_rk_type
 
+  The low-storage schemes, TSRK3W, TSRK4CK, TSRK3SSP, TSRK4SSP, or those registered with TSRKRegister2N() and TSRKRegister3Sstar(),
+  keep two or three registers instead of all the stages and their function evaluations; they do not support interpolation,
+  cost integrals, or adjoints.
+
   Level: beginner
 
 .seealso:  TSCreate(), TS, TSSetType(), TSRKSetType(), TSRKGetType(), TSRKSetFullyImplicit(), TSRK2D, TTSRK2E, TSRK3,
@@ -0,0 +1,546 @@
+/*
+  Code for timestepping with exponential Rosenbrock methods
+
+  The problem is U_t = f(t,U), given either as a right hand side or as an implicit function F(t,U,U_t) = U_t - f(t,U).
+  Each step linearizes f at the start of the step, f(t,U) = f(t_n,U_n) + J (U - U_n) + v (t - t_n) + g_n(t,U), and
+  integrates the linear part exactly through the products of the phi functions of h J with vectors. These products
+  are approximated in Krylov spaces of J built by Arnoldi, their dimension grows until an estimate of the error of the
+  product is small enough, so the step size is not limited by the stiffness of J and no preconditioner is ever set up.
+*/
+#include <petsc/private/tsimpl.h>                /*I   "petscts.h"   I*/
+#include <petscblaslapack.h>
+
+static const char *const TSExpRBTypes[] = {TSEXPRB2,TSEXPRB32};
+
+typedef struct {
+  char             type[8];
+  PetscInt         order;
+  Vec              X0;             /* solution at the start of the step */
+  Vec              F0;             /* f(t_n,U_n) */
+  Vec              V;              /* df/dt(t_n,U_n) */
+  Vec              Y2;             /* exponential Rosenbrock-Euler solution, embedded solution of the third order method */
+  Vec              W,D,Zero;
+  Vec              *Vk;            /* Krylov basis */
+  PetscInt         maxdim;         /* maximum dimension of the Krylov spaces */
+  PetscReal        krylov_rtol;    /* relative tolerance of the phi function products */
+  PetscScalar      *H;             /* Hessenberg matrix of the Arnoldi process */
+  PetscScalar      *E,*work;       /* dense matrices for the exponential of the augmented Hessenberg matrix */
+  PetscBLASInt     *ipiv;
+  PetscReal        vnorm;
+  PetscReal        hkrylov;        /* recent time step for which a product did not converge */
+  PetscReal        linear_time;    /* time and state of the start of the step of the current linearization */
+  PetscObjectState linear_state;
+  PetscInt         stepdim;        /* largest dimension of the Krylov spaces in the current step */
+  PetscInt         nproducts,nmult,dimmax;
+  TSStepStatus     status;
+} TS_ExpRB;
+
+/* E = exp(A) for a dense n x n matrix, by the (6,6) Pade approximant with scaling and squaring; A is overwritten */
+static PetscErrorCode TSExpRBExpm_Private(PetscInt n,PetscScalar *A,PetscScalar *E,PetscScalar *work,PetscBLASInt *ipiv)
+{
+  const PetscInt p = 6;
+  PetscScalar    *A2 = work,*A4 = work+n*n,*U = work+2*n*n,*V = work+3*n*n,*T;
+  PetscScalar    c[7],one = 1.0,zero = 0.0;
+  PetscReal      nrm = 0.0,rowsum;
+  PetscInt       i,j,k,s;
+  PetscBLASInt   bn,info;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (j=0,rowsum=0.0; j<n; j++) rowsum += PetscAbsScalar(A[i+j*n]);
+    nrm = PetscMax(nrm,rowsum);
+  }
+  s = nrm > 0.5 ? (PetscInt)PetscCeilReal(PetscLog2Real(nrm/0.5)) : 0;
+  for (i=0; i<n*n; i++) A[i] /= PetscPowReal(2.0,(PetscReal)s);
+
+  c[0] = 1.0;
+  for (k=1; k<=p; k++) c[k] = c[k-1]*(PetscReal)(p+1-k)/(PetscReal)(k*(2*p+1-k));
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bn,&bn,&one,A,&bn,A,&bn,&zero,A2,&bn));
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bn,&bn,&one,A2,&bn,A2,&bn,&zero,A4,&bn));
+  /* V = c1 I + c3 A^2 + c5 A^4 and E = c0 I + c2 A^2 + c4 A^4 + c6 A^6 */
+  for (i=0; i<n*n; i++) {
+    V[i] = c[3]*A2[i] + c[5]*A4[i];
+    E[i] = c[2]*A2[i] + c[4]*A4[i];
+  }
+  for (i=0; i<n; i++) {
+    V[i+i*n] += c[1];
+    E[i+i*n] += c[0];
+  }
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bn,&bn,&c[6],A4,&bn,A2,&bn,&one,E,&bn));
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bn,&bn,&one,A,&bn,V,&bn,&zero,U,&bn));
+  /* exp(A) ~ (E - U)^{-1} (E + U) */
+  for (i=0; i<n*n; i++) {
+    V[i] = E[i] - U[i];
+    E[i] = E[i] + U[i];
+  }
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgetrf",LAPACKgetrf_(&bn,&bn,V,&bn,ipiv,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine getrf %d",(int)info);
+  PetscStackCallBLAS("LAPACKgetrs",LAPACKgetrs_("N",&bn,&bn,V,&bn,ipiv,E,&bn,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine getrs %d",(int)info);
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  for (k=0; k<s; k++) {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bn,&bn,&one,E,&bn,E,&bn,&zero,U,&bn));
+    T = E; E = U; U = T;
+  }
+  if (s % 2) {ierr = PetscMemcpy(U,E,n*n*sizeof(PetscScalar));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+  Y = phi_k(tau J) B with J = -A, A being the Jacobian of the implicit function with shift 0.
+
+  After m Arnoldi steps phi_k(tau J) B ~ beta V_m phi_k(tau H_m) e_1. The exponential of the augmented matrix
+
+     [ tau H_m  e_1  0 ]
+     [    0      0   I ]   (with k+1 columns after the first m)
+     [    0      0   0 ]
+
+  holds phi_1(tau H_m) e_1, ..., phi_{k+1}(tau H_m) e_1 in its last k+1 columns, the last one gives the estimate
+  beta tau h_{m+1,m} |e_m^T phi_{k+1}(tau H_m) e_1| of the error.
+*/
+static PetscErrorCode TSExpRBPhi_Private(TS ts,Mat A,PetscInt k,PetscReal tau,Vec B,Vec Y,PetscBool *conv)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscInt       mmax = rb->maxdim,ld = rb->maxdim+1,i,j,m,N;
+  PetscScalar    *H = rb->H,*Ha = rb->work + 4*(rb->maxdim+5)*(rb->maxdim+5),*phi = NULL;
+  PetscReal      beta,hnext,est = 0.0,ynrm,hnrm = 0.0;
+  PetscBool      happy = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *conv = PETSC_FALSE;
+  rb->nproducts++;
+  ierr = VecNorm(B,NORM_2,&beta);CHKERRQ(ierr);
+  if (beta == 0.0) {
+    ierr = VecZeroEntries(Y);CHKERRQ(ierr);
+    *conv = PETSC_TRUE;
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMemzero(H,ld*mmax*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = VecAXPBY(rb->Vk[0],1.0/beta,0.0,B);CHKERRQ(ierr);
+  for (m=1; m<=mmax; m++) {
+    Vec w = rb->Vk[m];
+
+    /* Arnoldi step with classical Gram-Schmidt applied twice */
+    ierr = MatMult(A,rb->Vk[m-1],w);CHKERRQ(ierr);
+    ierr = VecScale(w,-1.0);CHKERRQ(ierr);
+    rb->nmult++;
+    for (j=0; j<2; j++) {
+      PetscScalar *h = rb->E;
+      ierr = VecMDot(w,m,rb->Vk,h);CHKERRQ(ierr);
+      for (i=0; i<m; i++) {
+        H[i+(m-1)*ld] += h[i];
+        h[i] = -h[i];
+      }
+      ierr = VecMAXPY(w,m,h,rb->Vk);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(w,NORM_2,&hnext);CHKERRQ(ierr);
+    H[m+(m-1)*ld] = hnext;
+    for (i=0; i<m; i++) hnrm = PetscMax(hnrm,PetscAbsScalar(H[i+(m-1)*ld]));
+    if (hnext <= PETSC_MACHINE_EPSILON*hnrm*m) happy = PETSC_TRUE;
+
+    /* phi functions of the projected matrix */
+    N    = m+k+1;
+    ierr = PetscMemzero(Ha,N*N*sizeof(PetscScalar));CHKERRQ(ierr);
+    for (j=0; j<m; j++) for (i=0; i<=PetscMin(j+1,m-1); i++) Ha[i+j*N] = tau*H[i+j*ld];
+    Ha[0+m*N] = 1.0;
+    for (j=m+1; j<N; j++) Ha[(j-1)+j*N] = 1.0;
+    ierr = TSExpRBExpm_Private(N,Ha,rb->E,rb->work,rb->ipiv);CHKERRQ(ierr);
+    phi  = rb->E + (m+k-1)*N;
+    est  = beta*tau*hnext*PetscAbsScalar(rb->E[(m-1)+(m+k)*N]);
+    for (i=0,ynrm=0.0; i<m; i++) ynrm += PetscSqr(PetscAbsScalar(phi[i]));
+    ynrm = beta*PetscSqrtReal(ynrm);
+    if (happy || est <= rb->krylov_rtol*ynrm) {
+      *conv = PETSC_TRUE;
+      break;
+    }
+    if (m == mmax) break;
+    ierr = VecScale(w,1.0/hnext);CHKERRQ(ierr);
+  }
+  m = PetscMin(m,mmax);
+  rb->dimmax  = PetscMax(rb->dimmax,m);
+  rb->stepdim = PetscMax(rb->stepdim,m);
+  for (i=0; i<m; i++) phi[i] *= beta;
+  ierr = VecZeroEntries(Y);CHKERRQ(ierr);
+  ierr = VecMAXPY(Y,m,phi,rb->Vk);CHKERRQ(ierr);
+  ierr = PetscInfo4(ts,"phi_%D product with Krylov dimension %D, error estimate %g, %s\n",k,m,(double)est,*conv ? "converged" : "not converged");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* F = f(t,U) */
+static PetscErrorCode TSExpRBComputeFunction_Private(TS ts,PetscReal t,Vec U,Vec F)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSComputeIFunction(ts,t,U,rb->Zero,F,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = VecScale(F,-1.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSEvaluateStep_ExpRB(TS ts,PetscInt order,Vec U,PetscBool *done)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (order == rb->order) {
+    ierr = VecCopy(ts->vec_sol,U);CHKERRQ(ierr);
+  } else if (order == 2 && rb->order == 3) {
+    ierr = VecCopy(rb->Y2,U);CHKERRQ(ierr);
+  } else {
+    if (done) {*done = PETSC_FALSE; PetscFunctionReturn(0);}
+    SETERRQ3(PetscObjectComm((PetscObject)ts),PETSC_ERR_SUP,"Exponential Rosenbrock '%s' of order %D cannot evaluate step at order %D. Consider using -ts_adapt_type none or the method 32 which has an embedded estimate.",rb->type,rb->order,order);
+  }
+  if (done) *done = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSRollBack_ExpRB(TS ts)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecCopy(rb->X0,ts->vec_sol);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  Exponential Rosenbrock-Euler and exprb32 of Hochbruck, Ostermann and Schweitzer:
+
+    Y2      = U_n + h phi_1(hJ) f(t_n,U_n) + h^2 phi_2(hJ) v
+    U_{n+1} = Y2 + 2 h phi_3(hJ) D,   D = f(t_n+h,Y2) - f(t_n,U_n) - J (Y2 - U_n) - h v
+
+  The derivative v in time is differenced, it vanishes exactly for an autonomous problem and then costs no product.
+*/
+static PetscErrorCode TSStep_ExpRB(TS ts)
+{
+  TS_ExpRB         *rb = (TS_ExpRB*)ts->data;
+  TSAdapt          adapt;
+  Mat              A,P;
+  PetscInt         rejections = 0;
+  PetscBool        conv,stageok,accept = PETSC_TRUE;
+  PetscReal        next_time_step = ts->time_step,dt;
+  PetscObjectState state;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!ts->steprollback) {
+    ierr = VecCopy(ts->vec_sol,rb->X0);CHKERRQ(ierr);
+  }
+  ierr = TSGetAdapt(ts,&adapt);CHKERRQ(ierr);
+  ierr = TSGetIJacobian(ts,&A,&P,NULL,NULL);CHKERRQ(ierr);
+
+  rb->status = TS_STEP_INCOMPLETE;
+  while (!ts->reason && rb->status != TS_STEP_COMPLETE) {
+    const PetscReal t = ts->ptime,h = ts->time_step;
+
+    rb->stepdim = 0;
+    ierr = TSPreStage(ts,t);CHKERRQ(ierr);
+    ierr = PetscObjectStateGet((PetscObject)rb->X0,&state);CHKERRQ(ierr);
+    if (t != rb->linear_time || state != rb->linear_state) {
+      /* the linearization only depends on the start of the step, it is kept when the step is retried */
+      ierr = TSExpRBComputeFunction_Private(ts,t,rb->X0,rb->F0);CHKERRQ(ierr);
+      ierr = TSComputeIJacobian(ts,t,rb->X0,rb->Zero,0.0,A,P,PETSC_FALSE);CHKERRQ(ierr);
+      dt   = PETSC_SQRT_MACHINE_EPSILON*PetscMax(PetscAbsReal(t),1.0);
+      ierr = TSExpRBComputeFunction_Private(ts,t+dt,rb->X0,rb->V);CHKERRQ(ierr);
+      ierr = VecAXPBY(rb->V,-1.0/dt,1.0/dt,rb->F0);CHKERRQ(ierr);
+      ierr = VecNorm(rb->V,NORM_INFINITY,&rb->vnorm);CHKERRQ(ierr);
+      ierr = PetscObjectStateGet((PetscObject)rb->X0,&rb->linear_state);CHKERRQ(ierr);
+      rb->linear_time = t;
+    }
+
+    ierr = TSExpRBPhi_Private(ts,A,1,h,rb->F0,rb->W,&conv);CHKERRQ(ierr);
+    if (!conv) goto krylov_fail;
+    ierr = VecWAXPY(rb->Y2,h,rb->W,rb->X0);CHKERRQ(ierr);
+    if (rb->vnorm > 0.0) {
+      ierr = TSExpRBPhi_Private(ts,A,2,h,rb->V,rb->W,&conv);CHKERRQ(ierr);
+      if (!conv) goto krylov_fail;
+      ierr = VecAXPY(rb->Y2,h*h,rb->W);CHKERRQ(ierr);
+    }
+    ierr = TSPostStage(ts,t+h,0,&rb->Y2);CHKERRQ(ierr);
+    ierr = TSAdaptCheckStage(adapt,ts,t+h,rb->Y2,&stageok);CHKERRQ(ierr);
+    if (!stageok) goto reject_step;
+
+    if (rb->order == 3) {
+      ierr = TSPreStage(ts,t+h);CHKERRQ(ierr);
+      ierr = TSExpRBComputeFunction_Private(ts,t+h,rb->Y2,rb->D);CHKERRQ(ierr);
+      ierr = VecAXPBYPCZ(rb->D,-1.0,-h,1.0,rb->F0,rb->V);CHKERRQ(ierr);
+      ierr = VecWAXPY(rb->W,-1.0,rb->X0,rb->Y2);CHKERRQ(ierr);
+      ierr = VecCopy(rb->W,rb->Vk[0]);CHKERRQ(ierr);
+      ierr = MatMult(A,rb->Vk[0],rb->W);CHKERRQ(ierr);
+      rb->nmult++;
+      ierr = VecAXPY(rb->D,1.0,rb->W);CHKERRQ(ierr); /* D - J (Y2 - U_n) with J = -A */
+      ierr = TSExpRBPhi_Private(ts,A,3,h,rb->D,rb->W,&conv);CHKERRQ(ierr);
+      if (!conv) goto krylov_fail;
+      ierr = VecWAXPY(ts->vec_sol,2.0*h,rb->W,rb->Y2);CHKERRQ(ierr);
+      ierr = TSPostStage(ts,t+h,1,&ts->vec_sol);CHKERRQ(ierr);
+    } else {
+      ierr = VecCopy(rb->Y2,ts->vec_sol);CHKERRQ(ierr);
+    }
+
+    rb->status = TS_STEP_PENDING;
+    ierr = TSAdaptCandidatesClear(adapt);CHKERRQ(ierr);
+    ierr = TSAdaptCandidateAdd(adapt,rb->type,rb->order,1,1.0,(PetscReal)(rb->order-1),PETSC_TRUE);CHKERRQ(ierr);
+    ierr = TSAdaptChoose(adapt,ts,ts->time_step,NULL,&next_time_step,&accept);CHKERRQ(ierr);
+    rb->status = accept ? TS_STEP_COMPLETE : TS_STEP_INCOMPLETE;
+    if (!accept) {
+      ierr = TSRollBack_ExpRB(ts);CHKERRQ(ierr);
+      ts->time_step = next_time_step;
+      goto reject_step;
+    }
+
+    /* do not come back right away to a step too long for the Krylov spaces */
+    if (rb->hkrylov > 0.0) {
+      if (2*rb->stepdim < rb->maxdim) rb->hkrylov *= 1.1;
+      next_time_step = PetscMin(next_time_step,0.9*rb->hkrylov);
+    }
+    ts->ptime    += ts->time_step;
+    ts->time_step = next_time_step;
+    break;
+
+  krylov_fail:
+    /* a smaller step makes the phi functions easier to approximate */
+    ierr = PetscInfo2(ts,"Step=%D, Krylov space of dimension %D too small, reducing the time step\n",ts->steps,rb->maxdim);CHKERRQ(ierr);
+    ierr = TSRollBack_ExpRB(ts);CHKERRQ(ierr);
+    rb->hkrylov    = ts->time_step;
+    ts->time_step *= 0.25;
+  reject_step:
+    ts->reject++; accept = PETSC_FALSE;
+    if (!ts->reason && ++rejections > ts->max_reject && ts->max_reject >= 0) {
+      ts->reason = TS_DIVERGED_STEP_REJECTED;
+      ierr = PetscInfo2(ts,"Step=%D, step rejections %D greater than current TS allowed, stopping solve\n",ts->steps,rejections);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSReset_ExpRB(TS ts)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDestroy(&rb->X0);CHKERRQ(ierr);
+  ierr = VecDestroy(&rb->F0);CHKERRQ(ierr);
+  ierr = VecDestroy(&rb->V);CHKERRQ(ierr);
+  ierr = VecDestroy(&rb->Y2);CHKERRQ(ierr);
+  ierr = VecDestroy(&rb->W);CHKERRQ(ierr);
+  ierr = VecDestroy(&rb->D);CHKERRQ(ierr);
+  ierr = VecDestroy(&rb->Zero);CHKERRQ(ierr);
+  if (rb->Vk) {ierr = VecDestroyVecs(rb->maxdim+1,&rb->Vk);CHKERRQ(ierr);}
+  ierr = PetscFree4(rb->H,rb->E,rb->work,rb->ipiv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSDestroy_ExpRB(TS ts)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSReset_ExpRB(ts);CHKERRQ(ierr);
+  ierr = PetscFree(ts->data);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSExpRBSetType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSExpRBGetType_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetUp_ExpRB(TS ts)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscInt       N = rb->maxdim+5;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (rb->maxdim < 1) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_OUTOFRANGE,"Maximum Krylov dimension %D must be positive",rb->maxdim);
+  ierr = VecDuplicate(ts->vec_sol,&rb->X0);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&rb->F0);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&rb->V);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&rb->Y2);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&rb->W);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&rb->D);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&rb->Zero);CHKERRQ(ierr);
+  ierr = VecZeroEntries(rb->Zero);CHKERRQ(ierr);
+  rb->linear_time  = PETSC_MIN_REAL;
+  rb->linear_state = -1;
+  ierr = VecDuplicateVecs(ts->vec_sol,rb->maxdim+1,&rb->Vk);CHKERRQ(ierr);
+  ierr = PetscMalloc4((rb->maxdim+1)*rb->maxdim,&rb->H,N*N,&rb->E,5*N*N,&rb->work,N,&rb->ipiv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSExpRBSetType_ExpRB(TS ts,TSExpRBType type)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscBool      flg2,flg32;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscStrcmp(type,TSEXPRB2,&flg2);CHKERRQ(ierr);
+  ierr = PetscStrcmp(type,TSEXPRB32,&flg32);CHKERRQ(ierr);
+  if (!flg2 && !flg32) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_UNKNOWN_TYPE,"Could not find exponential Rosenbrock method '%s'",type);
+  ierr = PetscStrncpy(rb->type,type,sizeof(rb->type));CHKERRQ(ierr);
+  rb->order = flg2 ? 2 : 3;
+  ts->default_adapt_type = flg2 ? TSADAPTNONE : TSADAPTBASIC;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSExpRBGetType_ExpRB(TS ts,TSExpRBType *type)
+{
+  TS_ExpRB *rb = (TS_ExpRB*)ts->data;
+
+  PetscFunctionBegin;
+  *type = rb->type;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetFromOptions_ExpRB(PetscOptionItems *PetscOptionsObject,TS ts)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscInt       choice = rb->order == 2 ? 0 : 1;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"Exponential Rosenbrock ODE solver options");CHKERRQ(ierr);
+  {
+    ierr = PetscOptionsEList("-ts_exprb_type","Exponential Rosenbrock method","TSExpRBSetType",TSExpRBTypes,2,TSExpRBTypes[choice],&choice,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = TSExpRBSetType(ts,TSExpRBTypes[choice]);CHKERRQ(ierr);}
+    ierr = PetscOptionsInt("-ts_exprb_krylov_maxdim","Maximum dimension of the Krylov spaces","",rb->maxdim,&rb->maxdim,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_exprb_krylov_rtol","Relative tolerance of the phi function products","",rb->krylov_rtol,&rb->krylov_rtol,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSView_ExpRB(TS ts,PetscViewer viewer)
+{
+  TS_ExpRB       *rb = (TS_ExpRB*)ts->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  Exponential Rosenbrock method %s of order %D\n",rb->type,rb->order);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  Krylov spaces: maximum dimension=%D, relative tolerance=%g\n",rb->maxdim,(double)rb->krylov_rtol);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  phi function products=%D, Jacobian products=%D, largest dimension used=%D\n",rb->nproducts,rb->nmult,rb->dimmax);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*MC
+      TSEXPRB - ODE solver using exponential Rosenbrock methods
+
+  The problem is U_t = f(t,U), given with TSSetRHSFunction() or with TSSetIFunction() as F(t,U,U_t) = U_t - f(t,U); the
+  Jacobian must be provided with TSSetRHSJacobian() or TSSetIJacobian(), it is only applied to vectors so a MATSHELL
+  is enough. The Jacobian at the start of each step is integrated exactly: the products of the phi functions of h J
+  with vectors are computed in Krylov spaces whose dimension grows until the estimated error of the product is below
+  the relative tolerance, no linear system is solved and no preconditioner is set up. A product which does not
+  converge in the maximum dimension rejects the step and retries with a smaller one; the following steps are kept
+  below the rejected one until the Krylov spaces become small again.
+
+  The methods are
++  2 - exponential Rosenbrock-Euler, order 2 without error estimate
+-  32 - exprb32 of Hochbruck, Ostermann and Schweitzer, order 3 with the exponential Rosenbrock-Euler solution as embedded method, used with TSAdapt
+
+  Options Database:
++  -ts_exprb_type <32> - the method
+.  -ts_exprb_krylov_maxdim <30> - maximum dimension of the Krylov spaces
+-  -ts_exprb_krylov_rtol <1e-8> - relative tolerance of the phi function products
+
+  Notes:
+  A nonautonomous problem costs one more evaluation of the function per step to difference its derivative in time,
+  and one more Krylov product.
+
+  References:
+.  1. -  M. Hochbruck, A. Ostermann and J. Schweitzer, Exponential Rosenbrock-type methods, SIAM J. Numer. Anal. 47 (2009).
+
+  Level: intermediate
+
+.seealso:  TSCreate(), TS, TSSetType(), TSExpRBSetType(), TSROSW
+
+M*/
+PETSC_EXTERN PetscErrorCode TSCreate_ExpRB(TS ts)
+{
+  TS_ExpRB       *rb;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ts->ops->reset          = TSReset_ExpRB;
+  ts->ops->destroy        = TSDestroy_ExpRB;
+  ts->ops->view           = TSView_ExpRB;
+  ts->ops->setup          = TSSetUp_ExpRB;
+  ts->ops->setfromoptions = TSSetFromOptions_ExpRB;
+  ts->ops->step           = TSStep_ExpRB;
+  ts->ops->evaluatestep   = TSEvaluateStep_ExpRB;
+  ts->ops->rollback       = TSRollBack_ExpRB;
+
+  ierr = PetscNewLog(ts,&rb);CHKERRQ(ierr);
+  ts->data = (void*)rb;
+
+  rb->maxdim      = 30;
+  rb->krylov_rtol = 1.e-8;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSExpRBSetType_C",TSExpRBSetType_ExpRB);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSExpRBGetType_C",TSExpRBGetType_ExpRB);CHKERRQ(ierr);
+  ierr = TSExpRBSetType_ExpRB(ts,TSEXPRB32);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  TSExpRBSetType - Set the exponential Rosenbrock method
+
+  Logically Collective
+
+  Input Parameters:
++  ts - timestepping context
+-  type - TSEXPRB2 or TSEXPRB32
+
+  Options Database:
+.  -ts_exprb_type <2,32> - the method
+
+  Level: intermediate
+
+.seealso: TSExpRBGetType(), TSEXPRB
+@*/
+PetscErrorCode TSExpRBSetType(TS ts,TSExpRBType type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidCharPointer(type,2);
+  ierr = PetscTryMethod(ts,"TSExpRBSetType_C",(TS,TSExpRBType),(ts,type));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  TSExpRBGetType - Get the exponential Rosenbrock method
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  type - the method
+
+  Level: intermediate
+
+.seealso: TSExpRBSetType(), TSEXPRB
+@*/
+PetscErrorCode TSExpRBGetType(TS ts,TSExpRBType *type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidPointer(type,2);
+  ierr = PetscUseMethod(ts,"TSExpRBGetType_C",(TS,TSExpRBType*),(ts,type));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
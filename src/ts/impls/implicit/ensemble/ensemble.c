@@ -0,0 +1,557 @@
+/*
+  Code for the integration of an ensemble of small independent ODE systems.
+
+  The solution vector holds the members interleaved, each member is a block of the block size of the vector. Every
+  member is advanced with its own time step and its own Newton iteration by an L-stable two stage SDIRK method, the
+  members only synchronize at the end of each step of the TS. The diagonal blocks of I - h gamma J are factored and
+  solved all at once with the entries of the different members stored contiguously, so that the innermost loops of
+  the dense kernels run over the members.
+*/
+#include <petsc/private/tsimpl.h>                /*I   "petscts.h"   I*/
+
+static const PetscReal EnsembleGamma = 0.29289321881345247560; /* 1 - 1/sqrt(2) */
+
+typedef struct {
+  PetscInt    bs;              /* size of each member */
+  PetscInt    n;               /* number of local members */
+  PetscReal   *t;              /* time of each member */
+  PetscReal   *h;              /* time step each member will try next */
+  PetscReal   *hu;             /* time step of each member in the current sweep */
+  PetscReal   *gh;             /* gamma*hu, zero for the members which do not move */
+  PetscReal   *tstage;         /* time of each member at which the right hand side is evaluated */
+  PetscReal   *err;
+  PetscBool   *active;         /* the member has not reached the end of the step of the TS */
+  PetscBool   *conv;           /* the Newton iteration of the member is finished */
+  PetscBool   *fail;           /* the factorization or the Newton iteration of the member failed */
+  PetscScalar *J;              /* diagonal blocks of the Jacobian, entry (i,j) of member m at (i*bs+j)*n+m */
+  PetscScalar *M;              /* LU factors of I - gamma*hu*J with the inverse of the pivots, same layout */
+  PetscScalar *r;              /* right hand sides of the solves, entry i of member m at i*n+m */
+  PetscReal   *scale;          /* work array with one entry per member */
+  Vec         Y,Z,K1,G,D;
+  PetscBool   fdjacobian;      /* difference the right hand side even if a Jacobian is provided */
+  PetscInt    newton_maxit;
+  PetscReal   newton_tol;
+  PetscInt    nsteps,nrejects,nfails,nnewton,nrhs,njac;
+} TS_Ensemble;
+
+/* LU factorization without pivoting of I - gh[m] J_m for all the members; a member with a small pivot is marked failed */
+static void TSEnsembleFactor_Private(PetscInt bs,PetscInt n,const PetscReal *gh,const PetscScalar *J,PetscScalar *M,PetscReal *scale,PetscBool *fail)
+{
+  PetscInt  i,j,k,m;
+  PetscReal tol = PETSC_SQRT_MACHINE_EPSILON;
+
+  for (m=0; m<n; m++) scale[m] = 1.0;
+  for (i=0; i<bs; i++) {
+    for (j=0; j<bs; j++) {
+      const PetscScalar *Jij = J + (i*bs+j)*n;
+      PetscScalar       *Mij = M + (i*bs+j)*n;
+      for (m=0; m<n; m++) {
+        Mij[m]   = (i == j ? 1.0 : 0.0) - gh[m]*Jij[m];
+        scale[m] = PetscMax(scale[m],PetscAbsScalar(Mij[m]));
+      }
+    }
+  }
+  for (k=0; k<bs; k++) {
+    PetscScalar *Mkk = M + (k*bs+k)*n;
+    for (m=0; m<n; m++) {
+      if (PetscAbsScalar(Mkk[m]) > tol*scale[m] && !PetscIsInfOrNanScalar(Mkk[m])) Mkk[m] = 1.0/Mkk[m];
+      else {
+        fail[m] = PETSC_TRUE;
+        Mkk[m]  = 0.0;
+      }
+    }
+    for (i=k+1; i<bs; i++) {
+      PetscScalar *Mik = M + (i*bs+k)*n;
+      for (m=0; m<n; m++) Mik[m] *= Mkk[m];
+      for (j=k+1; j<bs; j++) {
+        const PetscScalar *Mkj = M + (k*bs+j)*n;
+        PetscScalar       *Mij = M + (i*bs+j)*n;
+        for (m=0; m<n; m++) Mij[m] -= Mik[m]*Mkj[m];
+      }
+    }
+  }
+}
+
+/* r <- (LU)^{-1} r for all the members */
+static void TSEnsembleSolve_Private(PetscInt bs,PetscInt n,const PetscScalar *M,PetscScalar *r)
+{
+  PetscInt i,j,m;
+
+  for (i=1; i<bs; i++) {
+    for (j=0; j<i; j++) {
+      const PetscScalar *Mij = M + (i*bs+j)*n,*rj = r + j*n;
+      PetscScalar       *ri  = r + i*n;
+      for (m=0; m<n; m++) ri[m] -= Mij[m]*rj[m];
+    }
+  }
+  for (i=bs-1; i>=0; i--) {
+    const PetscScalar *Mii = M + (i*bs+i)*n;
+    PetscScalar       *ri  = r + i*n;
+    for (j=i+1; j<bs; j++) {
+      const PetscScalar *Mij = M + (i*bs+j)*n,*rj = r + j*n;
+      for (m=0; m<n; m++) ri[m] -= Mij[m]*rj[m];
+    }
+    for (m=0; m<n; m++) ri[m] *= Mii[m];
+  }
+}
+
+/* weighted root mean square norm of the block of member m of d */
+PETSC_STATIC_INLINE PetscReal TSEnsembleNorm_Private(TS ts,PetscInt bs,const PetscScalar *d,const PetscScalar *x,const PetscScalar *y)
+{
+  PetscInt  i;
+  PetscReal sum = 0.0,tol;
+
+  for (i=0; i<bs; i++) {
+    tol  = ts->atol + ts->rtol*PetscMax(PetscAbsScalar(x[i]),PetscAbsScalar(y[i]));
+    sum += PetscSqr(PetscAbsScalar(d[i])/tol);
+  }
+  return PetscSqrtReal(sum/bs);
+}
+
+/* total number of members whose flag is flg */
+static PetscErrorCode TSEnsembleCount_Private(TS ts,const PetscBool *flags,PetscBool flg,PetscInt *count)
+{
+  TS_Ensemble    *en = (TS_Ensemble*)ts->data;
+  PetscInt       m,c = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (m=0; m<en->n; m++) if (flags[m] == flg) c++;
+  ierr = MPIU_Allreduce(&c,count,1,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)ts));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* diagonal blocks of the Jacobian of the right hand side at X, from the matrix of the user or by differencing the right hand side */
+static PetscErrorCode TSEnsembleComputeJacobian_Private(TS ts,Vec X)
+{
+  TS_Ensemble       *en = (TS_Ensemble*)ts->data;
+  PetscInt          bs = en->bs,n = en->n,i,j,m,rstart;
+  PetscScalar       *y,*J = en->J;
+  const PetscScalar *x,*g,*d;
+  TSRHSJacobian     rhsjacobian;
+  Mat               B;
+  DM                dm;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  en->njac++;
+  ierr = TSGetDM(ts,&dm);CHKERRQ(ierr);
+  ierr = DMTSGetRHSJacobian(dm,&rhsjacobian,NULL);CHKERRQ(ierr);
+  B    = ts->Brhs ? ts->Brhs : ts->Arhs;
+  if (rhsjacobian && B && !en->fdjacobian) {
+    PetscInt    *idx;
+    PetscScalar *vals;
+
+    ierr = TSComputeRHSJacobian(ts,ts->ptime,X,ts->Arhs,B);CHKERRQ(ierr);
+    ierr = MatGetOwnershipRange(B,&rstart,NULL);CHKERRQ(ierr);
+    ierr = PetscMalloc2(bs,&idx,bs*bs,&vals);CHKERRQ(ierr);
+    for (m=0; m<n; m++) {
+      for (i=0; i<bs; i++) idx[i] = rstart + m*bs + i;
+      ierr = MatGetValues(B,bs,idx,bs,idx,vals);CHKERRQ(ierr);
+      for (i=0; i<bs*bs; i++) J[i*n+m] = vals[i];
+    }
+    ierr = PetscFree2(idx,vals);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  /* one evaluation of the right hand side per column, with the same column of all the members perturbed at once */
+  ierr = TSComputeRHSFunction(ts,ts->ptime,X,en->G);CHKERRQ(ierr);
+  en->nrhs++;
+  for (j=0; j<bs; j++) {
+    ierr = VecCopy(X,en->Y);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+    ierr = VecGetArray(en->Y,&y);CHKERRQ(ierr);
+    for (m=0; m<n; m++) {
+      PetscReal u = PetscRealPart(x[m*bs+j]),dx;
+      dx = PETSC_SQRT_MACHINE_EPSILON*(PetscAbsReal(u) < 1.e-6 ? (u < 0.0 ? -1.e-6 : 1.e-6) : u);
+      y[m*bs+j] += dx;
+      en->scale[m] = dx;
+    }
+    ierr = VecRestoreArray(en->Y,&y);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+    ierr = TSComputeRHSFunction(ts,ts->ptime,en->Y,en->D);CHKERRQ(ierr);
+    en->nrhs++;
+    ierr = VecGetArrayRead(en->G,&g);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(en->D,&d);CHKERRQ(ierr);
+    for (i=0; i<bs; i++) {
+      PetscScalar *Jij = J + (i*bs+j)*n;
+      for (m=0; m<n; m++) Jij[m] = (d[m*bs+i] - g[m*bs+i])/en->scale[m];
+    }
+    ierr = VecRestoreArrayRead(en->D,&d);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(en->G,&g);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Solves Y - Z - gh f(Y) = 0 for the members which move by modified Newton, starting from the values in Y */
+static PetscErrorCode TSEnsembleNewton_Private(TS ts,Vec X,Vec Z,Vec Y)
+{
+  TS_Ensemble       *en = (TS_Ensemble*)ts->data;
+  PetscInt          bs = en->bs,n = en->n,i,m,it,nleft;
+  PetscScalar       *y,*r = en->r;
+  const PetscScalar *x,*z,*g;
+  PetscReal         nrm;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  for (m=0; m<n; m++) en->conv[m] = (PetscBool)(!en->active[m] || en->fail[m]);
+  for (it=0; it<en->newton_maxit; it++) {
+    ierr = TSComputeRHSFunction(ts,ts->ptime,Y,en->G);CHKERRQ(ierr);
+    en->nrhs++;
+    ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(Z,&z);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(en->G,&g);CHKERRQ(ierr);
+    ierr = VecGetArray(Y,&y);CHKERRQ(ierr);
+    for (i=0; i<bs; i++) {
+      PetscScalar *ri = r + i*n;
+      for (m=0; m<n; m++) ri[m] = y[m*bs+i] - z[m*bs+i] - en->gh[m]*g[m*bs+i];
+    }
+    TSEnsembleSolve_Private(bs,n,en->M,r);
+    for (m=0; m<n; m++) {
+      if (en->conv[m]) continue;
+      for (i=0; i<bs; i++) y[m*bs+i] -= r[i*n+m];
+      nrm = 0.0;
+      for (i=0; i<bs; i++) {
+        PetscReal tol = ts->atol + ts->rtol*PetscMax(PetscAbsScalar(x[m*bs+i]),PetscAbsScalar(y[m*bs+i]));
+        nrm += PetscSqr(PetscAbsScalar(r[i*n+m])/tol);
+      }
+      nrm = PetscSqrtReal(nrm/bs);
+      en->nnewton++;
+      if (PetscIsInfOrNanReal(nrm)) en->fail[m] = en->conv[m] = PETSC_TRUE;
+      else if (nrm <= en->newton_tol) en->conv[m] = PETSC_TRUE;
+    }
+    ierr = VecRestoreArray(Y,&y);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(en->G,&g);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(Z,&z);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+    ierr = TSEnsembleCount_Private(ts,en->conv,PETSC_FALSE,&nleft);CHKERRQ(ierr);
+    if (!nleft) break;
+  }
+  for (m=0; m<n; m++) if (!en->conv[m]) en->fail[m] = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+  One sweep tries one step for every member which has not reached tf:
+
+    Y1 = X + h gamma f(Y1)
+    Y2 = X + h (1-gamma) K1 + h gamma f(Y2),   K1 = (Y1 - X)/(h gamma)
+
+  The new value is Y2, the embedded first order method gives the error estimate h gamma (K2 - K1).
+*/
+static PetscErrorCode TSEnsembleSweep_Private(TS ts,PetscReal tf)
+{
+  TS_Ensemble       *en = (TS_Ensemble*)ts->data;
+  PetscInt          bs = en->bs,n = en->n,i,m;
+  PetscReal         gamma = EnsembleGamma,fac;
+  PetscScalar       *k1,*z,*e,*xa;
+  const PetscScalar *x,*y,*zr,*k1r;
+  Vec               X = ts->vec_sol;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  for (m=0; m<n; m++) {
+    en->fail[m] = PETSC_FALSE;
+    if (en->active[m]) {
+      en->hu[m] = PetscMin(en->h[m],tf - en->t[m]);
+      en->gh[m] = gamma*en->hu[m];
+    } else en->hu[m] = en->gh[m] = 0.0;
+    en->tstage[m] = en->t[m];
+  }
+  ierr = TSEnsembleComputeJacobian_Private(ts,X);CHKERRQ(ierr);
+  TSEnsembleFactor_Private(bs,n,en->gh,en->J,en->M,en->scale,en->fail);
+
+  /* first stage */
+  for (m=0; m<n; m++) en->tstage[m] = en->t[m] + en->gh[m];
+  ierr = VecCopy(X,en->Y);CHKERRQ(ierr);
+  ierr = TSEnsembleNewton_Private(ts,X,X,en->Y);CHKERRQ(ierr);
+
+  /* second stage */
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(en->Y,&y);CHKERRQ(ierr);
+  ierr = VecGetArray(en->K1,&k1);CHKERRQ(ierr);
+  ierr = VecGetArray(en->Z,&z);CHKERRQ(ierr);
+  for (m=0; m<n; m++) {
+    PetscReal ig = en->gh[m] != 0.0 ? 1.0/en->gh[m] : 0.0;
+    for (i=0; i<bs; i++) {
+      k1[m*bs+i] = (y[m*bs+i] - x[m*bs+i])*ig;
+      z[m*bs+i]  = x[m*bs+i] + (1.0-gamma)*en->hu[m]*k1[m*bs+i];
+    }
+    en->tstage[m] = en->t[m] + en->hu[m];
+  }
+  ierr = VecRestoreArray(en->Z,&z);CHKERRQ(ierr);
+  ierr = VecRestoreArray(en->K1,&k1);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(en->Y,&y);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = TSEnsembleNewton_Private(ts,X,en->Z,en->Y);CHKERRQ(ierr);
+
+  /* error estimate and step size control of each member, the accepted members get their new value */
+  ierr = VecGetArrayRead(en->Y,&y);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(en->Z,&zr);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(en->K1,&k1r);CHKERRQ(ierr);
+  ierr = VecGetArray(en->D,&e);CHKERRQ(ierr);
+  for (m=0; m<n; m++) {
+    /* gamma h (K2 - K1) with K2 = (Y2 - Z)/(gamma h) */
+    for (i=0; i<bs; i++) e[m*bs+i] = y[m*bs+i] - zr[m*bs+i] - en->gh[m]*k1r[m*bs+i];
+  }
+  ierr = VecRestoreArrayRead(en->K1,&k1r);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(en->Z,&zr);CHKERRQ(ierr);
+  ierr = VecGetArray(X,&xa);CHKERRQ(ierr);
+  for (m=0; m<n; m++) {
+    if (!en->active[m]) continue;
+    if (!en->fail[m]) {
+      en->err[m] = TSEnsembleNorm_Private(ts,bs,e+m*bs,xa+m*bs,y+m*bs);
+      if (PetscIsInfOrNanReal(en->err[m])) en->fail[m] = PETSC_TRUE;
+    }
+    if (en->fail[m]) {
+      en->nfails++;
+      en->h[m] = 0.25*en->hu[m];
+      continue;
+    }
+    fac = en->err[m] > 0.0 ? 0.9/PetscSqrtReal(en->err[m]) : 5.0;
+    fac = PetscMin(5.0,PetscMax(0.2,fac));
+    if (en->err[m] > 1.0) {
+      en->nrejects++;
+      en->h[m] = PetscMin(fac,0.9)*en->hu[m];
+      continue;
+    }
+    en->nsteps++;
+    for (i=0; i<bs; i++) xa[m*bs+i] = y[m*bs+i];
+    /* a step shortened to reach tf does not limit the following steps */
+    en->h[m]  = en->hu[m] < en->h[m] ? PetscMax(en->h[m],fac*en->hu[m]) : fac*en->hu[m];
+    en->t[m] += en->hu[m];
+    if (en->t[m] >= tf - 100*PETSC_MACHINE_EPSILON*PetscMax(1.0,PetscAbsReal(tf))) {
+      en->t[m]      = tf;
+      en->active[m] = PETSC_FALSE;
+    }
+  }
+  ierr = VecRestoreArray(X,&xa);CHKERRQ(ierr);
+  ierr = VecRestoreArray(en->D,&e);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(en->Y,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSStep_Ensemble(TS ts)
+{
+  TS_Ensemble    *en = (TS_Ensemble*)ts->data;
+  PetscReal      tf = ts->ptime + ts->time_step;
+  PetscInt       m,nactive;
+  PetscMPIInt    small;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (m=0; m<en->n; m++) {
+    en->t[m]      = ts->ptime;
+    en->active[m] = PETSC_TRUE;
+    if (en->h[m] <= 0.0) en->h[m] = ts->time_step;
+  }
+  while (PETSC_TRUE) {
+    ierr = TSEnsembleCount_Private(ts,en->active,PETSC_TRUE,&nactive);CHKERRQ(ierr);
+    if (!nactive) break;
+    for (m=0,small=0; m<en->n; m++) {
+      if (en->active[m] && en->h[m] < 10*PETSC_MACHINE_EPSILON*PetscMax(PetscAbsReal(en->t[m]),ts->time_step)) small = 1;
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&small,1,MPI_INT,MPI_MAX,PetscObjectComm((PetscObject)ts));CHKERRQ(ierr);
+    if (small) {
+      ts->reason = TS_DIVERGED_STEP_REJECTED;
+      PetscFunctionReturn(0);
+    }
+    ierr = TSEnsembleSweep_Private(ts,tf);CHKERRQ(ierr);
+  }
+  ts->ptime = tf;
+  for (m=0; m<en->n; m++) en->tstage[m] = tf;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSReset_Ensemble(TS ts)
+{
+  TS_Ensemble    *en = (TS_Ensemble*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree5(en->t,en->h,en->hu,en->gh,en->tstage);CHKERRQ(ierr);
+  ierr = PetscFree5(en->err,en->active,en->conv,en->fail,en->scale);CHKERRQ(ierr);
+  ierr = PetscFree3(en->J,en->M,en->r);CHKERRQ(ierr);
+  ierr = VecDestroy(&en->Y);CHKERRQ(ierr);
+  ierr = VecDestroy(&en->Z);CHKERRQ(ierr);
+  ierr = VecDestroy(&en->K1);CHKERRQ(ierr);
+  ierr = VecDestroy(&en->G);CHKERRQ(ierr);
+  ierr = VecDestroy(&en->D);CHKERRQ(ierr);
+  en->n = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSDestroy_Ensemble(TS ts)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSReset_Ensemble(ts);CHKERRQ(ierr);
+  ierr = PetscFree(ts->data);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSEnsembleGetStageTimes_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetUp_Ensemble(TS ts)
+{
+  TS_Ensemble    *en = (TS_Ensemble*)ts->data;
+  PetscInt       nloc,bs,m;
+  TSIFunction    ifunction;
+  DM             dm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSGetDM(ts,&dm);CHKERRQ(ierr);
+  ierr = DMTSGetIFunction(dm,&ifunction,NULL);CHKERRQ(ierr);
+  if (ifunction) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_SUP,"TSENSEMBLE requires the problem in the form U_t = G(t,U), use TSSetRHSFunction()");
+  if (ts->vatol || ts->vrtol) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_SUP,"TSENSEMBLE only supports scalar tolerances");
+  ierr = VecGetLocalSize(ts->vec_sol,&nloc);CHKERRQ(ierr);
+  ierr = VecGetBlockSize(ts->vec_sol,&bs);CHKERRQ(ierr);
+  if (nloc % bs) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Local size %D is not a multiple of the block size %D",nloc,bs);
+  en->bs = bs;
+  en->n  = nloc/bs;
+  m      = en->n;
+  ierr = PetscCalloc5(m,&en->t,m,&en->h,m,&en->hu,m,&en->gh,m,&en->tstage);CHKERRQ(ierr);
+  ierr = PetscCalloc5(m,&en->err,m,&en->active,m,&en->conv,m,&en->fail,m,&en->scale);CHKERRQ(ierr);
+  ierr = PetscCalloc3(bs*bs*m,&en->J,bs*bs*m,&en->M,bs*m,&en->r);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&en->Y);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&en->Z);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&en->K1);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&en->G);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&en->D);CHKERRQ(ierr);
+  for (m=0; m<en->n; m++) en->tstage[m] = ts->ptime;
+  if (ts->exact_final_time == TS_EXACTFINALTIME_UNSPECIFIED) ts->exact_final_time = TS_EXACTFINALTIME_MATCHSTEP;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetFromOptions_Ensemble(PetscOptionItems *PetscOptionsObject,TS ts)
+{
+  TS_Ensemble    *en = (TS_Ensemble*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"Ensemble ODE solver options");CHKERRQ(ierr);
+  {
+    ierr = PetscOptionsBool("-ts_ensemble_fd_jacobian","Difference the right hand side even if a Jacobian is provided","",en->fdjacobian,&en->fdjacobian,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-ts_ensemble_newton_maxit","Maximum number of Newton iterations of a stage","",en->newton_maxit,&en->newton_maxit,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_ensemble_newton_tol","Weighted norm of the Newton update to stop the iterations","",en->newton_tol,&en->newton_tol,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSView_Ensemble(TS ts,PetscViewer viewer)
+{
+  TS_Ensemble    *en = (TS_Ensemble*)ts->data;
+  PetscInt       stats[6],gstats[6];
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    stats[0] = en->n;       stats[1] = en->nsteps; stats[2] = en->nrejects;
+    stats[3] = en->nfails;  stats[4] = en->nnewton;
+    ierr = MPIU_Allreduce(stats,gstats,5,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)ts));CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  %D members of size %D, SDIRK2 with a time step per member\n",gstats[0],en->bs);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  Newton: maximum iterations=%D, tolerance=%g, %s Jacobian\n",en->newton_maxit,(double)en->newton_tol,en->fdjacobian ? "finite difference" : "user or finite difference");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  member steps=%D, rejected=%D, failed=%D, Newton iterations=%D\n",gstats[1],gstats[2],gstats[3],gstats[4]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  right hand side evaluations=%D, Jacobian evaluations=%D\n",en->nrhs,en->njac);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSEnsembleGetStageTimes_Ensemble(TS ts,const PetscReal *times[])
+{
+  TS_Ensemble *en = (TS_Ensemble*)ts->data;
+
+  PetscFunctionBegin;
+  *times = en->tstage;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+      TSENSEMBLE - ODE solver for an ensemble of small independent systems
+
+  The solution vector holds the members one after the other, the block size of the vector (VecSetBlockSize()) is the
+  size of each system; members may be distributed over the processes but no member may be split. The problem must be
+  given with TSSetRHSFunction(), the right hand side evaluates all the members at once and must not couple them.
+
+  Each member is integrated with the L-stable SDIRK method of order 2 with gamma = 1 - 1/sqrt(2), its own adaptive
+  time step controlled with the tolerances of TSSetTolerances(), and its own modified Newton iteration. The time step
+  of the TS is only the interval after which all the members are synchronized, it is not adapted. The Newton systems
+  are the diagonal blocks of I - gamma h J, which are factored by LU without pivoting for all the members at once; a
+  member whose factorization breaks down or whose Newton iteration does not converge retries with a smaller step.
+
+  The diagonal blocks of the Jacobian are taken from the matrix given with TSSetRHSJacobian(), otherwise they are
+  computed by differencing with one evaluation of the right hand side per column of a block.
+
+  Since the members are at different times, the time passed to the callbacks is the start of the current step of the
+  TS; a right hand side which depends on time obtains the time of each member with TSEnsembleGetStageTimes().
+
+  Options Database:
++  -ts_ensemble_fd_jacobian - difference the right hand side even if a Jacobian is provided
+.  -ts_ensemble_newton_maxit <8> - maximum number of Newton iterations of a stage
+-  -ts_ensemble_newton_tol <0.03> - weighted norm of the Newton update below which a member has converged
+
+  Level: intermediate
+
+.seealso:  TSCreate(), TS, TSSetType(), TSEnsembleGetStageTimes(), TSSetTolerances()
+
+M*/
+PETSC_EXTERN PetscErrorCode TSCreate_Ensemble(TS ts)
+{
+  TS_Ensemble    *en;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ts->ops->reset          = TSReset_Ensemble;
+  ts->ops->destroy        = TSDestroy_Ensemble;
+  ts->ops->view           = TSView_Ensemble;
+  ts->ops->setup          = TSSetUp_Ensemble;
+  ts->ops->setfromoptions = TSSetFromOptions_Ensemble;
+  ts->ops->step           = TSStep_Ensemble;
+
+  ts->default_adapt_type = TSADAPTNONE;
+
+  ierr = PetscNewLog(ts,&en);CHKERRQ(ierr);
+  ts->data = (void*)en;
+
+  en->newton_maxit = 8;
+  en->newton_tol   = 0.03;
+  en->fdjacobian   = PETSC_FALSE;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSEnsembleGetStageTimes_C",TSEnsembleGetStageTimes_Ensemble);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  TSEnsembleGetStageTimes - Get the time of each local member at which the right hand side is being evaluated
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  times - the times of the local members, in the order of the members in the solution vector
+
+  Notes:
+  The members of a TSENSEMBLE have their own time steps, so the time passed to the right hand side function is only the
+  start of the current step of the TS. This is meant to be called from the right hand side function of a nonautonomous
+  problem. The array belongs to the TS and must not be freed.
+
+  Level: intermediate
+
+.seealso: TSENSEMBLE, TSSetRHSFunction()
+@*/
+PetscErrorCode TSEnsembleGetStageTimes(TS ts,const PetscReal *times[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidPointer(times,2);
+  ierr = PetscUseMethod(ts,"TSEnsembleGetStageTimes_C",(TS,const PetscReal*[]),(ts,times));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
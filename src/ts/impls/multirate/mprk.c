@@ -0,0 +1,405 @@
+/*
+  Code for timestepping with multirate partitioned Runge-Kutta methods
+
+  The components of the solution are split into a slow and a fast set with TSRHSSplitSetIS(). The slow components are
+  advanced with the macro-step H and the fast ones with m micro-steps of size h = H/m, during which the slow components
+  are predicted along the slow stage derivative. When the right hand side of a split is given with
+  TSRHSSplitSetRHSFunction() only that block is evaluated, otherwise the full right hand side is evaluated and restricted.
+*/
+#include <petsc/private/tsimpl.h>                /*I   "petscts.h"   I*/
+
+typedef struct {
+  PetscInt      ratio;           /* number of fast micro-steps in a macro-step */
+  IS            isfast,isslow;
+  TSRHSFunction ffast,fslow;     /* right hand sides restricted to the splits, optional */
+  void          *cfast,*cslow;
+  Vec           X0;              /* solution at the start of the step */
+  Vec           Y;               /* stage value */
+  Vec           F;               /* full right hand side, only used for splits without their own function */
+  Vec           Kf1,Kf2;         /* fast stage derivatives */
+  Vec           Ks1,Ks2;         /* slow stage derivatives */
+  PetscInt      nfull,nfast,nslow;
+  TSStepStatus  status;
+} TS_MPRK;
+
+/* Ff and Fs, either of which may be NULL, receive the right hand side of the fast and slow splits at (t,U) */
+static PetscErrorCode TSMPRKComputeSplits_Private(TS ts,PetscReal t,Vec U,Vec Ff,Vec Fs)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  Vec            sub;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (Ff && mprk->ffast) {
+    PetscStackPush("TS user fast split right-hand-side function");
+    ierr = (*mprk->ffast)(ts,t,U,Ff,mprk->cfast);CHKERRQ(ierr);
+    PetscStackPop;
+  }
+  if (Fs && mprk->fslow) {
+    PetscStackPush("TS user slow split right-hand-side function");
+    ierr = (*mprk->fslow)(ts,t,U,Fs,mprk->cslow);CHKERRQ(ierr);
+    PetscStackPop;
+  }
+  if ((Ff && !mprk->ffast) || (Fs && !mprk->fslow)) {
+    /* a single evaluation of the full right hand side serves both splits */
+    ierr = TSComputeRHSFunction(ts,t,U,mprk->F);CHKERRQ(ierr);
+    mprk->nfull++;
+    if (Ff && !mprk->ffast) {
+      ierr = VecGetSubVector(mprk->F,mprk->isfast,&sub);CHKERRQ(ierr);
+      ierr = VecCopy(sub,Ff);CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(mprk->F,mprk->isfast,&sub);CHKERRQ(ierr);
+    }
+    if (Fs && !mprk->fslow) {
+      ierr = VecGetSubVector(mprk->F,mprk->isslow,&sub);CHKERRQ(ierr);
+      ierr = VecCopy(sub,Fs);CHKERRQ(ierr);
+      ierr = VecRestoreSubVector(mprk->F,mprk->isslow,&sub);CHKERRQ(ierr);
+    }
+  }
+  if (Ff) mprk->nfast++;
+  if (Fs) mprk->nslow++;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSEvaluateStep_MPRK(TS ts,PetscInt order,Vec U,PetscBool *done)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (order == 2) {
+    ierr = VecCopy(ts->vec_sol,U);CHKERRQ(ierr);
+  } else {
+    if (done) {*done = PETSC_FALSE; PetscFunctionReturn(0);}
+    SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_SUP,"The multirate method of order 2 cannot evaluate step at order %D. Consider using -ts_adapt_type none.",order);
+  }
+  if (done) *done = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSRollBack_MPRK(TS ts)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecCopy(mprk->X0,ts->vec_sol);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  Multirate partitioned method built on Heun's method, with stage derivatives ks of the slow split and kf of the fast one:
+
+    ks1 = f_s(t_n,U_n)
+    for j = 0,...,m-1, with t_j = t_n + j h and the slow components predicted as Us_j = Us_n + j h ks1:
+      kf1 = f_f(t_j,(Uf,Us_j)),  kf2 = f_f(t_j+h,(Uf + h kf1,Us_{j+1})),  Uf = Uf + h/2 (kf1 + kf2)
+    ks2 = f_s(t_n+H,(Uf + h kf1,Us_m)), from the stage of the last micro-step
+    Us_{n+1} = Us_n + H/2 (ks1 + ks2)
+
+  The method is of order 2 for any ratio m. Without split functions the stages shared by the splits (the first and the
+  last ones) cost a single evaluation of the full right hand side, so a macro-step costs 2m full evaluations.
+*/
+static PetscErrorCode TSStep_MPRK(TS ts)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  TSAdapt        adapt;
+  PetscInt       j,m = mprk->ratio,rejections = 0;
+  PetscBool      stageok,accept = PETSC_TRUE;
+  PetscReal      next_time_step = ts->time_step;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ts->steprollback) {
+    ierr = VecCopy(ts->vec_sol,mprk->X0);CHKERRQ(ierr);
+  }
+  ierr = TSGetAdapt(ts,&adapt);CHKERRQ(ierr);
+
+  mprk->status = TS_STEP_INCOMPLETE;
+  while (!ts->reason && mprk->status != TS_STEP_COMPLETE) {
+    const PetscReal t = ts->ptime,H = ts->time_step,h = H/m;
+
+    ierr = TSPreStage(ts,t);CHKERRQ(ierr);
+    ierr = TSMPRKComputeSplits_Private(ts,t,mprk->X0,mprk->Kf1,mprk->Ks1);CHKERRQ(ierr);
+    for (j=0; j<m; j++) {
+      const PetscReal tj = t + j*h;
+
+      if (j) {
+        ierr = TSPreStage(ts,tj);CHKERRQ(ierr);
+        ierr = VecCopy(ts->vec_sol,mprk->Y);CHKERRQ(ierr);
+        ierr = VecISAXPY(mprk->Y,mprk->isslow,j*h,mprk->Ks1);CHKERRQ(ierr);
+        ierr = TSMPRKComputeSplits_Private(ts,tj,mprk->Y,mprk->Kf1,NULL);CHKERRQ(ierr);
+      }
+      ierr = TSPreStage(ts,tj+h);CHKERRQ(ierr);
+      ierr = VecCopy(ts->vec_sol,mprk->Y);CHKERRQ(ierr);
+      ierr = VecISAXPY(mprk->Y,mprk->isfast,h,mprk->Kf1);CHKERRQ(ierr);
+      ierr = VecISAXPY(mprk->Y,mprk->isslow,(j+1)*h,mprk->Ks1);CHKERRQ(ierr);
+      ierr = TSMPRKComputeSplits_Private(ts,tj+h,mprk->Y,mprk->Kf2,j == m-1 ? mprk->Ks2 : NULL);CHKERRQ(ierr);
+      /* the slow components of the solution stay at the start of the step until the end of the macro-step */
+      ierr = VecISAXPY(ts->vec_sol,mprk->isfast,0.5*h,mprk->Kf1);CHKERRQ(ierr);
+      ierr = VecISAXPY(ts->vec_sol,mprk->isfast,0.5*h,mprk->Kf2);CHKERRQ(ierr);
+    }
+    ierr = VecISAXPY(ts->vec_sol,mprk->isslow,0.5*H,mprk->Ks1);CHKERRQ(ierr);
+    ierr = VecISAXPY(ts->vec_sol,mprk->isslow,0.5*H,mprk->Ks2);CHKERRQ(ierr);
+    ierr = TSPostStage(ts,t+H,0,&ts->vec_sol);CHKERRQ(ierr);
+    ierr = TSAdaptCheckStage(adapt,ts,t+H,ts->vec_sol,&stageok);CHKERRQ(ierr);
+    if (!stageok) {
+      ierr = TSRollBack_MPRK(ts);CHKERRQ(ierr);
+      goto reject_step;
+    }
+
+    mprk->status = TS_STEP_PENDING;
+    ierr = TSAdaptCandidatesClear(adapt);CHKERRQ(ierr);
+    ierr = TSAdaptCandidateAdd(adapt,"mprk2",2,1,1.0,(PetscReal)(2*m),PETSC_TRUE);CHKERRQ(ierr);
+    ierr = TSAdaptChoose(adapt,ts,ts->time_step,NULL,&next_time_step,&accept);CHKERRQ(ierr);
+    mprk->status = accept ? TS_STEP_COMPLETE : TS_STEP_INCOMPLETE;
+    if (!accept) {
+      ierr = TSRollBack_MPRK(ts);CHKERRQ(ierr);
+      ts->time_step = next_time_step;
+      goto reject_step;
+    }
+
+    ts->ptime    += ts->time_step;
+    ts->time_step = next_time_step;
+    break;
+
+  reject_step:
+    ts->reject++; accept = PETSC_FALSE;
+    if (!ts->reason && ++rejections > ts->max_reject && ts->max_reject >= 0) {
+      ts->reason = TS_DIVERGED_STEP_REJECTED;
+      ierr = PetscInfo2(ts,"Step=%D, step rejections %D greater than current TS allowed, stopping solve\n",ts->steps,rejections);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSReset_MPRK(TS ts)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = ISDestroy(&mprk->isfast);CHKERRQ(ierr);
+  ierr = ISDestroy(&mprk->isslow);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->X0);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->Y);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->F);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->Kf1);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->Kf2);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->Ks1);CHKERRQ(ierr);
+  ierr = VecDestroy(&mprk->Ks2);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSDestroy_MPRK(TS ts)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSReset_MPRK(ts);CHKERRQ(ierr);
+  ierr = PetscFree(ts->data);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSMPRKSetRatio_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSMPRKGetRatio_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetUp_MPRK(TS ts)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  IS             isfast,isslow;
+  Vec            sub;
+  PetscInt       rstart,rend,nfast,nslow;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mprk->ratio < 1) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_OUTOFRANGE,"Multirate ratio %D must be positive",mprk->ratio);
+  ierr = TSRHSSplitGetIS(ts,"fast",&isfast);CHKERRQ(ierr);
+  ierr = TSRHSSplitGetIS(ts,"slow",&isslow);CHKERRQ(ierr);
+  if (!isfast && !isslow) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_WRONGSTATE,"Must set the \"fast\" or the \"slow\" split with TSRHSSplitSetIS()");
+  ierr = VecGetOwnershipRange(ts->vec_sol,&rstart,&rend);CHKERRQ(ierr);
+  if (isfast) {
+    ierr = PetscObjectReference((PetscObject)isfast);CHKERRQ(ierr);
+    mprk->isfast = isfast;
+  } else {
+    ierr = ISComplement(isslow,rstart,rend,&mprk->isfast);CHKERRQ(ierr);
+  }
+  if (isslow) {
+    ierr = PetscObjectReference((PetscObject)isslow);CHKERRQ(ierr);
+    mprk->isslow = isslow;
+  } else {
+    ierr = ISComplement(isfast,rstart,rend,&mprk->isslow);CHKERRQ(ierr);
+  }
+  ierr = ISGetLocalSize(mprk->isfast,&nfast);CHKERRQ(ierr);
+  ierr = ISGetLocalSize(mprk->isslow,&nslow);CHKERRQ(ierr);
+  if (nfast + nslow != rend - rstart) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Fast split of local size %D and slow split of local size %D do not partition the %D local components of the solution",nfast,nslow,rend-rstart);
+  ierr = TSRHSSplitGetRHSFunction(ts,"fast",&mprk->ffast,&mprk->cfast);CHKERRQ(ierr);
+  ierr = TSRHSSplitGetRHSFunction(ts,"slow",&mprk->fslow,&mprk->cslow);CHKERRQ(ierr);
+
+  ierr = VecDuplicate(ts->vec_sol,&mprk->X0);CHKERRQ(ierr);
+  ierr = VecDuplicate(ts->vec_sol,&mprk->Y);CHKERRQ(ierr);
+  if (!mprk->ffast || !mprk->fslow) {ierr = VecDuplicate(ts->vec_sol,&mprk->F);CHKERRQ(ierr);}
+  ierr = VecGetSubVector(ts->vec_sol,mprk->isfast,&sub);CHKERRQ(ierr);
+  ierr = VecDuplicate(sub,&mprk->Kf1);CHKERRQ(ierr);
+  ierr = VecDuplicate(sub,&mprk->Kf2);CHKERRQ(ierr);
+  ierr = VecRestoreSubVector(ts->vec_sol,mprk->isfast,&sub);CHKERRQ(ierr);
+  ierr = VecGetSubVector(ts->vec_sol,mprk->isslow,&sub);CHKERRQ(ierr);
+  ierr = VecDuplicate(sub,&mprk->Ks1);CHKERRQ(ierr);
+  ierr = VecDuplicate(sub,&mprk->Ks2);CHKERRQ(ierr);
+  ierr = VecRestoreSubVector(ts->vec_sol,mprk->isslow,&sub);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSMPRKSetRatio_MPRK(TS ts,PetscInt ratio)
+{
+  TS_MPRK *mprk = (TS_MPRK*)ts->data;
+
+  PetscFunctionBegin;
+  if (ratio < 1) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_OUTOFRANGE,"Multirate ratio %D must be positive",ratio);
+  mprk->ratio = ratio;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSMPRKGetRatio_MPRK(TS ts,PetscInt *ratio)
+{
+  TS_MPRK *mprk = (TS_MPRK*)ts->data;
+
+  PetscFunctionBegin;
+  *ratio = mprk->ratio;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetFromOptions_MPRK(PetscOptionItems *PetscOptionsObject,TS ts)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  PetscInt       ratio = mprk->ratio;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"Multirate partitioned Runge-Kutta ODE solver options");CHKERRQ(ierr);
+  {
+    ierr = PetscOptionsInt("-ts_mprk_ratio","Number of fast micro-steps in a step","TSMPRKSetRatio",ratio,&ratio,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = TSMPRKSetRatio(ts,ratio);CHKERRQ(ierr);}
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSView_MPRK(TS ts,PetscViewer viewer)
+{
+  TS_MPRK        *mprk = (TS_MPRK*)ts->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  Multirate method of order 2 with %D fast micro-steps per step\n",mprk->ratio);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  right hand side evaluations: full=%D, fast split=%D, slow split=%D\n",mprk->nfull,mprk->nfast,mprk->nslow);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*MC
+      TSMPRK - ODE solver using a multirate partitioned Runge-Kutta method
+
+  The components of the solution are split into a fast and a slow set, named "fast" and "slow", with TSRHSSplitSetIS()
+  in the way fields are given to PCFIELDSPLIT; a split which is not set is the complement of the other one. The slow
+  components are advanced with the step of the TS and the fast ones with a number of micro-steps in each step. The
+  right hand side of each split may be given with TSRHSSplitSetRHSFunction(), then only the components of that split
+  are evaluated in its stages, which makes a micro-step cost only the fast part of the right hand side; otherwise the
+  full right hand side given with TSSetRHSFunction() is evaluated and the other components are discarded.
+
+  The method is derived from Heun's method: the slow split takes a step of Heun's method and the fast split takes
+  micro-steps of Heun's method with the slow components predicted linearly along the first slow stage derivative. It
+  is of order 2 for any number of micro-steps.
+
+  Options Database:
+.  -ts_mprk_ratio <m> - number of fast micro-steps in a step
+
+  Notes:
+  The method has no embedded error estimate, the step is fixed unless the TSAdapt only checks the stages.
+
+  References:
+.  1. -  E. M. Constantinescu and A. Sandu, Multirate timestepping methods for hyperbolic conservation laws, J. Sci. Comput. 33 (2007).
+
+  Level: intermediate
+
+.seealso:  TSCreate(), TS, TSSetType(), TSMPRKSetRatio(), TSRHSSplitSetIS(), TSRHSSplitSetRHSFunction(), TSRK
+
+M*/
+PETSC_EXTERN PetscErrorCode TSCreate_MPRK(TS ts)
+{
+  TS_MPRK        *mprk;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ts->ops->reset          = TSReset_MPRK;
+  ts->ops->destroy        = TSDestroy_MPRK;
+  ts->ops->view           = TSView_MPRK;
+  ts->ops->setup          = TSSetUp_MPRK;
+  ts->ops->setfromoptions = TSSetFromOptions_MPRK;
+  ts->ops->step           = TSStep_MPRK;
+  ts->ops->evaluatestep   = TSEvaluateStep_MPRK;
+  ts->ops->rollback       = TSRollBack_MPRK;
+
+  ierr = PetscNewLog(ts,&mprk);CHKERRQ(ierr);
+  ts->data = (void*)mprk;
+
+  mprk->ratio            = 2;
+  ts->default_adapt_type = TSADAPTNONE;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSMPRKSetRatio_C",TSMPRKSetRatio_MPRK);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSMPRKGetRatio_C",TSMPRKGetRatio_MPRK);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TSMPRKSetRatio - Set the number of fast micro-steps in a step of the multirate method
+
+  Logically Collective
+
+  Input Parameters:
++  ts - timestepping context
+-  ratio - number of micro-steps of the fast split in a step of the slow split
+
+  Options Database:
+.  -ts_mprk_ratio <m> - the ratio
+
+  Level: intermediate
+
+.seealso: TSMPRKGetRatio(), TSMPRK
+@*/
+PetscErrorCode TSMPRKSetRatio(TS ts,PetscInt ratio)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ts,ratio,2);
+  ierr = PetscTryMethod(ts,"TSMPRKSetRatio_C",(TS,PetscInt),(ts,ratio));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TSMPRKGetRatio - Get the number of fast micro-steps in a step of the multirate method
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  ratio - number of micro-steps of the fast split in a step of the slow split
+
+  Level: intermediate
+
+.seealso: TSMPRKSetRatio(), TSMPRK
+@*/
+PetscErrorCode TSMPRKGetRatio(TS ts,PetscInt *ratio)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidIntPointer(ratio,2);
+  ierr = PetscUseMethod(ts,"TSMPRKGetRatio_C",(TS,PetscInt*),(ts,ratio));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,627 @@
+/*
+  Code for time-parallel integration with Parareal and two-level MGRIT.
+
+  The time interval is split into slices distributed over a time communicator. Each process of the time communicator
+  belongs to a group of processes, the communicator of the TS, that holds the state of its slices; the groups have the
+  same parallel layout, so a vector is passed to the next slice by sending the local array to the process with the same
+  rank in the next group.
+*/
+#include <petsc/private/tsimpl.h>                /*I   "petscts.h"   I*/
+#include <petscdmshell.h>
+
+typedef struct {
+  TS          fine,coarse;    /* fine and coarse propagators, they solve the problem of the outer TS */
+  PetscBool   subsetup;       /* the propagators have been given their prefixes, DMs and default types */
+  MPI_Comm    tcomm;          /* connects the processes that hold the same part of the state in the different slices */
+  PetscMPIInt trank,tsize;
+  PetscInt    nslices;        /* total number of slices, a multiple of the size of the time communicator */
+  PetscInt    nloc;           /* number of slices of this process */
+  PetscInt    max_it,its;
+  PetscReal   rtol;
+  PetscReal   coarse_ratio;   /* time step of the coarse propagator over time step of the fine one */
+  PetscBool   fcf;            /* FCF relaxation of two-level MGRIT instead of the F relaxation of Parareal */
+  PetscReal   dtf,dtc;
+  Vec         *U;             /* values at the start of the local slices and at the end of the last one */
+  Vec         *F;             /* fine propagation of the values at the start of the local slices */
+  Vec         *G;             /* coarse propagation of the values at the start of the local slices */
+  Vec         W;
+  PetscBool   monitoring;     /* forward the steps of the fine propagator to the monitors of the outer TS */
+  PetscInt    stepoffset;
+  PetscInt    *fsteps;        /* number of fine steps of each local slice in the last fine sweep */
+} TS_Parareal;
+
+static PetscErrorCode TSPararealSend_Private(TS_Parareal *pr,Vec X,PetscMPIInt dest)
+{
+  const PetscScalar *x;
+  PetscInt          n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = MPI_Send((void*)x,(PetscMPIInt)n,MPIU_SCALAR,dest,0,pr->tcomm);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealRecv_Private(TS_Parareal *pr,Vec X,PetscMPIInt source)
+{
+  PetscScalar    *x;
+  PetscInt       n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(X,&x);CHKERRQ(ierr);
+  ierr = MPI_Recv(x,(PetscMPIInt)n,MPIU_SCALAR,source,0,pr->tcomm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  ierr = VecRestoreArray(X,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* X <- propagation of X from t0 to t1 */
+static PetscErrorCode TSPararealPropagate_Private(TS sub,PetscReal dt,PetscReal t0,PetscReal t1,Vec X,PetscInt *steps)
+{
+  TSConvergedReason reason;
+  PetscInt          n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = TSSetTime(sub,t0);CHKERRQ(ierr);
+  ierr = TSSetStepNumber(sub,0);CHKERRQ(ierr);
+  ierr = TSSetTimeStep(sub,PetscMin(dt,t1-t0));CHKERRQ(ierr);
+  ierr = TSSetMaxTime(sub,t1);CHKERRQ(ierr);
+  ierr = TSSolve(sub,X);CHKERRQ(ierr);
+  ierr = TSGetConvergedReason(sub,&reason);CHKERRQ(ierr);
+  if (reason < 0) SETERRQ3(PetscObjectComm((PetscObject)sub),PETSC_ERR_NOT_CONVERGED,"Propagation from %g to %g failed due to %s",(double)t0,(double)t1,TSConvergedReasons[reason]);
+  ierr = TSGetStepNumber(sub,&n);CHKERRQ(ierr);
+  if (steps) *steps = n;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealMonitor_Fine(TS fine,PetscInt step,PetscReal ptime,Vec X,void *ctx)
+{
+  TS             ts = (TS)ctx;
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!pr->monitoring) PetscFunctionReturn(0);
+  if (!step && pr->stepoffset) PetscFunctionReturn(0); /* the end of the previous slice was already reported */
+  ts->ptime     = ptime;
+  ts->time_step = fine->time_step;
+  ierr = TSMonitor(ts,pr->stepoffset+step,ptime,X);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* a propagator works on a copy of the DM of the outer TS so that its solver callbacks do not replace the ones of the outer TS */
+static PetscErrorCode TSPararealSetUpPropagator_Private(TS ts,TS sub,const char prefix[],PetscBool coarse)
+{
+  DM             dm,subdm;
+  PetscBool      isshell;
+  TSIFunction    ifunction;
+  const char     *tsprefix;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSGetOptionsPrefix(ts,&tsprefix);CHKERRQ(ierr);
+  ierr = TSSetOptionsPrefix(sub,tsprefix);CHKERRQ(ierr);
+  ierr = TSAppendOptionsPrefix(sub,prefix);CHKERRQ(ierr);
+  ierr = TSGetDM(ts,&dm);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)dm,DMSHELL,&isshell);CHKERRQ(ierr);
+  if (isshell) {
+    ierr = DMShellCreate(PetscObjectComm((PetscObject)ts),&subdm);CHKERRQ(ierr);
+  } else {
+    ierr = DMClone(dm,&subdm);CHKERRQ(ierr);
+  }
+  ierr = TSSetDM(sub,subdm);CHKERRQ(ierr);
+  ierr = DMDestroy(&subdm);CHKERRQ(ierr);
+  ierr = TSGetIFunction(ts,NULL,&ifunction,NULL);CHKERRQ(ierr);
+  if (!((PetscObject)sub)->type_name) {ierr = TSSetType(sub,ifunction ? TSBEULER : TSRK);CHKERRQ(ierr);}
+  ierr = TSSetExactFinalTime(sub,TS_EXACTFINALTIME_MATCHSTEP);CHKERRQ(ierr);
+  if (coarse) { /* the coarse propagator takes fixed steps unless asked otherwise */
+    TSAdapt adapt;
+
+    ierr = TSGetAdapt(sub,&adapt);CHKERRQ(ierr);
+    ierr = TSAdaptSetType(adapt,TSADAPTNONE);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* give the current problem of the outer TS to a propagator */
+static PetscErrorCode TSPararealSetProblem_Private(TS ts,TS sub)
+{
+  DM             dm,subdm;
+  TSProblemType  ptype;
+  TSEquationType etype;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSGetDM(ts,&dm);CHKERRQ(ierr);
+  ierr = TSGetDM(sub,&subdm);CHKERRQ(ierr);
+  ierr = DMCopyDMTS(dm,subdm);CHKERRQ(ierr);
+  ierr = TSGetProblemType(ts,&ptype);CHKERRQ(ierr);
+  ierr = TSSetProblemType(sub,ptype);CHKERRQ(ierr);
+  ierr = TSGetEquationType(ts,&etype);CHKERRQ(ierr);
+  ierr = TSSetEquationType(sub,etype);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealSetUpPropagators_Private(TS ts)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (pr->subsetup) PetscFunctionReturn(0);
+  ierr = TSPararealSetUpPropagator_Private(ts,pr->fine,"parareal_fine_",PETSC_FALSE);CHKERRQ(ierr);
+  ierr = TSPararealSetUpPropagator_Private(ts,pr->coarse,"parareal_coarse_",PETSC_TRUE);CHKERRQ(ierr);
+  ierr = TSMonitorSet(pr->fine,TSPararealMonitor_Fine,ts,NULL);CHKERRQ(ierr);
+  pr->subsetup = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* the Jacobian matrices live in the SNES of the outer TS, the propagators use the same ones */
+static PetscErrorCode TSPararealSetUpMatrices_Private(TS ts,TS sub)
+{
+  DM             dm;
+  SNES           snes;
+  TSRHSJacobian  rhsjacobian;
+  TSIJacobian    ijacobian;
+  Mat            A,B;
+  void           *ctx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ts->snes) PetscFunctionReturn(0);
+  ierr = SNESGetJacobian(ts->snes,&A,&B,NULL,NULL);CHKERRQ(ierr);
+  if (!A && !B) PetscFunctionReturn(0);
+  ierr = TSGetSNES(sub,&snes);CHKERRQ(ierr);
+  ierr = SNESGetJacobian(snes,&A,&B,NULL,NULL);CHKERRQ(ierr);
+  if (A || B) PetscFunctionReturn(0);
+  ierr = SNESGetJacobian(ts->snes,&A,&B,NULL,NULL);CHKERRQ(ierr);
+  ierr = TSGetDM(ts,&dm);CHKERRQ(ierr);
+  ierr = DMTSGetIJacobian(dm,&ijacobian,&ctx);CHKERRQ(ierr);
+  if (ijacobian) {
+    ierr = TSSetIJacobian(sub,A,B,ijacobian,ctx);CHKERRQ(ierr);
+  } else {
+    ierr = DMTSGetRHSJacobian(dm,&rhsjacobian,&ctx);CHKERRQ(ierr);
+    ierr = TSSetRHSJacobian(sub,A,B,rhsjacobian,ctx);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* largest change of the slice boundary values, relative to their size */
+static PetscErrorCode TSPararealUpdate_Private(TS_Parareal *pr,Vec Unew,Vec Uold,PetscReal *err)
+{
+  PetscReal      nrm,dnrm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecAXPY(Uold,-1.0,Unew);CHKERRQ(ierr);
+  ierr = VecNorm(Uold,NORM_INFINITY,&dnrm);CHKERRQ(ierr);
+  ierr = VecNorm(Unew,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  *err = PetscMax(*err,dnrm/(1.0+nrm));
+  ierr = VecCopy(Unew,Uold);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSolve_Parareal(TS ts)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscInt       j,k,s0 = pr->trank*pr->nloc,nloc = pr->nloc,nsteps,n;
+  PetscReal      t0 = ts->ptime,T = (ts->max_time-ts->ptime)/pr->nslices,err;
+  PetscScalar    *x;
+  PetscMPIInt    prev = pr->trank-1,next = pr->trank+1,last = pr->tsize-1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ts->max_time >= PETSC_MAX_REAL) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_WRONGSTATE,"Parareal needs the final time, use TSSetMaxTime() or -ts_max_time");
+  if (!pr->U) {
+    ierr = VecDuplicateVecs(ts->vec_sol,nloc+1,&pr->U);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(ts->vec_sol,nloc,&pr->F);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(ts->vec_sol,nloc,&pr->G);CHKERRQ(ierr);
+    ierr = VecDuplicate(ts->vec_sol,&pr->W);CHKERRQ(ierr);
+    ierr = PetscCalloc1(nloc,&pr->fsteps);CHKERRQ(ierr);
+  }
+#define TSPararealTime(j) (t0+(s0+(j))*T)
+
+  /* initial values from a sequential coarse sweep */
+  if (!pr->trank) {ierr = VecCopy(ts->vec_sol,pr->U[0]);CHKERRQ(ierr);}
+  else {ierr = TSPararealRecv_Private(pr,pr->U[0],prev);CHKERRQ(ierr);}
+  for (j=0; j<nloc; j++) {
+    ierr = VecCopy(pr->U[j],pr->G[j]);CHKERRQ(ierr);
+    ierr = TSPararealPropagate_Private(pr->coarse,pr->dtc,TSPararealTime(j),TSPararealTime(j+1),pr->G[j],NULL);CHKERRQ(ierr);
+    ierr = VecCopy(pr->G[j],pr->U[j+1]);CHKERRQ(ierr);
+  }
+  if (next < pr->tsize) {ierr = TSPararealSend_Private(pr,pr->U[nloc],next);CHKERRQ(ierr);}
+
+  /* the first k slices are exact after k iterations */
+  for (k=0,pr->its=0; k<PetscMin(pr->max_it,pr->nslices); k++) {
+    if (pr->fcf) {
+      /* F and C relaxation: the start of each slice gets the fine propagation of the start of the previous one */
+      for (j=0; j<nloc; j++) {
+        ierr = VecCopy(pr->U[j],pr->F[j]);CHKERRQ(ierr);
+        ierr = TSPararealPropagate_Private(pr->fine,pr->dtf,TSPararealTime(j),TSPararealTime(j+1),pr->F[j],&pr->fsteps[j]);CHKERRQ(ierr);
+      }
+      for (j=0; j<nloc; j++) {ierr = VecCopy(pr->F[j],pr->U[j+1]);CHKERRQ(ierr);}
+      if (next < pr->tsize) {ierr = TSPararealSend_Private(pr,pr->U[nloc],next);CHKERRQ(ierr);}
+      if (pr->trank) {ierr = TSPararealRecv_Private(pr,pr->U[0],prev);CHKERRQ(ierr);}
+      for (j=0; j<nloc; j++) {
+        ierr = VecCopy(pr->U[j],pr->G[j]);CHKERRQ(ierr);
+        ierr = TSPararealPropagate_Private(pr->coarse,pr->dtc,TSPararealTime(j),TSPararealTime(j+1),pr->G[j],NULL);CHKERRQ(ierr);
+      }
+    }
+    /* F relaxation, the fine solves of the slices are independent */
+    for (j=0; j<nloc; j++) {
+      ierr = VecCopy(pr->U[j],pr->F[j]);CHKERRQ(ierr);
+      ierr = TSPararealPropagate_Private(pr->fine,pr->dtf,TSPararealTime(j),TSPararealTime(j+1),pr->F[j],&pr->fsteps[j]);CHKERRQ(ierr);
+    }
+    /* sequential coarse correction U_{j+1} = G(U_j) + F(U_j^old) - G(U_j^old) */
+    err  = 0.0;
+    if (pr->trank) {
+      ierr = VecCopy(pr->U[0],pr->W);CHKERRQ(ierr);
+      ierr = TSPararealRecv_Private(pr,pr->W,prev);CHKERRQ(ierr);
+      ierr = TSPararealUpdate_Private(pr,pr->W,pr->U[0],&err);CHKERRQ(ierr);
+    }
+    for (j=0; j<nloc; j++) {
+      ierr = VecCopy(pr->U[j],pr->W);CHKERRQ(ierr);
+      ierr = TSPararealPropagate_Private(pr->coarse,pr->dtc,TSPararealTime(j),TSPararealTime(j+1),pr->W,NULL);CHKERRQ(ierr);
+      ierr = VecAXPY(pr->F[j],-1.0,pr->G[j]);CHKERRQ(ierr);
+      ierr = VecCopy(pr->W,pr->G[j]);CHKERRQ(ierr);
+      ierr = VecAXPY(pr->W,1.0,pr->F[j]);CHKERRQ(ierr);
+      ierr = TSPararealUpdate_Private(pr,pr->W,pr->U[j+1],&err);CHKERRQ(ierr);
+    }
+    if (next < pr->tsize) {ierr = TSPararealSend_Private(pr,pr->U[nloc],next);CHKERRQ(ierr);}
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&err,1,MPIU_REAL,MPIU_MAX,pr->tcomm);CHKERRQ(ierr);
+    pr->its++;
+    ierr = PetscInfo2(ts,"Iteration %D, relative change of the slice values %g\n",pr->its,(double)err);CHKERRQ(ierr);
+    if (err <= pr->rtol) break;
+  }
+
+  /* number of fine steps before the slices of this process */
+  for (j=0,nsteps=0; j<nloc; j++) nsteps += pr->fsteps[j];
+  ierr = MPI_Scan(&nsteps,&n,1,MPIU_INT,MPI_SUM,pr->tcomm);CHKERRQ(ierr);
+  pr->stepoffset = ts->steps + n - nsteps;
+  if (ts->numbermonitors) {
+    /* a last F relaxation in the work vector gives the monitors the fine trajectory, the slices of different processes are monitored concurrently */
+    pr->monitoring = PETSC_TRUE;
+    for (j=0; j<nloc; j++) {
+      ierr = VecCopy(pr->U[j],pr->W);CHKERRQ(ierr);
+      ierr = TSPararealPropagate_Private(pr->fine,pr->dtf,TSPararealTime(j),TSPararealTime(j+1),pr->W,&pr->fsteps[j]);CHKERRQ(ierr);
+      pr->stepoffset += pr->fsteps[j];
+    }
+    pr->monitoring = PETSC_FALSE;
+  }
+#undef TSPararealTime
+
+  /* the solution is at the end of the last slice */
+  ierr = VecCopy(pr->U[nloc],ts->vec_sol);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(ts->vec_sol,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(ts->vec_sol,&x);CHKERRQ(ierr);
+  ierr = MPI_Bcast(x,(PetscMPIInt)n,MPIU_SCALAR,last,pr->tcomm);CHKERRQ(ierr);
+  ierr = VecRestoreArray(ts->vec_sol,&x);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&pr->stepoffset,1,MPIU_INT,MPI_MAX,pr->tcomm);CHKERRQ(ierr);
+  ts->steps     = pr->stepoffset;
+  ts->ptime     = ts->max_time;
+  ts->time_step = pr->dtf;
+  ts->reason    = TS_CONVERGED_TIME;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSReset_Parareal(TS ts)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (pr->U) {
+    ierr = VecDestroyVecs(pr->nloc+1,&pr->U);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(pr->nloc,&pr->F);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(pr->nloc,&pr->G);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&pr->W);CHKERRQ(ierr);
+  ierr = PetscFree(pr->fsteps);CHKERRQ(ierr);
+  ierr = TSReset(pr->fine);CHKERRQ(ierr);
+  ierr = TSReset(pr->coarse);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSDestroy_Parareal(TS ts)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSReset_Parareal(ts);CHKERRQ(ierr);
+  ierr = TSDestroy(&pr->fine);CHKERRQ(ierr);
+  ierr = TSDestroy(&pr->coarse);CHKERRQ(ierr);
+  ierr = MPI_Comm_free(&pr->tcomm);CHKERRQ(ierr);
+  ierr = PetscFree(ts->data);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealSetTimeComm_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealGetFineTS_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealGetCoarseTS_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealGetIterationNumber_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetUp_Parareal(TS ts)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = TSPararealSetUpPropagators_Private(ts);CHKERRQ(ierr);
+  if (!pr->nslices) pr->nslices = pr->tsize;
+  if (pr->nslices % pr->tsize) SETERRQ2(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_INCOMP,"The number of slices %D must be a multiple of the size of the time communicator %d",pr->nslices,pr->tsize);
+  pr->nloc = pr->nslices/pr->tsize;
+  if (pr->max_it == PETSC_DEFAULT) pr->max_it = pr->nslices;
+  ierr = TSPararealSetProblem_Private(ts,pr->fine);CHKERRQ(ierr);
+  ierr = TSPararealSetProblem_Private(ts,pr->coarse);CHKERRQ(ierr);
+  ierr = TSPararealSetUpMatrices_Private(ts,pr->fine);CHKERRQ(ierr);
+  ierr = TSPararealSetUpMatrices_Private(ts,pr->coarse);CHKERRQ(ierr);
+  pr->dtf  = ts->time_step;
+  pr->dtc  = pr->coarse_ratio*ts->time_step;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSSetFromOptions_Parareal(PetscOptionItems *PetscOptionsObject,TS ts)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"Parareal ODE solver options");CHKERRQ(ierr);
+  {
+    ierr = PetscOptionsInt("-ts_parareal_slices","Number of time slices","",pr->nslices,&pr->nslices,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-ts_parareal_max_it","Maximum number of iterations","",pr->max_it,&pr->max_it,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_parareal_rtol","Relative change of the slice values to stop the iterations","",pr->rtol,&pr->rtol,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_parareal_coarse_ratio","Time step of the coarse propagator over the one of the fine propagator","",pr->coarse_ratio,&pr->coarse_ratio,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsBool("-ts_parareal_fcf","Use the FCF relaxation of two-level MGRIT","",pr->fcf,&pr->fcf,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  ierr = TSPararealSetUpPropagators_Private(ts);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(pr->fine);CHKERRQ(ierr);
+  ierr = TSSetFromOptions(pr->coarse);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSView_Parareal(TS ts,PetscViewer viewer)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  %s relaxation, %D slices on %d processes in time\n",pr->fcf ? "FCF" : "F",pr->nslices,pr->tsize);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  maximum iterations=%D, relative tolerance=%g, iterations of the last solve=%D\n",pr->max_it,(double)pr->rtol,pr->its);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  Fine propagator\n");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+    ierr = TSView(pr->fine,viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  Coarse propagator, time step ratio %g\n",(double)pr->coarse_ratio);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+    ierr = TSView(pr->coarse,viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealSetTimeComm_Parareal(TS ts,MPI_Comm tcomm)
+{
+  TS_Parareal    *pr = (TS_Parareal*)ts->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ts->setupcalled) SETERRQ(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_WRONGSTATE,"Cannot change the time communicator after TSSetUp()");
+  ierr = MPI_Comm_free(&pr->tcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_dup(tcomm,&pr->tcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(pr->tcomm,&pr->trank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(pr->tcomm,&pr->tsize);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealGetFineTS_Parareal(TS ts,TS *fine)
+{
+  TS_Parareal *pr = (TS_Parareal*)ts->data;
+
+  PetscFunctionBegin;
+  *fine = pr->fine;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealGetCoarseTS_Parareal(TS ts,TS *coarse)
+{
+  TS_Parareal *pr = (TS_Parareal*)ts->data;
+
+  PetscFunctionBegin;
+  *coarse = pr->coarse;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSPararealGetIterationNumber_Parareal(TS ts,PetscInt *its)
+{
+  TS_Parareal *pr = (TS_Parareal*)ts->data;
+
+  PetscFunctionBegin;
+  *its = pr->its;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+      TSPARAREAL - Time-parallel integration with Parareal or two-level MGRIT
+
+   The interval from the initial time to the final time is split into slices. Starting from a sequential sweep of a cheap
+   coarse propagator, the values at the start of the slices are corrected iteratively with the fine propagator, whose
+   solves on the different slices are independent, until they stop changing. After k iterations the first k slices are
+   exact, so the iteration never takes more steps than the number of slices.
+
+   The fine and coarse propagators are TS objects that solve the problem of this TS, the fine one with its time step and
+   the coarse one with a time step -ts_parareal_coarse_ratio times larger. They use the options prefixes parareal_fine_
+   and parareal_coarse_, so e.g. -parareal_fine_ts_type rk -parareal_fine_ts_rk_type 5dp -parareal_coarse_ts_type euler.
+   By default both are TSRK, or TSBEULER if the problem has an IFunction, and the coarse one takes fixed steps.
+
+   To integrate in parallel in time, create the TS on a communicator that holds one copy of the state and give
+   TSPararealSetTimeComm() the communicator that connects the processes holding the same part of the state in the
+   different slices, for example from MPI_Comm_split(). Otherwise the slices are integrated one after the other.
+
+   Options Database:
++  -ts_parareal_slices <n> - number of time slices, a multiple of the size of the time communicator (default its size)
+.  -ts_parareal_max_it <it> - maximum number of iterations (default the number of slices)
+.  -ts_parareal_rtol <rtol> - stop when the values at the start of the slices change less than this, relative to their size
+.  -ts_parareal_coarse_ratio <r> - ratio of the coarse and fine time steps
+-  -ts_parareal_fcf - use the FCF relaxation of two-level MGRIT, which costs two fine sweeps per iteration but converges faster
+
+   Notes:
+   The monitors of this TS see the fine steps of a last fine sweep over the slices of each process; the slices of
+   different processes in time are monitored concurrently. The fine propagator may adapt its time step on each slice.
+
+   Level: advanced
+
+.seealso:  TSCreate(), TS, TSSetType(), TSPararealSetTimeComm(), TSPararealGetFineTS(), TSPararealGetCoarseTS()
+
+M*/
+PETSC_EXTERN PetscErrorCode TSCreate_Parareal(TS ts)
+{
+  TS_Parareal    *pr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ts->ops->reset          = TSReset_Parareal;
+  ts->ops->destroy        = TSDestroy_Parareal;
+  ts->ops->view           = TSView_Parareal;
+  ts->ops->setup          = TSSetUp_Parareal;
+  ts->ops->setfromoptions = TSSetFromOptions_Parareal;
+  ts->ops->solve          = TSSolve_Parareal;
+
+  ierr = PetscNewLog(ts,&pr);CHKERRQ(ierr);
+  ts->data = (void*)pr;
+
+  pr->max_it       = PETSC_DEFAULT;
+  pr->rtol         = 1.e-8;
+  pr->coarse_ratio = 10.0;
+  pr->fcf          = PETSC_FALSE;
+  ierr = MPI_Comm_dup(PETSC_COMM_SELF,&pr->tcomm);CHKERRQ(ierr);
+  pr->trank        = 0;
+  pr->tsize        = 1;
+
+  ierr = TSCreate(PetscObjectComm((PetscObject)ts),&pr->fine);CHKERRQ(ierr);
+  ierr = PetscObjectIncrementTabLevel((PetscObject)pr->fine,(PetscObject)ts,1);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ts,(PetscObject)pr->fine);CHKERRQ(ierr);
+  ierr = TSCreate(PetscObjectComm((PetscObject)ts),&pr->coarse);CHKERRQ(ierr);
+  ierr = PetscObjectIncrementTabLevel((PetscObject)pr->coarse,(PetscObject)ts,1);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ts,(PetscObject)pr->coarse);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealSetTimeComm_C",TSPararealSetTimeComm_Parareal);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealGetFineTS_C",TSPararealGetFineTS_Parareal);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealGetCoarseTS_C",TSPararealGetCoarseTS_Parareal);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ts,"TSPararealGetIterationNumber_C",TSPararealGetIterationNumber_Parareal);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  TSPararealSetTimeComm - Set the communicator that connects the time slices
+
+  Logically Collective on TS
+
+  Input Parameters:
++  ts - timestepping context
+-  tcomm - communicator connecting the processes that hold the same part of the state in the different time slices,
+           rank r of tcomm integrates the r-th group of consecutive slices
+
+  Notes:
+  Every group of processes holding a copy of the state must have the same parallel layout of the vectors.
+  The default is PETSC_COMM_SELF, the slices are then integrated one after the other.
+
+  Level: advanced
+
+.seealso: TSPARAREAL, TSPararealGetFineTS()
+@*/
+PetscErrorCode TSPararealSetTimeComm(TS ts,MPI_Comm tcomm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  ierr = PetscTryMethod(ts,"TSPararealSetTimeComm_C",(TS,MPI_Comm),(ts,tcomm));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TSPararealGetFineTS - Get the fine propagator
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  fine - the TS that integrates each time slice accurately
+
+  Level: advanced
+
+.seealso: TSPARAREAL, TSPararealGetCoarseTS()
+@*/
+PetscErrorCode TSPararealGetFineTS(TS ts,TS *fine)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidPointer(fine,2);
+  ierr = PetscUseMethod(ts,"TSPararealGetFineTS_C",(TS,TS*),(ts,fine));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TSPararealGetCoarseTS - Get the coarse propagator
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  coarse - the TS that propagates the corrections across the time slices
+
+  Level: advanced
+
+.seealso: TSPARAREAL, TSPararealGetFineTS()
+@*/
+PetscErrorCode TSPararealGetCoarseTS(TS ts,TS *coarse)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidPointer(coarse,2);
+  ierr = PetscUseMethod(ts,"TSPararealGetCoarseTS_C",(TS,TS*),(ts,coarse));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  TSPararealGetIterationNumber - Get the number of iterations of the last solve
+
+  Not Collective
+
+  Input Parameter:
+.  ts - timestepping context
+
+  Output Parameter:
+.  its - number of Parareal or MGRIT iterations
+
+  Level: advanced
+
+.seealso: TSPARAREAL
+@*/
+PetscErrorCode TSPararealGetIterationNumber(TS ts,PetscInt *its)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidIntPointer(its,2);
+  ierr = PetscUseMethod(ts,"TSPararealGetIterationNumber_C",(TS,PetscInt*),(ts,its));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
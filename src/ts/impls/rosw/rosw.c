@@ -1307,16 +1307,20 @@ static PetscErrorCode SNESTSFormJacobian_RosW(SNES snes,Vec U,Mat A,Mat B,TS ts)
   TS_RosW        *ros = (TS_RosW*)ts->data;
   Vec            Ydot,Zdot,Ystage,Zstage;
   PetscReal      shift = ros->scoeff / ts->time_step;
+  PetscBool      reuse;
   PetscErrorCode ierr;
   DM             dm,dmsave;
 
   PetscFunctionBegin;
+  ierr = TSJacobianReuseCheck_Private(ts,snes,shift,A,B,&reuse);CHKERRQ(ierr);
+  if (reuse) PetscFunctionReturn(0);
   /* ros->Ydot and ros->Ystage have already been computed in SNESTSFormFunction_RosW (SNES guarantees this) */
   ierr   = SNESGetDM(snes,&dm);CHKERRQ(ierr);
   ierr   = TSRosWGetVecs(ts,dm,&Ydot,&Zdot,&Ystage,&Zstage);CHKERRQ(ierr);
   dmsave = ts->dm;
   ts->dm = dm;
   ierr   = TSComputeIJacobian(ts,ros->stage_time,Ystage,Ydot,shift,A,B,PETSC_TRUE);CHKERRQ(ierr);
+  ierr   = TSJacobianReuseUpdate_Private(ts,shift,B);CHKERRQ(ierr);
   ts->dm = dmsave;
   ierr   = TSRosWRestoreVecs(ts,dm,&Ydot,&Zdot,&Ystage,&Zstage);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -163,6 +163,9 @@ static PetscErrorCode TSAdaptSetDefaultType(TSAdapt adapt,TSAdaptType default_ty
 .  -ts_error_if_step_fails <true,false> - Error if no step succeeds
 .  -ts_rtol <rtol> - relative tolerance for local truncation error
 .  -ts_atol <atol> Absolute tolerance for local truncation error
+.  -ts_jacobian_reuse - reuse the Jacobian and preconditioner across the implicit stages and steps
+.  -ts_jacobian_reuse_shift_ratio <ratio> - recompute them when the shift changes by more than this factor
+.  -ts_jacobian_reuse_rate <rate> - recompute them when a Newton iteration reduces the residual by less than this factor
 .  -ts_adjoint_solve <yes,no> After solving the ODE/DAE solve the adjoint problem (requires -ts_save_trajectory)
 .  -ts_fd_color - Use finite differences with coloring to compute IJacobian
 .  -ts_monitor - print information at each timestep
@@ -234,6 +237,9 @@ PetscErrorCode  TSSetFromOptions(TS ts)
   ierr = PetscOptionsBool("-ts_error_if_step_fails","Error if no step succeeds","TSSetErrorIfStepFails",ts->errorifstepfailed,&ts->errorifstepfailed,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsReal("-ts_rtol","Relative tolerance for local truncation error","TSSetTolerances",ts->rtol,&ts->rtol,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsReal("-ts_atol","Absolute tolerance for local truncation error","TSSetTolerances",ts->atol,&ts->atol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ts_jacobian_reuse","Reuse the Jacobian and preconditioner across implicit stages and steps","TSSetJacobianReuse",ts->jacreuse.use,&ts->jacreuse.use,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-ts_jacobian_reuse_shift_ratio","Rebuild when the shift changes by more than this factor","TSSetJacobianReuseTolerances",ts->jacreuse.shiftratio,&ts->jacreuse.shiftratio,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-ts_jacobian_reuse_rate","Rebuild when a Newton iteration reduces the residual by less than this factor","TSSetJacobianReuseTolerances",ts->jacreuse.rate,&ts->jacreuse.rate,NULL);CHKERRQ(ierr);
 
 #if defined(PETSC_HAVE_SAWS)
   {
@@ -1485,6 +1491,162 @@ PetscErrorCode TSRHSJacobianSetReuse(TS ts,PetscBool reuse)
   PetscFunctionReturn(0);
 }
 
+/*@
+   TSSetJacobianReuse - Keep the shifted Jacobian and its preconditioner across the implicit stages and steps of
+   TSARKIMEX, TSROSW and TSBDF as long as they remain good enough.
+
+   Logically Collective
+
+   Input Arguments:
++  ts - TS context obtained from TSCreate()
+-  flg - PETSC_TRUE to reuse the Jacobian
+
+   Options Database:
+.  -ts_jacobian_reuse - reuse the Jacobian
+
+   Notes:
+   Without reuse each implicit stage evaluates the Jacobian shifted by the stage coefficient and sets up the preconditioner
+   again whenever it is requested by the nonlinear solver. With reuse the current matrices are kept while the shift of
+   the stage stays within a factor of the shift they were computed with, no step is rejected and the Newton iterations
+   with them contract the residual by at least the rate, see TSSetJacobianReuseTolerances(). The nonlinear iteration then becomes a
+   modified Newton iteration; the number of evaluations avoided is reported by TSView() and TSGetJacobianReuseCounts().
+
+   The methods of TSROSW which are not W-methods lose their order with an out of date Jacobian, use reuse only with
+   W-methods such as ra34pw2 or with a small shift ratio.
+
+   Level: intermediate
+
+.seealso: TSSetJacobianReuseTolerances(), TSGetJacobianReuseCounts(), SNESSetLagJacobian(), SNESSetLagPreconditioner()
+@*/
+PetscErrorCode TSSetJacobianReuse(TS ts,PetscBool flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ts,flg,2);
+  ts->jacreuse.use   = flg;
+  ts->jacreuse.shift = 0.0;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   TSSetJacobianReuseTolerances - Set when the Jacobian kept by TSSetJacobianReuse() is recomputed
+
+   Logically Collective
+
+   Input Arguments:
++  ts - TS context obtained from TSCreate()
+.  shiftratio - recompute when the shift of a stage differs from the shift of the matrices by more than this factor, at least 1
+-  rate - recompute when a Newton iteration reduces the norm of the residual by less than this factor
+
+   Options Database:
++  -ts_jacobian_reuse_shift_ratio <1.5> - the shift ratio
+-  -ts_jacobian_reuse_rate <0.3> - the rate
+
+   Notes:
+   Use PETSC_DEFAULT to leave a value unchanged.
+
+   Level: intermediate
+
+.seealso: TSSetJacobianReuse(), TSGetJacobianReuseCounts()
+@*/
+PetscErrorCode TSSetJacobianReuseTolerances(TS ts,PetscReal shiftratio,PetscReal rate)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidLogicalCollectiveReal(ts,shiftratio,2);
+  PetscValidLogicalCollectiveReal(ts,rate,3);
+  if (shiftratio != PETSC_DEFAULT) {
+    if (shiftratio < 1.0) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_OUTOFRANGE,"Shift ratio %g must be at least 1",(double)shiftratio);
+    ts->jacreuse.shiftratio = shiftratio;
+  }
+  if (rate != PETSC_DEFAULT) {
+    if (rate <= 0.0) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_OUTOFRANGE,"Rate %g must be positive",(double)rate);
+    ts->jacreuse.rate = rate;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   TSGetJacobianReuseCounts - Get the number of shifted Jacobians computed and reused by the implicit stages since the
+   start of the solve
+
+   Not Collective
+
+   Input Argument:
+.  ts - TS context obtained from TSCreate()
+
+   Output Arguments:
++  computed - number of Jacobian evaluations, each followed by a setup of the preconditioner
+-  reused - number of requests of the nonlinear solver served by the current Jacobian and preconditioner
+
+   Level: intermediate
+
+.seealso: TSSetJacobianReuse()
+@*/
+PetscErrorCode TSGetJacobianReuseCounts(TS ts,PetscInt *computed,PetscInt *reused)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  if (computed) *computed = ts->jacreuse.computed;
+  if (reused)   *reused   = ts->jacreuse.reused;
+  PetscFunctionReturn(0);
+}
+
+/*
+   TSJacobianReuseCheck_Private - Called by the Jacobian function of the nonlinear solver of an implicit stage with the
+   shift of the stage, decides if the matrices computed earlier can be kept. They are kept when they have not been
+   changed since, their shift is close enough, no step was rejected and the residual of the Newton iteration contracts
+   fast enough; the preconditioner is then not set up again either since its operator is unchanged.
+*/
+PetscErrorCode TSJacobianReuseCheck_Private(TS ts,SNES snes,PetscReal shift,Mat A,Mat B,PetscBool *reuse)
+{
+  PetscInt         it;
+  PetscReal        fnorm,ratio;
+  PetscObjectState state;
+  PetscBool        flg;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  *reuse = PETSC_FALSE;
+  if (!ts->jacreuse.use) PetscFunctionReturn(0);
+  ierr = SNESGetIterationNumber(snes,&it);CHKERRQ(ierr);
+  ierr = SNESGetFunctionNorm(snes,&fnorm);CHKERRQ(ierr);
+  if (it > 0 && ts->jacreuse.fnorm > 0.0) ts->jacreuse.rateok = (PetscBool)(fnorm <= ts->jacreuse.rate*ts->jacreuse.fnorm);
+  ts->jacreuse.fnorm = fnorm;
+  /* a rejected step may come from the error of an out of date Jacobian */
+  if (ts->jacreuse.shift == 0.0 || !ts->jacreuse.rateok || ts->reject != ts->jacreuse.reject) PetscFunctionReturn(0);
+  ierr  = PetscObjectStateGet((PetscObject)B,&state);CHKERRQ(ierr);
+  if (state != ts->jacreuse.state) PetscFunctionReturn(0);
+  ratio = PetscAbsReal(shift/ts->jacreuse.shift);
+  if (ratio > ts->jacreuse.shiftratio || ratio*ts->jacreuse.shiftratio < 1.0) PetscFunctionReturn(0);
+
+  *reuse = PETSC_TRUE;
+  ts->jacreuse.reused++;
+  ierr = PetscInfo3(ts,"Reusing Jacobian and preconditioner computed with shift %g for shift %g at nonlinear iteration %D\n",(double)ts->jacreuse.shift,(double)shift,it);CHKERRQ(ierr);
+  /* a matrix-free operator still has to move its base to the current iterate */
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMFFD,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Records the matrices just computed with the shift by the Jacobian function of an implicit stage */
+PetscErrorCode TSJacobianReuseUpdate_Private(TS ts,PetscReal shift,Mat B)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ts->jacreuse.use) PetscFunctionReturn(0);
+  ierr = PetscObjectStateGet((PetscObject)B,&ts->jacreuse.state);CHKERRQ(ierr);
+  ts->jacreuse.shift  = shift;
+  ts->jacreuse.rateok = PETSC_TRUE;
+  ts->jacreuse.reject = ts->reject;
+  ts->jacreuse.computed++;
+  PetscFunctionReturn(0);
+}
+
 /*@C
    TSSetI2Function - Set the function to compute F(t,U,U_t,U_tt) where F = 0 is the DAE to be solved.
 
@@ -1993,6 +2155,10 @@ PetscErrorCode  TSView(TS ts,PetscViewer viewer)
       ierr = PetscObjectTypeCompare((PetscObject)ts->snes,SNESKSPONLY,&lin);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPrintf(viewer,"  total number of %slinear solve failures=%D\n",lin ? "" : "non",ts->num_snes_failures);CHKERRQ(ierr);
     }
+    if (ts->jacreuse.use) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  Jacobian reuse: shift ratio %g, Newton rate %g\n",(double)ts->jacreuse.shiftratio,(double)ts->jacreuse.rate);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPrintf(viewer,"  total number of Jacobian evaluations and preconditioner setups=%D, avoided=%D\n",ts->jacreuse.computed,ts->jacreuse.reused);CHKERRQ(ierr);
+    }
     ierr = PetscViewerASCIIPrintf(viewer,"  total number of rejected steps=%D\n",ts->reject);CHKERRQ(ierr);
     if (ts->vrtol) {
       ierr = PetscViewerASCIIPrintf(viewer,"  using vector of relative error tolerances, ");CHKERRQ(ierr);
@@ -2745,7 +2911,8 @@ PetscErrorCode  TSReset(TS ts)
 
   ierr = PetscFree(ts->vecs_fwdsensipacked);CHKERRQ(ierr);
 
-  ts->setupcalled = PETSC_FALSE;
+  ts->jacreuse.shift = 0.0;
+  ts->setupcalled    = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
 
@@ -2783,6 +2950,7 @@ PetscErrorCode  TSDestroy(TS *ts)
 
   ierr = TSAdaptDestroy(&(*ts)->adapt);CHKERRQ(ierr);
   ierr = TSEventDestroy(&(*ts)->event);CHKERRQ(ierr);
+  ierr = TSRHSSplitDestroy_Private(*ts);CHKERRQ(ierr);
 
   ierr = SNESDestroy(&(*ts)->snes);CHKERRQ(ierr);
   ierr = DMDestroy(&(*ts)->dm);CHKERRQ(ierr);
@@ -4343,6 +4511,8 @@ PetscErrorCode TSSolve(TS ts,Vec u)
     ts->snes_its          = 0;
     ts->num_snes_failures = 0;
     ts->reject            = 0;
+    ts->jacreuse.computed = 0;
+    ts->jacreuse.reused   = 0;
     ts->steprestart       = PETSC_TRUE;
     ts->steprollback      = PETSC_FALSE;
   }
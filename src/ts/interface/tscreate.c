@@ -68,6 +68,9 @@ PetscErrorCode  TSCreate(MPI_Comm comm, TS *ts)
   t->rhsjacobian.scale = 1.0;
   t->ijacobian.shift   = 1.0;
 
+  t->jacreuse.shiftratio = 1.5;
+  t->jacreuse.rate       = 0.3;
+
   /* All methods that do adaptivity should specify
    * its preferred adapt type in their constructor */
   t->default_adapt_type = TSADAPTNONE;
@@ -16,6 +16,10 @@ PETSC_EXTERN PetscErrorCode TSCreate_RosW(TS);
 PETSC_EXTERN PetscErrorCode TSCreate_EIMEX(TS);
 PETSC_EXTERN PetscErrorCode TSCreate_Mimex(TS);
 PETSC_EXTERN PetscErrorCode TSCreate_BDF(TS);
+PETSC_EXTERN PetscErrorCode TSCreate_Parareal(TS);
+PETSC_EXTERN PetscErrorCode TSCreate_Ensemble(TS);
+PETSC_EXTERN PetscErrorCode TSCreate_ExpRB(TS);
+PETSC_EXTERN PetscErrorCode TSCreate_MPRK(TS);
 PETSC_EXTERN PetscErrorCode TSCreate_GLEE(TS);
 
 /*@C
@@ -58,6 +62,10 @@ PetscErrorCode  TSRegisterAll(void)
   ierr = TSRegister(TSEIMEX,    TSCreate_EIMEX);CHKERRQ(ierr);
   ierr = TSRegister(TSMIMEX,    TSCreate_Mimex);CHKERRQ(ierr);
   ierr = TSRegister(TSBDF,      TSCreate_BDF);CHKERRQ(ierr);
+  ierr = TSRegister(TSPARAREAL, TSCreate_Parareal);CHKERRQ(ierr);
+  ierr = TSRegister(TSENSEMBLE, TSCreate_Ensemble);CHKERRQ(ierr);
+  ierr = TSRegister(TSEXPRB,    TSCreate_ExpRB);CHKERRQ(ierr);
+  ierr = TSRegister(TSMPRK,     TSCreate_MPRK);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
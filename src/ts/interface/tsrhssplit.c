@@ -0,0 +1,187 @@
+#include <petsc/private/tsimpl.h>        /*I "petscts.h"  I*/
+
+static PetscErrorCode TSRHSSplitGetLink_Private(TS ts,const char splitname[],PetscBool create,TS_RHSSplitLink *isplit)
+{
+  TS_RHSSplitLink link,*next = &ts->tsrhssplit;
+  PetscBool       found;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  *isplit = NULL;
+  for (link=ts->tsrhssplit; link; link=link->next) {
+    ierr = PetscStrcmp(link->splitname,splitname,&found);CHKERRQ(ierr);
+    if (found) {*isplit = link; PetscFunctionReturn(0);}
+    next = &link->next;
+  }
+  if (!create) PetscFunctionReturn(0);
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(splitname,&link->splitname);CHKERRQ(ierr);
+  *next   = link;
+  *isplit = link;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode TSRHSSplitDestroy_Private(TS ts)
+{
+  TS_RHSSplitLink link = ts->tsrhssplit,next;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  while (link) {
+    next = link->next;
+    ierr = ISDestroy(&link->is);CHKERRQ(ierr);
+    ierr = PetscFree(link->splitname);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+    link = next;
+  }
+  ts->tsrhssplit = NULL;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   TSRHSSplitSetIS - Set the index set for the specified split
+
+   Logically Collective on TS
+
+   Input Parameters:
++  ts        - the TS context obtained from TSCreate()
+.  splitname - name of this split, if NULL the number of the split is used
+-  is        - the index set for part of the solution vector
+
+   Notes:
+   As with PCFieldSplitSetIS(), each process lists the global numbers of locally owned components of the solution.
+
+   Level: intermediate
+
+.seealso: TSRHSSplitGetIS(), TSRHSSplitSetRHSFunction(), TSMPRK
+
+.keywords: TS, TSRHSSplit
+@*/
+PetscErrorCode TSRHSSplitSetIS(TS ts,const char splitname[],IS is)
+{
+  TS_RHSSplitLink link,l;
+  PetscInt        n = 0;
+  char            name[8];
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidHeaderSpecific(is,IS_CLASSID,3);
+  if (!splitname) {
+    for (l=ts->tsrhssplit; l; l=l->next) n++;
+    ierr = PetscSNPrintf(name,sizeof(name),"%D",n);CHKERRQ(ierr);
+    splitname = name;
+  }
+  ierr = TSRHSSplitGetLink_Private(ts,splitname,PETSC_TRUE,&link);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject)is);CHKERRQ(ierr);
+  ierr = ISDestroy(&link->is);CHKERRQ(ierr);
+  link->is = is;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   TSRHSSplitGetIS - Retrieves the elements for a split as an IS
+
+   Not Collective
+
+   Input Parameters:
++  ts        - the TS context obtained from TSCreate()
+-  splitname - name of this split
+
+   Output Parameters:
+.  is        - the index set for part of the solution vector, NULL if the split has not been set
+
+   Level: intermediate
+
+.seealso: TSRHSSplitSetIS(), TSRHSSplitGetRHSFunction()
+
+.keywords: TS, TSRHSSplit
+@*/
+PetscErrorCode TSRHSSplitGetIS(TS ts,const char splitname[],IS *is)
+{
+  TS_RHSSplitLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidPointer(is,3);
+  ierr = TSRHSSplitGetLink_Private(ts,splitname,PETSC_FALSE,&link);CHKERRQ(ierr);
+  *is  = link ? link->is : NULL;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   TSRHSSplitSetRHSFunction - Set the function evaluating the right hand side restricted to a split
+
+   Logically Collective on TS
+
+   Input Parameters:
++  ts        - the TS context obtained from TSCreate()
+.  splitname - name of this split
+.  rhsfunc   - the right hand side function of the split
+-  ctx       - [optional] user-defined context for private data for the split function (may be NULL)
+
+   Calling sequence of rhsfunc:
+$  rhsfunc(TS ts,PetscReal t,Vec u,Vec f,void *ctx);
+
++  t    - current timestep
+.  u    - the full solution vector
+.  f    - the components of the right hand side in the split, laid out as the subvector obtained with VecGetSubVector()
+-  ctx  - [optional] user-defined context
+
+   Notes:
+   Methods which integrate the splits separately call this function instead of evaluating the full right hand side
+   given with TSSetRHSFunction() and discarding the components outside the split.
+
+   Level: intermediate
+
+.seealso: TSRHSSplitSetIS(), TSRHSSplitGetRHSFunction(), TSSetRHSFunction()
+
+.keywords: TS, TSRHSSplit
+@*/
+PetscErrorCode TSRHSSplitSetRHSFunction(TS ts,const char splitname[],TSRHSFunction rhsfunc,void *ctx)
+{
+  TS_RHSSplitLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  PetscValidCharPointer(splitname,2);
+  ierr = TSRHSSplitGetLink_Private(ts,splitname,PETSC_FALSE,&link);CHKERRQ(ierr);
+  if (!link) SETERRQ1(PetscObjectComm((PetscObject)ts),PETSC_ERR_ARG_WRONGSTATE,"Must call TSRHSSplitSetIS() for split '%s' first",splitname);
+  link->rhsfunction = rhsfunc;
+  link->ctx         = ctx;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   TSRHSSplitGetRHSFunction - Get the function evaluating the right hand side restricted to a split
+
+   Not Collective
+
+   Input Parameters:
++  ts        - the TS context obtained from TSCreate()
+-  splitname - name of this split
+
+   Output Parameters:
++  rhsfunc   - the right hand side function of the split, NULL if none was set
+-  ctx       - the user-defined context of the function
+
+   Level: intermediate
+
+.seealso: TSRHSSplitSetRHSFunction(), TSRHSSplitGetIS()
+
+.keywords: TS, TSRHSSplit
+@*/
+PetscErrorCode TSRHSSplitGetRHSFunction(TS ts,const char splitname[],TSRHSFunction *rhsfunc,void **ctx)
+{
+  TS_RHSSplitLink link;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ts,TS_CLASSID,1);
+  ierr = TSRHSSplitGetLink_Private(ts,splitname,PETSC_FALSE,&link);CHKERRQ(ierr);
+  if (rhsfunc) *rhsfunc = link ? link->rhsfunction : NULL;
+  if (ctx)     *ctx     = link ? link->ctx : NULL;
+  PetscFunctionReturn(0);
+}
@@ -1,5 +1,52 @@
 
 #include <petsc/private/tsimpl.h>        /*I "petscts.h"  I*/
+#include <petsctime.h>
+#if defined(PETSC_HAVE_PTHREAD)
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
+PetscLogEvent TSTrajectory_IOWait;
+
+/*
+   Asynchronous mode: the first process serializes each checkpoint into the same byte stream VecView() and
+   PetscViewerBinaryWrite() would produce, and a background thread writes it. During the adjoint sweep the thread
+   reads the file of the previous step while the current step is processed. The thread only does POSIX I/O,
+   it never calls PETSc or MPI.
+*/
+typedef enum {TJ_REQ_FREE,TJ_REQ_QUEUED,TJ_REQ_ACTIVE,TJ_REQ_DONE} TJRequestState;
+
+typedef struct {
+  TJRequestState state;
+  PetscBool      write;                       /* write or read request */
+  PetscInt       stepnum;
+  PetscInt       seq;                         /* requests are served in the order they were queued */
+  char           filename[PETSC_MAX_PATH_LEN];
+  char           *buf;
+  size_t         len;
+  int            err;                         /* errno of a failed request */
+  PetscLogDouble iotime;                      /* time spent by the thread on the request */
+} TJRequest;
+
+typedef struct {
+  PetscBool       async;                      /* use the background I/O thread */
+  PetscInt        nbuffers;                   /* size of the buffer pool */
+  TJRequest       *req;
+  size_t          bufsize;                    /* capacity of each buffer */
+  PetscInt        N,nstages;                  /* layout the buffers were allocated for */
+  PetscMPIInt     *counts,*displs;            /* local sizes for the gather/scatter of the vectors */
+  PetscInt        seq;
+  PetscLogDouble  iotime,waittime;            /* total I/O time of the thread and time the solver waited for it */
+#if defined(PETSC_HAVE_PTHREAD)
+  pthread_t       thread;
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  PetscBool       running,shutdown;
+#endif
+} TSTrajectory_Basic;
 
 static PetscErrorCode OutputBIN(MPI_Comm comm,const char *filename,PetscViewer *viewer)
 {
@@ -13,6 +60,406 @@ static PetscErrorCode OutputBIN(MPI_Comm comm,const char *filename,PetscViewer *
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_PTHREAD)
+static PetscLogDouble TJWallTime(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv,NULL);
+  return (PetscLogDouble)tv.tv_sec + 1.e-6*(PetscLogDouble)tv.tv_usec;
+}
+
+/* runs on the I/O thread, no PETSc or MPI calls allowed */
+static int TJRequestProcess(TJRequest *r)
+{
+  size_t  done = 0;
+  ssize_t n;
+  int     fd;
+
+  if (r->write) fd = open(r->filename,O_WRONLY|O_CREAT|O_TRUNC,0666);
+  else          fd = open(r->filename,O_RDONLY);
+  if (fd < 0) return errno ? errno : EIO;
+  while (done < r->len) {
+    if (r->write) n = write(fd,r->buf+done,r->len-done);
+    else          n = read(fd,r->buf+done,r->len-done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {close(fd); return (n < 0 && errno) ? errno : EIO;}
+    done += (size_t)n;
+  }
+  if (close(fd)) return errno ? errno : EIO;
+  return 0;
+}
+
+static void *TJIOThread(void *ctx)
+{
+  TSTrajectory_Basic *tjb = (TSTrajectory_Basic*)ctx;
+  TJRequest          *r;
+  PetscInt           i;
+  PetscLogDouble     t0;
+  int                err;
+
+  pthread_mutex_lock(&tjb->lock);
+  while (1) {
+    for (r=NULL,i=0; i<tjb->nbuffers; i++) {
+      if (tjb->req[i].state == TJ_REQ_QUEUED && (!r || tjb->req[i].seq < r->seq)) r = &tjb->req[i];
+    }
+    if (!r) {
+      if (tjb->shutdown) break;
+      pthread_cond_wait(&tjb->cond,&tjb->lock);
+      continue;
+    }
+    r->state = TJ_REQ_ACTIVE;
+    pthread_mutex_unlock(&tjb->lock);
+    t0  = TJWallTime();
+    err = TJRequestProcess(r);
+    t0  = TJWallTime() - t0;
+    pthread_mutex_lock(&tjb->lock);
+    r->err    = err;
+    r->iotime = t0;
+    r->state  = TJ_REQ_DONE;
+    pthread_cond_broadcast(&tjb->cond);
+  }
+  pthread_mutex_unlock(&tjb->lock);
+  return NULL;
+}
+
+/* release a completed request, called with the lock held */
+static PetscErrorCode TSTrajectoryBasicReap_Private(TSTrajectory_Basic *tjb,TJRequest *r)
+{
+  PetscFunctionBegin;
+  if (r->err) {
+    int err = r->err;
+
+    r->state = TJ_REQ_FREE;
+    pthread_mutex_unlock(&tjb->lock);
+    SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Could not %s checkpoint file %s: %s",r->write ? "write" : "read",r->filename,strerror(err));
+  }
+  tjb->iotime += r->iotime;
+  r->iotime    = 0.0;
+  if (r->write) r->state = TJ_REQ_FREE;
+  PetscFunctionReturn(0);
+}
+
+/* block until the request is done, the time spent waiting is logged in TSTrajIOWait; called with the lock held */
+static PetscErrorCode TSTrajectoryBasicWait_Private(TSTrajectory_Basic *tjb,TJRequest *r)
+{
+  PetscLogDouble t0,t1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (r->state == TJ_REQ_QUEUED || r->state == TJ_REQ_ACTIVE) {
+    ierr = PetscLogEventBegin(TSTrajectory_IOWait,0,0,0,0);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    while (r->state != TJ_REQ_DONE) pthread_cond_wait(&tjb->cond,&tjb->lock);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(TSTrajectory_IOWait,0,0,0,0);CHKERRQ(ierr);
+    tjb->waittime += t1 - t0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* complete every pending request, prefetched reads are dropped */
+static PetscErrorCode TSTrajectoryBasicDrain_Private(TSTrajectory_Basic *tjb)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!tjb->running) PetscFunctionReturn(0);
+  pthread_mutex_lock(&tjb->lock);
+  for (i=0; i<tjb->nbuffers; i++) {
+    TJRequest *r = &tjb->req[i];
+
+    if (r->state == TJ_REQ_FREE) continue;
+    ierr = TSTrajectoryBasicWait_Private(tjb,r);CHKERRQ(ierr);
+    ierr = TSTrajectoryBasicReap_Private(tjb,r);CHKERRQ(ierr);
+    r->state = TJ_REQ_FREE;
+  }
+  pthread_mutex_unlock(&tjb->lock);
+  PetscFunctionReturn(0);
+}
+
+/* obtain a free buffer, waiting for the oldest write or dropping the oldest unused prefetch if the pool is full */
+static PetscErrorCode TSTrajectoryBasicGetFreeRequest_Private(TSTrajectory_Basic *tjb,TJRequest **req)
+{
+  TJRequest      *r,*oldest;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!tjb->running) {
+    tjb->shutdown = PETSC_FALSE;
+    if (pthread_mutex_init(&tjb->lock,NULL) || pthread_cond_init(&tjb->cond,NULL)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not initialize the I/O thread synchronization");
+    if (pthread_create(&tjb->thread,NULL,TJIOThread,tjb)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"Could not create the I/O thread");
+    tjb->running = PETSC_TRUE;
+  }
+  pthread_mutex_lock(&tjb->lock);
+  while (1) {
+    for (i=0,oldest=NULL; i<tjb->nbuffers; i++) {
+      r = &tjb->req[i];
+      if (r->state == TJ_REQ_DONE && r->write) {ierr = TSTrajectoryBasicReap_Private(tjb,r);CHKERRQ(ierr);}
+      if (r->state == TJ_REQ_FREE) {
+        pthread_mutex_unlock(&tjb->lock);
+        *req = r;
+        PetscFunctionReturn(0);
+      }
+      if (!oldest || r->seq < oldest->seq) oldest = r;
+    }
+    ierr = TSTrajectoryBasicWait_Private(tjb,oldest);CHKERRQ(ierr);
+    ierr = TSTrajectoryBasicReap_Private(tjb,oldest);CHKERRQ(ierr);
+    oldest->state = TJ_REQ_FREE;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryBasicEnqueue_Private(TSTrajectory_Basic *tjb,TJRequest *r,PetscBool write,PetscInt stepnum,size_t len)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSNPrintf(r->filename,sizeof(r->filename),"SA-data/SA-%06d.bin",stepnum);CHKERRQ(ierr);
+  pthread_mutex_lock(&tjb->lock);
+  r->write   = write;
+  r->stepnum = stepnum;
+  r->len     = len;
+  r->err     = 0;
+  r->seq     = tjb->seq++;
+  r->state   = TJ_REQ_QUEUED;
+  pthread_cond_broadcast(&tjb->cond);
+  pthread_mutex_unlock(&tjb->lock);
+  PetscFunctionReturn(0);
+}
+#endif
+
+/* size of a checkpoint file, matches the output of VecView() and PetscViewerBinaryWrite() */
+static size_t TSTrajectoryBasicFileSize(PetscInt N,PetscInt nvecs,PetscInt nreals)
+{
+  return (size_t)nvecs*(2*sizeof(PetscInt) + (size_t)N*sizeof(PetscScalar)) + (size_t)nreals*sizeof(PetscReal);
+}
+
+static PetscErrorCode TSTrajectoryBasicSetUpBuffers_Private(TSTrajectory_Basic *tjb,Vec X,PetscInt nstages)
+{
+  const PetscInt *ranges;
+  PetscInt       N,i;
+  PetscMPIInt    size,rank;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetSize(X,&N);CHKERRQ(ierr);
+  if (tjb->counts && N == tjb->N && nstages <= tjb->nstages) PetscFunctionReturn(0);
+  ierr = PetscObjectGetComm((PetscObject)X,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscFree2(tjb->counts,tjb->displs);CHKERRQ(ierr);
+  ierr = PetscMalloc2(size,&tjb->counts,size,&tjb->displs);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRanges(X,&ranges);CHKERRQ(ierr);
+  for (i=0; i<size; i++) {
+    ierr = PetscMPIIntCast(ranges[i+1]-ranges[i],&tjb->counts[i]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(ranges[i],&tjb->displs[i]);CHKERRQ(ierr);
+  }
+  tjb->N       = N;
+  tjb->nstages = PetscMax(nstages,tjb->nstages);
+  if (!rank) {
+#if defined(PETSC_HAVE_PTHREAD)
+    ierr = TSTrajectoryBasicDrain_Private(tjb);CHKERRQ(ierr);
+#endif
+    tjb->bufsize = TSTrajectoryBasicFileSize(N,1+tjb->nstages,2);
+    for (i=0; i<tjb->nbuffers; i++) {
+      ierr = PetscFree(tjb->req[i].buf);CHKERRQ(ierr);
+      ierr = PetscMalloc1(tjb->bufsize,&tjb->req[i].buf);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* gather a vector into the buffer of the first process in the binary format of VecView() */
+static PetscErrorCode TSTrajectoryBasicPackVec_Private(TSTrajectory_Basic *tjb,Vec X,char **buf)
+{
+  const PetscScalar *x;
+  PetscInt          n,tr[2];
+  PetscMPIInt       rank;
+  MPI_Comm          comm;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)X,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = MPI_Gatherv((void*)x,(PetscMPIInt)n,MPIU_SCALAR,rank ? NULL : *buf+2*sizeof(PetscInt),tjb->counts,tjb->displs,MPIU_SCALAR,0,comm);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  if (!rank) {
+    tr[0] = VEC_FILE_CLASSID;
+    tr[1] = tjb->N;
+    ierr = PetscMemcpy(*buf,tr,sizeof(tr));CHKERRQ(ierr);
+#if !defined(PETSC_WORDS_BIGENDIAN)
+    ierr = PetscByteSwap(*buf,PETSC_INT,2);CHKERRQ(ierr);
+    ierr = PetscByteSwap(*buf+2*sizeof(PetscInt),PETSC_SCALAR,tjb->N);CHKERRQ(ierr);
+#endif
+    *buf += 2*sizeof(PetscInt) + tjb->N*sizeof(PetscScalar);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryBasicPackReal_Private(PetscReal t,char **buf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemcpy(*buf,&t,sizeof(PetscReal));CHKERRQ(ierr);
+#if !defined(PETSC_WORDS_BIGENDIAN)
+  ierr = PetscByteSwap(*buf,PETSC_REAL,1);CHKERRQ(ierr);
+#endif
+  *buf += sizeof(PetscReal);
+  PetscFunctionReturn(0);
+}
+
+/* scatter a vector from the buffer of the first process, the inverse of TSTrajectoryBasicPackVec_Private() */
+static PetscErrorCode TSTrajectoryBasicUnpackVec_Private(TSTrajectory_Basic *tjb,Vec X,const char *filename,char **buf)
+{
+  PetscScalar    *x;
+  PetscInt       n,tr[2];
+  PetscMPIInt    rank;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)X,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscMemcpy(tr,*buf,sizeof(tr));CHKERRQ(ierr);
+#if !defined(PETSC_WORDS_BIGENDIAN)
+    ierr = PetscByteSwap(tr,PETSC_INT,2);CHKERRQ(ierr);
+    ierr = PetscByteSwap(*buf+2*sizeof(PetscInt),PETSC_SCALAR,tjb->N);CHKERRQ(ierr);
+#endif
+    if (tr[0] != VEC_FILE_CLASSID || tr[1] != tjb->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Checkpoint file %s does not contain a vector of size %D",filename,tjb->N);
+  }
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(X,&x);CHKERRQ(ierr);
+  ierr = MPI_Scatterv(rank ? NULL : *buf+2*sizeof(PetscInt),tjb->counts,tjb->displs,MPIU_SCALAR,x,(PetscMPIInt)n,MPIU_SCALAR,0,comm);CHKERRQ(ierr);
+  ierr = VecRestoreArray(X,&x);CHKERRQ(ierr);
+  if (!rank) *buf += 2*sizeof(PetscInt) + tjb->N*sizeof(PetscScalar);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryBasicUnpackReal_Private(PetscReal *t,char **buf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemcpy(t,*buf,sizeof(PetscReal));CHKERRQ(ierr);
+#if !defined(PETSC_WORDS_BIGENDIAN)
+  ierr = PetscByteSwap(t,PETSC_REAL,1);CHKERRQ(ierr);
+#endif
+  *buf += sizeof(PetscReal);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_PTHREAD)
+static PetscErrorCode TSTrajectorySet_Basic_Async(TSTrajectory tj,TS ts,PetscInt stepnum,PetscReal time,Vec X)
+{
+  TSTrajectory_Basic *tjb = (TSTrajectory_Basic*)tj->data;
+  TJRequest          *r = NULL;
+  PetscInt           ns = 0,i;
+  Vec                *Y;
+  PetscReal          tprev;
+  PetscMPIInt        rank;
+  MPI_Comm           comm;
+  char               *buf = NULL;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)ts,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = TSGetStepNumber(ts,&stepnum);CHKERRQ(ierr);
+  if (stepnum) {ierr = TSGetStages(ts,&ns,&Y);CHKERRQ(ierr);}
+  ierr = TSTrajectoryBasicSetUpBuffers_Private(tjb,X,ns);CHKERRQ(ierr);
+  if (!rank) {
+    if (stepnum == 0) {
+      /* files of a previous solve may still be in flight */
+      ierr = TSTrajectoryBasicDrain_Private(tjb);CHKERRQ(ierr);
+      ierr = PetscRMTree("SA-data");CHKERRQ(ierr);
+      ierr = PetscMkdir("SA-data");CHKERRQ(ierr);
+    }
+    ierr = TSTrajectoryBasicGetFreeRequest_Private(tjb,&r);CHKERRQ(ierr);
+    buf  = r->buf;
+  }
+  ierr = TSTrajectoryBasicPackVec_Private(tjb,X,&buf);CHKERRQ(ierr);
+  if (!rank) {ierr = TSTrajectoryBasicPackReal_Private(time,&buf);CHKERRQ(ierr);}
+  if (stepnum) {
+    for (i=0; i<ns; i++) {ierr = TSTrajectoryBasicPackVec_Private(tjb,Y[i],&buf);CHKERRQ(ierr);}
+    ierr = TSGetPrevTime(ts,&tprev);CHKERRQ(ierr);
+    if (!rank) {ierr = TSTrajectoryBasicPackReal_Private(tprev,&buf);CHKERRQ(ierr);}
+  }
+  if (!rank) {ierr = TSTrajectoryBasicEnqueue_Private(tjb,r,PETSC_TRUE,stepnum,(size_t)(buf - r->buf));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryGet_Basic_Async(TSTrajectory tj,TS ts,PetscInt stepnum,PetscReal *t)
+{
+  TSTrajectory_Basic *tjb = (TSTrajectory_Basic*)tj->data;
+  TJRequest          *r = NULL,*pf = NULL;
+  Vec                Sol,*Y;
+  PetscInt           Nr = 0,i;
+  PetscReal          times[2] = {0.0,0.0};
+  PetscMPIInt        rank;
+  MPI_Comm           comm;
+  char               *buf = NULL;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)ts,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = TSGetSolution(ts,&Sol);CHKERRQ(ierr);
+  if (stepnum) {ierr = TSGetStages(ts,&Nr,&Y);CHKERRQ(ierr);}
+  ierr = TSTrajectoryBasicSetUpBuffers_Private(tjb,Sol,Nr);CHKERRQ(ierr);
+  if (!rank) {
+    /* every pending write must reach the disk before reading, then use the prefetched file if there is one */
+    pthread_mutex_lock(&tjb->lock);
+    for (i=0; i<tjb->nbuffers; i++) {
+      TJRequest *q = &tjb->req[i];
+
+      if (q->state == TJ_REQ_FREE) continue;
+      ierr = TSTrajectoryBasicWait_Private(tjb,q);CHKERRQ(ierr);
+      ierr = TSTrajectoryBasicReap_Private(tjb,q);CHKERRQ(ierr);
+      if (!q->write && q->stepnum == stepnum && !r) r = q;
+      else q->state = TJ_REQ_FREE;
+    }
+    pthread_mutex_unlock(&tjb->lock);
+    if (!r) {
+      ierr = TSTrajectoryBasicGetFreeRequest_Private(tjb,&r);CHKERRQ(ierr);
+      ierr = TSTrajectoryBasicEnqueue_Private(tjb,r,PETSC_FALSE,stepnum,TSTrajectoryBasicFileSize(tjb->N,1+Nr,stepnum ? 2 : 1));CHKERRQ(ierr);
+      pthread_mutex_lock(&tjb->lock);
+      ierr = TSTrajectoryBasicWait_Private(tjb,r);CHKERRQ(ierr);
+      ierr = TSTrajectoryBasicReap_Private(tjb,r);CHKERRQ(ierr);
+      pthread_mutex_unlock(&tjb->lock);
+    }
+    /* read ahead the previous step while this one is being used */
+    if (stepnum > 0) {
+      ierr = TSTrajectoryBasicGetFreeRequest_Private(tjb,&pf);CHKERRQ(ierr);
+      ierr = TSTrajectoryBasicEnqueue_Private(tjb,pf,PETSC_FALSE,stepnum-1,TSTrajectoryBasicFileSize(tjb->N,stepnum-1 ? 1+Nr : 1,stepnum-1 ? 2 : 1));CHKERRQ(ierr);
+    }
+    buf  = r->buf;
+  }
+  ierr = TSTrajectoryBasicUnpackVec_Private(tjb,Sol,r ? r->filename : NULL,&buf);CHKERRQ(ierr);
+  if (!rank) {ierr = TSTrajectoryBasicUnpackReal_Private(&times[0],&buf);CHKERRQ(ierr);}
+  if (stepnum) {
+    for (i=0; i<Nr; i++) {ierr = TSTrajectoryBasicUnpackVec_Private(tjb,Y[i],r ? r->filename : NULL,&buf);CHKERRQ(ierr);}
+    if (!rank) {ierr = TSTrajectoryBasicUnpackReal_Private(&times[1],&buf);CHKERRQ(ierr);}
+  }
+  if (!rank) {
+    pthread_mutex_lock(&tjb->lock);
+    r->state = TJ_REQ_FREE;
+    pthread_mutex_unlock(&tjb->lock);
+  }
+  ierr = MPI_Bcast(times,2,MPIU_REAL,0,comm);CHKERRQ(ierr);
+  *t   = times[0];
+  if (stepnum) {ierr = TSSetTimeStep(ts,-(*t)+times[1]);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+#endif
+
 static PetscErrorCode TSTrajectorySet_Basic(TSTrajectory tj,TS ts,PetscInt stepnum,PetscReal time,Vec X)
 {
   PetscViewer    viewer;
@@ -24,6 +471,12 @@ static PetscErrorCode TSTrajectorySet_Basic(TSTrajectory tj,TS ts,PetscInt stepn
   MPI_Comm       comm;
 
   PetscFunctionBegin;
+#if defined(PETSC_HAVE_PTHREAD)
+  if (((TSTrajectory_Basic*)tj->data)->async) {
+    ierr = TSTrajectorySet_Basic_Async(tj,ts,stepnum,time,X);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
   ierr = PetscObjectGetComm((PetscObject)ts,&comm);CHKERRQ(ierr);
   ierr = TSGetStepNumber(ts,&stepnum);CHKERRQ(ierr);
   if (stepnum == 0) {
@@ -67,6 +520,12 @@ static PetscErrorCode TSTrajectoryGet_Basic(TSTrajectory tj,TS ts,PetscInt stepn
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+#if defined(PETSC_HAVE_PTHREAD)
+  if (((TSTrajectory_Basic*)tj->data)->async) {
+    ierr = TSTrajectoryGet_Basic_Async(tj,ts,stepnum,t);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
   ierr = PetscSNPrintf(filename,sizeof filename,"SA-data/SA-%06d.bin",stepnum);CHKERRQ(ierr);
   ierr = PetscViewerBinaryOpen(PETSC_COMM_WORLD,filename,FILE_MODE_READ,&viewer);CHKERRQ(ierr);
 
@@ -88,6 +547,91 @@ static PetscErrorCode TSTrajectoryGet_Basic(TSTrajectory tj,TS ts,PetscInt stepn
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode TSTrajectorySetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,TSTrajectory tj)
+{
+  TSTrajectory_Basic *tjb = (TSTrajectory_Basic*)tj->data;
+  PetscInt           i,nbuffers = tjb->nbuffers;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"Basic TS trajectory options");CHKERRQ(ierr);
+  {
+    ierr = PetscOptionsBool("-ts_trajectory_basic_async","Write and read checkpoints with a background I/O thread","",tjb->async,&tjb->async,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsInt("-ts_trajectory_basic_buffers","Number of checkpoints buffered by the I/O thread","",tjb->nbuffers,&nbuffers,NULL);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  if (nbuffers < 2) SETERRQ1(PetscObjectComm((PetscObject)tj),PETSC_ERR_ARG_OUTOFRANGE,"At least 2 buffers are needed, not %D",nbuffers);
+  if (tjb->req && nbuffers != tjb->nbuffers) {
+    /* complete the pending requests and resize the pool, its buffers are allocated again at the next checkpoint */
+#if defined(PETSC_HAVE_PTHREAD)
+    ierr = TSTrajectoryBasicDrain_Private(tjb);CHKERRQ(ierr);
+    if (tjb->running) pthread_mutex_lock(&tjb->lock);
+#endif
+    for (i=0; i<tjb->nbuffers; i++) {ierr = PetscFree(tjb->req[i].buf);CHKERRQ(ierr);}
+    ierr = PetscFree(tjb->req);CHKERRQ(ierr);
+    ierr = PetscCalloc1(nbuffers,&tjb->req);CHKERRQ(ierr);
+    tjb->nbuffers = nbuffers;
+#if defined(PETSC_HAVE_PTHREAD)
+    if (tjb->running) pthread_mutex_unlock(&tjb->lock);
+#endif
+    ierr = PetscFree2(tjb->counts,tjb->displs);CHKERRQ(ierr);
+  }
+  tjb->nbuffers = nbuffers;
+#if !defined(PETSC_HAVE_PTHREAD)
+  if (tjb->async) {
+    ierr = PetscInfo(tj,"Asynchronous checkpoint I/O needs pthreads, using synchronous I/O\n");CHKERRQ(ierr);
+    tjb->async = PETSC_FALSE;
+  }
+#endif
+  if (tjb->async && !tjb->req) {ierr = PetscCalloc1(tjb->nbuffers,&tjb->req);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryView_Basic(TSTrajectory tj,PetscViewer viewer)
+{
+  TSTrajectory_Basic *tjb = (TSTrajectory_Basic*)tj->data;
+  PetscBool          iascii;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && tjb->async) {
+    ierr = PetscViewerASCIIPrintf(viewer,"asynchronous I/O with %D buffers\n",tjb->nbuffers);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"I/O time %g seconds, %g seconds of it overlapped with the solver\n",(double)tjb->iotime,(double)PetscMax(tjb->iotime-tjb->waittime,0.0));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TSTrajectoryDestroy_Basic(TSTrajectory tj)
+{
+  TSTrajectory_Basic *tjb = (TSTrajectory_Basic*)tj->data;
+  PetscInt           i;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_PTHREAD)
+  if (tjb->running) {
+    ierr = TSTrajectoryBasicDrain_Private(tjb);CHKERRQ(ierr);
+    pthread_mutex_lock(&tjb->lock);
+    tjb->shutdown = PETSC_TRUE;
+    pthread_cond_broadcast(&tjb->cond);
+    pthread_mutex_unlock(&tjb->lock);
+    pthread_join(tjb->thread,NULL);
+    pthread_cond_destroy(&tjb->cond);
+    pthread_mutex_destroy(&tjb->lock);
+    tjb->running = PETSC_FALSE;
+    ierr = PetscInfo2(tj,"Checkpoint I/O took %g seconds, the solver waited %g seconds\n",(double)tjb->iotime,(double)tjb->waittime);CHKERRQ(ierr);
+  }
+#endif
+  if (tjb->req) {
+    for (i=0; i<tjb->nbuffers; i++) {ierr = PetscFree(tjb->req[i].buf);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree(tjb->req);CHKERRQ(ierr);
+  ierr = PetscFree2(tjb->counts,tjb->displs);CHKERRQ(ierr);
+  ierr = PetscFree(tj->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*MC
       TSTRAJECTORYBASIC - Stores each solution of the ODE/DAE in a file
 
@@ -97,6 +641,15 @@ static PetscErrorCode TSTrajectoryGet_Basic(TSTrajectory tj,TS ts,PetscInt stepn
 
       $PETSC_DIR/share/petsc/matlab/PetscReadBinaryTrajectory.m can read in files created with this format
 
+  Options Database Keys:
++  -ts_trajectory_basic_async - write the checkpoints from a pool of buffers with a background thread, and read the previous step ahead during the adjoint sweep
+-  -ts_trajectory_basic_buffers <n> - number of buffers in the pool (default 4)
+
+  Notes:
+  In the asynchronous mode the first process holds the buffers and does all the file I/O, as VecView() does with the binary viewer, and no .info files are written.
+  The time the solver spent waiting for the I/O thread is logged in the TSTrajIOWait event; TSTrajectoryView() reports the I/O time of the thread
+  and the part of it that overlapped with the solver.
+
   Level: intermediate
 
 .seealso:  TSTrajectoryCreate(), TS, TSTrajectorySetType()
@@ -104,8 +657,20 @@ static PetscErrorCode TSTrajectoryGet_Basic(TSTrajectory tj,TS ts,PetscInt stepn
 M*/
 PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Basic(TSTrajectory tj,TS ts)
 {
+  TSTrajectory_Basic *tjb;
+  PetscErrorCode     ierr;
+
   PetscFunctionBegin;
-  tj->ops->set  = TSTrajectorySet_Basic;
-  tj->ops->get  = TSTrajectoryGet_Basic;
+  tj->ops->set            = TSTrajectorySet_Basic;
+  tj->ops->get            = TSTrajectoryGet_Basic;
+  tj->ops->setfromoptions = TSTrajectorySetFromOptions_Basic;
+  tj->ops->view           = TSTrajectoryView_Basic;
+  tj->ops->destroy        = TSTrajectoryDestroy_Basic;
+
+  ierr = PetscNewLog(tj,&tjb);CHKERRQ(ierr);
+  tjb->async    = PETSC_FALSE;
+  tjb->nbuffers = 4;
+
+  tj->data = tjb;
   PetscFunctionReturn(0);
 }
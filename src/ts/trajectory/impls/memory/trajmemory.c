@@ -8,6 +8,9 @@ PetscLogEvent TSTrajectory_DiskWrite, TSTrajectory_DiskRead;
 
 typedef enum {NONE,TWO_LEVEL_NOREVOLVE,TWO_LEVEL_REVOLVE,TWO_LEVEL_TWO_REVOLVE,REVOLVE_OFFLINE,REVOLVE_ONLINE,REVOLVE_MULTISTAGE} SchedulerType;
 
+typedef enum {COMPRESS_NONE,COMPRESS_LOSSLESS,COMPRESS_LOSSY} CompressionType;
+static const char *const CompressionTypes[] = {"none","lossless","lossy","CompressionType","COMPRESS_",0};
+
 typedef struct _StackElement {
   PetscInt  stepnum;
   Vec       X;
@@ -15,6 +18,8 @@ typedef struct _StackElement {
   PetscReal time;
   PetscReal timeprev; /* for no solution_only mode */
   PetscReal timenext; /* for solution_only mode */
+  char      *cdata;   /* compressed X and Y, used instead of the vectors when compression is on */
+  size_t    clen;
 } *StackElement;
 
 #if defined(PETSC_HAVE_REVOLVE)
@@ -32,12 +37,18 @@ typedef struct _RevolveCTX {
 #endif
 
 typedef struct _Stack {
-  PetscInt      stacksize;
-  PetscInt      top;
-  StackElement  *container;
-  PetscInt      numY;
-  PetscBool     solution_only;
-  PetscBool     use_dram;
+  PetscInt        stacksize;
+  PetscInt        top;
+  StackElement    *container;
+  PetscInt        numY;
+  PetscBool       solution_only;
+  PetscBool       use_dram;
+  CompressionType compress;
+  PetscReal       compress_tol;   /* relative error bound of each entry with lossy compression */
+  unsigned char   *shuffle,*work; /* scratch buffers of the compressor */
+  size_t          shufflesize,worksize;
+  Vec             Xwork,*Ywork;   /* decompressed element, used when writing to or reading from disk */
+  PetscLogDouble  rawbytes,packedbytes;
 } Stack;
 
 typedef struct _DiskStack {
@@ -57,6 +68,7 @@ typedef struct _TJScheduler {
   PetscBool     skip_trajectory;
   PetscBool     save_stack;
   PetscInt      max_cps_ram;  /* maximum checkpoints in RAM */
+  PetscReal     compress_ratio; /* expected compression ratio, the checkpoints are assumed uncompressed if not set */
   PetscInt      max_cps_disk; /* maximum checkpoints on disk */
   PetscInt      stride;
   PetscInt      total_steps;  /* total number of steps */
@@ -101,6 +113,277 @@ static PetscErrorCode TurnBackward(TS ts)
   PetscFunctionReturn(0);
 }
 
+/*
+   Compression of the stack elements. The bytes of the real numbers of each vector are shuffled so that the bytes
+   of equal significance are contiguous, which makes the sign and exponent bytes of smooth data very repetitive, and
+   the result is compressed with a small LZ77 coder. The lossy mode keeps only the most significant bytes of each
+   real number, enough to bound the relative error of each entry by the tolerance, and compresses those.
+
+   Each vector is stored as its compressed length (a size_t) followed by the compressed bytes. A literal run of k
+   bytes, 1 <= k <= 128, is coded as the byte k-1 followed by the bytes; a match of length k, 4 <= k <= 131, with
+   the data that starts d bytes earlier, 1 <= d <= 65535, is coded as the byte 0x80|(k-4) followed by d in two bytes.
+*/
+#define LZ_HASH_BITS  12
+#define LZ_MIN_MATCH  4
+#define LZ_MAX_MATCH  (0x7f+LZ_MIN_MATCH)
+#define LZ_MAX_OFFSET 0xffff
+
+PETSC_STATIC_INLINE size_t LZCompressBound(size_t n)
+{
+  return n + n/128 + 1;
+}
+
+static PetscErrorCode LZCompress(const unsigned char *in,size_t n,unsigned char *out,size_t *clen)
+{
+  size_t         table[1<<LZ_HASH_BITS],i = 0,lit = 0,o = 0,ref,len,k;
+  unsigned int   v,h;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(table,sizeof(table));CHKERRQ(ierr);
+  while (i+LZ_MIN_MATCH <= n) {
+    ierr = PetscMemcpy(&v,in+i,sizeof(v));CHKERRQ(ierr);
+    h        = (v*2654435761U) >> (32-LZ_HASH_BITS);
+    ref      = table[h];
+    table[h] = i+1; /* 0 marks an empty slot */
+    if (!ref || i-(ref-1) > LZ_MAX_OFFSET || memcmp(in+ref-1,in+i,LZ_MIN_MATCH)) {i++; continue;}
+    ref--;
+    for (len=LZ_MIN_MATCH; i+len < n && len < LZ_MAX_MATCH && in[ref+len] == in[i+len]; len++) ;
+    for (; lit < i; lit += k) {
+      k = PetscMin(i-lit,128);
+      out[o++] = (unsigned char)(k-1);
+      ierr = PetscMemcpy(out+o,in+lit,k);CHKERRQ(ierr);
+      o += k;
+    }
+    out[o++] = (unsigned char)(0x80 | (len-LZ_MIN_MATCH));
+    out[o++] = (unsigned char)((i-ref) & 0xff);
+    out[o++] = (unsigned char)((i-ref) >> 8);
+    i  += len;
+    lit = i;
+  }
+  for (; lit < n; lit += k) {
+    k = PetscMin(n-lit,128);
+    out[o++] = (unsigned char)(k-1);
+    ierr = PetscMemcpy(out+o,in+lit,k);CHKERRQ(ierr);
+    o += k;
+  }
+  *clen = o;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode LZDecompress(const unsigned char *in,size_t clen,unsigned char *out,size_t n)
+{
+  PetscErrorCode ierr;
+  size_t         i = 0,o = 0,len,off,k;
+
+  PetscFunctionBegin;
+  while (i < clen) {
+    if (in[i] & 0x80) {
+      if (i+3 > clen) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+      len = (size_t)(in[i] & 0x7f) + LZ_MIN_MATCH;
+      off = (size_t)in[i+1] | ((size_t)in[i+2] << 8);
+      i  += 3;
+      if (!off || off > o || len > n-o) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+      for (k=0; k<len; k++) out[o+k] = out[o-off+k]; /* the match may overlap the output */
+    } else {
+      len = (size_t)in[i] + 1;
+      if (len > clen-i-1 || len > n-o) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+      ierr = PetscMemcpy(out+o,in+i+1,len);CHKERRQ(ierr);
+      i += 1+len;
+    }
+    o += len;
+  }
+  if (o != n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Corrupted compressed checkpoint");
+  PetscFunctionReturn(0);
+}
+
+/* range [b0,b1) of the bytes of each real number that are stored */
+static PetscErrorCode CompressGetByteRange(Stack *stack,size_t *b0,size_t *b1)
+{
+  const size_t s = sizeof(PetscReal);
+  size_t       nb = s;
+  PetscInt     signexp,mant;
+
+  PetscFunctionBegin;
+  if (stack->compress == COMPRESS_LOSSY) {
+    /* truncating the mantissa to mant bits gives a relative error below 2^-mant */
+    signexp = (PetscInt)(8*s) - (PetscInt)PetscRoundReal(-PetscLog2Real(PETSC_MACHINE_EPSILON));
+    mant    = (PetscInt)PetscCeilReal(-PetscLog2Real(stack->compress_tol));
+    nb      = PetscMin(s,(size_t)(signexp+PetscMax(mant,0)+7)/8);
+  }
+#if defined(PETSC_WORDS_BIGENDIAN)
+  *b0 = 0; *b1 = nb;
+#else
+  *b0 = s-nb; *b1 = s;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* compress the local part of X at *buf and advance *buf, the buffer must hold CompressVecBound() bytes */
+static PetscErrorCode CompressVec(Stack *stack,Vec X,unsigned char **buf)
+{
+  const size_t      s = sizeof(PetscReal);
+  const PetscScalar *x;
+  PetscInt          n;
+  size_t            cnt,b,b0,b1,i,clen;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = CompressGetByteRange(stack,&b0,&b1);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  cnt  = (size_t)n*(sizeof(PetscScalar)/s);
+  ierr = VecGetArrayRead(X,&x);CHKERRQ(ierr);
+  for (b=b0; b<b1; b++) {
+    const unsigned char *in = (const unsigned char*)x + b;
+    unsigned char       *out = stack->shuffle + (b-b0)*cnt;
+    for (i=0; i<cnt; i++) out[i] = in[i*s];
+  }
+  ierr = VecRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = LZCompress(stack->shuffle,(b1-b0)*cnt,*buf+sizeof(size_t),&clen);CHKERRQ(ierr);
+  ierr = PetscMemcpy(*buf,&clen,sizeof(size_t));CHKERRQ(ierr);
+  *buf += sizeof(size_t)+clen;
+  stack->rawbytes    += (PetscLogDouble)(n*sizeof(PetscScalar));
+  stack->packedbytes += (PetscLogDouble)(sizeof(size_t)+clen);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DecompressVec(Stack *stack,Vec X,const unsigned char **buf)
+{
+  const size_t   s = sizeof(PetscReal);
+  PetscScalar    *x;
+  PetscInt       n;
+  size_t         cnt,b,b0,b1,i,clen;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = CompressGetByteRange(stack,&b0,&b1);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  cnt  = (size_t)n*(sizeof(PetscScalar)/s);
+  ierr = PetscMemcpy(&clen,*buf,sizeof(size_t));CHKERRQ(ierr);
+  ierr = LZDecompress(*buf+sizeof(size_t),clen,stack->shuffle,(b1-b0)*cnt);CHKERRQ(ierr);
+  *buf += sizeof(size_t)+clen;
+  ierr = VecGetArray(X,&x);CHKERRQ(ierr);
+  if (b1-b0 < s) {ierr = PetscMemzero(x,n*sizeof(PetscScalar));CHKERRQ(ierr);}
+  for (b=b0; b<b1; b++) {
+    const unsigned char *in = stack->shuffle + (b-b0)*cnt;
+    unsigned char       *out = (unsigned char*)x + b;
+    for (i=0; i<cnt; i++) out[i*s] = in[i];
+  }
+  ierr = VecRestoreArray(X,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* make sure the scratch buffers can hold the compression of nvec vectors like X */
+static PetscErrorCode CompressSetUpWork(Stack *stack,Vec X,PetscInt nvec)
+{
+  PetscInt       n;
+  size_t         size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(X,&n);CHKERRQ(ierr);
+  size = (size_t)n*sizeof(PetscScalar);
+  if (size > stack->shufflesize) {
+    ierr = PetscFree(stack->shuffle);CHKERRQ(ierr);
+    ierr = PetscMalloc1(size,&stack->shuffle);CHKERRQ(ierr);
+    stack->shufflesize = size;
+  }
+  size = nvec*(sizeof(size_t)+LZCompressBound(size));
+  if (size > stack->worksize) {
+    ierr = PetscFree(stack->work);CHKERRQ(ierr);
+    ierr = PetscMalloc1(size,&stack->work);CHKERRQ(ierr);
+    stack->worksize = size;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* store X and the stages Y (NULL in the solution only mode) in the element */
+static PetscErrorCode ElementPack(Stack *stack,StackElement e,Vec X,Vec *Y)
+{
+  unsigned char  *buf;
+  PetscInt       i,nY = Y ? stack->numY : 0;
+  size_t         clen;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (stack->compress == COMPRESS_NONE) {
+    ierr = VecCopy(X,e->X);CHKERRQ(ierr);
+    for (i=0;i<nY;i++) {
+      ierr = VecCopy(Y[i],e->Y[i]);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
+  ierr = CompressSetUpWork(stack,X,1+nY);CHKERRQ(ierr);
+  buf  = stack->work;
+  ierr = CompressVec(stack,X,&buf);CHKERRQ(ierr);
+  for (i=0;i<nY;i++) {
+    ierr = CompressVec(stack,Y[i],&buf);CHKERRQ(ierr);
+  }
+  /* keep only the compressed bytes */
+  clen = (size_t)(buf-stack->work);
+  if (clen != e->clen) {
+    if (stack->use_dram) {
+      ierr = PetscMallocSetDRAM();CHKERRQ(ierr);
+    }
+    ierr = PetscFree(e->cdata);CHKERRQ(ierr);
+    ierr = PetscMalloc1(clen,&e->cdata);CHKERRQ(ierr);
+    if (stack->use_dram) {
+      ierr = PetscMallocResetDRAM();CHKERRQ(ierr);
+    }
+    e->clen = clen;
+  }
+  ierr = PetscMemcpy(e->cdata,stack->work,clen);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* restore X and the stages Y (NULL in the solution only mode) from the element */
+static PetscErrorCode ElementUnpack(Stack *stack,StackElement e,Vec X,Vec *Y)
+{
+  const unsigned char *buf;
+  PetscInt            i,nY = Y ? stack->numY : 0;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (stack->compress == COMPRESS_NONE) {
+    ierr = VecCopy(e->X,X);CHKERRQ(ierr);
+    for (i=0;i<nY;i++) {
+      ierr = VecCopy(e->Y[i],Y[i]);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
+  ierr = CompressSetUpWork(stack,X,0);CHKERRQ(ierr);
+  buf  = (const unsigned char*)e->cdata;
+  ierr = DecompressVec(stack,X,&buf);CHKERRQ(ierr);
+  for (i=0;i<nY;i++) {
+    ierr = DecompressVec(stack,Y[i],&buf);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* vectors to write to or read from disk for an element, the work vectors are used when compression is on */
+static PetscErrorCode ElementGetVecs(TS ts,Stack *stack,StackElement e,Vec *X,Vec **Y)
+{
+  Vec            *Yts;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (stack->compress == COMPRESS_NONE) {
+    *X = e->X;
+    *Y = e->Y;
+    PetscFunctionReturn(0);
+  }
+  if (!stack->Xwork) {
+    ierr = VecDuplicate(ts->vec_sol,&stack->Xwork);CHKERRQ(ierr);
+    if (stack->numY > 0 && !stack->solution_only) {
+      ierr = TSGetStages(ts,&stack->numY,&Yts);CHKERRQ(ierr);
+      ierr = VecDuplicateVecs(Yts[0],stack->numY,&stack->Ywork);CHKERRQ(ierr);
+    }
+  }
+  *X = stack->Xwork;
+  *Y = stack->Ywork;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode ElementCreate(TS ts,Stack *stack,StackElement *e)
 {
   Vec            X;
@@ -112,11 +395,13 @@ static PetscErrorCode ElementCreate(TS ts,Stack *stack,StackElement *e)
     ierr = PetscMallocSetDRAM();CHKERRQ(ierr);
   }
   ierr = PetscCalloc1(1,e);CHKERRQ(ierr);
-  ierr = TSGetSolution(ts,&X);CHKERRQ(ierr);
-  ierr = VecDuplicate(X,&(*e)->X);CHKERRQ(ierr);
-  if (stack->numY > 0 && !stack->solution_only) {
-    ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
-    ierr = VecDuplicateVecs(Y[0],stack->numY,&(*e)->Y);CHKERRQ(ierr);
+  if (stack->compress == COMPRESS_NONE) { /* the compressed data is allocated by ElementPack() */
+    ierr = TSGetSolution(ts,&X);CHKERRQ(ierr);
+    ierr = VecDuplicate(X,&(*e)->X);CHKERRQ(ierr);
+    if (stack->numY > 0 && !stack->solution_only) {
+      ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
+      ierr = VecDuplicateVecs(Y[0],stack->numY,&(*e)->Y);CHKERRQ(ierr);
+    }
   }
   if (stack->use_dram) {
     ierr = PetscMallocResetDRAM();CHKERRQ(ierr);
@@ -126,19 +411,15 @@ static PetscErrorCode ElementCreate(TS ts,Stack *stack,StackElement *e)
 
 static PetscErrorCode ElementSet(TS ts,Stack *stack,StackElement *e,PetscInt stepnum,PetscReal time,Vec X)
 {
-  Vec            *Y;
-  PetscInt       i;
+  Vec            *Y = NULL;
   PetscReal      timeprev;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = VecCopy(X,(*e)->X);CHKERRQ(ierr);
   if (stack->numY > 0 && !stack->solution_only) {
     ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
-    for (i=0;i<stack->numY;i++) {
-      ierr = VecCopy(Y[i],(*e)->Y[i]);CHKERRQ(ierr);
-    }
   }
+  ierr = ElementPack(stack,*e,X,Y);CHKERRQ(ierr);
   (*e)->stepnum = stepnum;
   (*e)->time    = time;
   /* for consistency */
@@ -163,6 +444,7 @@ static PetscErrorCode ElementDestroy(Stack *stack,StackElement e)
   if (stack->numY > 0 && !stack->solution_only) {
     ierr = VecDestroyVecs(stack->numY,&e->Y);CHKERRQ(ierr);
   }
+  ierr = PetscFree(e->cdata);CHKERRQ(ierr);
   ierr = PetscFree(e);CHKERRQ(ierr);
   if (stack->use_dram) {
     ierr = PetscMallocResetDRAM();CHKERRQ(ierr);
@@ -238,6 +520,12 @@ static PetscErrorCode StackDestroy(Stack *stack)
     }
   }
   ierr = PetscFree(stack->container);CHKERRQ(ierr);
+  ierr = PetscFree(stack->shuffle);CHKERRQ(ierr);
+  ierr = PetscFree(stack->work);CHKERRQ(ierr);
+  ierr = VecDestroy(&stack->Xwork);CHKERRQ(ierr);
+  if (stack->Ywork) {
+    ierr = VecDestroyVecs(stack->numY,&stack->Ywork);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -296,7 +584,7 @@ static PetscErrorCode ReadFromDisk(PetscInt *stepnum,PetscReal *time,PetscReal *
 
 static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
 {
-  Vec            *Y;
+  Vec            *Y,Xe,*Ye;
   PetscInt       i;
   StackElement   e = NULL;
   PetscViewer    viewer;
@@ -323,8 +611,12 @@ static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
   ierr = OutputBIN(comm,filename,&viewer);CHKERRQ(ierr);
   for (i=0;i<stack->stacksize;i++) {
     e = stack->container[i];
+    ierr = ElementGetVecs(ts,stack,e,&Xe,&Ye);CHKERRQ(ierr);
+    if (stack->compress != COMPRESS_NONE) {
+      ierr = ElementUnpack(stack,e,Xe,stack->solution_only ? NULL : Ye);CHKERRQ(ierr);
+    }
     ierr = PetscLogEventBegin(TSTrajectory_DiskWrite,ts,0,0,0);CHKERRQ(ierr);
-    ierr = WriteToDisk(e->stepnum,e->time,e->timeprev,e->X,e->Y,stack->numY,stack->solution_only,viewer);CHKERRQ(ierr);
+    ierr = WriteToDisk(e->stepnum,e->time,e->timeprev,Xe,Ye,stack->numY,stack->solution_only,viewer);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(TSTrajectory_DiskWrite,ts,0,0,0);CHKERRQ(ierr);
     ts->trajectory->diskwrites++;
   }
@@ -344,7 +636,7 @@ static PetscErrorCode StackDumpAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
 
 static PetscErrorCode StackLoadAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
 {
-  Vec            *Y;
+  Vec            *Y,Xe,*Ye;
   PetscInt       i;
   StackElement   e;
   PetscViewer    viewer;
@@ -362,9 +654,13 @@ static PetscErrorCode StackLoadAll(TSTrajectory tj,TS ts,Stack *stack,PetscInt i
   for (i=0;i<stack->stacksize;i++) {
     ierr = ElementCreate(ts,stack,&e);CHKERRQ(ierr);
     ierr = StackPush(stack,e);CHKERRQ(ierr);
+    ierr = ElementGetVecs(ts,stack,e,&Xe,&Ye);CHKERRQ(ierr);
     ierr = PetscLogEventBegin(TSTrajectory_DiskRead,ts,0,0,0);CHKERRQ(ierr);
-    ierr = ReadFromDisk(&e->stepnum,&e->time,&e->timeprev,e->X,e->Y,stack->numY,stack->solution_only,viewer);CHKERRQ(ierr);
+    ierr = ReadFromDisk(&e->stepnum,&e->time,&e->timeprev,Xe,Ye,stack->numY,stack->solution_only,viewer);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(TSTrajectory_DiskRead,ts,0,0,0);CHKERRQ(ierr);
+    if (stack->compress != COMPRESS_NONE) {
+      ierr = ElementPack(stack,e,Xe,stack->solution_only ? NULL : Ye);CHKERRQ(ierr);
+    }
     ts->trajectory->diskreads++;
   }
   /* load the last step into TS */
@@ -494,18 +790,14 @@ static PetscErrorCode LoadSingle(TSTrajectory tj,TS ts,Stack *stack,PetscInt id)
 
 static PetscErrorCode UpdateTS(TS ts,Stack *stack,StackElement e)
 {
-  Vec            *Y;
-  PetscInt       i;
+  Vec            *Y = NULL;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = VecCopy(e->X,ts->vec_sol);CHKERRQ(ierr);
   if (!stack->solution_only) {
     ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
-    for (i=0;i<stack->numY;i++) {
-      ierr = VecCopy(e->Y[i],Y[i]);CHKERRQ(ierr);
-    }
   }
+  ierr = ElementUnpack(stack,e,ts->vec_sol,Y);CHKERRQ(ierr);
   ierr = TSSetTimeStep(ts,e->timeprev-e->time);CHKERRQ(ierr); /* stepsize will be negative */
   ts->ptime      = e->time;
   ts->ptime_prev = e->timeprev;
@@ -980,8 +1272,8 @@ static PetscErrorCode GetTrajROF(TSTrajectory tj,TS ts,TJScheduler *tjsch,PetscI
 static PetscErrorCode SetTrajRON(TSTrajectory tj,TS ts,TJScheduler *tjsch,PetscInt stepnum,PetscReal time,Vec X)
 {
   Stack          *stack = &tjsch->stack;
-  Vec            *Y;
-  PetscInt       i,store;
+  Vec            *Y = NULL;
+  PetscInt       store;
   PetscReal      timeprev;
   StackElement   e;
   RevolveCTX     *rctx = tjsch->rctx;
@@ -994,13 +1286,10 @@ static PetscErrorCode SetTrajRON(TSTrajectory tj,TS ts,TJScheduler *tjsch,PetscI
   if (store == 1) {
     if (rctx->check != stack->top+1) { /* overwrite some non-top checkpoint in the stack */
       ierr = StackFind(stack,&e,rctx->check);CHKERRQ(ierr);
-      ierr = VecCopy(X,e->X);CHKERRQ(ierr);
       if (stack->numY > 0 && !stack->solution_only) {
         ierr = TSGetStages(ts,&stack->numY,&Y);CHKERRQ(ierr);
-        for (i=0;i<stack->numY;i++) {
-          ierr = VecCopy(Y[i],e->Y[i]);CHKERRQ(ierr);
-        }
       }
+      ierr = ElementPack(stack,e,X,Y);CHKERRQ(ierr);
       e->stepnum  = stepnum;
       e->time     = time;
       ierr        = TSGetPrevTime(ts,&timeprev);CHKERRQ(ierr);
@@ -1662,8 +1951,12 @@ static PetscErrorCode TSTrajectorySetFromOptions_Memory(PetscOptionItems *PetscO
     ierr = PetscOptionsBool("-ts_trajectory_save_stack","Save all stack to disk","TSTrajectorySetSaveStack",tjsch->save_stack,&tjsch->save_stack,NULL);CHKERRQ(ierr);
     ierr = PetscOptionsBool("-ts_trajectory_solution_only","Checkpoint solution only","TSTrajectorySetSolutionOnly",tjsch->stack.solution_only,&tjsch->stack.solution_only,NULL);CHKERRQ(ierr);
     ierr = PetscOptionsBool("-ts_trajectory_use_dram","Use DRAM for checkpointing","TSTrajectorySetUseDRAM",tjsch->stack.use_dram,&tjsch->stack.use_dram,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsEnum("-ts_trajectory_compress","Compress the checkpoints in RAM","TSTrajectorySetFromOptions",CompressionTypes,(PetscEnum)tjsch->stack.compress,(PetscEnum*)&tjsch->stack.compress,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_trajectory_compress_tol","Relative error bound of the lossy compression","TSTrajectorySetFromOptions",tjsch->stack.compress_tol,&tjsch->stack.compress_tol,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ts_trajectory_compress_ratio","Expected compression ratio, the checkpoints are assumed uncompressed if not set","TSTrajectorySetFromOptions",tjsch->compress_ratio,&tjsch->compress_ratio,NULL);CHKERRQ(ierr);
   }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
+  if (tjsch->stack.compress == COMPRESS_LOSSY && (tjsch->stack.compress_tol <= 0.0 || tjsch->stack.compress_tol >= 1.0)) SETERRQ1(PetscObjectComm((PetscObject)tj),PETSC_ERR_ARG_OUTOFRANGE,"The tolerance of the lossy compression must be in (0,1), not %g",(double)tjsch->stack.compress_tol);
   PetscFunctionReturn(0);
 }
 
@@ -1683,6 +1976,14 @@ static PetscErrorCode TSTrajectorySetUp_Memory(TSTrajectory tj,TS ts)
   PetscFunctionBegin;
   PetscStrcmp(((PetscObject)ts->adapt)->type_name,TSADAPTNONE,&flg);
   if (flg) tjsch->total_steps = PetscMin(ts->max_steps,(PetscInt)(PetscCeilReal((ts->max_time-ts->ptime)/ts->time_step))); /* fixed time step */
+  if (stack->compress != COMPRESS_NONE && tjsch->max_cps_ram > 0) {
+    /* max_cps_ram is the memory budget in uncompressed checkpoints, the schedulers get the number of compressed checkpoints
+       that fit. No checkpoint has been measured yet (the initial solution is often trivial to compress), so without an
+       expected ratio from the user they are counted at their uncompressed size. */
+    tjsch->compress_ratio = PetscMax(tjsch->compress_ratio,1.0);
+    ierr = PetscInfo3(tj,"Compression ratio %g, %D checkpoints fit in RAM instead of %D\n",(double)tjsch->compress_ratio,(PetscInt)(tjsch->max_cps_ram*tjsch->compress_ratio),tjsch->max_cps_ram);CHKERRQ(ierr);
+    tjsch->max_cps_ram = (PetscInt)(tjsch->max_cps_ram*tjsch->compress_ratio);
+  }
   if (tjsch->max_cps_ram > 0) stack->stacksize = tjsch->max_cps_ram;
 
   if (tjsch->stride > 1) { /* two level mode */
@@ -1767,6 +2068,31 @@ static PetscErrorCode TSTrajectorySetUp_Memory(TSTrajectory tj,TS ts)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode TSTrajectoryView_Memory(TSTrajectory tj,PetscViewer viewer)
+{
+  TJScheduler    *tjsch = (TJScheduler*)tj->data;
+  Stack          *stack = &tjsch->stack;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && stack->compress != COMPRESS_NONE) {
+    if (stack->compress == COMPRESS_LOSSY) {
+      ierr = PetscViewerASCIIPrintf(viewer,"lossy compression of the checkpoints in RAM, relative tolerance %g\n",(double)stack->compress_tol);CHKERRQ(ierr);
+    } else {
+      ierr = PetscViewerASCIIPrintf(viewer,"lossless compression of the checkpoints in RAM\n");CHKERRQ(ierr);
+    }
+    if (tjsch->compress_ratio > 0.0) {
+      ierr = PetscViewerASCIIPrintf(viewer,"expected compression ratio %g\n",(double)tjsch->compress_ratio);CHKERRQ(ierr);
+    }
+    if (stack->packedbytes > 0.0) {
+      ierr = PetscViewerASCIIPrintf(viewer,"achieved compression ratio %g\n",(double)(stack->rawbytes/stack->packedbytes));CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode TSTrajectoryDestroy_Memory(TSTrajectory tj)
 {
   TJScheduler    *tjsch = (TJScheduler*)tj->data;
@@ -1796,6 +2122,17 @@ static PetscErrorCode TSTrajectoryDestroy_Memory(TSTrajectory tj)
 /*MC
       TSTRAJECTORYMEMORY - Stores each solution of the ODE/ADE in memory
 
+  Options Database Keys:
++  -ts_trajectory_compress <none,lossless,lossy> - compress the checkpoints kept in RAM
+.  -ts_trajectory_compress_tol <tol> - relative error bound of each entry with lossy compression
+-  -ts_trajectory_compress_ratio <r> - expected compression ratio
+
+  Notes:
+  With compression -ts_trajectory_max_cps_ram gives the memory available in units of uncompressed checkpoints, and the
+  checkpointing schedule is computed for the number of compressed checkpoints that fit in it, assuming the expected
+  compression ratio. Without it the checkpoints are counted at their uncompressed size, so compression only reduces the
+  memory used; TSTrajectoryView() reports the achieved ratio, which can be given for later runs.
+
   Level: intermediate
 
 .seealso:  TSTrajectoryCreate(), TS, TSTrajectorySetType()
@@ -1812,6 +2149,7 @@ PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Memory(TSTrajectory tj,TS ts)
   tj->ops->setup          = TSTrajectorySetUp_Memory;
   tj->ops->destroy        = TSTrajectoryDestroy_Memory;
   tj->ops->setfromoptions = TSTrajectorySetFromOptions_Memory;
+  tj->ops->view           = TSTrajectoryView_Memory;
 
   ierr = PetscCalloc1(1,&tjsch);CHKERRQ(ierr);
   tjsch->stype        = NONE;
@@ -1824,6 +2162,8 @@ PETSC_EXTERN PetscErrorCode TSTrajectoryCreate_Memory(TSTrajectory tj,TS ts)
   tjsch->save_stack   = PETSC_TRUE;
 
   tjsch->stack.solution_only = PETSC_TRUE;
+  tjsch->stack.compress      = COMPRESS_NONE;
+  tjsch->stack.compress_tol  = 1.e-8;
 
   tj->data = tjsch;
   PetscFunctionReturn(0);
@@ -19,6 +19,32 @@ PetscErrorCode ISColoringSetType(ISColoring coloring,ISColoringType type)
   PetscFunctionReturn(0);
 }
 
+/*@
+   ISColoringGetType - Gets whether the coloring is of the global or ghosted (local) columns
+
+   Not Collective
+
+   Input Parameter:
+.  coloring - the coloring context
+
+   Output Parameter:
+.  type - IS_COLORING_GLOBAL or IS_COLORING_LOCAL
+
+   Notes: A DM may return a global coloring when a ghosted one is requested, for example on one process.
+
+   Level: advanced
+
+.seealso: ISColoringSetType(), ISColoringCreate(), DMCreateColoring()
+@*/
+PetscErrorCode ISColoringGetType(ISColoring coloring,ISColoringType *type)
+{
+  PetscFunctionBegin;
+  PetscValidPointer(coloring,1);
+  PetscValidPointer(type,2);
+  *type = coloring->ctype;
+  PetscFunctionReturn(0);
+}
+
 /*@
    ISColoringDestroy - Destroys a coloring context.
 
@@ -506,12 +506,34 @@ PetscErrorCode  VecTDotEnd(Vec x,Vec y,PetscScalar *result)
 PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
 {
   PetscErrorCode      ierr;
-  PetscSplitReduction *sr;
   PetscReal           lresult[2];
-  MPI_Comm            comm;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
+  if (!x->ops->norm_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local norms");
+  ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
+  ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
+  if (ntype == NORM_2)         lresult[0]                = lresult[0]*lresult[0];
+  if (ntype == NORM_1_AND_2)   lresult[1]                = lresult[1]*lresult[1];
+  ierr = VecNormBeginLocal_Private(x,ntype,lresult);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecNormBeginLocal_Private - Starts a split phase norm computation from a local contribution that has
+   already been computed, for example as a by-product of the routine that filled x. The values are those
+   entering the reduction: the sum of the squares of the local entries for NORM_2.
+
+   The norm is obtained with VecNormEnd() as usual; x must not be changed in between.
+*/
+PetscErrorCode VecNormBeginLocal_Private(Vec x,NormType ntype,const PetscReal lresult[])
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  MPI_Comm            comm;
+
+  PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
@@ -520,12 +542,6 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
   }
 
   sr->invecs[sr->numopsbegin] = (void*)x;
-  if (!x->ops->norm_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local norms");
-  ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);
-  ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  if (ntype == NORM_2)         lresult[0]                = lresult[0]*lresult[0];
-  if (ntype == NORM_1_AND_2)   lresult[1]                = lresult[1]*lresult[1];
   if (ntype == NORM_MAX) sr->reducetype[sr->numopsbegin] = REDUCE_MAX;
   else                   sr->reducetype[sr->numopsbegin] = REDUCE_SUM;
   sr->lvalues[sr->numopsbegin++] = lresult[0];